@@ -18,17 +18,29 @@
 #endif
 #include <cmath>
 
+#include <functional>
+
 // #include <QDebug>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 #include <QToolTip>
+#include <QtMath>
 #include <QWidget>
 
 #include "appmodes.h"
 #include "canvas.h"
 #include "canvasmode.h"
+#include "itemrendercache.h"
 #include "pageitem_textframe.h"
 #include "pageitem_group.h"
 #include "prefsmanager.h"
 #include "scpage.h"
+#include "scpagerenderer.h"
 #include "scpainter.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
@@ -105,7 +117,10 @@ QDataStream &operator>> ( QDataStream & ds, CanvasViewMode & vm )
 }
 	
 
-Canvas::Canvas(ScribusDoc* doc, ScribusView* parent) : QWidget(parent), m_doc(doc), m_view(parent)
+Canvas::Canvas(ScribusDoc* doc, ScribusView* parent) : QWidget(parent), m_doc(doc), m_view(parent),
+	// cost is in KB, enough for several screens of tiles
+	m_tiles(96 * 1024),
+	m_tilePage(nullptr)
 {
 	setAutoFillBackground(true);
 	setAttribute(Qt::WA_OpaquePaintEvent, true);
@@ -477,20 +492,19 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 	if (m_doc->Items->count() == 0)
 		return nullptr;
 
-	int currNr = itemAbove? m_doc->Items->indexOf(itemAbove)-1 : m_doc->Items->count()-1;
-	while (currNr >= 0)
+	int lastNr = itemAbove? m_doc->Items->indexOf(itemAbove)-1 : m_doc->Items->count()-1;
+	// only the items whose bounds come near the cursor, topmost first
+	const QList<int> candidates(m_doc->itemIndicesIn(mouseArea));
+	for (int i = candidates.count() - 1; i >= 0; --i)
 	{
+		int currNr = candidates.at(i);
+		if (currNr > lastNr)
+			continue;
 		currItem = m_doc->Items->at(currNr);
 		if ((m_doc->masterPageMode())  && (!((currItem->OwnPage == -1) || (currItem->OwnPage == static_cast<int>(m_doc->currentPage()->pageNr())))))
-		{
-			--currNr;
 			continue;
-		}
 		if ((m_doc->drawAsPreview && !m_doc->editOnPreview) && !(currItem->isAnnotation() || currItem->isGroup()))
-		{
-			--currNr;
 			continue;
-		}
 		if (((currItem->LayerID == m_doc->activeLayer()) || (m_doc->layerSelectable(currItem->LayerID))) && (!m_doc->layerLocked(currItem->LayerID)))
 		{
 			QTransform itemPos = currItem->getTransform();
@@ -519,7 +533,6 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 				return currItem;
 			}
 		}
-		--currNr;
 	}
 	return nullptr;
 }
@@ -613,6 +626,7 @@ PageItem * Canvas::itemUnderItem(PageItem * item, int& index) const
  
  m_buffer holds the current page(s)
  m_bufferRect describes the contents in local coordinates:
+ m_tiles caches the contents in tiles of TileSize pixels, which m_buffer is filled from
 
  minCanvasCoordinate |-> local (0,0) 
  
@@ -640,6 +654,326 @@ void Canvas::clearBuffers()
 	m_bufferRect = QRect();
 	m_selectionBuffer = QPixmap();
 	m_selectionRect = QRect();
+	m_tiles.clear();
+}
+
+Canvas::TileState::TileState() :
+	scale(0.0),
+	previewMode(false),
+	viewAsPreview(false),
+	previewVisual(0),
+	masterPageMode(false),
+	appMode(0),
+	drawSelectedItemsWithControls(false),
+	drawFramelinksWithContents(false)
+{
+}
+
+bool Canvas::TileState::operator==(const TileState& other) const
+{
+	return scale == other.scale
+		&& previewMode == other.previewMode
+		&& viewAsPreview == other.viewAsPreview
+		&& previewVisual == other.previewVisual
+		&& masterPageMode == other.masterPageMode
+		&& appMode == other.appMode
+		&& drawSelectedItemsWithControls == other.drawSelectedItemsWithControls
+		&& drawFramelinksWithContents == other.drawFramelinksWithContents
+		&& selection == other.selection;
+}
+
+void Canvas::invalidateTiles(QRectF canvasRect)
+{
+	if (!canvasRect.isValid())
+	{
+		m_tiles.clear();
+		return;
+	}
+	// same margin as ScribusView::updateCanvas()
+	invalidateLocalTiles(canvasToLocal(canvasRect).adjusted(-10, -10, 10, 10));
+}
+
+void Canvas::invalidateLocalTiles(QRect localRect)
+{
+	if (m_tiles.isEmpty() || !localRect.isValid())
+		return;
+	int col0 = qFloor(localRect.left() / double(TileSize));
+	int row0 = qFloor(localRect.top() / double(TileSize));
+	int col1 = qFloor(localRect.right() / double(TileSize));
+	int row1 = qFloor(localRect.bottom() / double(TileSize));
+	if ((col1 - col0 + 1) * (row1 - row0 + 1) > m_tiles.count())
+	{
+		// cheaper to look at the cached tiles than at the range
+		const QList<quint64> keys = m_tiles.keys();
+		for (quint64 key : keys)
+		{
+			int col = qint32(key >> 32);
+			int row = qint32(key & 0xffffffff);
+			if (col >= col0 && col <= col1 && row >= row0 && row <= row1)
+				m_tiles.remove(key);
+		}
+		return;
+	}
+	for (int row = row0; row <= row1; ++row)
+	{
+		for (int col = col0; col <= col1; ++col)
+			m_tiles.remove(tileKey(col, row));
+	}
+}
+
+void Canvas::validateTiles()
+{
+	TileState state;
+	state.scale = m_viewMode.scale;
+	state.previewMode = m_viewMode.previewMode;
+	state.viewAsPreview = m_viewMode.viewAsPreview;
+	state.previewVisual = m_viewMode.previewVisual;
+	state.masterPageMode = m_doc->masterPageMode();
+	state.appMode = m_doc->appMode;
+	state.drawSelectedItemsWithControls = m_viewMode.drawSelectedItemsWithControls;
+	state.drawFramelinksWithContents = m_viewMode.drawFramelinksWithContents;
+	// selected items are drawn with decorations and their frame links
+	if (!m_viewMode.viewAsPreview)
+		state.selection = m_doc->m_Selection->items();
+	if (state != m_tileState)
+	{
+		m_tiles.clear();
+		m_tileState = state;
+	}
+
+	// the current page has an indicator drawn around it
+	ScPage* page = m_doc->currentPage();
+	if (page != m_tilePage)
+	{
+		if (m_doc->masterPageMode())
+			m_tiles.clear();
+		else
+		{
+			for (ScPage* p : { m_tilePage, page })
+			{
+				if (p && m_doc->Pages->contains(p))
+					invalidateTiles(QRectF(p->xOffset(), p->yOffset(), p->width() + 5 / m_viewMode.scale, p->height() + 5 / m_viewMode.scale));
+			}
+		}
+		m_tilePage = page;
+	}
+}
+
+void Canvas::renderTiles(QRect tileRange)
+{
+	// tiles showing older revisions of the document are rendered again
+	QList<QPoint> tiles;
+	QRect missing;
+	for (int row = tileRange.top(); row <= tileRange.bottom(); ++row)
+	{
+		for (int col = tileRange.left(); col <= tileRange.right(); ++col)
+		{
+			Tile* tile = m_tiles.object(tileKey(col, row));
+			if (tile && (tile->revision < tileRevision(col, row)))
+			{
+				m_tiles.remove(tileKey(col, row));
+				tile = nullptr;
+			}
+			if (!tile)
+			{
+				tiles.append(QPoint(col, row));
+				missing |= QRect(col, row, 1, 1);
+			}
+		}
+	}
+	if (tiles.isEmpty())
+		return;
+	if ((tiles.count() > 1) && canRenderTilesConcurrently())
+	{
+		renderTilesConcurrently(tiles);
+		return;
+	}
+
+	// render the bounding rectangle of the missing tiles in one go
+	QHash<quint64, quint64> revisions;
+	for (int row = missing.top(); row <= missing.bottom(); ++row)
+	{
+		for (int col = missing.left(); col <= missing.right(); ++col)
+			revisions.insert(tileKey(col, row), tileRevision(col, row));
+	}
+	QRect area(missing.left() * TileSize, missing.top() * TileSize, missing.width() * TileSize, missing.height() * TileSize);
+	QPixmap pixmap = createPixmap(area.width(), area.height());
+	QPainter painter(&pixmap);
+	painter.translate(-area.x(), -area.y());
+	drawContents(&painter, area.x(), area.y(), area.width(), area.height());
+	painter.end();
+
+	const qreal ratio = devicePixelRatio();
+	const int tilePixels = qRound(TileSize * ratio);
+	const int cost = qMax(1, tilePixels * tilePixels * 4 / 1024);
+	for (int row = missing.top(); row <= missing.bottom(); ++row)
+	{
+		for (int col = missing.left(); col <= missing.right(); ++col)
+		{
+			Tile* tile = new Tile;
+			tile->pixmap = pixmap.copy(qRound((col - missing.left()) * TileSize * ratio), qRound((row - missing.top()) * TileSize * ratio), tilePixels, tilePixels);
+			tile->pixmap.setDevicePixelRatio(ratio);
+			tile->revision = revisions.value(tileKey(col, row));
+			m_tiles.insert(tileKey(col, row), tile, cost);
+		}
+	}
+}
+
+/// a tile rendered by CanvasTileTask
+struct CanvasTileJob
+{
+	QRect clip;
+	Canvas::TilePass pass;
+	QImage image;
+};
+
+/// renders the jobs of Canvas::renderTilesConcurrently() until there are none left
+class CanvasTileTask : public QRunnable
+{
+public:
+	typedef std::function<QImage(const CanvasTileJob&)> RenderFunction;
+
+	CanvasTileTask(CanvasTileJob* jobs, int count, QAtomicInt& next, const RenderFunction& render, QSemaphore* done)
+		: m_jobs(jobs), m_count(count), m_next(next), m_render(render), m_done(done)
+	{ }
+
+	void run()
+	{
+		for (int i = m_next.fetchAndAddOrdered(1); i < m_count; i = m_next.fetchAndAddOrdered(1))
+			m_jobs[i].image = m_render(m_jobs[i]);
+		if (m_done)
+			m_done->release();
+	}
+
+private:
+	CanvasTileJob* m_jobs;
+	int m_count;
+	QAtomicInt& m_next;
+	const RenderFunction& m_render;
+	QSemaphore* m_done;
+};
+
+static QThreadPool* canvasTilePool()
+{
+	static QThreadPool pool;
+	return &pool;
+}
+
+void Canvas::renderTilesConcurrently(const QList<QPoint>& tiles)
+{
+	// Everything which may change the document or the canvas happens here, on the GUI
+	// thread: laying out text, querying the item index, revisions, frame links and rulers.
+	// The document can't change while the GUI thread waits for the workers.
+	QRect area;
+	for (const QPoint& tile : tiles)
+		area |= tileRect(tile.x(), tile.y());
+	QRectF canvasArea(clipToCanvas(area));
+	ScPageRenderer(m_doc).prepare(canvasArea);
+
+	QVector<CanvasTileJob> jobs;
+	QVector<quint64> revisions;
+	jobs.reserve(tiles.count());
+	revisions.reserve(tiles.count());
+	for (const QPoint& tile : tiles)
+	{
+		CanvasTileJob job;
+		job.clip = tileRect(tile.x(), tile.y());
+		job.pass.candidates = m_doc->itemIndicesIn(clipToCanvas(job.clip));
+		jobs.append(job);
+		revisions.append(tileRevision(tile.x(), tile.y()));
+	}
+
+	const qreal ratio = devicePixelRatio();
+	const QColor background(palette().color(QPalette::Window));
+	CanvasTileTask::RenderFunction render = [this, ratio, background](const CanvasTileJob& job)
+	{
+		return renderContents(job.clip, ratio, background, &job.pass);
+	};
+	// the GUI thread takes part in the work instead of just waiting
+	int threads = qMin(QThread::idealThreadCount(), jobs.count());
+	QAtomicInt next(0);
+	QSemaphore done;
+	QThreadPool* pool = canvasTilePool();
+	if (pool->maxThreadCount() < threads - 1)
+		pool->setMaxThreadCount(threads - 1);
+	for (int t = 1; t < threads; ++t)
+		pool->start(new CanvasTileTask(jobs.data(), jobs.count(), next, render, &done));
+	CanvasTileTask(jobs.data(), jobs.count(), next, render, nullptr).run();
+	done.acquire(threads - 1);
+
+	// frame links cross tiles, they are collected over all of them as drawContents() does
+	m_viewMode.linkedFramesToShow.clear();
+	int docCurrPageNo = static_cast<int>(m_doc->currentPageNumber());
+	const QList<int> candidates(m_doc->itemIndicesIn(canvasArea));
+	for (int index : candidates)
+	{
+		PageItem* currItem = m_doc->Items->at(index);
+		if (!m_doc->layerVisible(currItem->LayerID))
+			continue;
+		if ((m_viewMode.previewMode) && (!m_doc->layerPrintable(currItem->LayerID) || !currItem->printEnabled()))
+			continue;
+		if ((m_doc->masterPageMode()) && ((currItem->OwnPage != -1) && (currItem->OwnPage != docCurrPageNo)))
+			continue;
+		if (!m_doc->masterPageMode() && !currItem->OnMasterPage.isEmpty() && (currItem->OnMasterPage != m_doc->currentPage()->pageName()))
+			continue;
+		if (!canvasArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+			continue;
+		getLinkedFrames(currItem);
+		if ((m_doc->appMode == modeEdit) && (currItem->isSelected()) && (currItem->itemType() == PageItem::TextFrame))
+			setupEditHRuler(currItem);
+	}
+	bool drawLinks = ((m_doc->m_Selection->count() != 0) || (m_viewMode.linkedFramesToShow.count() != 0)) && (!m_viewMode.viewAsPreview);
+
+	const int tilePixels = qRound(TileSize * ratio);
+	const int cost = qMax(1, tilePixels * tilePixels * 4 / 1024);
+	for (int i = 0; i < jobs.count(); ++i)
+	{
+		CanvasTileJob& job = jobs[i];
+		if (drawLinks)
+			drawFrameLinks(&job.image, job.clip);
+		Tile* tile = new Tile;
+		tile->pixmap = QPixmap::fromImage(job.image);
+		tile->pixmap.setDevicePixelRatio(ratio);
+		tile->revision = revisions.at(i);
+		m_tiles.insert(tileKey(tiles.at(i).x(), tiles.at(i).y()), tile, cost);
+	}
+}
+
+bool Canvas::canRenderTilesConcurrently() const
+{
+	// forced redraws lay out text while drawing, selecting with the rubber band changes items
+	if (m_viewMode.forceRedraw || m_viewMode.operItemSelecting)
+		return false;
+	return QThread::idealThreadCount() > 1;
+}
+
+quint64 Canvas::tileRevision(int col, int row)
+{
+	QRectF area(clipToCanvas(tileRect(col, row)));
+	quint64 revision = qMax(m_doc->settingsRevision(), m_doc->layersRevision());
+	// pages are drawn with their bleeds and shadows
+	double shadow = 6.0 / m_viewMode.scale;
+	MarginStruct pageBleeds;
+	for (ScPage* page : qAsConst(*m_doc->Pages))
+	{
+		m_doc->getBleeds(page, pageBleeds);
+		QRectF pageRect(page->xOffset() - pageBleeds.left() - 1.0, page->yOffset() - pageBleeds.top() - 1.0,
+						page->width() + pageBleeds.left() + pageBleeds.right() + shadow, page->height() + pageBleeds.top() + pageBleeds.bottom() + shadow);
+		if (pageRect.intersects(area))
+			revision = qMax(revision, m_doc->pageRevision(page));
+	}
+	// items on the pasteboard are not on any page
+	const QList<int> candidates(m_doc->itemIndicesIn(area));
+	for (int index : candidates)
+		revision = qMax(revision, m_doc->Items->at(index)->revision());
+	return revision;
+}
+
+QRectF Canvas::clipToCanvas(QRect clip) const
+{
+	FPoint orig = localToCanvas(clip.topLeft());
+	return QRectF(static_cast<int>(orig.x()), static_cast<int>(orig.y()),
+				  qRound(clip.width() / m_viewMode.scale + 0.5), qRound(clip.height() / m_viewMode.scale + 0.5));
 }
 
 void Canvas::setScale(double scale)
@@ -663,6 +997,8 @@ bool Canvas::adjustBuffer()
 		m_bufferRect.translate(minCanvasCoordinate.x() - m_oldMinCanvasCoordinate.x(),
 							   minCanvasCoordinate.y() - m_oldMinCanvasCoordinate.y());
 		m_oldMinCanvasCoordinate = minCanvasCoordinate;
+		// the tiles are in local coordinates
+		m_tiles.clear();
 	}
 #if DRAW_DEBUG_LINES
 //	qDebug() << "adjust buffer" << m_bufferRect << "for viewport" << viewport;
@@ -795,12 +1131,69 @@ bool Canvas::adjustBuffer()
 void Canvas::fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect)
 {
 // 	qDebug()<<"Canvas::fillBuffer"<<clipRect<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
+	if (clipRect.isEmpty())
+		return;
+	validateTiles();
+	QRect tileRange(QPoint(qFloor(clipRect.left() / double(TileSize)), qFloor(clipRect.top() / double(TileSize))),
+					QPoint(qFloor(clipRect.right() / double(TileSize)), qFloor(clipRect.bottom() / double(TileSize))));
+	renderTiles(tileRange);
+
+	QPainter painter(buffer);
+	painter.translate(-bufferOrigin.x(), -bufferOrigin.y());
+	painter.setClipRect(clipRect);
+	for (int row = tileRange.top(); row <= tileRange.bottom(); ++row)
+	{
+		for (int col = tileRange.left(); col <= tileRange.right(); ++col)
+		{
+			Tile* tile = m_tiles.object(tileKey(col, row));
+			if (tile)
+				painter.drawPixmap(col * TileSize, row * TileSize, tile->pixmap);
+			else
+			{
+				// more tiles than fit into the cache
+				QRect rect(tileRect(col, row) & clipRect);
+				drawContents(&painter, rect.x(), rect.y(), rect.width(), rect.height());
+			}
+		}
+	}
+	painter.end();
+}
+
+void Canvas::drawBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect)
+{
 	QPainter painter(buffer);
 	painter.translate(-bufferOrigin.x(), -bufferOrigin.y());
 	drawContents(&painter, clipRect.x(), clipRect.y(), clipRect.width(), clipRect.height());
 	painter.end();
 }
 
+void Canvas::storeTiles(QRect localRect)
+{
+	validateTiles();
+	const qreal ratio = devicePixelRatio();
+	const int tilePixels = qRound(TileSize * ratio);
+	const int cost = qMax(1, tilePixels * tilePixels * 4 / 1024);
+	int col0 = qFloor(localRect.left() / double(TileSize));
+	int row0 = qFloor(localRect.top() / double(TileSize));
+	int col1 = qFloor(localRect.right() / double(TileSize));
+	int row1 = qFloor(localRect.bottom() / double(TileSize));
+	for (int row = row0; row <= row1; ++row)
+	{
+		for (int col = col0; col <= col1; ++col)
+		{
+			QRect rect(tileRect(col, row));
+			quint64 key = tileKey(col, row);
+			if (!m_bufferRect.contains(rect) || m_tiles.contains(key))
+				continue;
+			Tile* tile = new Tile;
+			tile->pixmap = m_buffer.copy(qRound((rect.x() - m_bufferRect.x()) * ratio), qRound((rect.y() - m_bufferRect.y()) * ratio), tilePixels, tilePixels);
+			tile->pixmap.setDevicePixelRatio(ratio);
+			tile->revision = tileRevision(col, row);
+			m_tiles.insert(key, tile, cost);
+		}
+	}
+}
+
 /**
   Actually we have at least three super-layers:
   - background (page outlines, guides if below)
@@ -822,6 +1215,18 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	t1 = t2=t3=t4=t5 =t6= 0;
 	t.start();
 #endif
+	// changed contents have to be rendered again, not copied from the tiles
+	if (m_renderMode == RENDER_NORMAL && (m_viewMode.forceRedraw || m_viewMode.operTextSelecting))
+	{
+		QRect viewport(-x(), -y(), m_view->viewport()->width(), m_view->viewport()->height());
+		if (p->rect().contains(viewport))
+			m_tiles.clear();
+		else
+		{
+			for (const QRect& rect : p->region().rects())
+				invalidateLocalTiles(rect);
+		}
+	}
 	// fill buffer if necessary
 	bool bufferFilled = adjustBuffer();
 	QPainter qp(this);
@@ -840,7 +1245,9 @@ void Canvas::paintEvent ( QPaintEvent * p )
 			if ((m_viewMode.forceRedraw || m_viewMode.operTextSelecting) && (!bufferFilled))
 			{
 //				qDebug() << "Canvas::paintEvent: forceRedraw=" << m_viewMode.forceRedraw << "bufferFilled=" << bufferFilled;
-				fillBuffer(&m_buffer, m_bufferRect.topLeft(), p->rect());
+				// only the changed rectangle is rendered, the tiles it covers are taken from the buffer
+				drawBuffer(&m_buffer, m_bufferRect.topLeft(), p->rect());
+				storeTiles(p->rect());
 			}
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 			t2 = t.elapsed();
@@ -964,12 +1371,23 @@ void Canvas::drawContents(QPainter *psx, int clipx, int clipy, int clipw, int cl
 //	QTime tim;
 //	tim.start();
 // 	qDebug() << "Canvas::drawContents" << clipx << clipy << clipw << cliph<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
+	QImage img = renderContents(QRect(clipx, clipy, clipw, cliph), devicePixelRatio(), palette().color(QPalette::Window), nullptr);
+	psx->drawImage(clipx, clipy, img);
+// 	qDebug( "Time elapsed: %d ms, setup=%d, outlines=%d, background=%d, contents=%d, rest=%d", tim.elapsed(), Tsetup,Toutlines -Tsetup, Tbackground-Toutlines, Tcontents-Tbackground, tim.elapsed() - Tcontents );
+}
+
+QImage Canvas::renderContents(QRect clipRect, qreal ratio, const QColor& background, const TilePass* pass)
+{
+	int clipx = clipRect.x();
+	int clipy = clipRect.y();
+	int clipw = clipRect.width();
+	int cliph = clipRect.height();
 	int docPagesCount=m_doc->Pages->count();
 	ScPainter *painter=nullptr;
-	QImage img = QImage(clipw * devicePixelRatio(), cliph * devicePixelRatio(), QImage::Format_ARGB32_Premultiplied);
-	img.setDevicePixelRatio(devicePixelRatio());
+	QImage img = QImage(clipw * ratio, cliph * ratio, QImage::Format_ARGB32_Premultiplied);
+	img.setDevicePixelRatio(ratio);
 	painter = new ScPainter(&img, img.width(), img.height(), 1.0, 0);
-	painter->clear(palette().color(QPalette::Window));
+	painter->clear(background);
 	painter->newPath();
 	painter->moveTo(0, 0);
 	painter->lineTo(clipw, 0);
@@ -990,7 +1408,8 @@ void Canvas::drawContents(QPainter *psx, int clipx, int clipy, int clipw, int cl
 	if (!m_doc->masterPageMode())
 	{
 		drawBackgroundPageOutlines(painter, clipx, clipy, clipw, cliph);
-		m_viewMode.linkedFramesToShow.clear();
+		if (!pass)
+			m_viewMode.linkedFramesToShow.clear();
 		QRectF clip = QRectF(clipx, clipy, clipw, cliph);
 		DrawPageBorder(painter, clip);
 		if (m_viewMode.viewAsPreview)
@@ -1033,12 +1452,12 @@ void Canvas::drawContents(QPainter *psx, int clipx, int clipy, int clipw, int cl
 					m_doc->Layers.levelToLayer(layer, layerLevel);
 					for (uint a = 0; a < docPagesCount; ++a)
 					{
-						DrawMasterItems(painter, m_doc->Pages->at(a), layer, QRect(clipx, clipy, clipw, cliph));
+						DrawMasterItems(painter, m_doc->Pages->at(a), layer, QRect(clipx, clipy, clipw, cliph), pass);
 					}
 					//first pass draws all except notes frames
-					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), false);
+					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), false, pass);
 					//seconf only for notes frames
-					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), true);
+					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), true, pass);
 				}
 			}
 		}
@@ -1048,7 +1467,8 @@ void Canvas::drawContents(QPainter *psx, int clipx, int clipy, int clipw, int cl
 	}
 	else // masterPageMode
 	{			
-		m_viewMode.linkedFramesToShow.clear();
+		if (!pass)
+			m_viewMode.linkedFramesToShow.clear();
 		drawBackgroundMasterpage(painter, clipx, clipy, clipw, cliph);
 		painter->beginLayer(1.0, 0);
 		QRectF clip = QRectF(clipx, clipy, clipw, cliph);
@@ -1080,24 +1500,37 @@ void Canvas::drawContents(QPainter *psx, int clipx, int clipy, int clipw, int cl
 				{
 					m_doc->Layers.levelToLayer(layer, layerLevel);
 					//first pass draws all except notes frames
-					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), false);
+					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), false, pass);
 					//second pass draw only notes frames
-					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), true);
+					DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), true, pass);
 				}
 			}
 		}
 		DrawPageIndicator(painter, clip, true);
 		painter->endLayer();
 	}
-	if (((m_doc->m_Selection->count() != 0) || (m_viewMode.linkedFramesToShow.count() != 0))  && (!m_viewMode.viewAsPreview))
+	// the frames of other tiles are not known here, renderTilesConcurrently() draws the links
+	if (!pass && ((m_doc->m_Selection->count() != 0) || (m_viewMode.linkedFramesToShow.count() != 0))  && (!m_viewMode.viewAsPreview))
 	{
 		drawFrameLinks(painter);
 	}
 	painter->end();
-	psx->drawImage(clipx, clipy, img);
 	delete painter;
 	painter=nullptr;
-// 	qDebug( "Time elapsed: %d ms, setup=%d, outlines=%d, background=%d, contents=%d, rest=%d", tim.elapsed(), Tsetup,Toutlines -Tsetup, Tbackground-Toutlines, Tcontents-Tbackground, tim.elapsed() - Tcontents );
+	return img;
+}
+
+void Canvas::drawFrameLinks(QImage* image, QRect clip)
+{
+	ScPainter* painter = new ScPainter(image, image->width(), image->height(), 1.0, 0);
+	painter->translate(-clip.x(), -clip.y());
+	painter->setZoomFactor(m_viewMode.scale);
+	painter->translate(-m_doc->minCanvasCoordinate.x(), -m_doc->minCanvasCoordinate.y());
+	painter->setLineWidth(1);
+	painter->setFillMode(ScPainter::Solid);
+	drawFrameLinks(painter);
+	painter->end();
+	delete painter;
 }
 
 void Canvas::drawControls(QPainter *psx)
@@ -1363,7 +1796,7 @@ void Canvas::drawControlsFreehandLine(QPainter* pp)
 /**
   draws masterpage items of a specific layer
  */
-void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, QRect clip)
+void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, QRect clip, const TilePass* pass)
 {
 	if ((m_viewMode.previewMode) && (!layer.isPrintable))
 		return;
@@ -1376,9 +1809,9 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 	if (page->FromMaster.count() <= 0)
 		return;
 
-	FPoint orig = localToCanvas(clip.topLeft());
-	QRectF cullingArea = QRectF(static_cast<int>(orig.x()), static_cast<int>(orig.y()), 
-							  qRound(clip.width() / m_viewMode.scale + 0.5), qRound(clip.height() / m_viewMode.scale + 0.5));
+	QRectF cullingArea(clipToCanvas(clip));
+	// master items are moved to page and laid out again for its page number
+	QMutexLocker locker(pass ? ScPageRenderer::changingItemsMutex() : nullptr);
 
 	PageItem *currItem;
 	ScPage* Mp = m_doc->MasterPages.at(m_doc->MasterNames[page->MPageNam]);
@@ -1441,7 +1874,7 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 /**
   draws page items contained in a specific Layer
  */
-void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool notesFramesPass)
+void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool notesFramesPass, const TilePass* pass)
 {
 	if ((m_viewMode.previewMode) && (!layer.isPrintable))
 		return;
@@ -1453,9 +1886,7 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 		return;
 
 // 	qDebug()<<"Canvas::DrawPageItems"<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
-	FPoint orig = localToCanvas(clip.topLeft());
-	QRectF cullingArea = QRectF(static_cast<int>(orig.x()), static_cast<int>(orig.y()), 
-							  qRound(clip.width() / m_viewMode.scale + 0.5), qRound(clip.height() / m_viewMode.scale + 0.5));
+	QRectF cullingArea(clipToCanvas(clip));
 
 	PageItem *currItem;
 	int layerCount = m_doc->layerCount();
@@ -1465,7 +1896,8 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 
 	//if notes are used
 	//then we must be sure that text frames are valid and all notes frames are created before we start drawing
-	if (!notesFramesPass && !m_doc->notesList().isEmpty())
+	//tiles rendered on worker threads have been laid out already
+	if (!notesFramesPass && !pass && !m_doc->notesList().isEmpty())
 	{
 		for (auto it = m_doc->Items->begin(); it != m_doc->Items->end(); ++it)
 		{
@@ -1483,9 +1915,11 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 				currItem->layout();
 		}
 	}
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	// the index only returns items near the culling area, which are tested exactly below
+	const QList<int> candidates(pass ? pass->candidates : m_doc->itemIndicesIn(cullingArea));
+	for (int it = 0; it < candidates.count(); ++it)
 	{
-		currItem = m_doc->Items->at(it);
+		currItem = m_doc->Items->at(candidates.at(it));
 		if (notesFramesPass && !currItem->isNoteFrame())
 			continue;
 		if (!notesFramesPass && currItem->isNoteFrame())
@@ -1515,7 +1949,8 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 			else if(m_viewMode.operItemSelecting)
 			{
 				currItem->invalid = false;
-				currItem->DrawObj(painter, cullingArea);
+				if (!ItemRenderCache::instance().draw(currItem, painter))
+					currItem->DrawObj(painter, cullingArea);
 				currItem->DrawObj_Decoration(painter);
 			}
 			else
@@ -1524,9 +1959,14 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 				// alter the "data". And it really prevents optimisation - pm
 // 				if (m_viewMode.forceRedraw)
 // 					currItem->invalidateLayout();
-				currItem->DrawObj(painter, cullingArea);
+				QMutexLocker locker((pass && ScPageRenderer::changesWhenDrawn(m_doc, currItem, false)) ? ScPageRenderer::changingItemsMutex() : nullptr);
+				if (!ItemRenderCache::instance().draw(currItem, painter))
+					currItem->DrawObj(painter, cullingArea);
 				currItem->DrawObj_Decoration(painter);
 			}
+			// tiles rendered on worker threads leave the canvas alone, see renderTilesConcurrently()
+			if (pass)
+				continue;
 			getLinkedFrames(currItem);
 /*			if ((currItem->asTextFrame()) && ((currItem->nextInChain() != 0) || (currItem->prevInChain() != 0)))
 			{
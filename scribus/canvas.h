@@ -25,7 +25,10 @@ scribusview.h  -  description
 #define CANVAS_H
 
 #include <QApplication>
+#include <QCache>
 //#include <QDebug>
+#include <QImage>
+#include <QPixmap>
 #include <QPolygon>
 #include <QRect>
 #include <QRectF>
@@ -142,6 +145,11 @@ public:
 	void setRenderMode(RenderMode m);
 	
 	void clearBuffers();              // very expensive
+	/**
+		Drops the cached tiles which intersect the given region in canvas coordinates,
+		all tiles if the region is not valid.
+	 */
+	void invalidateTiles(QRectF canvasRect = QRectF());
 	
 	// deprecated:
 	void resetRenderMode() { m_renderMode = RENDER_NORMAL; clearBuffers(); }
@@ -198,9 +206,18 @@ public:
 	int previewVisual() const { return m_viewMode.previewVisual; }
 	void setPreviewVisual(int mode);
 	
-	void DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, QRect clip);
+	/**
+		A tile rendered on a worker thread. Its text has been laid out and its items have been
+		looked up on the GUI thread, the item index is not thread-safe.
+	 */
+	struct TilePass
+	{
+		/// positions in the item list of the items near the tile
+		QList<int> candidates;
+	};
+	void DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, QRect clip, const TilePass* pass = nullptr);
 	//notesFramesPass determine if notes frames are drawed or not
-	void DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool notesFramesPass);
+	void DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool notesFramesPass, const TilePass* pass = nullptr);
 	virtual void paintEvent ( QPaintEvent * p );
 	void displayXYHUD(QPoint m);
 	void displayCorrectedXYHUD(QPoint m, double x, double y);
@@ -244,11 +261,74 @@ private:
 	 */
 	bool adjustBuffer();
 	/**
-		Fills the given buffer with contents.
+		Fills the given buffer with contents, taken from the tile cache where possible.
 	    bufferOrigin and clipRect are in local coordinates
 	 */
 	void fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect);
+	/**
+		The view settings the contents depend on. The tile cache is dropped when they change.
+	 */
+	struct TileState
+	{
+		TileState();
+		bool operator==(const TileState& other) const;
+		bool operator!=(const TileState& other) const { return !(*this == other); }
+
+		double scale;
+		bool previewMode;
+		bool viewAsPreview;
+		int previewVisual;
+		bool masterPageMode;
+		int appMode;
+		bool drawSelectedItemsWithControls;
+		bool drawFramelinksWithContents;
+		QList<PageItem*> selection;
+	};
+	/**
+		Checks the tile cache against the current view settings, drops tiles as needed.
+	 */
+	void validateTiles();
+	/**
+		Drops the cached tiles which intersect localRect.
+	 */
+	void invalidateLocalTiles(QRect localRect);
+	/**
+		Renders the tiles in the given range of tile columns and rows which are not cached.
+	 */
+	void renderTiles(QRect tileRange);
+	/**
+		Renders the given tiles on a thread pool, the GUI thread waits for them.
+	 */
+	void renderTilesConcurrently(const QList<QPoint>& tiles);
+	/**
+		True if the contents can be rendered on worker threads in the current view mode.
+	 */
+	bool canRenderTilesConcurrently() const;
+	/**
+		The newest revision of the layers, pages and items shown in a tile, see ScribusDoc::revision().
+		Cached tiles with an older revision are out of date.
+	 */
+	quint64 tileRevision(int col, int row);
+	static quint64 tileKey(int col, int row) { return (quint64(quint32(col)) << 32) | quint32(row); }
+	static QRect tileRect(int col, int row) { return QRect(col * TileSize, row * TileSize, TileSize, TileSize); }
+	/// the area of the canvas, in canvas coordinates, which is drawn into clip, in local coordinates
+	QRectF clipToCanvas(QRect clip) const;
+	/**
+		Fills the given buffer with freshly rendered contents, bypassing the tiles.
+	 */
+	void drawBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect);
+	/**
+		Copies the tiles which intersect localRect and lie within m_buffer into the cache.
+	 */
+	void storeTiles(QRect localRect);
 	void drawContents(QPainter *p, int clipx, int clipy, int clipw, int cliph);
+	/**
+		Renders the contents in clip, in local coordinates, into an image. If pass is given, this
+		may run on a worker thread: the canvas is not changed and the frame links are not drawn.
+	 */
+	QImage renderContents(QRect clip, qreal ratio, const QColor& background, const TilePass* pass);
+	/// draws the links of m_viewMode.linkedFramesToShow over an image from renderContents()
+	void drawFrameLinks(QImage* image, QRect clip);
 	void drawBackgroundMasterpage(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundPageOutlines(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
 	void drawFrameLinks(ScPainter* painter);
@@ -278,6 +358,19 @@ private:
 	QPixmap m_selectionBuffer;
 	QRect   m_selectionRect;
 	QPoint  m_oldMinCanvasCoordinate;
+	/**
+		Rendered contents in tiles of TileSize x TileSize local pixels, keyed by tile column
+		and row, with the revision they show. Scrolling over cached tiles only copies them to m_buffer.
+	 */
+	struct Tile
+	{
+		QPixmap pixmap;
+		quint64 revision;
+	};
+	QCache<quint64, Tile> m_tiles;
+	TileState m_tileState;
+	ScPage*   m_tilePage;
+	static const int TileSize = 256;
 };
 
 
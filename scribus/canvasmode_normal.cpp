@@ -1175,8 +1175,12 @@ void CanvasMode_Normal::mouseReleaseEvent(QMouseEvent *m)
 		if (docItemCount != 0)
 		{
 			m_doc->m_Selection->delaySignalsOn();
-			for (int a = 0; a < docItemCount; ++a)
+			// items inside the rubber band intersect it, allow for the rounding to pixels below
+			double margin = 2.0 / m_canvas->scale();
+			const QList<int> candidates(m_doc->itemIndicesIn(canvasSele.adjusted(-margin, -margin, margin, margin)));
+			for (int i = 0; i < candidates.count(); ++i)
 			{
+				int a = candidates.at(i);
 				PageItem* docItem = m_doc->Items->at(a);
 				if ((m_doc->masterPageMode()) && (docItem->OnMasterPage != m_doc->currentPage()->pageName()))
 					continue;
@@ -4,6 +4,8 @@ to the COPYING file provided with the program. Following this notice may exist
 a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
+#include <QMutexLocker>
+
 #include "sccolorprofilecache.h"
 
 void ScColorProfileCache::addProfile(const ScColorProfile& profile)
@@ -12,6 +14,7 @@ void ScColorProfileCache::addProfile(const ScColorProfile& profile)
 	if (path.isEmpty())
 		return;
 
+	QMutexLocker locker(&m_mutex);
 	auto iter = m_profileMap.find(path);
 	if (iter != m_profileMap.end())
 	{
@@ -24,16 +27,19 @@ void ScColorProfileCache::addProfile(const ScColorProfile& profile)
 
 void ScColorProfileCache::removeProfile(const QString& profilePath)
 {
+	QMutexLocker locker(&m_mutex);
 	m_profileMap.remove(profilePath);
 }
 
 void ScColorProfileCache::removeProfile(const ScColorProfile& profile)
 {
+	QMutexLocker locker(&m_mutex);
 	m_profileMap.remove(profile.profilePath());
 }
 	
 bool ScColorProfileCache::contains(const QString& profilePath)
 {
+	QMutexLocker locker(&m_mutex);
 	auto iter = m_profileMap.find(profilePath);
 	if (iter != m_profileMap.end())
 	{
@@ -45,6 +51,7 @@ bool ScColorProfileCache::contains(const QString& profilePath)
 
 ScColorProfile ScColorProfileCache::profile(const QString& profilePath)
 {
+	QMutexLocker locker(&m_mutex);
 	ScColorProfile profile;
 	auto iter = m_profileMap.find(profilePath);
 	if (iter != m_profileMap.end())
@@ -9,10 +9,13 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLORPROFILECACHE_H
 
 #include <QMap>
+#include <QMutex>
 #include <QString>
 #include <QWeakPointer>
 #include "sccolorprofile.h"
 
+// Profiles are looked up and added under a lock, images are converted on several threads
+// when they are prepared for an export.
 class ScColorProfileCache 
 {
 public:
@@ -25,6 +28,7 @@ public:
 
 protected:
 	QMap<QString, QWeakPointer<ScColorProfileData> > m_profileMap;
+	QMutex m_mutex;
 };
 
 #endif
@@ -9,10 +9,13 @@ for which a new license (GPL+exception) is in place.
 #define SCCOLORTRANSFORMPOOL_H
 
 #include <QList>
+#include <QMutex>
 #include <QWeakPointer>
 #include "sccolormgmtstructs.h"
 #include "sccolortransform.h"
 
+// Transforms are looked up and added under a lock, images are converted on several threads
+// when they are prepared for an export.
 class ScColorTransformPool
 {
 	friend class ScColorMgmtEngineData;
@@ -30,6 +33,9 @@ public:
 protected:
 	int m_engineID;
 	QList< QWeakPointer<ScColorTransformData> > m_pool;
+	mutable QMutex m_mutex;
+
+	ScColorTransform lookup(const ScColorTransformInfo& info) const;
 };
 
 #endif
@@ -201,15 +201,15 @@ ScFace::gid_type FtFace::char2CMap(uint ch) const
 
 void FtFace::loadGlyph(ScFace::gid_type gl) const
 {
-	if (m_glyphWidth.contains(gl))
+	if (isGlyphCached(gl))
 		return;
 
 	ScFace::GlyphData GRec;
+	qreal advance = 1;
 	FT_Face face = ftFace();
 	if (FT_Load_Glyph( face, gl, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP ))
 	{
 		sDebug(QObject::tr("Font %1 has broken glyph %2").arg(fontFile).arg(gl));
-		m_glyphWidth[gl] = 1;
 	}
 	else {
 		qreal ww = qreal(face->glyph->metrics.horiAdvance) / m_uniEM;
@@ -226,22 +226,17 @@ void FtFace::loadGlyph(ScFace::gid_type gl) const
 		qreal x, y;
 		bool error = false;
 		error = FT_Set_Char_Size( face, 0, 10, 72, 72 );
-		if (error)
-			m_glyphWidth[gl] = 1;
 		FPointArray outlines = traceGlyph(face, gl, 10, &x, &y, &error);
 		if (!error)
 		{
-			m_glyphWidth[gl] = ww;
+			advance = ww;
 			GRec.Outlines = outlines;
 			GRec.x = x;
 			GRec.y = y;
 			GRec.broken = false;
 		}
-		else {
-			m_glyphWidth[gl] = 1;
-		}
 	}
-	m_glyphOutline[gl] = GRec;
+	cacheGlyph(gl, advance, GRec);
 	if (GRec.broken && status < ScFace::BROKENGLYPHS)
 		status = ScFace::BROKENGLYPHS;
 }
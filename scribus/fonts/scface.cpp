@@ -13,8 +13,12 @@ for which a new license (GPL+exception) is in place.
 #include <ft2build.h>
 #include FT_TRUETYPE_TABLES_H
 
+#include <QMutex>
+#include <QMutexLocker>
+
 #include "scribusapi.h"
 #include "fonts/scface.h"
+#include "fonts/scglyphcache.h"
 #include "text/storytext.h"
 
 static const QString NONE_LITERAL("(None)");
@@ -43,6 +47,7 @@ ScFace::ScFaceData::ScFaceData() :
 
 ScFace::ScFaceData::~ScFaceData()
 {
+	clearGlyphCache();
 	if (m_hbFont)
 	{
 		hb_font_destroy(reinterpret_cast<hb_font_t*>(m_hbFont));
@@ -124,6 +129,42 @@ QMap<QString,QString> ScFace::ScFaceData::fontDictionary(qreal /*sz*/) const
 }
 
 
+ScFace::GlyphData ScFace::ScFaceData::glyphData(gid_type gl, qreal* advance, bool withOutline) const
+{
+	GlyphData data;
+	ScGlyphCache& cache(ScGlyphCache::instance());
+	if (cache.find(this, gl, advance, &data, withOutline))
+		return data;
+	// FreeType faces must not be used by several threads at once, pages may be rendered in parallel
+	static QMutex loadMutex;
+	QMutexLocker locker(&loadMutex);
+	// another thread may have loaded the glyph meanwhile
+	if (!cache.contains(this, gl))
+		loadGlyph(gl);
+	if (!cache.fetch(this, gl, advance, &data, withOutline) && advance)
+		*advance = 0;
+	return data;
+}
+
+
+bool ScFace::ScFaceData::isGlyphCached(gid_type gl) const
+{
+	return ScGlyphCache::instance().contains(this, gl);
+}
+
+
+void ScFace::ScFaceData::cacheGlyph(gid_type gl, qreal advance, const GlyphData& data) const
+{
+	ScGlyphCache::instance().insert(this, gl, advance, data);
+}
+
+
+void ScFace::ScFaceData::clearGlyphCache() const
+{
+	ScGlyphCache::instance().remove(this);
+}
+
+
 GlyphMetrics ScFace::ScFaceData::glyphBBox(gid_type gl, qreal sz) const
 {
 	GlyphMetrics res;
@@ -133,10 +174,7 @@ GlyphMetrics ScFace::ScFaceData::glyphBBox(gid_type gl, qreal sz) const
 		res.descent = 0;
 		return res;
 	}
-	else if (! m_glyphWidth.contains(gl)) {
-		loadGlyph(gl);
-	}
-	const struct GlyphData & data(m_glyphOutline[gl]);
+	const GlyphData data(glyphData(gl, nullptr, false));
 	res.width = data.bbox_width * sz;
 	res.ascent = data.bbox_ascent * sz;
 	res.descent = data.bbox_descent * sz;	
@@ -148,10 +186,9 @@ qreal ScFace::ScFaceData::glyphWidth(gid_type gl, qreal size) const
 {
 	if (gl >= CONTROL_GLYPHS)
 		return 0.0;
-	else if (! m_glyphWidth.contains(gl)) {
-		loadGlyph(gl);
-	}
-	return m_glyphWidth[gl] * size;
+	qreal advance;
+	glyphData(gl, &advance, false);
+	return advance * size;
 }
 
 
@@ -159,10 +196,7 @@ FPointArray ScFace::ScFaceData::glyphOutline(gid_type gl, qreal sz) const
 { 
 	if (gl >= CONTROL_GLYPHS)
 		return FPointArray();
-	else if (! m_glyphWidth.contains(gl)) {
-		loadGlyph(gl);
-	}
-	FPointArray res = m_glyphOutline[gl].Outlines.copy();
+	FPointArray res = glyphData(gl).Outlines;
 	if (sz != 1.0)
 		res.scale(sz, sz);
 	return res;
@@ -173,10 +207,7 @@ FPoint ScFace::ScFaceData::glyphOrigin(gid_type gl, qreal sz) const
 {
 	if (gl >= CONTROL_GLYPHS)
 		return FPoint(0,0);
-	else if (! m_glyphWidth.contains(gl)) {
-		loadGlyph(gl);
-	}
-	const struct GlyphData & res(m_glyphOutline[gl]);
+	const GlyphData res(glyphData(gl, nullptr, false));
 	return FPoint(res.x, res.y) * sz; 
 }
 
@@ -420,8 +451,7 @@ void ScFace::unload() const
 		m_m->unload();
 	}
 	// clear caches
-	m_m->m_glyphWidth.clear();
-	m_m->m_glyphOutline.clear();
+	m_m->clearGlyphCache();
 	//m->m_cMap.clear();
 	m_m->status = ScFace::UNKNOWN;
 }
@@ -498,8 +528,7 @@ bool ScFace::canRender(QChar ch) const
 		if (gl >= CONTROL_GLYPHS)   //  those are always empty
 			return true;
 		else if (gl != 0) {
-			m_m->loadGlyph(gl);
-			return ! m_m->m_glyphOutline[gl].broken; 
+			return ! m_m->glyphData(gl, nullptr, false).broken; 
 		}
 		else  {
 			return false;
@@ -542,10 +571,9 @@ void ScFace::checkAllGlyphs()
 		return;
 	}
 	for (gid_type gl=0; gl <= m_m->maxGlyph; ++gl) {
-		if (! m_m->m_glyphWidth.contains(gl)) {
+		if (! m_m->isGlyphCached(gl)) {
 			m_m->loadGlyph(gl);
-			m_m->m_glyphWidth.remove(gl);
-			m_m->m_glyphOutline.remove(gl);
+			ScGlyphCache::instance().remove(m_m, gl);
 		}
 	}
 }
@@ -149,9 +149,7 @@ public:
 		friend class ScFace;
 		Status m_cachedStatus;
 
-		// caches
-		mutable QHash<gid_type, qreal>     m_glyphWidth;
-		mutable QHash<gid_type, GlyphData> m_glyphOutline;
+		// caches, glyph widths and outlines are kept in ScGlyphCache
 		//mutable QHash<gid_type, uint>      m_cMap;
 		void* m_hbFont;
 
@@ -159,8 +157,7 @@ public:
 
 		virtual void load()             const 
 		{ 
-			m_glyphWidth.clear();
-			m_glyphOutline.clear();
+			clearGlyphCache();
 			//m_cMap.clear();
 
 			status = qMax(m_cachedStatus, ScFace::LOADED);
@@ -168,15 +165,24 @@ public:
 
 		virtual void unload()           const 
 		{
-			m_glyphWidth.clear();
-			m_glyphOutline.clear();
+			clearGlyphCache();
 			//m_cMap.clear();
 
 			status = ScFace::UNKNOWN;
 		}
 
+		/// loads glyph gl and stores it with cacheGlyph()
 		virtual void loadGlyph(gid_type /*gl*/) const {}
 
+		/// returns glyph gl from the glyph cache, loading it if needed. The outline is only filled in if withOutline is true
+		GlyphData glyphData(gid_type gl, qreal* advance = nullptr, bool withOutline = true) const;
+		/// whether glyph gl is in the glyph cache
+		bool isGlyphCached(gid_type gl) const;
+		/// stores a glyph loaded by loadGlyph() in the glyph cache
+		void cacheGlyph(gid_type gl, qreal advance, const GlyphData& data) const;
+		/// drops all glyphs of this face from the glyph cache
+		void clearGlyphCache() const;
+
 		// dummy implementations
 		virtual qreal ascent(qreal sz)           const { return sz; }
 		virtual QString pdfAscentAsString()      const { return "0" ; }
@@ -0,0 +1,261 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+
+#include "fonts/scglyphcache.h"
+
+// enough for the glyphs of several large CJK fonts
+static const qint64 DefaultMaxBytes = 64 * 1024 * 1024;
+
+ScGlyphCache& ScGlyphCache::instance()
+{
+	static ScGlyphCache cache;
+	return cache;
+}
+
+ScGlyphCache::ScGlyphCache() :
+	m_first(nullptr),
+	m_last(nullptr),
+	m_bytes(0),
+	m_maxBytes(DefaultMaxBytes),
+	m_hits(0),
+	m_misses(0),
+	m_evictions(0)
+{
+}
+
+ScGlyphCache::~ScGlyphCache()
+{
+	clear();
+}
+
+bool ScGlyphCache::find(const void* face, ScFace::gid_type gl, qreal* advance, ScFace::GlyphData* data, bool withOutline)
+{
+	QMutexLocker locker(&m_mutex);
+	bool found = lookup(Key(face, gl), advance, data, withOutline);
+	if (found)
+		++m_hits;
+	else
+		++m_misses;
+	return found;
+}
+
+bool ScGlyphCache::fetch(const void* face, ScFace::gid_type gl, qreal* advance, ScFace::GlyphData* data, bool withOutline)
+{
+	QMutexLocker locker(&m_mutex);
+	return lookup(Key(face, gl), advance, data, withOutline);
+}
+
+bool ScGlyphCache::contains(const void* face, ScFace::gid_type gl) const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_entries.contains(Key(face, gl));
+}
+
+bool ScGlyphCache::lookup(const Key& key, qreal* advance, ScFace::GlyphData* data, bool withOutline)
+{
+	Entry* entry = m_entries.value(key, nullptr);
+	if (!entry)
+		return false;
+
+	if (entry != m_first)
+	{
+		unlink(entry);
+		pushFront(entry);
+	}
+
+	if (advance)
+		*advance = entry->advance;
+	if (data)
+	{
+		data->x = entry->x;
+		data->y = entry->y;
+		data->bbox_width = entry->bboxWidth;
+		data->bbox_ascent = entry->bboxAscent;
+		data->bbox_descent = entry->bboxDescent;
+		data->broken = entry->broken;
+		data->Outlines.resize(0);
+		if (withOutline)
+		{
+			int points = entry->outline.count() / 2;
+			data->Outlines.resize(points);
+			const float* coords = entry->outline.constData();
+			for (int i = 0; i < points; ++i)
+				data->Outlines.setPoint(i, coords[2 * i], coords[2 * i + 1]);
+		}
+	}
+	return true;
+}
+
+void ScGlyphCache::insert(const void* face, ScFace::gid_type gl, qreal advance, const ScFace::GlyphData& data)
+{
+	QMutexLocker locker(&m_mutex);
+	Key key(face, gl);
+	Entry* old = m_entries.value(key, nullptr);
+	if (old)
+		erase(old);
+
+	Entry* entry = new Entry;
+	entry->key = key;
+	entry->advance = advance;
+	entry->x = data.x;
+	entry->y = data.y;
+	entry->bboxWidth = data.bbox_width;
+	entry->bboxAscent = data.bbox_ascent;
+	entry->bboxDescent = data.bbox_descent;
+	entry->broken = data.broken;
+	entry->outline.resize(2 * data.Outlines.size());
+	float* coords = entry->outline.data();
+	for (int i = 0; i < data.Outlines.size(); ++i)
+	{
+		const FPoint& p = data.Outlines.point(i);
+		coords[2 * i] = p.x();
+		coords[2 * i + 1] = p.y();
+	}
+	entry->prev = entry->next = nullptr;
+
+	m_entries.insert(key, entry);
+	m_faceCounts[face] += 1;
+	pushFront(entry);
+	m_bytes += entrySize(entry);
+	evict(entry);
+}
+
+void ScGlyphCache::remove(const void* face, ScFace::gid_type gl)
+{
+	QMutexLocker locker(&m_mutex);
+	Entry* entry = m_entries.value(Key(face, gl), nullptr);
+	if (entry)
+		erase(entry);
+}
+
+void ScGlyphCache::remove(const void* face)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_faceCounts.contains(face))
+		return;
+	Entry* entry = m_first;
+	while (entry)
+	{
+		Entry* next = entry->next;
+		if (entry->key.first == face)
+			erase(entry);
+		entry = next;
+	}
+}
+
+void ScGlyphCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	qDeleteAll(m_entries);
+	m_entries.clear();
+	m_faceCounts.clear();
+	m_first = m_last = nullptr;
+	m_bytes = 0;
+}
+
+qint64 ScGlyphCache::maxBytes() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_maxBytes;
+}
+
+void ScGlyphCache::setMaxBytes(qint64 bytes)
+{
+	QMutexLocker locker(&m_mutex);
+	m_maxBytes = qMax<qint64>(0, bytes);
+	evict(nullptr);
+}
+
+qint64 ScGlyphCache::bytes() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_bytes;
+}
+
+int ScGlyphCache::count() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_entries.count();
+}
+
+qint64 ScGlyphCache::hits() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_hits;
+}
+
+qint64 ScGlyphCache::misses() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_misses;
+}
+
+qint64 ScGlyphCache::evictions() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_evictions;
+}
+
+void ScGlyphCache::resetCounters()
+{
+	QMutexLocker locker(&m_mutex);
+	m_hits = m_misses = m_evictions = 0;
+}
+
+qint64 ScGlyphCache::entrySize(const Entry* entry)
+{
+	// the entry, its hash node and the outline data
+	return sizeof(Entry) + sizeof(Key) + 2 * sizeof(void*) + entry->outline.count() * sizeof(float);
+}
+
+void ScGlyphCache::unlink(Entry* entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		m_first = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		m_last = entry->prev;
+	entry->prev = entry->next = nullptr;
+}
+
+void ScGlyphCache::pushFront(Entry* entry)
+{
+	entry->prev = nullptr;
+	entry->next = m_first;
+	if (m_first)
+		m_first->prev = entry;
+	m_first = entry;
+	if (!m_last)
+		m_last = entry;
+}
+
+void ScGlyphCache::erase(Entry* entry)
+{
+	unlink(entry);
+	m_entries.remove(entry->key);
+	int& faceCount = m_faceCounts[entry->key.first];
+	if (--faceCount <= 0)
+		m_faceCounts.remove(entry->key.first);
+	m_bytes -= entrySize(entry);
+	delete entry;
+}
+
+void ScGlyphCache::evict(const Entry* keep)
+{
+	// the glyph just inserted is kept even if it alone exceeds the limit,
+	// the caller reads it back right away
+	while (m_bytes > m_maxBytes && m_last && m_last != keep)
+	{
+		erase(m_last);
+		++m_evictions;
+	}
+}
@@ -0,0 +1,105 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SC_GLYPHCACHE_H
+#define SC_GLYPHCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+
+#include "scribusapi.h"
+#include "fonts/scface.h"
+
+/**
+ ScGlyphCache holds the metrics and outlines of the glyphs loaded by all faces.
+ Entries are keyed by face and glyph index, outlines are stored as float pairs
+ at the size they were traced at. When the cache grows beyond maxBytes() the least
+ recently used glyphs are dropped and loaded again from the font on the next access.
+ All functions may be called from any thread.
+ */
+class SCRIBUS_API ScGlyphCache
+{
+public:
+	static ScGlyphCache& instance();
+
+	/**
+	 Looks up glyph gl of face. If found, the advance width and, if data is not nullptr,
+	 the glyph data are filled in. The outline is only converted if withOutline is true.
+	 Counts a hit or a miss.
+	 */
+	bool find(const void* face, ScFace::gid_type gl, qreal* advance, ScFace::GlyphData* data, bool withOutline = true);
+	/// same as find() without counting a hit or a miss
+	bool fetch(const void* face, ScFace::gid_type gl, qreal* advance, ScFace::GlyphData* data, bool withOutline = true);
+	bool contains(const void* face, ScFace::gid_type gl) const;
+	/// stores a glyph, replacing an older entry for face and gl
+	void insert(const void* face, ScFace::gid_type gl, qreal advance, const ScFace::GlyphData& data);
+
+	/// drops one glyph of face
+	void remove(const void* face, ScFace::gid_type gl);
+	/// drops all glyphs of face, called when a face is unloaded or destroyed
+	void remove(const void* face);
+	void clear();
+
+	/// memory limit in bytes
+	qint64 maxBytes() const;
+	void setMaxBytes(qint64 bytes);
+	/// estimated memory used by the cached glyphs in bytes
+	qint64 bytes() const;
+	int count() const;
+
+	qint64 hits() const;
+	qint64 misses() const;
+	qint64 evictions() const;
+	void resetCounters();
+
+private:
+	ScGlyphCache();
+	~ScGlyphCache();
+	ScGlyphCache(const ScGlyphCache&);
+	ScGlyphCache& operator=(const ScGlyphCache&);
+
+	typedef QPair<const void*, ScFace::gid_type> Key;
+
+	struct Entry
+	{
+		Key key;
+		float advance;
+		float x;
+		float y;
+		float bboxWidth;
+		float bboxAscent;
+		float bboxDescent;
+		bool broken;
+		QVector<float> outline;
+		Entry* prev;
+		Entry* next;
+	};
+
+	bool lookup(const Key& key, qreal* advance, ScFace::GlyphData* data, bool withOutline);
+	static qint64 entrySize(const Entry* entry);
+	void unlink(Entry* entry);
+	void pushFront(Entry* entry);
+	void erase(Entry* entry);
+	void evict(const Entry* keep);
+
+	mutable QMutex m_mutex;
+	QHash<Key, Entry*> m_entries;
+	// number of cached glyphs of each face, so remove(face) can skip faces without glyphs
+	QHash<const void*, int> m_faceCounts;
+	// most recently used first
+	Entry* m_first;
+	Entry* m_last;
+	qint64 m_bytes;
+	qint64 m_maxBytes;
+	qint64 m_hits;
+	qint64 m_misses;
+	qint64 m_evictions;
+};
+
+#endif
@@ -890,7 +890,7 @@ QColor gtAction::parseColorN(const QString &rgbColor)
 void gtAction::finalize()
 {
 	if (m_textFrame->doc()->docHyphenator->AutoCheck)
-		m_textFrame->doc()->docHyphenator->slotHyphenate(m_textFrame);
+		m_textFrame->doc()->docHyphenator->slotHyphenateLater(m_textFrame);
 	m_textFrame->doc()->regionsChanged()->update(QRectF());
 	m_textFrame->doc()->changed();
 }
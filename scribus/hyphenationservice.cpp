@@ -0,0 +1,412 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QSet>
+#include <QTextCodec>
+#include <QThread>
+
+#include "hyphenationservice.h"
+#include "langmgr.h"
+#include "scpaths.h"
+
+// words per language kept in memory and on disk
+static const int DefaultMaxWords = 100000;
+// words looked up by one task of the worker pool
+static const int WordsPerTask = 256;
+
+static const quint32 CacheMagic = 0x53484331;
+static const qint32 CacheVersion = 1;
+
+static QString cacheFileName()
+{
+	return ScPaths::applicationDataDir() + "hyphenation.cache";
+}
+
+/**
+ Looks up a list of words in the dictionary and stores the results in the cache.
+ The dictionary is only read by libhyphen, so all tasks of a language share it.
+ */
+class HyphenationTask : public QRunnable
+{
+public:
+	HyphenationTask(HyphenationService* service, const QString& language, const QStringList& words, int request, QSemaphore* done)
+		: m_service(service), m_language(language), m_words(words), m_request(request), m_done(done)
+	{ }
+
+	void run()
+	{
+		const HyphenationService::Dictionary* dict = m_service->findDictionary(m_language);
+		if (dict)
+		{
+			QByteArray hyphens;
+			for (const QString& word : m_words)
+			{
+				if (HyphenationService::hyphenateUncached(dict, word, hyphens))
+					m_service->insert(m_language, word, hyphens);
+			}
+		}
+		if (m_done)
+			m_done->release();
+		else
+			m_service->taskFinished(m_request);
+	}
+
+private:
+	HyphenationService* m_service;
+	QString m_language;
+	QStringList m_words;
+	int m_request;
+	QSemaphore* m_done;
+};
+
+HyphenationService* HyphenationService::m_instance = nullptr;
+
+HyphenationService* HyphenationService::instance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new HyphenationService();
+		m_instance->loadCache();
+	}
+	return m_instance;
+}
+
+void HyphenationService::deleteInstance()
+{
+	if (m_instance)
+	{
+		m_instance->saveCache();
+		delete m_instance;
+	}
+	m_instance = nullptr;
+}
+
+HyphenationService::HyphenationService() : QObject(),
+	m_maxWords(DefaultMaxWords),
+	m_cacheChanged(false),
+	m_lastRequest(0)
+{
+	m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+HyphenationService::~HyphenationService()
+{
+	m_pool.waitForDone();
+	qDeleteAll(m_caches);
+	for (Dictionary* dict : qAsConst(m_dicts))
+	{
+		if (dict && dict->dict)
+			hnj_hyphen_free(dict->dict);
+		delete dict;
+	}
+}
+
+bool HyphenationService::hasDictionary(const QString& language)
+{
+	return dictionary(language) != nullptr;
+}
+
+const HyphenationService::Dictionary* HyphenationService::dictionary(const QString& language)
+{
+	QMutexLocker locker(&m_dictMutex);
+	if (m_dicts.contains(language))
+		return m_dicts.value(language);
+
+	// failed loads are remembered as well, so the file is only tried once
+	Dictionary* dict = nullptr;
+	QString fileName(LanguageManager::instance()->getHyphFilename(language));
+	QFile file(fileName);
+	if (!fileName.isEmpty() && file.open(QIODevice::ReadOnly))
+	{
+		dict = new Dictionary();
+		dict->codec = QTextCodec::codecForName(file.readLine());
+		dict->dict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
+		dict->fileName = fileName;
+		dict->lastModified = QFileInfo(file).lastModified();
+		file.close();
+		if (dict->codec == nullptr || dict->dict == nullptr)
+		{
+			if (dict->dict)
+				hnj_hyphen_free(dict->dict);
+			delete dict;
+			dict = nullptr;
+		}
+	}
+	m_dicts.insert(language, dict);
+	locker.unlock();
+
+	if (dict)
+	{
+		// drop the words found with an older version of the dictionary
+		QMutexLocker cacheLocker(&m_cacheMutex);
+		WordCache* cache = wordCache(language);
+		if (cache->fileName != dict->fileName || cache->lastModified != dict->lastModified)
+		{
+			cache->words.clear();
+			cache->fileName = dict->fileName;
+			cache->lastModified = dict->lastModified;
+		}
+	}
+	return dict;
+}
+
+const HyphenationService::Dictionary* HyphenationService::findDictionary(const QString& language) const
+{
+	QMutexLocker locker(&m_dictMutex);
+	return m_dicts.value(language, nullptr);
+}
+
+bool HyphenationService::hyphenateUncached(const Dictionary* dict, const QString& word, QByteArray& hyphens)
+{
+	QByteArray te = dict->codec->fromUnicode(word);
+	char *buffer = static_cast<char*>(malloc(te.length() + 5));
+	if (buffer == nullptr)
+		return false;
+	char **rep = nullptr;
+	int *pos = nullptr;
+	int *cut = nullptr;
+	bool ok = false;
+	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
+	if (!hnj_hyphen_hyphenate2(dict->dict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
+	{
+		buffer[te.length()] = '\0';
+		hyphens.fill('\0', word.length());
+		int count = qMin(word.length(), te.length());
+		for (int i = 0; i < count; ++i)
+			hyphens[i] = buffer[i] & 1;
+		ok = true;
+	}
+	free(buffer);
+	if (rep)
+	{
+		for (int i = 0; i < te.length() - 1; ++i)
+			free(rep[i]);
+	}
+	free(rep);
+	free(pos);
+	free(cut);
+	return ok;
+}
+
+bool HyphenationService::lookup(const QString& language, const QString& word, QByteArray& hyphens)
+{
+	QMutexLocker locker(&m_cacheMutex);
+	WordCache* cache = m_caches.value(language, nullptr);
+	if (cache == nullptr)
+		return false;
+	const QByteArray* cached = cache->words.object(word);
+	if (cached == nullptr)
+		return false;
+	hyphens = *cached;
+	return true;
+}
+
+bool HyphenationService::hyphenate(const QString& language, const QString& word, QByteArray& hyphens)
+{
+	const Dictionary* dict = dictionary(language);
+	if (dict == nullptr)
+		return false;
+	if (lookup(language, word, hyphens))
+		return true;
+	if (!hyphenateUncached(dict, word, hyphens))
+		return false;
+	insert(language, word, hyphens);
+	return true;
+}
+
+void HyphenationService::hyphenate(const QString& language, const QStringList& words)
+{
+	QStringList missing(uncachedWords(language, words));
+	if (missing.isEmpty())
+		return;
+
+	QSemaphore done;
+	int tasks = 0;
+	for (int i = WordsPerTask; i < missing.count(); i += WordsPerTask)
+	{
+		m_pool.start(new HyphenationTask(this, language, missing.mid(i, WordsPerTask), 0, &done));
+		++tasks;
+	}
+	// the calling thread looks up the first words itself
+	HyphenationTask(this, language, missing.mid(0, WordsPerTask), 0, nullptr).run();
+	done.acquire(tasks);
+}
+
+int HyphenationService::request(const QString& language, const QStringList& words)
+{
+	QStringList missing(uncachedWords(language, words));
+	if (missing.isEmpty())
+		return 0;
+
+	QMutexLocker locker(&m_requestMutex);
+	if (++m_lastRequest <= 0)
+		m_lastRequest = 1;
+	int request = m_lastRequest;
+	m_pendingTasks.insert(request, (missing.count() + WordsPerTask - 1) / WordsPerTask);
+	locker.unlock();
+
+	for (int i = 0; i < missing.count(); i += WordsPerTask)
+		m_pool.start(new HyphenationTask(this, language, missing.mid(i, WordsPerTask), request, nullptr));
+	return request;
+}
+
+void HyphenationService::taskFinished(int request)
+{
+	QMutexLocker locker(&m_requestMutex);
+	int& tasks = m_pendingTasks[request];
+	if (--tasks > 0)
+		return;
+	m_pendingTasks.remove(request);
+	locker.unlock();
+	// queued to the thread of the service, as this is called from a worker
+	emit wordsHyphenated(request);
+}
+
+QStringList HyphenationService::uncachedWords(const QString& language, const QStringList& words)
+{
+	QStringList missing;
+	if (dictionary(language) == nullptr)
+		return missing;
+
+	QSet<QString> seen;
+	QMutexLocker locker(&m_cacheMutex);
+	WordCache* cache = wordCache(language);
+	for (const QString& word : words)
+	{
+		if (cache->words.contains(word) || seen.contains(word))
+			continue;
+		seen.insert(word);
+		missing.append(word);
+	}
+	return missing;
+}
+
+void HyphenationService::insert(const QString& language, const QString& word, const QByteArray& hyphens)
+{
+	QMutexLocker locker(&m_cacheMutex);
+	wordCache(language)->words.insert(word, new QByteArray(hyphens));
+	m_cacheChanged = true;
+}
+
+HyphenationService::WordCache* HyphenationService::wordCache(const QString& language)
+{
+	WordCache* cache = m_caches.value(language, nullptr);
+	if (cache == nullptr)
+	{
+		cache = new WordCache(m_maxWords);
+		m_caches.insert(language, cache);
+	}
+	return cache;
+}
+
+int HyphenationService::maxWords() const
+{
+	QMutexLocker locker(&m_cacheMutex);
+	return m_maxWords;
+}
+
+void HyphenationService::setMaxWords(int words)
+{
+	QMutexLocker locker(&m_cacheMutex);
+	m_maxWords = qMax(0, words);
+	for (WordCache* cache : qAsConst(m_caches))
+		cache->words.setMaxCost(m_maxWords);
+}
+
+void HyphenationService::loadCache()
+{
+	QFile file(cacheFileName());
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic;
+	qint32 version;
+	in >> magic >> version;
+	if (magic != CacheMagic || version != CacheVersion)
+		return;
+
+	QMutexLocker locker(&m_cacheMutex);
+	qint32 languages;
+	in >> languages;
+	for (int l = 0; l < languages && in.status() == QDataStream::Ok; ++l)
+	{
+		QString language;
+		QString fileName;
+		QDateTime lastModified;
+		qint32 count;
+		in >> language >> fileName >> lastModified >> count;
+		// words of a dictionary which has been updated since are read but not kept
+		bool valid = (LanguageManager::instance()->getHyphFilename(language) == fileName)
+				&& (QFileInfo(fileName).lastModified() == lastModified);
+		WordCache* cache = nullptr;
+		if (valid)
+		{
+			cache = wordCache(language);
+			cache->fileName = fileName;
+			cache->lastModified = lastModified;
+		}
+		for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+		{
+			QString word;
+			QByteArray hyphens;
+			in >> word >> hyphens;
+			if (cache && hyphens.length() == word.length())
+				cache->words.insert(word, new QByteArray(hyphens));
+		}
+	}
+	m_cacheChanged = false;
+}
+
+void HyphenationService::saveCache()
+{
+	m_pool.waitForDone();
+
+	QMutexLocker locker(&m_cacheMutex);
+	if (!m_cacheChanged)
+		return;
+
+	QSaveFile file(cacheFileName());
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << CacheMagic << CacheVersion;
+
+	QList<QString> languages;
+	for (auto it = m_caches.constBegin(); it != m_caches.constEnd(); ++it)
+	{
+		if (!it.value()->fileName.isEmpty() && !it.value()->words.isEmpty())
+			languages.append(it.key());
+	}
+	out << qint32(languages.count());
+	for (const QString& language : languages)
+	{
+		const WordCache* cache = m_caches.value(language);
+		const QList<QString> words(cache->words.keys());
+		out << language << cache->fileName << cache->lastModified << qint32(words.count());
+		for (const QString& word : words)
+			out << word << *cache->words.object(word);
+	}
+	if (file.commit())
+		m_cacheChanged = false;
+}
+
+void HyphenationService::clearCache()
+{
+	QMutexLocker locker(&m_cacheMutex);
+	for (WordCache* cache : qAsConst(m_caches))
+		cache->words.clear();
+	m_cacheChanged = true;
+}
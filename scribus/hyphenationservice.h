@@ -0,0 +1,128 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef HYPHENATIONSERVICE_H
+#define HYPHENATIONSERVICE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+#include "third_party/hyphen/hyphen.h"
+
+class QTextCodec;
+
+/**
+ HyphenationService looks up words in the hyphenation dictionaries for all documents.
+ Results are kept in a cache per language, which is bounded to maxWords() words and
+ stored in the application data directory between sessions. Dictionary lookups for
+ lists of words are spread over a pool of worker threads.
+
+ Hyphenation points are returned as one byte per character of the word, bit 0 is set
+ where a hyphen may be inserted after the character, as expected by StoryText::hyphenateWord().
+ */
+class SCRIBUS_API HyphenationService : public QObject
+{
+	Q_OBJECT
+
+public:
+	static HyphenationService* instance();
+	/**
+	 * @brief Saves the cache and deletes the instance.
+	 * Must be called when HyphenationService is no longer needed.
+	 */
+	static void deleteInstance();
+
+	/// true if there is a dictionary for language, loads it if needed
+	bool hasDictionary(const QString& language);
+
+	/// looks up word in the cache only
+	bool lookup(const QString& language, const QString& word, QByteArray& hyphens);
+	/// looks up word in the cache and, if not found, in the dictionary on the calling thread
+	bool hyphenate(const QString& language, const QString& word, QByteArray& hyphens);
+	/// looks up the words which are not cached yet in the worker pool and waits until all are done
+	void hyphenate(const QString& language, const QStringList& words);
+	/**
+	 Looks up the words which are not cached yet in the worker pool and returns immediately.
+	 Returns a request number which is passed to wordsHyphenated() once all words are in
+	 the cache, or 0 if they already are.
+	 */
+	int request(const QString& language, const QStringList& words);
+
+	int maxWords() const;
+	void setMaxWords(int words);
+
+	/// reads the cache saved by a previous session, entries of changed dictionaries are dropped
+	void loadCache();
+	void saveCache();
+	void clearCache();
+
+signals:
+	/// emitted on the thread of the service when the words of a request can be looked up
+	void wordsHyphenated(int request);
+
+private:
+	HyphenationService();
+	~HyphenationService();
+
+	struct Dictionary
+	{
+		Dictionary() : dict(nullptr), codec(nullptr) {}
+		HyphenDict* dict;
+		QTextCodec* codec;
+		QString fileName;
+		QDateTime lastModified;
+	};
+
+	/// the cached words of one language and the dictionary they were looked up in
+	struct WordCache
+	{
+		explicit WordCache(int maxWords) : words(maxWords) {}
+		QCache<QString, QByteArray> words;
+		QString fileName;
+		QDateTime lastModified;
+	};
+
+	friend class HyphenationTask;
+
+	/// the loaded dictionary, has to be called on the thread of the service
+	const Dictionary* dictionary(const QString& language);
+	/// the loaded dictionary or nullptr, may be called from any thread
+	const Dictionary* findDictionary(const QString& language) const;
+	/// looks up word in the dictionary without using the cache
+	static bool hyphenateUncached(const Dictionary* dict, const QString& word, QByteArray& hyphens);
+	QStringList uncachedWords(const QString& language, const QStringList& words);
+	void insert(const QString& language, const QString& word, const QByteArray& hyphens);
+	/// the cache of language, has to be called with m_cacheMutex locked
+	WordCache* wordCache(const QString& language);
+	void taskFinished(int request);
+
+	static HyphenationService* m_instance;
+
+	mutable QMutex m_dictMutex;
+	QHash<QString, Dictionary*> m_dicts;
+
+	mutable QMutex m_cacheMutex;
+	QHash<QString, WordCache*> m_caches;
+	int m_maxWords;
+	bool m_cacheChanged;
+
+	QMutex m_requestMutex;
+	QHash<int, int> m_pendingTasks;
+	int m_lastRequest;
+
+	QThreadPool m_pool;
+};
+
+#endif
@@ -29,7 +29,9 @@ for which a new license (GPL+exception) is in place.
 #include <QCursor>
 #include <QCheckBox>
 #include <QByteArray>
+#include <QTimer>
 
+#include "hyphenationservice.h"
 #include "langmgr.h"
 #include "scpaths.h"
 #include "scribuscore.h"
@@ -39,8 +41,6 @@ for which a new license (GPL+exception) is in place.
 
 Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 	m_doc(dok),
-	m_hdict(nullptr),
-	m_codec(nullptr),
 	m_automatic(m_doc->hyphAutomatic()),
 	AutoCheck(m_doc->hyphAutoCheck())
 {
@@ -48,43 +48,69 @@ Hyphenator::Hyphenator(QWidget* parent, ScribusDoc *dok) : QObject( parent ),
 /* Add reading these special lists from prefs or doc here */
 	ignoredWords.clear();
 	specialWords.clear();
+	connect(HyphenationService::instance(), SIGNAL(wordsHyphenated(int)), this, SLOT(slotWordsHyphenated(int)));
 }
 
 Hyphenator::~Hyphenator()
 {
-	if (m_hdict)
-		hnj_hyphen_free(m_hdict);
 }
 
-bool Hyphenator::loadDict(const QString& name)
+QList<Hyphenator::Word> Hyphenator::collectWords(PageItem* it, int& startC) const
 {
-	if (LanguageManager::instance()->getHyphFilename(name).isEmpty())
-		return false;
-		
-	if (m_language != name)
+	QList<Word> words;
+	QString text = "";
+
+	startC = 0;
+	if (it->itemText.lengthOfSelection() > 0)
 	{
-		m_language = name;
+		startC = it->itemText.startOfSelection();
+		text = it->itemText.text(startC, it->itemText.lengthOfSelection());
+	}
+	else {
+		text = it->itemText.text(0, it->itemText.length());
+	}
 
-		QFile file(LanguageManager::instance()->getHyphFilename(m_language));
-		
-		if (m_hdict != nullptr)
-			hnj_hyphen_free(m_hdict);
+	BreakIterator* bi = StoryText::getWordIterator();
+	bi->setText((const UChar*) text.utf16());
+	int pos = bi->first();
+	while (pos != BreakIterator::DONE)
+	{
+		int firstC = pos;
+		pos = bi->next();
+		int lastC = pos;
+		int countC = lastC - firstC;
 
-		if (file.open(QIODevice::ReadOnly))
+		const CharStyle& style = it->itemText.charStyle(firstC);
+		if (countC > 0 && countC > style.hyphenWordMin() - 1)
 		{
-			m_codec = QTextCodec::codecForName(file.readLine());
-			m_hdict = hnj_hyphen_load(file.fileName().toLocal8Bit().data());
-			file.close();
-			return true;
+			Word word;
+			word.firstC = firstC;
+			word.word = text.mid(firstC, countC);
+			word.language = style.language();
+			word.wordLower = QLocale(word.language).toLower(word.word);
+			if (word.wordLower.contains(SpecialChars::SHYPHEN))
+				break;
+			words.append(word);
 		}
+	}
+	return words;
+}
+
+void Hyphenator::setHyphens(const QString& outs, QByteArray& hyphens)
+{
+	// the word may have been edited by the user, so never write past its end
+	int ii = 1;
+	for (int i = 1; i < outs.length()-1 && ii < hyphens.length(); ++i)
+	{
+		QChar cht = outs[i];
+		if (cht == '-')
+			hyphens[ii-1] = 1;
 		else
 		{
-			m_hdict = nullptr;
-			return false;
+			hyphens[ii] = 0;
+			++ii;
 		}
 	}
-
-	return (m_codec != 0 && m_hdict != 0);
 }
 
 void Hyphenator::slotNewSettings(bool Autom, bool ACheck)
@@ -103,32 +129,9 @@ void Hyphenator::slotHyphenateWord(PageItem* it, const QString& text, int firstC
 	if (text.length() < style.hyphenWordMin())
 		return;
 
-	bool ok = loadDict(style.language());
-	if (!ok)
-		return;
-
-	QByteArray te = m_codec->fromUnicode(text);
-	char *buffer = static_cast<char*>(malloc(te.length() + 5));
-	if (buffer == nullptr)
-		return;
-	char **rep = nullptr;
-	int *pos = nullptr;
-	int *cut = nullptr;
-	// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-	if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
-	{
-		buffer[te.length()] = '\0';
-		it->itemText.hyphenateWord(firstC, text.length(), buffer);
-	}
-	free(buffer);
-	if (rep)
-	{
-		for (int i = 0; i < te.length() - 1; ++i)
-			free(rep[i]);
-	}
-	free(rep);
-	free(pos);
-	free(cut);
+	QByteArray hyphens;
+	if (HyphenationService::instance()->hyphenate(style.language(), text, hyphens))
+		it->itemText.hyphenateWord(firstC, text.length(), hyphens.data());
 }
 
 void Hyphenator::slotHyphenate(PageItem* it)
@@ -137,200 +140,112 @@ void Hyphenator::slotHyphenate(PageItem* it)
 		return;
 	m_doc->DoDrawing = false;
 
-	QString text = "";
+	rememberedWords.clear();
+	qApp->setOverrideCursor(QCursor(Qt::WaitCursor));
 
 	int startC = 0;
-	if (it->itemText.lengthOfSelection() > 0)
-	{
-		startC = it->itemText.startOfSelection();
-		text = it->itemText.text(startC, it->itemText.lengthOfSelection());
-	}
-	else {
-		text = it->itemText.text(0, it->itemText.length());
-	}
+	const QList<Word> words = collectWords(it, startC);
 
-	rememberedWords.clear();
-	qApp->setOverrideCursor(QCursor(Qt::WaitCursor));
+	// look up all words of a language at once, this is spread over several threads
+	HyphenationService* service = HyphenationService::instance();
+	QHash<QString, QStringList> wordsByLanguage;
+	for (const Word& word : words)
+		wordsByLanguage[word.language].append(word.wordLower);
+	for (auto lang = wordsByLanguage.constBegin(); lang != wordsByLanguage.constEnd(); ++lang)
+		service->hyphenate(lang.key(), lang.value());
 
-	BreakIterator* bi = StoryText::getWordIterator();
-	bi->setText((const UChar*) text.utf16());
-	int pos = bi->first();
-	while (pos != BreakIterator::DONE)
+	for (const Word& w : words)
 	{
-		int firstC = pos;
-		pos = bi->next();
-		int lastC = pos;
-		int countC = lastC - firstC;
-
-		const CharStyle& style = it->itemText.charStyle(firstC);
-		if (countC > 0 && countC > style.hyphenWordMin() - 1)
-		{
-			QString word = text.mid(firstC, countC);
-			QString wordLower = QLocale(style.language()).toLower(word);
-			if (wordLower.contains(SpecialChars::SHYPHEN))
-				break;
+		const int firstC = w.firstC;
+		const QString& word = w.word;
+		const QString& wordLower = w.wordLower;
 
-			bool ok = loadDict(style.language());
-			if (!ok)
-				continue;
+		// long stories may have more words than the cache keeps
+		QByteArray hyphens;
+		if (!service->hyphenate(w.language, wordLower, hyphens))
+			continue;
+		const char *buffer = hyphens.data();
 
-			QByteArray te = m_codec->fromUnicode(wordLower);
-			char *buffer = static_cast<char*>(malloc(te.length() + 5));
-			if (buffer == nullptr)
+		int i = 0;
+		bool hasHyphen = false;
+		for (i = 1; i < wordLower.length()-1; ++i)
+		{
+			if(buffer[i] & 1)
+			{
+				hasHyphen = true;
 				break;
-
-			char **rep = nullptr;
-			int *pos = nullptr;
-			int *cut = nullptr;
-			// TODO: support non-standard hyphenation, see hnj_hyphen_hyphenate2 docs
-			if (!hnj_hyphen_hyphenate2(m_hdict, te.data(), te.length(), buffer, nullptr, &rep, &pos, &cut))
+			}
+		}
+		QString outs = "";
+		QString input = "";
+		outs += word[0];
+		for (i = 1; i < wordLower.length()-1; ++i)
+		{
+			outs += word[i];
+			if(buffer[i] & 1)
+				outs += "-";
+		}
+		outs += word.rightRef(1);
+		input = outs;
+		if (ignoredWords.contains(word))
+			continue;
+		if (!hasHyphen)
+			it->itemText.hyphenateWord(startC + firstC, wordLower.length(), nullptr);
+		else if (m_automatic)
+		{
+			if (specialWords.contains(word))
+				setHyphens(specialWords.value(word), hyphens);
+			it->itemText.hyphenateWord(startC + firstC, wordLower.length(), hyphens.data());
+		}
+		else
+		{
+			if (specialWords.contains(word))
+				setHyphens(specialWords.value(word), hyphens);
+			if (rememberedWords.contains(input))
 			{
-	  			int i = 0;
-				buffer[te.length()] = '\0';
-				bool hasHyphen = false;
-				for (i = 1; i < wordLower.length()-1; ++i)
-				{
-					if(buffer[i] & 1)
-					{
-						hasHyphen = true;
-						break;
-					}
-				}
-				QString outs = "";
-				QString input = "";
-				outs += word[0];
-				for (i = 1; i < wordLower.length()-1; ++i)
-				{
-					outs += word[i];
-					if(buffer[i] & 1)
-						outs += "-";
-				}
-				outs += word.rightRef(1);
-				input = outs;
-				if (!ignoredWords.contains(word))
+				setHyphens(rememberedWords.value(input), hyphens);
+				it->itemText.hyphenateWord(firstC, wordLower.length(), hyphens.data());
+			}
+			else
+			{
+				qApp->changeOverrideCursor(QCursor(Qt::ArrowCursor));
+				PrefsContext* prefs = PrefsManager::instance()->prefsFile->getContext("hyhpen_options");
+				int xpos = prefs->getInt("Xposition", -9999);
+				int ypos = prefs->getInt("Yposition", -9999);
+				HyAsk *dia = new HyAsk((QWidget*)parent(), outs);
+				if ((xpos != -9999) && (ypos != -9999))
+					dia->move(xpos, ypos);
+				qApp->processEvents();
+				if (dia->exec())
 				{
-					if (!hasHyphen)
-						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), nullptr);
-					else if (m_automatic)
+					outs = dia->Wort->text();
+					setHyphens(outs, hyphens);
+					if (!rememberedWords.contains(input))
+						rememberedWords.insert(input, outs);
+					if (dia->addToIgnoreList->isChecked())
 					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length()-1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii-1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
-						it->itemText.hyphenateWord(startC + firstC, wordLower.length(), buffer);
+						if (!ignoredWords.contains(word))
+							ignoredWords.insert(word);
 					}
-					else
+					if (dia->addToExceptionList->isChecked())
 					{
-						if (specialWords.contains(word))
-						{
-							outs = specialWords.value(word);
-							uint ii = 1;
-							for (i = 1; i < outs.length()-1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii-1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-						}
-						if (rememberedWords.contains(input))
-						{
-							outs = rememberedWords.value(input);
-							uint ii = 1;
-							for (i = 1; i < outs.length()-1; ++i)
-							{
-								QChar cht = outs[i];
-								if (cht == '-')
-									buffer[ii-1] = 1;
-								else
-								{
-									buffer[ii] = 0;
-									++ii;
-								}
-							}
-							it->itemText.hyphenateWord(firstC, wordLower.length(), buffer);
-						}
-						else
-						{
-							qApp->changeOverrideCursor(QCursor(Qt::ArrowCursor));
-							PrefsContext* prefs = PrefsManager::instance()->prefsFile->getContext("hyhpen_options");
-							int xpos = prefs->getInt("Xposition", -9999);
-							int ypos = prefs->getInt("Yposition", -9999);
-							HyAsk *dia = new HyAsk((QWidget*)parent(), outs);
-							if ((xpos != -9999) && (ypos != -9999))
-								dia->move(xpos, ypos);
-							qApp->processEvents();
-							if (dia->exec())
-							{
-								outs = dia->Wort->text();
-								uint ii = 1;
-								for (i = 1; i < outs.length()-1; ++i)
-								{
-									QChar cht = outs[i];
-									if (cht == '-')
-										buffer[ii-1] = 1;
-									else
-									{
-										buffer[ii] = 0;
-										++ii;
-									}
-								}
-								if (!rememberedWords.contains(input))
-									rememberedWords.insert(input, outs);
-								if (dia->addToIgnoreList->isChecked())
-								{
-									if (!ignoredWords.contains(word))
-										ignoredWords.insert(word);
-								}
-								if (dia->addToExceptionList->isChecked())
-								{
-									if (!specialWords.contains(word))
-										specialWords.insert(word, outs);
-								}
-								it->itemText.hyphenateWord(firstC, wordLower.length(), buffer);
-							}
-							else
-							{
-								free(buffer);
-								buffer = nullptr;
-								prefs->set("Xposition", dia->xpos);
-								prefs->set("Yposition", dia->ypos);
-								delete dia;
-								break;
-							}
-							prefs->set("Xposition", dia->xpos);
-							prefs->set("Yposition", dia->ypos);
-							delete dia;
-							qApp->changeOverrideCursor(QCursor(Qt::WaitCursor));
-						}
+						if (!specialWords.contains(word))
+							specialWords.insert(word, outs);
 					}
+					it->itemText.hyphenateWord(firstC, wordLower.length(), hyphens.data());
 				}
+				else
+				{
+					prefs->set("Xposition", dia->xpos);
+					prefs->set("Yposition", dia->ypos);
+					delete dia;
+					break;
+				}
+				prefs->set("Xposition", dia->xpos);
+				prefs->set("Yposition", dia->ypos);
+				delete dia;
+				qApp->changeOverrideCursor(QCursor(Qt::WaitCursor));
 			}
-			free(buffer);
-			if (rep)
-			{
-				for (int i = 0; i < te.length() - 1; ++i)
-					free(rep[i]);
-			}
-			free(rep);
-			free(pos);
-			free(cut);
 		}
 	}
 	qApp->restoreOverrideCursor();
@@ -338,6 +253,139 @@ void Hyphenator::slotHyphenate(PageItem* it)
 	rememberedWords.clear();
 }
 
+void Hyphenator::slotHyphenateLater(PageItem* it)
+{
+	if (!m_automatic)
+	{
+		slotHyphenate(it);
+		return;
+	}
+	if (!(it->asTextFrame()) || (it->itemText.length() == 0))
+		return;
+
+	PendingFrame frame;
+	frame.item = it;
+	frame.words = collectWords(it, frame.startC);
+	frame.next = 0;
+
+	// a newer request for the same frame replaces the older one
+	for (int i = m_pendingFrames.count() - 1; i >= 0; --i)
+	{
+		if (m_pendingFrames[i].item == it)
+			m_pendingFrames.removeAt(i);
+	}
+	for (int i = m_readyFrames.count() - 1; i >= 0; --i)
+	{
+		if (m_readyFrames[i].item == it)
+			m_readyFrames.removeAt(i);
+	}
+
+	HyphenationService* service = HyphenationService::instance();
+	QHash<QString, QStringList> wordsByLanguage;
+	for (const Word& word : frame.words)
+		wordsByLanguage[word.language].append(word.wordLower);
+	for (auto lang = wordsByLanguage.constBegin(); lang != wordsByLanguage.constEnd(); ++lang)
+	{
+		int request = service->request(lang.key(), lang.value());
+		if (request != 0)
+			frame.requests.insert(request);
+	}
+
+	if (!frame.requests.isEmpty())
+	{
+		m_pendingFrames.append(frame);
+		return;
+	}
+	// all words are cached
+	for (const Word& word : qAsConst(frame.words))
+		applyWord(it, frame.startC + word.firstC, word);
+}
+
+void Hyphenator::slotWordsHyphenated(int request)
+{
+	for (int i = 0; i < m_pendingFrames.count(); )
+	{
+		PendingFrame& frame = m_pendingFrames[i];
+		frame.requests.remove(request);
+		if (!frame.requests.isEmpty())
+		{
+			++i;
+			continue;
+		}
+		m_readyFrames.append(frame);
+		m_pendingFrames.removeAt(i);
+		if (m_readyFrames.count() == 1)
+			QTimer::singleShot(0, this, SLOT(slotApplyBatch()));
+	}
+}
+
+void Hyphenator::slotApplyBatch()
+{
+	// keeps the GUI responsive while long stories are hyphenated
+	const int batchWords = 500;
+	if (m_readyFrames.isEmpty())
+		return;
+
+	PendingFrame& frame = m_readyFrames.first();
+	PageItem* it = frame.item.data();
+	bool done = (it == nullptr);
+	if (it)
+	{
+		int end = qMin(frame.next + batchWords, frame.words.count());
+		for (; frame.next < end; ++frame.next)
+		{
+			const Word& word = frame.words.at(frame.next);
+			if (!applyWord(it, frame.startC + word.firstC, word))
+				break;
+		}
+		done = (frame.next < end) || (frame.next >= frame.words.count());
+	}
+	if (done)
+	{
+		m_readyFrames.removeFirst();
+		if (it)
+			m_doc->regionsChanged()->update(QRectF());
+	}
+	if (!m_readyFrames.isEmpty())
+		QTimer::singleShot(0, this, SLOT(slotApplyBatch()));
+}
+
+bool Hyphenator::applyWord(PageItem* it, int pos, const Word& word)
+{
+	// the text may have been edited while the words were looked up
+	if (pos + word.word.length() > it->itemText.length())
+		return false;
+	if (it->itemText.text(pos, word.word.length()) != word.word)
+		return false;
+	if (ignoredWords.contains(word.word))
+		return true;
+
+	// the word may have been evicted from the cache since it was looked up
+	QByteArray hyphens;
+	if (!HyphenationService::instance()->hyphenate(word.language, word.wordLower, hyphens))
+		return true;
+	const char *buffer = hyphens.data();
+
+	bool hasHyphen = false;
+	for (int i = 1; i < word.wordLower.length()-1; ++i)
+	{
+		if (buffer[i] & 1)
+		{
+			hasHyphen = true;
+			break;
+		}
+	}
+	if (!hasHyphen)
+	{
+		it->itemText.hyphenateWord(pos, word.wordLower.length(), nullptr);
+		return true;
+	}
+	if (specialWords.contains(word.word))
+		setHyphens(specialWords.value(word.word), hyphens);
+	it->itemText.hyphenateWord(pos, word.wordLower.length(), hyphens.data());
+	return true;
+}
+
 void Hyphenator::slotDeHyphenate(PageItem* it)
 {
 	if (!(it->asTextFrame()) || (it ->itemText.length() == 0))
@@ -10,10 +10,11 @@ for which a new license (GPL+exception) is in place.
 #include <QObject>
 #include <QTextCodec>
 #include <QHash>
+#include <QList>
+#include <QPointer>
 #include <QSet>
 
 #include "scribusapi.h"
-#include "third_party/hyphen/hyphen.h"
 
 class ScribusDoc;
 class ScribusMainWindow;
@@ -46,26 +47,58 @@ public:
 	
 private:
 
+	/*! A word of a text frame to be hyphenated. */
+	struct Word
+	{
+		int firstC;
+		QString word;
+		QString wordLower;
+		QString language;
+	};
+
+	/*! Words of a text frame waiting for \see HyphenationService to look them up. */
+	struct PendingFrame
+	{
+		QPointer<PageItem> item;
+		int startC;
+		QList<Word> words;
+		QSet<int> requests;
+		int next;
+	};
+
 	/*! Embedded reference to the \see ScribusDoc filled by \a dok */
 	ScribusDoc *m_doc;
-	/*! Reference to the hyphen dictionary structure. */
-	HyphenDict *m_hdict;
-	/*! Qt text codec which handles local characters. */
-	QTextCodec *m_codec;
-	/*! Language in use */
-	QString m_language;
 
 	/*! Flag - if user set auto hyphen processing.*/
 	bool m_automatic;
 
+	/*! Frames waiting for dictionary lookups. */
+	QList<PendingFrame> m_pendingFrames;
+	/*! Frames whose words are all looked up, applied a batch at a time. */
+	QList<PendingFrame> m_readyFrames;
+
 	/*!
-		\brief Loads dictionary and fills parameters like \a m_codec, \a m_hdict.
-	 \date
-	 \author Franz Schmid
-	 \param name is the name of specified language.
-	 */
-	bool loadDict(const QString& name);
-	
+	\brief Splits the text of the frame, or its selection, into the words to hyphenate.
+	\param it references \see PageItem - text frame.
+	\param startC is set to the position of the text in the frame.
+	*/
+	QList<Word> collectWords(PageItem* it, int& startC) const;
+	/*!
+	\brief Sets the hyphens of a word as given in the form "hy-phen-ation".
+	\param outs is the hyphenated word.
+	\param hyphens holds one byte per character of the word.
+	*/
+	static void setHyphens(const QString& outs, QByteArray& hyphens);
+	/*!
+	\brief Applies the looked up hyphens of a word without asking the user.
+	\return false if the frame text has changed since the word was collected.
+	*/
+	bool applyWord(PageItem* it, int pos, const Word& word);
+
+private slots:
+	void slotWordsHyphenated(int request);
+	void slotApplyBatch();
+
 public:
 	/*! Flag - obsolete? */
 	bool AutoCheck;
@@ -101,6 +134,14 @@ public slots:
 	*/
 	void slotHyphenate(PageItem *it);
 	/*!
+	\brief Like \see slotHyphenate, but looks up the words in the background.
+	Words found in the cache of \see HyphenationService are hyphenated right away, the
+	others when their lookup has finished, a batch at a time on the GUI thread. Frames
+	which are hyphenated interactively are hyphenated immediately.
+	\param it references \see PageItem - text frame.
+	*/
+	void slotHyphenateLater(PageItem *it);
+	/*!
 	\fn void Hyphenator::slotDeHyphenate(PageItem* it)
 	\brief Removes hyphenation either for the whole text frame or the selected text if there is a selection.
 	\date
@@ -0,0 +1,220 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <climits>
+
+#include <cairo.h>
+
+#include <QMutexLocker>
+#include <QtMath>
+
+#include "appmodes.h"
+#include "itemrendercache.h"
+#include "pageitem.h"
+#include "scpainter.h"
+#include "scribusdoc.h"
+
+// the bitmaps of a few hundred shadowed frames at page size
+static const qint64 DefaultMaxBytes = 128 * 1024 * 1024;
+// larger bitmaps are not worth keeping, the item is drawn directly then
+static const qint64 MaxPixels = 2048 * 2048;
+
+ItemRenderCache& ItemRenderCache::instance()
+{
+	static ItemRenderCache cache;
+	return cache;
+}
+
+ItemRenderCache::ItemRenderCache() :
+	m_enabled(true),
+	m_entries(DefaultMaxBytes / 1024)
+{
+}
+
+bool ItemRenderCache::isCacheable(PageItem* item)
+{
+	ScribusDoc* doc = item->doc();
+	if (!doc->DoDrawing || doc->RePos || doc->layerOutline(item->LayerID))
+		return false;
+	// items being edited change all the time, selections do not change the other items
+	if (item->isSelected() || item->isEmbedded || item->isGroupChild())
+		return false;
+	// groups and symbols draw items which are not tracked here, text changes with the layout of its chain
+	if (item->isGroup() || item->isSymbol() || item->isTable() || item->isTextFrame() || item->isPathText()
+		|| item->isLatexFrame() || item->isOSGFrame())
+		return false;
+	// blending with what is below must happen on the canvas
+	if ((item->fillBlendmode() != 0) || (item->lineBlendmode() != 0))
+		return false;
+	if (item->hasSoftShadow() && (item->softShadowBlendMode() != 0))
+		return false;
+
+	bool expensive = item->hasSoftShadow() || (item->GrMask != 0) || (item->GrType >= 8) || item->patternStrokePath;
+	if (item->isImageFrame() && item->imageIsAvailable)
+		expensive = true;
+	return expensive;
+}
+
+bool ItemRenderCache::draw(PageItem* item, ScPainter* p)
+{
+	if (!m_enabled || !isCacheable(item))
+		return false;
+
+	// the world matrix of p maps to logical pixels, the target may have more
+	double devicePixelRatio = 1.0;
+	double scaleY = 1.0;
+	cairo_surface_get_device_scale(cairo_get_target(p->context()), &devicePixelRatio, &scaleY);
+
+	QTransform canvasToDevice(p->worldMatrix());
+	QRect pixels(canvasToDevice.mapRect(renderBounds(item)).toAlignedRect().adjusted(-1, -1, 1, 1));
+	qint64 imagePixels = qint64(qCeil(pixels.width() * devicePixelRatio)) * qint64(qCeil(pixels.height() * devicePixelRatio));
+	if (pixels.isEmpty() || (imagePixels > MaxPixels))
+		return false;
+	// the bitmap can be reused while the item is only moved by whole pixels on the device
+	QTransform matrix(canvasToDevice * QTransform::fromTranslate(-pixels.left(), -pixels.top()));
+	DrawState state(drawState(item->doc()));
+
+	QImage image;
+	QMutexLocker locker(&m_mutex);
+	Entry* entry = m_entries.object(item);
+	if (entry && (entry->doc == item->doc()) && (entry->revision == item->revision()) && (entry->state == state) && sameMatrix(entry->matrix, matrix))
+		image = entry->image;
+	locker.unlock();
+	if (image.isNull())
+	{
+		// drawing an item may invalidate others, so the cache is not locked meanwhile
+		entry = new Entry;
+		entry->image = QImage(qCeil(pixels.width() * devicePixelRatio), qCeil(pixels.height() * devicePixelRatio), QImage::Format_ARGB32_Premultiplied);
+		entry->image.setDevicePixelRatio(devicePixelRatio);
+		entry->image.fill(Qt::transparent);
+		entry->matrix = matrix;
+		entry->bounds = renderBounds(item);
+		entry->doc = item->doc();
+		entry->state = state;
+		entry->revision = item->revision();
+		ScPainter* painter = new ScPainter(&entry->image, entry->image.width(), entry->image.height(), 1.0, 0);
+		painter->setZoomFactor(p->zoomFactor());
+		painter->setWorldMatrix(matrix);
+		painter->setLineWidth(1);
+		painter->setFillMode(ScPainter::Solid);
+		item->DrawObj(painter, QRectF());
+		painter->end();
+		delete painter;
+		image = entry->image;
+		locker.relock();
+		// an entry exceeding the budget is deleted right away, it is still drawn once
+		m_entries.insert(item, entry, qMax(1, image.byteCount() / 1024));
+		locker.unlock();
+	}
+
+	double brushOpacity = p->brushOpacity();
+	int blendMode = p->blendModeFill();
+	int maskMode = p->maskMode();
+	p->save();
+	p->setWorldMatrix(QTransform::fromTranslate(pixels.left(), pixels.top()));
+	p->scale(1.0 / devicePixelRatio, 1.0 / devicePixelRatio);
+	p->setBrushOpacity(1.0);
+	p->setBlendModeFill(0);
+	p->setMaskMode(0);
+	p->drawImage(&image);
+	p->restore();
+	p->setMaskMode(maskMode);
+	p->setBlendModeFill(blendMode);
+	p->setBrushOpacity(brushOpacity);
+	return true;
+}
+
+void ItemRenderCache::invalidate(const PageItem* item)
+{
+	QMutexLocker locker(&m_mutex);
+	m_entries.remove(item);
+}
+
+void ItemRenderCache::invalidate(const ScribusDoc* doc, const QRectF& area)
+{
+	QMutexLocker locker(&m_mutex);
+	const QList<const PageItem*> items(m_entries.keys());
+	for (const PageItem* item : items)
+	{
+		const Entry* entry = m_entries.object(item);
+		if ((entry->doc == doc) && (!area.isValid() || entry->bounds.intersects(area)))
+			m_entries.remove(item);
+	}
+}
+
+void ItemRenderCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_entries.clear();
+}
+
+void ItemRenderCache::setEnabled(bool enabled)
+{
+	QMutexLocker locker(&m_mutex);
+	m_enabled = enabled;
+	if (!m_enabled)
+		m_entries.clear();
+}
+
+qint64 ItemRenderCache::maxBytes() const
+{
+	QMutexLocker locker(&m_mutex);
+	return qint64(m_entries.maxCost()) * 1024;
+}
+
+void ItemRenderCache::setMaxBytes(qint64 bytes)
+{
+	QMutexLocker locker(&m_mutex);
+	m_entries.setMaxCost(static_cast<int>(qBound<qint64>(0, bytes / 1024, INT_MAX)));
+}
+
+int ItemRenderCache::count() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_entries.count();
+}
+
+bool ItemRenderCache::DrawState::operator==(const DrawState& other) const
+{
+	return (editMode == other.editMode)
+		&& (framesShown == other.framesShown)
+		&& (drawAsPreview == other.drawAsPreview)
+		&& (viewAsPreview == other.viewAsPreview)
+		&& (previewVisual == other.previewVisual);
+}
+
+ItemRenderCache::DrawState ItemRenderCache::drawState(ScribusDoc* doc)
+{
+	DrawState state;
+	// soft shadows are not drawn in edit mode
+	state.editMode = (doc->appMode == modeEdit);
+	state.framesShown = doc->guidesPrefs().framesShown;
+	state.drawAsPreview = doc->drawAsPreview;
+	state.viewAsPreview = doc->viewAsPreview;
+	state.previewVisual = doc->previewVisual;
+	return state;
+}
+
+QRectF ItemRenderCache::renderBounds(PageItem* item)
+{
+	QRectF bounds(item->getVisualBoundingRect());
+	if (item->hasSoftShadow())
+	{
+		// the offset is applied in item coordinates, the blur spreads beyond it
+		double spread = qAbs(item->softShadowXOffset()) + qAbs(item->softShadowYOffset()) + 2.0 * item->softShadowBlurRadius();
+		bounds.adjust(-spread, -spread, spread, spread);
+	}
+	return bounds;
+}
+
+bool ItemRenderCache::sameMatrix(const QTransform& m1, const QTransform& m2)
+{
+	const double eps = 1e-6;
+	return (qAbs(m1.m11() - m2.m11()) < eps) && (qAbs(m1.m12() - m2.m12()) < eps)
+		&& (qAbs(m1.m21() - m2.m21()) < eps) && (qAbs(m1.m22() - m2.m22()) < eps)
+		&& (qAbs(m1.dx() - m2.dx()) < 1e-3) && (qAbs(m1.dy() - m2.dy()) < 1e-3);
+}
@@ -0,0 +1,106 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef ITEMRENDERCACHE_H
+#define ITEMRENDERCACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QRectF>
+#include <QTransform>
+
+#include "scribusapi.h"
+
+class PageItem;
+class ScPainter;
+class ScribusDoc;
+
+/**
+ ItemRenderCache keeps bitmaps of page items which are expensive to draw, like items with
+ soft shadows, mesh, diamond or four colour gradients, hatches, patterns, masks or images.
+ A bitmap is rendered at the zoom and pixel position it is drawn at and reused as long as
+ the item is drawn the same way, the canvas blits it instead of calling PageItem::DrawObj().
+ The bitmaps of all documents share a memory budget of maxBytes(), the least recently
+ used ones are dropped first.
+
+ Only items whose result does not depend on what is below them can be cached, so items
+ with blend modes other than normal are always drawn directly. Bitmaps are dropped when
+ the item changes, i.e. when its layout is invalidated or a region of the document it
+ intersects is reported as changed, and are not reused once the revision of the item,
+ see PageItem::revision(), is newer than theirs.
+ draw() is called from the GUI thread and from the threads rendering canvas tiles while the
+ GUI thread waits for them, bitmaps may be dropped from any thread.
+ */
+class SCRIBUS_API ItemRenderCache
+{
+public:
+	static ItemRenderCache& instance();
+
+	/// true if item is worth caching and looks the same when drawn from a bitmap
+	static bool isCacheable(PageItem* item);
+	/**
+	 Draws item with p like PageItem::DrawObj() does, from a cached bitmap. The bitmap is
+	 rendered first if there is none for the current transformation of p.
+	 Returns false if item is not drawn through the cache, the caller draws it directly then.
+	 */
+	bool draw(PageItem* item, ScPainter* p);
+
+	/// drops the bitmap of item
+	void invalidate(const PageItem* item);
+	/// drops the bitmaps of the items of doc intersecting area, all of doc if area is not valid
+	void invalidate(const ScribusDoc* doc, const QRectF& area = QRectF());
+	void clear();
+
+	bool isEnabled() const { return m_enabled; }
+	void setEnabled(bool enabled);
+	/// memory limit in bytes
+	qint64 maxBytes() const;
+	void setMaxBytes(qint64 bytes);
+	int count() const;
+
+private:
+	ItemRenderCache();
+	~ItemRenderCache() {}
+	ItemRenderCache(const ItemRenderCache&);
+	ItemRenderCache& operator=(const ItemRenderCache&);
+
+	/// the document settings an item is drawn with, apart from the item itself
+	struct DrawState
+	{
+		bool operator==(const DrawState& other) const;
+		bool editMode;
+		bool framesShown;
+		bool drawAsPreview;
+		bool viewAsPreview;
+		int previewVisual;
+	};
+
+	struct Entry
+	{
+		QImage image;
+		// maps canvas coordinates to the pixels of image
+		QTransform matrix;
+		// area of the canvas covered by image
+		QRectF bounds;
+		const ScribusDoc* doc;
+		DrawState state;
+		quint64 revision;
+	};
+
+	static DrawState drawState(ScribusDoc* doc);
+	/// the area item draws to, including its soft shadow
+	static QRectF renderBounds(PageItem* item);
+	static bool sameMatrix(const QTransform& m1, const QTransform& m2);
+
+	mutable QMutex m_mutex;
+	bool m_enabled;
+	// costs are in KB
+	QCache<const PageItem*, Entry> m_entries;
+};
+
+#endif
@@ -28,10 +28,15 @@ for which a new license (GPL+exception) is in place.
 #include <QLabel>
 #include <QPaintEvent>
 #include <QPainter>
+#include "pagethumbnailcache.h"
+#include "scribusdoc.h"
 #include "scribusview.h"
 #include "util_ghostscript.h"
 
-Navigator::Navigator(QWidget *parent, int Size, int Seite, ScribusView* vie, QString fn) : QLabel(parent)
+Navigator::Navigator(QWidget *parent, int Size, int Seite, ScribusView* vie, QString fn) : QLabel(parent),
+	view(vie),
+	m_page(nullptr),
+	m_size(0)
 {
 	setScaledContents(false);
 	setAlignment(Qt::AlignLeft | Qt::AlignTop);
@@ -44,12 +49,11 @@ Navigator::Navigator(QWidget *parent, int Size, int Seite, ScribusView* vie, QSt
 			pmx = LoadPDF(fn, 1, Size, &Width, &Height);
 	}
 	else
-		pmx=QPixmap::fromImage(vie->PageToPixmap(Seite, Size));
+		showThumbnail(Seite, Size);
 	resize(pmx.width(), pmx.height());
 	Xp = 0;
 	Yp = 0;
 	drawMark(0, 0);
-	view = vie;
 }
 
 void Navigator::mouseMoveEvent(QMouseEvent *m)
@@ -100,6 +104,7 @@ bool Navigator::SetSeite(int Seite, int Size, QString fn)
 	bool ret = false;
 	if (!fn.isEmpty())
 	{
+		m_page = nullptr;
 		QPixmap img = LoadPDF(fn, Seite, Size, &Width, &Height);
 		if (!img.isNull())
 		{
@@ -111,10 +116,32 @@ bool Navigator::SetSeite(int Seite, int Size, QString fn)
 	}
 	else
 	{
-		pmx=QPixmap::fromImage(view->PageToPixmap(Seite, Size));
+		showThumbnail(Seite, Size);
 		ret = true;
 	}
 	resize(pmx.width(), pmx.height());
 	repaint();
 	return ret;
 }
+
+void Navigator::showThumbnail(int Seite, int Size)
+{
+	PageThumbnailCache* cache = view->Doc->thumbnailCache();
+	connect(cache, SIGNAL(thumbnailReady(ScPage*,int)), this, SLOT(updateThumbnail(ScPage*,int)), Qt::UniqueConnection);
+	m_page = view->Doc->DocPages.at(Seite);
+	m_size = Size;
+	// a blank page of the same size is shown until the page is rendered
+	QImage thumbnail(cache->thumbnail(m_page, m_size));
+	if (thumbnail.isNull())
+		thumbnail = PageThumbnailCache::placeholder(m_page, m_size);
+	pmx = QPixmap::fromImage(thumbnail);
+}
+
+void Navigator::updateThumbnail(ScPage* page, int size)
+{
+	if ((page != m_page) || (size != m_size))
+		return;
+	pmx = QPixmap::fromImage(view->Doc->thumbnailCache()->cachedThumbnail(m_page, m_size));
+	resize(pmx.width(), pmx.height());
+	repaint();
+}
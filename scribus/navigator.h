@@ -31,6 +31,7 @@ class QMouseEvent;
 class QPixmap;
 
 #include "scribusapi.h"
+class ScPage;
 class ScribusView;
 
 /**
@@ -59,6 +60,15 @@ public:
 	
 signals:
 	void Coords(double x, double y);
+
+private slots:
+	void updateThumbnail(ScPage* page, int size);
+
+private:
+	void showThumbnail(int Seite, int Size);
+
+	ScPage* m_page;
+	int m_size;
 };
 
 #endif
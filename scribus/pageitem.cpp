@@ -46,6 +46,7 @@ for which a new license (GPL+exception) is in place.
 #include "colorblind.h"
 #include "desaxe/saxXML.h"
 #include "iconmanager.h"
+#include "itemrendercache.h"
 #include "marks.h"
 #include "pageitem_arc.h"
 #include "pageitem_group.h"
@@ -358,7 +359,8 @@ PageItem::PageItem(const PageItem & other)
 	firstLineOffsetP(other.firstLineOffsetP),
 	m_groupClips(other.m_groupClips),
 	hatchBackgroundQ(other.hatchBackgroundQ),
-	hatchForegroundQ(other.hatchForegroundQ)
+	hatchForegroundQ(other.hatchForegroundQ),
+	m_revision(other.m_Doc->nextRevision())
 {
 	QString tmp;
 	m_imageVisible = m_Doc->guidesPrefs().showPic;
@@ -397,6 +399,7 @@ PageItem::PageItem(const PageItem & other)
 	}
 	Parent = nullptr;
 	unWeld();
+	m_Doc->itemGeometryChanged(this);
 }
 
 
@@ -423,7 +426,8 @@ PageItem::PageItem(ScribusDoc *pa, ItemType newType, double x, double y, double
 	m_SizeLocked(false),
 	m_SizeHLocked(false),
 	m_SizeVLocked(false),
-	textFlowModeVal(TextFlowDisabled)
+	textFlowModeVal(TextFlowDisabled),
+	m_revision(pa->nextRevision())
 {
 	Parent = nullptr;
 	m_Doc = pa;
@@ -900,10 +904,14 @@ PageItem::PageItem(ScribusDoc *pa, ItemType newType, double x, double y, double
 	tagged=false;
 	no_fill=false;
 	no_stroke=false;
+	// a new item may reuse the address of a deleted one the index still knows
+	m_Doc->itemGeometryChanged(this);
 }
 
 PageItem::~PageItem()
 {
+	ItemRenderCache::instance().invalidate(this);
+	m_Doc->itemDeleted(this);
 	if ((isTempFile) && (!Pfile.isEmpty()))
 		QFile::remove(Pfile);
 	//remove marks
@@ -929,6 +937,17 @@ PageItem::~PageItem()
 //			unWeldChild();
 }
 
+void PageItem::invalidateLayout()
+{
+	invalid = true;
+	ItemRenderCache::instance().invalidate(this);
+}
+
+void PageItem::bumpRevision()
+{
+	m_Doc->bumpRevision(this);
+}
+
 bool PageItem::isGroupChild() const
 {
 	return (dynamic_cast<PageItem_Group*>(Parent) != nullptr);
@@ -942,6 +961,7 @@ bool PageItem::isTableCell() const
 void PageItem::setXPos(const double newXPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -950,6 +970,7 @@ void PageItem::setXPos(const double newXPos, bool drawingOnly)
 void PageItem::setYPos(const double newYPos, bool drawingOnly)
 {
 	m_yPos = newYPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -959,6 +980,7 @@ void PageItem::setXYPos(const double newXPos, const double newYPos, bool drawing
 {
 	m_xPos = newXPos;
 	m_yPos = newYPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -997,6 +1019,7 @@ void PageItem::moveBy(const double dX, const double dY, bool drawingOnly)
 		gYpos += dY;
 		BoundingY += dY;
 	}
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	moveWelded(dX, dY);
@@ -1007,6 +1030,7 @@ void PageItem::setWidth(const double newWidth)
 {
 	m_width = newWidth;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1016,6 +1040,7 @@ void PageItem::setHeight(const double newHeight)
 {
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1026,6 +1051,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight, boo
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly)
 		return;
 	checkChanges();
@@ -1036,6 +1062,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight)
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1050,6 +1077,7 @@ void PageItem::resizeBy(const double dH, const double dW)
 	if (dW!=0.0)
 		m_height+=dW;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1064,6 +1092,7 @@ void PageItem::setRotation(const double newRotation, bool drawingOnly)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	rotateWelded(dR, oldRot);
@@ -1079,6 +1108,7 @@ void PageItem::rotateBy(const double dR)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2603,6 +2633,7 @@ void PageItem::setItemName(const QString& newName)
 	QString oldName = AnName;
 	AnName = generateUniqueCopyName(newName);
 	AutoName=false;
+	m_Doc->itemRenamed(this);
 	if (UndoManager::undoEnabled())
 	{
 		SimpleState *ss = new SimpleState(Um::Rename, QString(Um::FromTo).arg(oldName, newName));
@@ -4092,6 +4123,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	Oldm_lineWidth=m_lineWidth;
 	m_lineWidth = newWidth;
+	m_Doc->itemGeometryChanged(this);
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -9889,6 +9921,7 @@ void PageItem::setRedrawBounding()
 	BoundingH = bh - BoundingY;
 	if (asLine())
 		BoundingH = qMax(BoundingH, 1.0);
+	m_Doc->itemGeometryChanged(this);
 }
 
 void PageItem::updateGradientVectors()
@@ -10475,6 +10508,7 @@ void PageItem::updateClip(bool updateWelded)
 		break;
 	}
 	updateGradientVectors();
+	m_Doc->itemGeometryChanged(this);
 }
 
 QString PageItem::infoDescription()
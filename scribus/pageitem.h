@@ -30,9 +30,12 @@ for which a new license (GPL+exception) is in place.
 #include <QStack>
 #include <QList>
 #include <QKeyEvent>
+#include <QMap>
 #include <QMenu>
+#include <QPair>
 #include <QRect>
 #include <QRectF>
+#include <QRegion>
 #include <QVector>
 #include <QTemporaryFile>
 
@@ -41,6 +44,7 @@ for which a new license (GPL+exception) is in place.
 #include "commonstrings.h"
 #include "colormgmt/sccolormgmtstructs.h"
 #include "desaxe/saxio.h"
+#include "fpointarray.h"
 #include "observable.h"
 #include "pagestructs.h"
 #include "scimage.h"
@@ -82,6 +86,25 @@ class PageItem_Symbol;
 class PageItem_Table;
 class PageItem_TextFrame;
 
+/**
+ * Shape of an item as seen by text frames flowing around it, together with the
+ * values it was computed from, see PageItem_TextFrame::calcAvailableRegion().
+ */
+struct SCRIBUS_API TextFlowShape
+{
+	TextFlowShape() : valid(false) {}
+
+	bool valid;
+	QVector<double> params;
+	QString lineStyle;
+	QPolygon clip;
+	FPointArray poLine;
+	FPointArray contourLine;
+	FPointArray imageClip;
+	/// the shape by offset, master page items are seen by the frames of each page using their master page
+	QMap<QPair<double, double>, QRegion> regions;
+};
+
 /**
   *@author Franz Schmid
   */
@@ -392,7 +415,12 @@ public: // Start public functions
 
 
 	/// invalidates current layout information
-	virtual void invalidateLayout() { invalid = true; }
+	virtual void invalidateLayout();
+	/// revision of the document this item has last been changed in, see ScribusDoc::revision()
+	quint64 revision() const { return m_revision; }
+	void setRevision(quint64 revision) { m_revision = revision; }
+	/// makes the item, its groups and the pages showing it newer
+	void bumpRevision();
 	/// creates valid layout information
 	virtual void layout() {}
 	/// returns frame where is text end
@@ -1331,6 +1359,7 @@ public:	// Start public variables
 	double CurY; ///< Zeichen Y-Position
 	StoryText itemText; ///< Text of element
 	TextLayout textLayout;
+	TextFlowShape textFlowShape; ///< Cached shape used by text frames flowing around this item
 	bool isBookmark; ///< Flag for PDF Bookmark
 	bool Dirty; ///< Flag for redraw in EditMode
 	bool invalid; ///< Flag indicates that layout has changed (eg. for textlayout)
@@ -1872,6 +1901,7 @@ private:	// Start private functions
 			// End private functions
 
 private:	// Start private variables
+	quint64 m_revision;
 			// End private variables
 
 
@@ -141,6 +141,7 @@ void PageItem_NoteFrame::setNS(NotesStyle *nStyle, PageItem_TextFrame* master)
 
 	AnName = generateUniqueCopyName(m_nstyle->isEndNotes() ? "Endnote frame " + m_nstyle->name() : "Footnote frame " + m_nstyle->name(), false);
 	setUName(AnName);
+	m_Doc->itemRenamed(this);
 	
 	//set default style for note frame
 	ParagraphStyle newStyle;
@@ -225,7 +225,7 @@ void PageItem_PathText::DrawObj_Item(ScPainter *p, QRectF cullingArea)
 	QList<QPainterPath> pathList = decomposePath(guidePath);
 	QPainterPath currPath = pathList[0];
 	int currPathIndex = 0;
-	PathLineBox* linebox = new PathLineBox();
+	PathLineBox* linebox = textLayout.createBox<PathLineBox>();
 	for (int i = firstRun; i < glyphRuns.length(); i++)
 	{
 		const GlyphCluster &run = glyphRuns.at(i);
@@ -282,13 +282,13 @@ void PageItem_PathText::DrawObj_Item(ScPainter *p, QRectF cullingArea)
 		Box* box;
 		if (run.object().getPageItem(m_Doc))
 		{
-			box = new ObjectBox(run, this);
+			box = textLayout.createBox<ObjectBox>(run, this);
 			box->setAscent(this->getVisualBoundingBox(run.object()).height());
 			box->setDescent(0);
 		}
 		else
 		{
-			box = new GlyphBox(run);
+			box = textLayout.createBox<GlyphBox>(run);
 			box->setAscent(linebox->ascent());
 			box->setDescent(linebox->descent());
 		}
@@ -44,6 +44,7 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem.h"
 #include "pageitem_group.h"
 #include "pageitem_noteframe.h"
+#include "pageitemindex.h"
 #include "prefsmanager.h"
 #include "scconfig.h"
 #include "scpage.h"
@@ -59,6 +60,7 @@ for which a new license (GPL+exception) is in place.
 #include "text/screenpainter.h"
 #include "text/textshaper.h"
 #include "text/shapedtext.h"
+#include "text/shapedtextcache.h"
 #include "text/shapedtextfeed.h"
 #include "ui/guidemanager.h"
 #include "ui/marksmanager.h"
@@ -189,6 +191,55 @@ static QRegion itemShape(PageItem* docItem, double xOffset, double yOffset)
 	return  res;
 }
 
+// itemShape() is costly for stroked or contoured items, so the result is kept
+// in the item until one of the values it depends on changes. Callers check the
+// bounds of the item first, comparing these values is not free either.
+static QRegion cachedItemShape(PageItem* docItem, double xOffset, double yOffset)
+{
+	QVector<double> params;
+	params.reserve(24);
+	params << docItem->xPos() << docItem->yPos() << docItem->gXpos << docItem->gYpos;
+	params << docItem->width() << docItem->height() << docItem->rotation() << docItem->lineWidth();
+	params << docItem->textFlowMode() << docItem->itemType() << docItem->isGroupChild();
+	params << docItem->imageFlippedH() << docItem->imageFlippedV();
+	params << docItem->lineEnd() << docItem->lineJoin() << docItem->GrTypeStroke;
+	params << (docItem->lineColor() != CommonStrings::None) << docItem->patternStrokeVal.isEmpty();
+	QRectF bb = docItem->getVisualBoundingRect();
+	params << bb.x() << bb.y() << bb.width() << bb.height();
+	if (!docItem->NamedLStyle.isEmpty())
+	{
+		multiLine ml = docItem->doc()->MLineStyles.value(docItem->NamedLStyle);
+		if (!ml.isEmpty())
+		{
+			const SingleLine& sl = ml.last();
+			params << (sl.Color != CommonStrings::None) << sl.Width << sl.LineEnd << sl.LineJoin;
+		}
+	}
+
+	TextFlowShape& cache = docItem->textFlowShape;
+	if (!cache.valid || cache.params != params || cache.lineStyle != docItem->NamedLStyle
+		|| cache.clip != docItem->Clip || cache.poLine != docItem->PoLine
+		|| cache.contourLine != docItem->ContourLine || cache.imageClip != docItem->imageClip)
+	{
+		cache.params = params;
+		cache.lineStyle = docItem->NamedLStyle;
+		cache.clip = docItem->Clip;
+		cache.poLine = docItem->PoLine;
+		cache.contourLine = docItem->ContourLine;
+		cache.imageClip = docItem->imageClip;
+		cache.regions.clear();
+		cache.valid = true;
+	}
+
+	const QPair<double, double> offset(xOffset, yOffset);
+	QMap<QPair<double, double>, QRegion>::const_iterator it = cache.regions.constFind(offset);
+	if (it != cache.regions.constEnd())
+		return it.value();
+	QRegion region = itemShape(docItem, xOffset, yOffset);
+	cache.regions.insert(offset, region);
+	return region;
+}
+
 QRegion PageItem_TextFrame::calcAvailableRegion()
 {
 	QRegion result(this->Clip);
@@ -201,6 +252,8 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 		else
 			canvasToLocalMat.translate(m_xPos, m_yPos);
 		canvasToLocalMat.rotate(m_rotation);
+		// obstacles whose shape misses this rect can't change the result
+		QRect frameRect = canvasToLocalMat.mapRect(Clip.boundingRect()).adjusted(-1, -1, 1, 1);
 		canvasToLocalMat = canvasToLocalMat.inverted(&invertible);
 
 		if (!invertible) return QRegion();
@@ -223,7 +276,11 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 			else
 				thisList = m_Doc->MasterItems;
 			int thisid = thisList.indexOf(this);
-			for (int a = 0; a < m_Doc->MasterItems.count(); ++a)
+			double xOffset = Mp->xOffset() - Dp->xOffset();
+			double yOffset = Mp->yOffset() - Dp->yOffset();
+			// the shapes are moved by the offset, their bounding boxes aren't
+			const QList<int> candidates(m_Doc->itemIndicesIn(m_Doc->MasterItems, QRectF(frameRect) | QRectF(frameRect).translated(xOffset, yOffset)));
+			for (int a : candidates)
 			{
 				docItem = m_Doc->MasterItems.at(a);
 				// #10642 : masterpage items interact only with items placed on same masterpage
@@ -234,8 +291,9 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 				{
 					if (docItem->textFlowAroundObject())
 					{
-						QRegion itemRgn = itemShape(docItem, Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset());
-						result = result.subtracted( canvasToLocalMat.map(itemRgn) );
+						QRegion itemRgn = cachedItemShape(docItem, xOffset, yOffset);
+						if (itemRgn.boundingRect().intersects(frameRect))
+							result = result.subtracted( canvasToLocalMat.map(itemRgn) );
 					}
 				}
 			} // for all masterItems
@@ -267,15 +325,21 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 					docItem = Parent->asGroupFrame()->groupItemList.at(a);
 					if (docItem->textFlowAroundObject())
 					{
-						QRegion itemRgn = itemShape(docItem, 0, 0);
-						result = result.subtracted( canvasToLocalMat.map(itemRgn) );
+						// group members are not indexed, they are placed relative to the group
+						QRectF bounds(PageItemIndex::itemBounds(docItem));
+						if (!bounds.translated(docItem->gXpos - docItem->xPos(), docItem->gYpos - docItem->yPos()).intersects(frameRect))
+							continue;
+						QRegion itemRgn = cachedItemShape(docItem, 0, 0);
+						if (itemRgn.boundingRect().intersects(frameRect))
+							result = result.subtracted( canvasToLocalMat.map(itemRgn) );
 					}
 				}
 			}
 			else
 			{
 				thisid = m_Doc->Items->indexOf(this);
-				for (int a = 0; a < docItemsCount; ++a)
+				const QList<int> candidates(m_Doc->itemIndicesIn(frameRect));
+				for (int a : candidates)
 				{
 					docItem = m_Doc->Items->at(a);
 					LayerLevItem = m_Doc->layerLevelFromID(docItem->LayerID);
@@ -283,8 +347,9 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 					{
 						if (docItem->textFlowAroundObject())
 						{
-							QRegion itemRgn = itemShape(docItem, 0, 0);
-							result = result.subtracted( canvasToLocalMat.map(itemRgn) );
+							QRegion itemRgn = cachedItemShape(docItem, 0, 0);
+							if (itemRgn.boundingRect().intersects(frameRect))
+								result = result.subtracted( canvasToLocalMat.map(itemRgn) );
 						}
 					}
 				}
@@ -1095,27 +1160,27 @@ struct LineControl {
 		return 0.0;
 	}
 
-	LineBox* createLineBox()
+	LineBox* createLineBox(TextLayout& layout)
 	{
-		LineBox* result = new LineBox();
+		LineBox* result = layout.createBox<LineBox>();
 		result->moveTo(lineData.x - colLeft, lineData.y - lineData.ascent);
 		result->setWidth(lineData.width);
 		result->setAscent(lineData.ascent);
 		result->setDescent(lineData.descent);
 		for (const GlyphCluster& run : ShapedTextFeed::putInVisualOrder(glyphs,   0, lineData.lastCluster - lineData.firstCluster + 1))
 		{
-			addBox(result, run);
+			addBox(layout, result, run);
 //			qDebug() << "cluster" << run.firstChar() << ".." << run.lastChar() << "@" << run.visualIndex();
 		}
 		return result;
 	}
 
-	void addBox(LineBox *lineBox, const GlyphCluster& run)
+	void addBox(TextLayout& layout, LineBox *lineBox, const GlyphCluster& run)
 	{
 		Box* result;
 		if (run.object().getPageItem(doc))
 		{
-			result = new ObjectBox(run, context);
+			result = layout.createBox<ObjectBox>(run, context);
 			QRectF bBox = context->getVisualBoundingBox(run.object());
 			if (run.hasFlag(ScLayout_DropCap))
 				result->setAscent(bBox.height() * run.scaleV() - run.yoffset);
@@ -1125,7 +1190,7 @@ struct LineControl {
 		}
 		else
 		{
-			result = new GlyphBox(run);
+			result = layout.createBox<GlyphBox>(run);
 			result->setAscent(lineBox->ascent());
 			result->setDescent(lineBox->descent());
 		}
@@ -1248,6 +1313,7 @@ bool PageItem_TextFrame::moveLinesFromPreviousFrame ()
 	int startingPos = prev->incompletePositions[prev->incompleteLines - pull];
 	for (int i = 0; i < pull; ++i)
 		prev->textLayout.removeLastLine();
+	prev->m_layoutSnapshot.valid = false;
 	firstChar = prev->MaxChars = startingPos;
 	// keep the remaining incomplete lines flagged as such
 	// this ensures that if pulling one line won't be enough, the subsequent call to layout() will pull more
@@ -1328,6 +1394,8 @@ void PageItem_TextFrame::layout()
 		// #9592 : warning, BackBox->layout() may not layout BackBox next box
 		if (!invalid)
 			return;
+		if (reuseLayout())
+			return;
 	}
 	else if (!invalid && OnMasterPage.isEmpty()) {
 //		qDebug() << QString("textframe: len=%1, invalid=%2 OnMasterPage=%3: no relayout").arg(itemText.length()).arg(invalid).arg(OnMasterPage);
@@ -1368,6 +1436,10 @@ void PageItem_TextFrame::layout()
 	textLayout.clear();
 	incompleteLines = 0;
 	incompletePositions.clear();
+	// where the next frame started before the text changed, if it still starts there its contents stay the same
+	int oldEnd = m_layoutSnapshot.maxChars;
+	bool endTracked = m_layoutSnapshot.valid && itemText.trackPosition(m_layoutSnapshot.revision, oldEnd);
+	m_layoutSnapshot.valid = false;
 
 	double lineCorr = 0;
 	if (lineColor() != CommonStrings::None)
@@ -1402,6 +1474,7 @@ void PageItem_TextFrame::layout()
 			next->firstChar = itLen;
 			next->MaxChars = itLen;
 			next->textLayout.clear();
+			next->m_layoutSnapshot.valid = false;
 			next = dynamic_cast<PageItem_TextFrame*>(next->nextInChain());
 		}
 		// TODO layout() shouldn't delete any frame here, as it breaks any loop
@@ -1427,6 +1500,7 @@ void PageItem_TextFrame::layout()
 	{
 		// determine layout area
 		m_availableRegion = calcAvailableRegion();
+		m_layoutSnapshot.region = m_availableRegion;
 		if (m_availableRegion.isEmpty())
 		{
 			MaxChars = firstInFrame();
@@ -1450,8 +1524,9 @@ void PageItem_TextFrame::layout()
 		}
 
 		ITextContext* context = this;
+		itemText.shapedTextCache()->setTypographicPrefs(context->typographicPrefs());
 		//TextShaper textShaper(this, itemText, firstInFrame());
-		ShapedTextFeed shapedText(&itemText, firstInFrame(), context);
+		ShapedTextFeed shapedText(&itemText, firstInFrame(), context, itemText.shapedTextCache());
 		
 		QList<GlyphCluster> glyphClusters; // = textShaper.shape();
 		// std::sort(glyphClusters.begin(), glyphClusters.end(), logicalGlyphRunComp);
@@ -2746,7 +2821,7 @@ void PageItem_TextFrame::layout()
 						}
 						current.fillInTabLeaders();
 						//if right margin is set we temporally save line, not append it
-						textLayout.appendLine(current.createLineBox());
+						textLayout.appendLine(current.createLineBox(textLayout));
 						setMaxY(maxYDesc);
 						current.restartIndex = current.lineData.lastCluster + 1;
 						i = current.lineData.lastCluster;
@@ -2969,7 +3044,7 @@ void PageItem_TextFrame::layout()
 			current.startOfCol = false;
 			goNextColumn = false;
 
-			textLayout.appendLine(current.createLineBox());
+			textLayout.appendLine(current.createLineBox(textLayout));
 			setMaxY(maxYDesc);
 			current.startOfCol = false;
 
@@ -3003,6 +3078,7 @@ void PageItem_TextFrame::layout()
 		}
 	}
 	invalid = false;
+	saveLayoutSnapshot();
 	if (!isNoteFrame() && (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged()))
 	{ //if notes are used
 		UndoManager::instance()->setUndoEnabled(false);
@@ -3023,6 +3099,8 @@ void PageItem_TextFrame::layout()
 			nextFrame->firstChar = MaxChars;
 			nextFrame = dynamic_cast<PageItem_TextFrame*>(nextFrame->NextBox);
 		}
+		if (!endTracked || (oldEnd != signed(MaxChars)))
+			redrawFollowingFrames();
 	}
 	itemText.blockSignals(false);
 //	qDebug("textframe: len=%d, done relayout", itemText.length());
@@ -3054,6 +3132,7 @@ NoRoom:
 			}
 		}
 	}
+	saveLayoutSnapshot();
 
 	if (!isNoteFrame() && (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged()))
 	{
@@ -3082,32 +3161,132 @@ NoRoom:
 			next->firstChar = MaxChars;
 			next = dynamic_cast<PageItem_TextFrame*>(next->NextBox);
 		}
+		if (!endTracked || (oldEnd != signed(MaxChars)))
+			redrawFollowingFrames();
 	}
 //	qDebug("textframe: len=%d, done relayout (no room %d)", itemText.length(), MaxChars);
 	itemText.blockSignals(false);
 }
 
+QVector<double> PageItem_TextFrame::layoutParams()
+{
+	QVector<double> params;
+	params << m_xPos << m_yPos << m_width << m_height << m_rotation;
+	params << m_textDistanceMargins.left() << m_textDistanceMargins.top();
+	params << m_textDistanceMargins.right() << m_textDistanceMargins.bottom();
+	params << m_lineWidth << (lineColor() != CommonStrings::None ? 1 : 0);
+	params << Cols << ColGap << firstLineOffset() << verticalAlign << FrameType;
+	params << (imageFlippedH() ? 1 : 0) << (imageFlippedV() ? 1 : 0);
+	params << m_Doc->guidesPrefs().valueBaselineGrid << m_Doc->guidesPrefs().offsetBaselineGrid;
+	params << m_Doc->typographicPrefs().autoLineSpacing;
+	if (OwnPage >= 0 && OwnPage < m_Doc->Pages->count())
+		params << m_Doc->Pages->at(OwnPage)->yOffset();
+	return params;
+}
+
+void PageItem_TextFrame::saveLayoutSnapshot()
+{
+	m_layoutSnapshot.valid = false;
+	if (!OnMasterPage.isEmpty())
+		return;
+	// marks, page numbers and inline objects can change without a change of the text
+	for (int i = firstInFrame(); i < signed(MaxChars); ++i)
+	{
+		if (itemText.hasExpansionPoint(i) || itemText.hasObject(i))
+			return;
+	}
+	m_layoutSnapshot.valid = true;
+	m_layoutSnapshot.revision = itemText.revision();
+	m_layoutSnapshot.firstChar = firstInFrame();
+	m_layoutSnapshot.maxChars = MaxChars;
+	m_layoutSnapshot.params = layoutParams();
+}
+
+bool PageItem_TextFrame::reuseLayout()
+{
+	if (!m_layoutSnapshot.valid || isNoteFrame() || !OnMasterPage.isEmpty())
+		return false;
+	if (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged())
+		return false;
+	int pos = m_layoutSnapshot.firstChar;
+	if (!itemText.trackPosition(m_layoutSnapshot.revision, pos) || pos != firstInFrame())
+		return false;
+	if (layoutParams() != m_layoutSnapshot.params)
+		return false;
+	if (calcAvailableRegion() != m_layoutSnapshot.region)
+		return false;
+
+	int delta = pos - m_layoutSnapshot.firstChar;
+	int maxChars = m_layoutSnapshot.maxChars + delta;
+	// see moveLinesFromPreviousFrame()
+	PageItem_TextFrame* prev = dynamic_cast<PageItem_TextFrame*>(BackBox);
+	if (prev && prev->incompleteLines && maxChars == itemText.length())
+	{
+		const ParagraphStyle& style = itemText.paragraphStyle(maxChars - 1);
+		if (static_cast<int>(textLayout.lines()) < style.keepLinesEnd() + 1)
+			return false;
+		prev->incompleteLines = 0;
+	}
+
+	if (delta != 0)
+	{
+		textLayout.moveChars(delta);
+		for (int i = 0; i < incompletePositions.count(); ++i)
+			incompletePositions[i] += delta;
+	}
+	MaxChars = maxChars;
+	m_layoutSnapshot.firstChar = pos;
+	m_layoutSnapshot.maxChars = maxChars;
+	m_layoutSnapshot.revision = itemText.revision();
+	invalid = false;
+
+	PageItem_TextFrame* next = dynamic_cast<PageItem_TextFrame*>(NextBox);
+	while (next)
+	{
+		next->invalid   = true;
+		next->firstChar = MaxChars;
+		next = dynamic_cast<PageItem_TextFrame*>(next->NextBox);
+	}
+	return true;
+}
+
+void PageItem_TextFrame::redrawFollowingFrames()
+{
+	// the following frames may lie on other pages, which nothing else redraws
+	for (PageItem* next = NextBox; next != nullptr; next = next->NextBox)
+		m_Doc->regionsChanged()->update(next->getVisualBoundingRect());
+}
+
 void PageItem_TextFrame::invalidateLayout(bool wholeChain)
 {
 	//const bool wholeChain = true;
 	invalid = true;
+	m_layoutSnapshot.valid = false;
 	if (wholeChain)
 	{
 		PageItem *prevFrame = this->prevInChain();
 		while (prevFrame != 0)
 		{
 			prevFrame->invalid = true;
+			prevFrame->asTextFrame()->m_layoutSnapshot.valid = false;
 			prevFrame = prevFrame->prevInChain();
 		}
 		PageItem *nextFrame = this->nextInChain();
 		while (nextFrame != 0)
 		{
 			nextFrame->invalid = true;
+			nextFrame->asTextFrame()->m_layoutSnapshot.valid = false;
 			nextFrame = nextFrame->nextInChain();
 		}
 	}
 }
 
+void PageItem_TextFrame::invalidateLayout()
+{
+	PageItem::invalidateLayout();
+	m_layoutSnapshot.valid = false;
+}
+
 void PageItem_TextFrame::slotInvalidateLayout(int firstItem, int endItem)
 {
 	PageItem* firstFrame = firstInChain();
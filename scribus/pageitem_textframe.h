@@ -71,7 +71,8 @@ public:
 	
 	//for speed up updates when changed was only one frame from chain
 	virtual void invalidateLayout(bool wholeChain);
-	using PageItem::invalidateLayout;
+	/// also drops the layout kept by saveLayoutSnapshot(), what changed is not known to the story
+	virtual void invalidateLayout();
 	virtual void layout();
 	//return true if all previouse frames from chain are valid (including that one)
 	bool isValidChainFromBegin();
@@ -113,6 +114,25 @@ private:
 	// This holds the line splitting positions
 	QList<int> incompletePositions;
 
+	/// what the last layout() depended on, see reuseLayout()
+	struct LayoutSnapshot
+	{
+		LayoutSnapshot() : valid(false), revision(0), firstChar(0), maxChars(0) {}
+		bool valid;
+		uint revision;
+		int firstChar;
+		int maxChars;
+		QVector<double> params;
+		QRegion region;
+	};
+	LayoutSnapshot m_layoutSnapshot;
+	QVector<double> layoutParams();
+	void saveLayoutSnapshot();
+	// Keeps the last layout if only text in front of this frame changed and it still starts with the same character.
+	bool reuseLayout();
+	/// marks the areas of the frames after this one in the chain as changed, when the text they show moved
+	void redrawFollowingFrames();
+
 	void setShadow();
 	QString m_currentShadow;
 	QMap<QString,StoryText> m_shadows;
@@ -0,0 +1,221 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <QPolygonF>
+#include <QTransform>
+
+#include "pageitem.h"
+#include "pageitemindex.h"
+
+// edge length of a grid cell in points
+static const double CellSize = 256.0;
+// items covering more cells are not sorted into the grid
+static const double MaxCells = 256.0;
+// cell coordinates beyond this are not sorted into the grid either, far outside of any canvas
+static const double MaxCellCoordinate = 1000000.0;
+
+static bool inGrid(double left, double top, double right, double bottom)
+{
+	return (std::fabs(left) < MaxCellCoordinate) && (std::fabs(top) < MaxCellCoordinate)
+		&& (std::fabs(right) < MaxCellCoordinate) && (std::fabs(bottom) < MaxCellCoordinate);
+}
+
+PageItemIndex::PageItemIndex() :
+	m_valid(false),
+	m_stamp(0)
+{
+}
+
+QList<int> PageItemIndex::indicesIn(const QList<PageItem*>& items, const QRectF& area)
+{
+	update(items);
+
+	QList<int> indices;
+	if (m_entries.isEmpty())
+		return indices;
+	QRectF searchArea(area.normalized());
+	if (++m_stamp == 0)
+	{
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+			it.value().stamp = 0;
+		m_stamp = 1;
+	}
+
+	// touching counts as intersecting, so empty areas and items find each other as well
+	auto collect = [&](PageItem* item)
+	{
+		Entry& entry = m_entries[item];
+		if (entry.stamp == m_stamp)
+			return;
+		entry.stamp = m_stamp;
+		if ((entry.bounds.left() <= searchArea.right()) && (entry.bounds.right() >= searchArea.left())
+			&& (entry.bounds.top() <= searchArea.bottom()) && (entry.bounds.bottom() >= searchArea.top()))
+			indices.append(entry.index);
+	};
+
+	double left = std::floor(searchArea.left() / CellSize);
+	double top = std::floor(searchArea.top() / CellSize);
+	double right = std::floor(searchArea.right() / CellSize);
+	double bottom = std::floor(searchArea.bottom() / CellSize);
+	if (!inGrid(left, top, right, bottom) || ((right - left + 1.0) * (bottom - top + 1.0) > m_cells.count()))
+	{
+		// cheaper to look at all occupied cells than at all cells of the area
+		for (auto it = m_cells.constBegin(); it != m_cells.constEnd(); ++it)
+		{
+			for (PageItem* item : it.value())
+				collect(item);
+		}
+	}
+	else
+	{
+		for (int col = static_cast<int>(left); col <= static_cast<int>(right); ++col)
+		{
+			for (int row = static_cast<int>(top); row <= static_cast<int>(bottom); ++row)
+			{
+				auto cell = m_cells.constFind(cellKey(col, row));
+				if (cell == m_cells.constEnd())
+					continue;
+				for (PageItem* item : cell.value())
+					collect(item);
+			}
+		}
+	}
+	for (PageItem* item : qAsConst(m_largeItems))
+		collect(item);
+
+	std::sort(indices.begin(), indices.end());
+	return indices;
+}
+
+void PageItemIndex::itemChanged(PageItem* item)
+{
+	// nothing to update before the first query or when the next query rebuilds anyway
+	if (m_valid)
+		m_changed.insert(item);
+}
+
+void PageItemIndex::clear()
+{
+	m_valid = false;
+	m_items.clear();
+	m_entries.clear();
+	m_cells.clear();
+	m_largeItems.clear();
+	m_changed.clear();
+}
+
+QRectF PageItemIndex::itemBounds(PageItem* item)
+{
+	// the same rects Canvas uses for culling, hit testing and rubber band selection
+	QRectF bounds(item->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0));
+	bounds |= item->getCurrentBoundingRect(item->lineWidth());
+	if (!item->Clip.isEmpty())
+		bounds |= item->getTransform().map(QPolygonF(item->Clip)).boundingRect();
+	// text frames flowing around the item query the index for its stroke and contour line as well
+	bounds |= item->getVisualBoundingRect();
+	if (!item->ContourLine.isEmpty())
+		bounds |= item->getTransform().map(item->ContourLine.toQPainterPath(true)).boundingRect();
+	return bounds;
+}
+
+void PageItemIndex::update(const QList<PageItem*>& items)
+{
+	// comparing lists which still share their data is cheap
+	if (!m_valid || (m_items != items))
+	{
+		rebuild(items);
+		return;
+	}
+	// share the data again if the list has only been copied
+	m_items = items;
+	// the changed items are still in the list, otherwise it would differ from m_items
+	for (PageItem* item : qAsConst(m_changed))
+	{
+		auto it = m_entries.constFind(item);
+		if (it == m_entries.constEnd())
+			continue;
+		int index = it.value().index;
+		remove(item);
+		insert(item, index);
+	}
+	m_changed.clear();
+}
+
+void PageItemIndex::rebuild(const QList<PageItem*>& items)
+{
+	clear();
+	m_items = items;
+	m_entries.reserve(items.count());
+	for (int i = 0; i < items.count(); ++i)
+		insert(items.at(i), i);
+	m_valid = true;
+}
+
+void PageItemIndex::insert(PageItem* item, int index)
+{
+	Entry entry;
+	entry.bounds = itemBounds(item);
+	entry.index = index;
+	entry.stamp = 0;
+	double left = std::floor(entry.bounds.left() / CellSize);
+	double top = std::floor(entry.bounds.top() / CellSize);
+	double right = std::floor(entry.bounds.right() / CellSize);
+	double bottom = std::floor(entry.bounds.bottom() / CellSize);
+	entry.large = !inGrid(left, top, right, bottom) || ((right - left + 1.0) * (bottom - top + 1.0) > MaxCells);
+	if (entry.large)
+	{
+		entry.left = entry.top = entry.right = entry.bottom = 0;
+		m_largeItems.append(item);
+	}
+	else
+	{
+		entry.left = static_cast<int>(left);
+		entry.top = static_cast<int>(top);
+		entry.right = static_cast<int>(right);
+		entry.bottom = static_cast<int>(bottom);
+		for (int col = entry.left; col <= entry.right; ++col)
+		{
+			for (int row = entry.top; row <= entry.bottom; ++row)
+				m_cells[cellKey(col, row)].append(item);
+		}
+	}
+	m_entries.insert(item, entry);
+}
+
+void PageItemIndex::remove(PageItem* item)
+{
+	auto it = m_entries.find(item);
+	if (it == m_entries.end())
+		return;
+	const Entry& entry = it.value();
+	if (entry.large)
+		m_largeItems.removeOne(item);
+	else
+	{
+		for (int col = entry.left; col <= entry.right; ++col)
+		{
+			for (int row = entry.top; row <= entry.bottom; ++row)
+			{
+				auto cell = m_cells.find(cellKey(col, row));
+				if (cell == m_cells.end())
+					continue;
+				cell.value().removeOne(item);
+				if (cell.value().isEmpty())
+					m_cells.erase(cell);
+			}
+		}
+	}
+	m_entries.erase(it);
+}
+
+quint64 PageItemIndex::cellKey(int col, int row)
+{
+	return (quint64(quint32(col)) << 32) | quint32(row);
+}
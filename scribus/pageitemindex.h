@@ -0,0 +1,78 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PAGEITEMINDEX_H
+#define PAGEITEMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ PageItemIndex finds the items of an item list whose bounds intersect an area of the canvas.
+ Items are sorted into a uniform grid over canvas coordinates, items covering very many cells
+ are kept in a separate list which is always searched.
+
+ The index is validated lazily when it is queried: if the list has been changed since the last
+ query, i.e. items have been added, deleted, reordered, grouped or ungrouped, it is rebuilt,
+ otherwise only the items reported by itemChanged() are moved to their new cells.
+ Layer and page are not part of the index, callers filter the returned items as before.
+ */
+class SCRIBUS_API PageItemIndex
+{
+public:
+	PageItemIndex();
+
+	/**
+	 Returns the positions in items of the items whose bounds intersect area, in ascending order.
+	 The result may contain items which only come close to area, never misses one which intersects it.
+	 */
+	QList<int> indicesIn(const QList<PageItem*>& items, const QRectF& area);
+	/// marks the bounds of item as changed, they are read again by the next query
+	void itemChanged(PageItem* item);
+	void clear();
+
+	/// the area searched for item, its bounding rects, its clip and its contour line
+	static QRectF itemBounds(PageItem* item);
+
+private:
+	struct Entry
+	{
+		QRectF bounds;
+		int index;
+		int left;
+		int top;
+		int right;
+		int bottom;
+		bool large;
+		uint stamp;
+	};
+
+	void update(const QList<PageItem*>& items);
+	void rebuild(const QList<PageItem*>& items);
+	void insert(PageItem* item, int index);
+	void remove(PageItem* item);
+	static quint64 cellKey(int col, int row);
+
+	bool m_valid;
+	// the list the index has been built from, shares its data with the indexed list until that changes
+	QList<PageItem*> m_items;
+	QHash<PageItem*, Entry> m_entries;
+	QHash<quint64, QVector<PageItem*> > m_cells;
+	QVector<PageItem*> m_largeItems;
+	QSet<PageItem*> m_changed;
+	// marks the entries already returned by the current query
+	uint m_stamp;
+};
+
+#endif
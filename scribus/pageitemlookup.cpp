@@ -0,0 +1,210 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "pageitem.h"
+#include "pageitem_group.h"
+#include "pageitemlookup.h"
+
+PageItemLookup::PageItemLookup() :
+	m_valid(false)
+{
+}
+
+PageItem* PageItemLookup::itemByName(const QList<PageItem*>& items, const QString& name)
+{
+	update(items);
+
+	PageItem* found = nullptr;
+	auto it = m_byName.constFind(name);
+	if (it == m_byName.constEnd())
+		return found;
+	for (PageItem* item : it.value())
+	{
+		if (item->itemName() != name)
+			continue;
+		if (m_entries.constFind(item).value().parent == nullptr)
+			return item;
+		if (found == nullptr)
+			found = item;
+	}
+	return found;
+}
+
+PageItem* PageItemLookup::itemByUniqueID(const QList<PageItem*>& items, uint id)
+{
+	update(items);
+
+	PageItem* found = nullptr;
+	auto it = m_byID.constFind(id);
+	if (it == m_byID.constEnd())
+		return found;
+	for (PageItem* item : it.value())
+	{
+		if (item->uniqueNr != id)
+			continue;
+		if (m_entries.constFind(item).value().parent == nullptr)
+			return item;
+		if (found == nullptr)
+			found = item;
+	}
+	return found;
+}
+
+void PageItemLookup::itemRenamed(PageItem* item)
+{
+	auto it = m_entries.find(item);
+	if (it == m_entries.end())
+		return;
+	QString name(item->itemName());
+	if (it.value().name == name)
+		return;
+	QList<PageItem*>& named = m_byName[it.value().name];
+	named.removeOne(item);
+	if (named.isEmpty())
+		m_byName.remove(it.value().name);
+	it.value().name = name;
+	m_byName[name].append(item);
+}
+
+void PageItemLookup::itemDeleted(PageItem* item)
+{
+	auto it = m_entries.constFind(item);
+	if (it == m_entries.constEnd())
+		return;
+	// a new item may get the address of item, so it must not be found in the indexed lists any more
+	PageItem* parent = it.value().parent;
+	QList<PageItem*>& indexed = (parent == nullptr) ? m_items : m_entries[parent].children;
+	int index = indexed.indexOf(item);
+	if (index >= 0)
+		indexed[index] = nullptr;
+	remove(item);
+}
+
+void PageItemLookup::clear()
+{
+	m_valid = false;
+	m_items.clear();
+	m_entries.clear();
+	m_byName.clear();
+	m_byID.clear();
+	m_groups.clear();
+}
+
+void PageItemLookup::update(const QList<PageItem*>& items)
+{
+	if (!m_valid)
+	{
+		rebuild(items);
+		return;
+	}
+	if (m_items != items)
+	{
+		QList<PageItem*> indexed(m_items);
+		m_items = items;
+		sync(indexed, items, nullptr);
+	}
+	else
+		m_items = items;
+
+	// groups whose members have been changed in place
+	QList<PageItem*> changed;
+	for (PageItem* group : m_groups)
+	{
+		if (m_entries.constFind(group).value().children != group->asGroupFrame()->groupItemList)
+			changed.append(group);
+	}
+	for (PageItem* group : changed)
+	{
+		// may have been removed together with a group changed before
+		if (!m_groups.contains(group))
+			continue;
+		QList<PageItem*> indexed(m_entries.constFind(group).value().children);
+		const QList<PageItem*>& members = group->asGroupFrame()->groupItemList;
+		m_entries[group].children = members;
+		sync(indexed, members, group);
+	}
+}
+
+void PageItemLookup::rebuild(const QList<PageItem*>& items)
+{
+	clear();
+	m_items = items;
+	m_entries.reserve(items.count());
+	for (PageItem* item : items)
+		insert(item, nullptr);
+	m_valid = true;
+}
+
+void PageItemLookup::sync(const QList<PageItem*>& indexed, const QList<PageItem*>& items, PageItem* parent)
+{
+	// items are mostly added or deleted in one place, the rest of the list stays as it was
+	int common = qMin(indexed.count(), items.count());
+	int prefix = 0;
+	while ((prefix < common) && (indexed.at(prefix) == items.at(prefix)))
+		++prefix;
+	int suffix = 0;
+	while ((suffix < common - prefix) && (indexed.at(indexed.count() - 1 - suffix) == items.at(items.count() - 1 - suffix)))
+		++suffix;
+
+	for (int i = prefix; i < indexed.count() - suffix; ++i)
+	{
+		PageItem* item = indexed.at(i);
+		// items moved to another list have been inserted there already
+		auto it = m_entries.constFind(item);
+		if ((it != m_entries.constEnd()) && (it.value().parent == parent))
+			remove(item);
+	}
+	for (int i = prefix; i < items.count() - suffix; ++i)
+		insert(items.at(i), parent);
+}
+
+void PageItemLookup::insert(PageItem* item, PageItem* parent)
+{
+	if (item == nullptr)
+		return;
+	if (m_entries.contains(item))
+		remove(item);
+	Entry entry;
+	entry.name = item->itemName();
+	entry.id = item->uniqueNr;
+	entry.parent = parent;
+	if (item->isGroup())
+	{
+		entry.children = item->asGroupFrame()->groupItemList;
+		m_groups.insert(item);
+	}
+	m_entries.insert(item, entry);
+	m_byName[entry.name].append(item);
+	m_byID[entry.id].append(item);
+	for (PageItem* child : entry.children)
+		insert(child, item);
+}
+
+void PageItemLookup::remove(PageItem* item)
+{
+	auto it = m_entries.find(item);
+	if (it == m_entries.end())
+		return;
+	// items are not dereferenced here, they may have been destroyed
+	Entry entry(it.value());
+	m_entries.erase(it);
+	m_groups.remove(item);
+	QList<PageItem*>& named = m_byName[entry.name];
+	named.removeOne(item);
+	if (named.isEmpty())
+		m_byName.remove(entry.name);
+	QList<PageItem*>& numbered = m_byID[entry.id];
+	numbered.removeOne(item);
+	if (numbered.isEmpty())
+		m_byID.remove(entry.id);
+	for (PageItem* child : entry.children)
+	{
+		auto childIt = m_entries.constFind(child);
+		if ((childIt != m_entries.constEnd()) && (childIt.value().parent == item))
+			remove(child);
+	}
+}
@@ -0,0 +1,71 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PAGEITEMLOOKUP_H
+#define PAGEITEMLOOKUP_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ PageItemLookup finds the items of an item list and of its groups by name or by unique number
+ through hashes instead of scanning the list.
+
+ Like PageItemIndex it is validated lazily when it is queried: the list and the member lists of
+ the groups are compared with the copies taken by the last query, which is cheap while they still
+ share their data, and only the items between the unchanged beginning and end of a changed list
+ are removed and inserted again. So creating, deleting, grouping and ungrouping items need no
+ notification, renamed and deleted items are reported by itemRenamed() and itemDeleted().
+ */
+class SCRIBUS_API PageItemLookup
+{
+public:
+	PageItemLookup();
+
+	/// the item of items or of their groups named name, top level items first, nullptr if there is none
+	PageItem* itemByName(const QList<PageItem*>& items, const QString& name);
+	/// the item of items or of their groups whose uniqueNr is id, top level items first
+	PageItem* itemByUniqueID(const QList<PageItem*>& items, uint id);
+	/// reads the name of item again, call after it changed
+	void itemRenamed(PageItem* item);
+	/// forgets item, call before it is destroyed
+	void itemDeleted(PageItem* item);
+	void clear();
+
+private:
+	struct Entry
+	{
+		QString name;
+		uint id;
+		// the group the item is a member of, nullptr for top level items
+		PageItem* parent;
+		// the members of a group when it was indexed, shares its data with groupItemList until that changes
+		QList<PageItem*> children;
+	};
+
+	void update(const QList<PageItem*>& items);
+	void rebuild(const QList<PageItem*>& items);
+	void sync(const QList<PageItem*>& indexed, const QList<PageItem*>& items, PageItem* parent);
+	void insert(PageItem* item, PageItem* parent);
+	void remove(PageItem* item);
+
+	bool m_valid;
+	// the list the lookup has been built from, shares its data with the indexed list until that changes
+	QList<PageItem*> m_items;
+	QHash<PageItem*, Entry> m_entries;
+	QHash<QString, QList<PageItem*> > m_byName;
+	QHash<uint, QList<PageItem*> > m_byID;
+	QSet<PageItem*> m_groups;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <climits>
+
+#include <QPainter>
+
+#include "pagethumbnailcache.h"
+#include "scpage.h"
+#include "scpagerenderer.h"
+#include "scribusdoc.h"
+
+// thumbnails of a few thousand pages at the sizes of the palettes and dialogs
+static const qint64 DefaultMaxBytes = 64 * 1024 * 1024;
+// how long to wait before trying again while the document is loaded
+static const int LoadingRetryInterval = 200;
+
+PageThumbnailCache::PageThumbnailCache(ScribusDoc* doc) : QObject(),
+	m_doc(doc),
+	m_entries(DefaultMaxBytes / 1024)
+{
+	m_idleTimer.setInterval(0);
+	connect(&m_idleTimer, SIGNAL(timeout()), this, SLOT(renderNext()));
+}
+
+PageThumbnailCache::~PageThumbnailCache()
+{
+}
+
+QImage PageThumbnailCache::thumbnail(ScPage* page, int maxSize)
+{
+	Key key(page, maxSize);
+	const Entry* entry = m_entries.object(key);
+	if (!isCurrent(key, entry))
+		request(key);
+	return entry ? entry->image : QImage();
+}
+
+QImage PageThumbnailCache::cachedThumbnail(ScPage* page, int maxSize) const
+{
+	const Entry* entry = m_entries.object(Key(page, maxSize));
+	return entry ? entry->image : QImage();
+}
+
+QImage PageThumbnailCache::thumbnailNow(ScPage* page, int maxSize)
+{
+	Key key(page, maxSize);
+	const Entry* entry = m_entries.object(key);
+	if (isCurrent(key, entry))
+		return entry->image;
+	return render(page, maxSize);
+}
+
+bool PageThumbnailCache::isCurrent(ScPage* page, int maxSize) const
+{
+	Key key(page, maxSize);
+	return isCurrent(key, m_entries.object(key));
+}
+
+QImage PageThumbnailCache::placeholder(const ScPage* page, int maxSize)
+{
+	double scale = ScPageRenderer::dpiForSize(page, maxSize) / 72.0;
+	int width = qMax(1, qRound(page->width() * scale));
+	int height = qMax(1, qRound(page->height() * scale));
+	QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::white);
+	QPainter painter(&image);
+	painter.setPen(QColor(Qt::lightGray));
+	painter.drawRect(0, 0, width - 1, height - 1);
+	painter.end();
+	return image;
+}
+
+void PageThumbnailCache::clear()
+{
+	m_entries.clear();
+	m_queue.clear();
+	m_queued.clear();
+	m_idleTimer.stop();
+}
+
+qint64 PageThumbnailCache::maxBytes() const
+{
+	return qint64(m_entries.maxCost()) * 1024;
+}
+
+void PageThumbnailCache::setMaxBytes(qint64 bytes)
+{
+	m_entries.setMaxCost(static_cast<int>(qBound<qint64>(0, bytes / 1024, INT_MAX)));
+}
+
+void PageThumbnailCache::renderNext()
+{
+	if (m_doc->isLoading())
+	{
+		m_idleTimer.setInterval(LoadingRetryInterval);
+		return;
+	}
+	m_idleTimer.setInterval(0);
+	while (!m_queue.isEmpty())
+	{
+		Key key(m_queue.takeFirst());
+		m_queued.remove(key);
+		// pages may have been deleted since they were requested
+		if (!hasPage(key.first) || isCurrent(key, m_entries.object(key)))
+			continue;
+		render(key.first, key.second);
+		emit thumbnailReady(key.first, key.second);
+		break;
+	}
+	if (m_queue.isEmpty())
+		m_idleTimer.stop();
+}
+
+bool PageThumbnailCache::isCurrent(const Key& key, const Entry* entry) const
+{
+	return entry && (entry->revision == m_doc->pageRevision(key.first));
+}
+
+bool PageThumbnailCache::hasPage(ScPage* page) const
+{
+	return m_doc->DocPages.contains(page) || m_doc->MasterPages.contains(page);
+}
+
+QImage PageThumbnailCache::render(ScPage* page, int maxSize)
+{
+	Entry* entry = new Entry;
+	// taken first, so changes made meanwhile outdate the thumbnail
+	entry->revision = m_doc->pageRevision(page);
+	ScPageRenderer renderer(m_doc);
+	renderer.prepare(QList<ScPage*>() << page);
+	entry->image = renderer.render(page, ScPageRenderer::dpiForSize(page, maxSize), ScPageRenderer::DrawBackground);
+	QImage image(entry->image);
+	m_entries.insert(Key(page, maxSize), entry, qMax(1, image.byteCount() / 1024));
+	return image;
+}
+
+void PageThumbnailCache::request(const Key& key)
+{
+	if (m_queued.contains(key))
+		return;
+	m_queue.append(key);
+	m_queued.insert(key);
+	if (!m_idleTimer.isActive())
+		m_idleTimer.start();
+}
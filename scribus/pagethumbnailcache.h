@@ -0,0 +1,92 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PAGETHUMBNAILCACHE_H
+#define PAGETHUMBNAILCACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QTimer>
+
+#include "scribusapi.h"
+
+class ScPage;
+class ScribusDoc;
+
+/**
+ PageThumbnailCache keeps thumbnails of the pages and master pages of a document for the page
+ palette, the navigator and the PDF export dialog. Thumbnails are rendered by ScPageRenderer
+ when the event loop is idle, one at a time, so requesting the thumbnails of hundreds of pages
+ does not block the user interface. Until a thumbnail is ready callers show placeholder()
+ or the outdated thumbnail, thumbnailReady() tells them when to update.
+
+ A thumbnail is outdated when the revision of its page changes, see ScribusDoc::pageRevision(),
+ and is only rendered again when requested.
+ */
+class SCRIBUS_API PageThumbnailCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit PageThumbnailCache(ScribusDoc* doc);
+	~PageThumbnailCache();
+
+	/**
+	 Returns the thumbnail of page whose longer side is maxSize pixels. If it is outdated or has
+	 not been rendered yet, rendering is scheduled and the outdated thumbnail or a null image
+	 is returned.
+	 */
+	QImage thumbnail(ScPage* page, int maxSize);
+	/// the cached thumbnail, even if outdated, without scheduling rendering
+	QImage cachedThumbnail(ScPage* page, int maxSize) const;
+	/// same as thumbnail(), but renders the thumbnail right away if needed
+	QImage thumbnailNow(ScPage* page, int maxSize);
+	/// true if the thumbnail of page at maxSize is cached and up to date
+	bool isCurrent(ScPage* page, int maxSize) const;
+	/// a blank page of the size of the thumbnail of page at maxSize
+	static QImage placeholder(const ScPage* page, int maxSize);
+
+	/// drops all thumbnails and pending requests
+	void clear();
+
+	/// memory limit in bytes
+	qint64 maxBytes() const;
+	void setMaxBytes(qint64 bytes);
+
+signals:
+	void thumbnailReady(ScPage* page, int maxSize);
+
+private slots:
+	void renderNext();
+
+private:
+	typedef QPair<ScPage*, int> Key;
+
+	struct Entry
+	{
+		QImage image;
+		quint64 revision;
+	};
+
+	bool isCurrent(const Key& key, const Entry* entry) const;
+	bool hasPage(ScPage* page) const;
+	QImage render(ScPage* page, int maxSize);
+	void request(const Key& key);
+
+	ScribusDoc* m_doc;
+	// costs are in KB
+	QCache<Key, Entry> m_entries;
+	QList<Key> m_queue;
+	QSet<Key> m_queued;
+	QTimer m_idleTimer;
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "pdfexportindex.h"
+
+namespace {
+	const quint32 IndexFileMagic = 0x53504458; // "SPDX"
+	const quint32 IndexFileVersion = 2;
+	const char* const IndexFileSuffix = ".scindex";
+
+	void writeResources(QDataStream& out, const Pdf::ResourceDictionary& dict)
+	{
+		out << dict.XObject << dict.Font << dict.Shading << dict.Pattern << dict.ExtGState << dict.Properties;
+		out << qint32(dict.ColorSpace.count());
+		for (const Pdf::Resource& res : dict.ColorSpace)
+			out << res.ResName << quint32(res.ResNum);
+	}
+
+	void readResources(QDataStream& in, Pdf::ResourceDictionary& dict)
+	{
+		in >> dict.XObject >> dict.Font >> dict.Shading >> dict.Pattern >> dict.ExtGState >> dict.Properties;
+		qint32 count;
+		in >> count;
+		dict.ColorSpace.clear();
+		for (int i = 0; (i < count) && (in.status() == QDataStream::Ok); ++i)
+		{
+			Pdf::Resource res;
+			quint32 resNum;
+			in >> res.ResName >> resNum;
+			res.ResNum = resNum;
+			dict.ColorSpace.append(res);
+		}
+	}
+
+	void mergeMap(Pdf::ResourceMap& map, const Pdf::ResourceMap& older)
+	{
+		for (Pdf::ResourceMap::const_iterator it = older.constBegin(); it != older.constEnd(); ++it)
+		{
+			if (!map.contains(it.key()))
+				map.insert(it.key(), it.value());
+		}
+	}
+}
+
+PdfExportIndex::PdfExportIndex() :
+	revision(0),
+	prologueCount(0),
+	objectCount(0),
+	resourcesObj(0),
+	resourceCount(0),
+	xrefOffset(0),
+	fullExportSize(0),
+	m_pdfSize(0),
+	m_pdfModified(0)
+{
+}
+
+QString PdfExportIndex::fileName(const QString& pdfName)
+{
+	return pdfName + IndexFileSuffix;
+}
+
+bool PdfExportIndex::load(const QString& pdfName)
+{
+	QFileInfo pdfInfo(pdfName);
+	if (!pdfInfo.exists())
+		return false;
+	QFile file(fileName(pdfName));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic, version;
+	in >> magic >> version;
+	if ((magic != IndexFileMagic) || (version != IndexFileVersion))
+		return false;
+	in >> m_pdfSize >> m_pdfModified;
+	// the PDF was written or edited by someone else meanwhile
+	if ((m_pdfSize != pdfInfo.size()) || (m_pdfModified != pdfInfo.lastModified().toMSecsSinceEpoch()))
+		return false;
+	quint32 prologue, objects, resObj;
+	qint32 resCount, pageCount;
+	in >> revisionSession >> revision >> optionsKey >> fontsKey >> fileId >> creationDate;
+	in >> prologue >> objects >> resObj >> resCount >> xrefOffset >> fullExportSize;
+	prologueCount = prologue;
+	objectCount = objects;
+	resourcesObj = resObj;
+	resourceCount = resCount;
+	readResources(in, resources);
+	in >> pageCount;
+	pages.clear();
+	for (int i = 0; (i < pageCount) && (in.status() == QDataStream::Ok); ++i)
+	{
+		Page page;
+		qint32 pageIndex;
+		quint32 object;
+		in >> pageIndex >> object >> page.pinned >> page.revision >> page.items >> page.imagesKey;
+		page.pageIndex = pageIndex;
+		page.object = object;
+		pages.append(page);
+	}
+	return (in.status() == QDataStream::Ok) && (pages.count() == pageCount);
+}
+
+bool PdfExportIndex::save(const QString& pdfName)
+{
+	QFileInfo pdfInfo(pdfName);
+	if (!pdfInfo.exists())
+		return false;
+	m_pdfSize = pdfInfo.size();
+	m_pdfModified = pdfInfo.lastModified().toMSecsSinceEpoch();
+	QSaveFile file(fileName(pdfName));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << IndexFileMagic << IndexFileVersion << m_pdfSize << m_pdfModified;
+	out << revisionSession << revision << optionsKey << fontsKey << fileId << creationDate;
+	out << quint32(prologueCount) << quint32(objectCount) << quint32(resourcesObj) << qint32(resourceCount) << xrefOffset << fullExportSize;
+	writeResources(out, resources);
+	out << qint32(pages.count());
+	for (const Page& page : pages)
+		out << qint32(page.pageIndex) << quint32(page.object) << page.pinned << page.revision << page.items << page.imagesKey;
+	if (out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+void PdfExportIndex::remove(const QString& pdfName)
+{
+	QString name = fileName(pdfName);
+	if (QFile::exists(name))
+		QFile::remove(name);
+}
+
+void PdfExportIndex::mergeResources(Pdf::ResourceDictionary& dict, const Pdf::ResourceDictionary& older)
+{
+	mergeMap(dict.XObject, older.XObject);
+	mergeMap(dict.Font, older.Font);
+	mergeMap(dict.Shading, older.Shading);
+	mergeMap(dict.Pattern, older.Pattern);
+	mergeMap(dict.ExtGState, older.ExtGState);
+	mergeMap(dict.Properties, older.Properties);
+	for (const Pdf::Resource& res : older.ColorSpace)
+	{
+		bool found = false;
+		for (const Pdf::Resource& current : qAsConst(dict.ColorSpace))
+		{
+			if (current.ResName == res.ResName)
+			{
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+			dict.ColorSpace.append(res);
+	}
+}
@@ -0,0 +1,83 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFEXPORTINDEX_H
+#define PDFEXPORTINDEX_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "pdfstructs.h"
+#include "scribusapi.h"
+
+/**
+ PdfExportIndex records what an export wrote to a PDF file, so the next export of the same
+ document may append the changed pages as an incremental update instead of writing the whole
+ file again. It is kept next to the PDF in a file named after it, see fileName(), and is only
+ loaded while the PDF has the size and modification time it had when the index was saved.
+
+ Pages keep their page objects: an update writes the new contents of a page into the object
+ of its earlier version and the resources of the update into the resource dictionary of the
+ file, merged with the resources of the earlier exports.
+ */
+class SCRIBUS_API PdfExportIndex
+{
+public:
+	struct Page
+	{
+		/// index of the page in ScribusDoc::DocPages
+		int pageIndex;
+		PdfId object;
+		/// the page has annotations, bookmarks or article beads referring to other objects
+		bool pinned;
+		/// newest revision of the page and the items shown on it
+		quint64 revision;
+		/// PageItem::uniqueNr of the items shown on the page
+		QList<uint> items;
+		/// hash of the image files shown on the page, see PdfImageStreamCache::fileKey()
+		QByteArray imagesKey;
+	};
+
+	PdfExportIndex();
+
+	static QString fileName(const QString& pdfName);
+	/// returns false if there is no index for pdfName or the PDF changed since it was saved
+	bool load(const QString& pdfName);
+	bool save(const QString& pdfName);
+	static void remove(const QString& pdfName);
+
+	/// adds the resources of older which are not in dict
+	static void mergeResources(Pdf::ResourceDictionary& dict, const Pdf::ResourceDictionary& older);
+
+	/// ScribusDoc::revisionSession() and ScribusDoc::revision() when the export started
+	QByteArray revisionSession;
+	quint64 revision;
+	/// hashes of the export options and of the fonts and glyphs used
+	QByteArray optionsKey;
+	QByteArray fontsKey;
+	/// the first file identifier and the creation date of the file, which updates keep
+	QByteArray fileId;
+	QByteArray creationDate;
+	/// object count when the prologue and the master pages were written, and at the end of the file
+	PdfId prologueCount;
+	PdfId objectCount;
+	PdfId resourcesObj;
+	/// count of the resources named by ResNam
+	int resourceCount;
+	qint64 xrefOffset;
+	/// size of the file written by the last export of all pages
+	qint64 fullExportSize;
+	Pdf::ResourceDictionary resources;
+	QList<Page> pages;
+
+private:
+	qint64 m_pdfSize;
+	qint64 m_pdfModified;
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "pdfimagestreamcache.h"
+#include "prefsmanager.h"
+#include "scimagecachemanager.h"
+#include "scpaths.h"
+#include "util_file.h"
+
+namespace {
+	const quint32 CacheFileMagic = 0x53504943; // "SPIC"
+	const quint32 CacheFileVersion = 1;
+	const char* const CacheFileSuffix = ".stream";
+
+	bool olderThan(const QFileInfo& a, const QFileInfo& b)
+	{
+		return a.lastModified() < b.lastModified();
+	}
+}
+
+QMutex PdfImageStreamCache::s_fileKeysMutex;
+QHash<QString, PdfImageStreamCache::FileKey> PdfImageStreamCache::s_fileKeys;
+
+PdfImageStreamCache::PdfImageStreamCache() :
+	m_enabled(ScImageCacheManager::instance().enabled()),
+	m_stored(false),
+	m_dir(ScPaths::pdfImageCacheDir())
+{
+}
+
+QByteArray PdfImageStreamCache::fileKey(const QString& fn) const
+{
+	QFileInfo info(fn);
+	FileKey fileKey;
+	fileKey.size = info.size();
+	fileKey.modified = info.lastModified();
+	{
+		QMutexLocker locker(&s_fileKeysMutex);
+		QHash<QString, FileKey>::const_iterator it = s_fileKeys.constFind(fn);
+		if ((it != s_fileKeys.constEnd()) && (it->size == fileKey.size) && (it->modified == fileKey.modified))
+			return it->key;
+	}
+	// hashed without the lock, another thread may hash the same file meanwhile
+	QFile file(fn);
+	if (file.open(QIODevice::ReadOnly))
+	{
+		QCryptographicHash hash(QCryptographicHash::Md5);
+		if (hash.addData(&file))
+		{
+			fileKey.key = hash.result().toHex();
+			fileKey.key += ' ' + QByteArray::number(fileKey.size);
+			fileKey.key += ' ' + QByteArray::number(fileKey.modified.toMSecsSinceEpoch());
+		}
+	}
+	QMutexLocker locker(&s_fileKeysMutex);
+	s_fileKeys.insert(fn, fileKey);
+	return fileKey.key;
+}
+
+QString PdfImageStreamCache::fileName(const QByteArray& key) const
+{
+	QByteArray name = QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+	return m_dir + QString::fromLatin1(name.left(2)) + "/" + QString::fromLatin1(name) + CacheFileSuffix;
+}
+
+bool PdfImageStreamCache::load(const QByteArray& key, Entry& entry) const
+{
+	if (!m_enabled)
+		return false;
+	QFile file(fileName(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic, version;
+	QByteArray storedKey;
+	in >> magic >> version;
+	if ((magic != CacheFileMagic) || (version != CacheFileVersion))
+		return false;
+	in >> storedKey;
+	// the file name is a hash of the key, which might collide
+	if (storedKey != key)
+		return false;
+	qint32 colorSpace, width, height, outType, compression, maskWidth, maskHeight;
+	in >> entry.contentHash >> colorSpace >> entry.sxa >> entry.sya;
+	in >> width >> height >> outType >> compression >> entry.data;
+	in >> entry.mask >> maskWidth >> maskHeight >> entry.maskCompressed;
+	if ((in.status() != QDataStream::Ok) || entry.data.isEmpty())
+		return false;
+	entry.colorSpace = colorSpace;
+	entry.width = width;
+	entry.height = height;
+	entry.outType = outType;
+	entry.compression = compression;
+	entry.maskWidth = maskWidth;
+	entry.maskHeight = maskHeight;
+	file.close();
+	// prune() removes the least recently used entries first
+	touchFile(file.fileName());
+	return true;
+}
+
+bool PdfImageStreamCache::store(const QByteArray& key, const Entry& entry)
+{
+	if (!m_enabled)
+		return false;
+	QString name = fileName(key);
+	if (!QDir().mkpath(QFileInfo(name).absolutePath()))
+		return false;
+	QSaveFile file(name);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << CacheFileMagic << CacheFileVersion << key;
+	out << entry.contentHash << qint32(entry.colorSpace) << entry.sxa << entry.sya;
+	out << qint32(entry.width) << qint32(entry.height) << qint32(entry.outType) << qint32(entry.compression) << entry.data;
+	out << entry.mask << qint32(entry.maskWidth) << qint32(entry.maskHeight) << entry.maskCompressed;
+	if (out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	m_stored = file.commit();
+	return m_stored;
+}
+
+void PdfImageStreamCache::prune()
+{
+	if (!m_stored)
+		return;
+	m_stored = false;
+	qint64 maxBytes = qint64(PrefsManager::instance()->appPrefs.imageCachePrefs.maxCacheSizeMiB) * 1024 * 1024;
+	QList<QFileInfo> files;
+	qint64 totalBytes = 0;
+	QDirIterator it(m_dir, QStringList() << QString("*") + CacheFileSuffix, QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		files.append(it.fileInfo());
+		totalBytes += it.fileInfo().size();
+	}
+	if (totalBytes <= maxBytes)
+		return;
+	std::sort(files.begin(), files.end(), olderThan);
+	for (int i = 0; (i < files.count()) && (totalBytes > maxBytes); ++i)
+	{
+		if (QFile::remove(files[i].absoluteFilePath()))
+			totalBytes -= files[i].size();
+	}
+}
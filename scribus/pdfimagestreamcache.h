@@ -0,0 +1,84 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PDFIMAGESTREAMCACHE_H
+#define PDFIMAGESTREAMCACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "scribusapi.h"
+
+/**
+ PdfImageStreamCache keeps the image streams encoded by the PDF export on disk, so exporting
+ an image again with the same settings copies the stream instead of loading, converting,
+ downsampling and compressing the image. Entries are found by a key the export makes of the
+ hash, size and modification time of the image file and of every setting affecting the stream,
+ see fileKey(). The cache is used while the image cache is enabled in the preferences and is
+ limited to the same size, the least recently used entries are removed first.
+
+ Streams are stored before encryption, which depends on the object number. fileKey() and load()
+ may be called from the threads preparing images, see ScImagePrefetcher.
+ */
+class SCRIBUS_API PdfImageStreamCache
+{
+public:
+	struct Entry
+	{
+		/// hash of the pixels and export settings, finds equal images within an export
+		QByteArray contentHash;
+		/// ColorSpaceEnum of the loaded image
+		int colorSpace;
+		double sxa;
+		double sya;
+		int width;
+		int height;
+		/// ColorSpaceEnum of the stream
+		int outType;
+		/// PDFOptions::PDFCompression of the stream
+		int compression;
+		QByteArray data;
+		/// soft mask or mask, empty if the image has no transparency
+		QByteArray mask;
+		int maskWidth;
+		int maskHeight;
+		bool maskCompressed;
+	};
+
+	PdfImageStreamCache();
+
+	bool enabled() const { return m_enabled; }
+	/// hash, size and modification time of the file fn, the file is only read again after it changed
+	QByteArray fileKey(const QString& fn) const;
+	/// returns true if an entry was stored for key, and marks it as recently used
+	bool load(const QByteArray& key, Entry& entry) const;
+	bool store(const QByteArray& key, const Entry& entry);
+	/// removes the oldest entries above the size limit if entries were stored
+	void prune();
+
+private:
+	struct FileKey
+	{
+		qint64 size;
+		QDateTime modified;
+		QByteArray key;
+	};
+
+	QString fileName(const QByteArray& key) const;
+
+	bool m_enabled;
+	bool m_stored;
+	QString m_dir;
+	// the keys of the files hashed by all exports of the session
+	static QMutex s_fileKeysMutex;
+	static QHash<QString, FileKey> s_fileKeys;
+};
+
+#endif
@@ -3,7 +3,8 @@
 #include "pdflib_core.h"
 
 PDFlib::PDFlib(ScribusDoc & docu)
-    : m_impl( new PDFLibCore(docu) )
+    : m_doc(docu),
+      m_impl( new PDFLibCore(docu) )
 {
 	Q_ASSERT(m_impl);
 }
@@ -16,6 +17,14 @@ PDFlib::~PDFlib()
 bool PDFlib::doExport(const QString& fn, const QString& nam, int Components,
 			  const std::vector<int> & pageNs, const QMap<int, QImage>& thumbs)
 {
+	if (static_cast<PDFLibCore*>(m_impl)->doExport(fn, nam, Components, pageNs, thumbs))
+		return true;
+	if (!static_cast<PDFLibCore*>(m_impl)->updateRejected())
+		return false;
+	// the pages could not be appended to the existing file, the core dropped its index and
+	// a fresh one writes the whole file
+	delete static_cast<PDFLibCore*>(m_impl);
+	m_impl = new PDFLibCore(m_doc);
 	return static_cast<PDFLibCore*>(m_impl)->doExport(fn, nam, Components, pageNs, thumbs);
 }
 
@@ -64,6 +64,7 @@ public:
 	bool  exportAborted(void);
 
 private:
+	ScribusDoc& m_doc;
     /// A pointer to the real implementation of pdflib .
 	void* m_impl;
 };
@@ -37,6 +37,7 @@ for which a new license (GPL+exception) is in place.
 
 #include "rc4.h"
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QCryptographicHash>
 #include <QDateTime>
@@ -49,7 +50,9 @@ for which a new license (GPL+exception) is in place.
 #include <QPainterPath>
 #include <QRect>
 #include <QRegExp>
+#include <QRunnable>
 #include <QScopedPointer>
+#include <QSet>
 #include <QStack>
 #include <QString>
 #include <QTemporaryFile>
@@ -64,11 +67,13 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_group.h"
 #include "pageitem_table.h"
 #include "pdfoptions.h"
+#include "pdfoptionsio.h"
 #include "prefscontext.h"
 #include "prefsmanager.h"
 #include "sccolor.h"
 #include "sccolorengine.h"
 #include "scfonts.h"
+#include "scoperatorwriter.h"
 #include "text/textlayoutpainter.h"
 #include "fonts/cff.h"
 #include "fonts/sfnt.h"
@@ -105,12 +110,80 @@ using namespace TableUtils;
 
 static inline QByteArray FToStr(double c)
 {
-	double v = c;
-	if (fabs(c) < 0.0000001)
-		v = 0.0;
-	return QByteArray::number(v, 'f', 5);
+	return ScOperatorWriter::toByteArray(c);
 }
 
+// Number of page content streams which may be encoded on the thread pool while the following
+// pages are generated. It is fixed, so where the streams end up in the file does not depend
+// on the number of threads.
+static const int PagesEncodedAhead = 8;
+
+/// Compresses and encrypts one stream of PDFLibCore::WritePDFStreamLater().
+class PdfStreamEncodeTask : public QRunnable
+{
+public:
+	PdfStreamEncodeTask(PDFLibCore* pdf, PDFLibCore::EncodedStream* stream) : m_pdf(pdf), m_stream(stream) { }
+	void run()
+	{
+		m_stream->data = m_pdf->encodeStream(m_stream->data, m_stream->objId);
+		m_stream->finished.release();
+	}
+
+private:
+	PDFLibCore* m_pdf;
+	PDFLibCore::EncodedStream* m_stream;
+};
+
+struct PDFLibCore::PreparedImage
+{
+	PreparedImage() : loadFailed(false), maskFailed(false), realCMYK(false), sxa(0), sya(0), maskCompressed(false), cacheHit(false) { }
+
+	bool loadFailed;
+	bool maskFailed;
+	ScImage img;
+	bool realCMYK;
+	double sxa;
+	double sya;
+	QByteArray mask;
+	bool maskCompressed;
+	QByteArray cacheKey;
+	bool cacheHit;
+	PdfImageStreamCache::Entry cached;
+};
+
+/// Loads an image of PDFLibCore::prefetchImages() ahead of PDF_Image().
+class PdfImagePrefetchJob : public ScImagePrefetcher::Job
+{
+public:
+	PdfImagePrefetchJob(const PDFLibCore* pdf, PageItem* item, int step) :
+		ScImagePrefetcher::Job(item, item->Pfile, step, qMax<qint64>(1, qint64(item->OrigW) * item->OrigH * 5)),
+		sx(item->imageXScale()),
+		sy(item->imageYScale()),
+		profile(item->IProfile),
+		embedded(item->UseEmbedded),
+		intent(item->IRender),
+		m_pdf(pdf),
+		m_pageItem(item)
+	{ }
+
+	PDFLibCore::PreparedImage prepared;
+	double sx;
+	double sy;
+	QString profile;
+	bool embedded;
+	eRenderIntent intent;
+
+protected:
+	void prepare()
+	{
+		m_pdf->prepareImage(m_pageItem, fileName(), sx, sy, profile, embedded, intent, prepared);
+	}
+
+private:
+	const PDFLibCore* m_pdf;
+	PageItem* m_pageItem;
+};
+
 class PdfPainter: public TextLayoutPainter
 {
 	QByteArray m_glyphBuffer;
@@ -532,7 +605,9 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 	abortExport(false),
 	usingGUI(ScCore->usingGUI()),
 	bleedDisplacementX(0),
-	bleedDisplacementY(0)
+	bleedDisplacementY(0),
+	incrementalUpdate(false),
+	rejectedUpdate(false)
 {
 //	KeyGen.resize(32);
 //	OwnerKey.resize(32);
@@ -557,10 +632,10 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 		progressDialog = new MultiProgressDialog( tr("Saving PDF"), CommonStrings::tr_Cancel, doc.scMW());
 		Q_CHECK_PTR(progressDialog);
 		QStringList barNames, barTexts;
-		barNames << "EMP" << "EP" << "ECPI";
-		barTexts << tr("Exporting Master Page:") << tr("Exporting Page:") << tr("Exporting Items on Current Page:");
+		barNames << "EMP" << "EP" << "ECPI" << "EIP";
+		barTexts << tr("Exporting Master Page:") << tr("Exporting Page:") << tr("Exporting Items on Current Page:") << tr("Preparing Images:");
 		QList<bool> barsNumeric;
-		barsNumeric << true << true << false;
+		barsNumeric << true << true << false << true;
 		progressDialog->addExtraProgressBars(barNames, barTexts, barsNumeric);
 		connect(progressDialog, SIGNAL(canceled()), this, SLOT(cancelRequested()));
 	}
@@ -568,6 +643,7 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 
 PDFLibCore::~PDFLibCore()
 {
+	discardEncodedStreams();
 	delete progressDialog;
 }
 
@@ -614,8 +690,30 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 		PDF_Error( tr("Qt build miss both \"UTF-16\" and \"ISO-10646-UCS-2\" text codecs, pdf export is not possible") );
 		return false;
 	}
+	// pages which changed since the last export of fn may be appended to it, see PdfExportIndex
+	quint64 exportRevision = doc.revision();
+	QList<PdfExportIndex::Page> indexPages;
+	QByteArray optionsKey, fontsKey;
+	std::vector<int> exportPages(pageNs);
+	if (Options.incrementalUpdate)
+	{
+		indexPages = scanExportPages(pageNs);
+		optionsKey = exportOptionsKey();
+		fontsKey = exportFontsKey(usedFonts);
+		incrementalUpdate = prepareIncrementalUpdate(fn, indexPages, optionsKey, fontsKey, exportPages);
+		if (incrementalUpdate && exportPages.empty())
+		{
+			if (usingGUI)
+				progressDialog->close();
+			return true;
+		}
+	}
+	if (!incrementalUpdate)
+		PdfExportIndex::remove(fn);
+	PdfId prologueCount = 0;
 	if (PDF_Begin_Doc(fn, PrefsManager::instance()->appPrefs.fontPrefs.AvailFonts, usedFonts, doc.scMW()->bookmarkPalette->BView))
 	{
+		// an update replays the master pages of all pages, so their objects are numbered as before
 		QMap<int, int> pageNsMpa;
 		for (uint a = 0; a < pageNs.size(); ++a)
 		{
@@ -623,13 +721,15 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 		}
 		if (usingGUI)
 		{
-			progressDialog->setOverallTotalSteps(pageNsMpa.count()+pageNs.size());
+			progressDialog->setOverallTotalSteps(pageNsMpa.count()+exportPages.size());
 			progressDialog->setTotalSteps("EMP", pageNsMpa.count());
-			progressDialog->setTotalSteps("EP", pageNs.size());
+			progressDialog->setTotalSteps("EP", exportPages.size());
 			progressDialog->setOverallProgress(0);
 			progressDialog->setProgress("EMP", 0);
 			progressDialog->setProgress("EP", 0);
 		}
+		prefetchImages(exportPages, pageNsMpa);
+		updateImagePrefetchProgress();
 		for (int ap = 0; ap < doc.MasterPages.count() && !abortExport; ++ap)
 		{
 			if (doc.MasterItems.count() != 0)
@@ -648,23 +748,37 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 				progressDialog->setOverallProgress(pc_exportmasterpages+pc_exportpages);
 			}
 		}
-		for (uint a = 0; a < pageNs.size() && !abortExport; ++a)
+		imagePrefetcher.finishStep(0);
+		prologueCount = writer.objectCounter();
+		if (incrementalUpdate && !abortExport && !PDF_Begin_Update(fn))
+		{
+			if (!rejectedUpdate)
+				error = true;
+			abortExport = true;
+		}
+		for (uint a = 0; a < exportPages.size() && !abortExport; ++a)
 		{
 			if (doc.pdfOptions().Thumbnails)
-				thumb = thumbs[pageNs[a]];
+				thumb = thumbs[exportPages[a]];
 			qApp->processEvents();
 			if (abortExport) break;
 
-			PDF_Begin_Page(doc.DocPages.at(pageNs[a]-1), thumb);
+			PDF_Begin_Page(doc.DocPages.at(exportPages[a]-1), thumb);
 			qApp->processEvents();
 			if (abortExport) break;
 
-			if (!PDF_ProcessPage(doc.DocPages.at(pageNs[a]-1), pageNs[a]-1, doc.pdfOptions().doClip))
+			// Pages are generated one after another, PDF_ProcessPage() writes the fonts, images,
+			// patterns and annotations of the page to the writer as it finds them. Only the images
+			// are prepared and the content streams are encoded on other threads.
+			if (!PDF_ProcessPage(doc.DocPages.at(exportPages[a]-1), exportPages[a]-1, doc.pdfOptions().doClip))
 				error = abortExport = true;
 			qApp->processEvents();
 			if (abortExport) break;
 
 			PDF_End_Page();
+			writeEncodedStreams(PagesEncodedAhead);
+			imagePrefetcher.finishStep(a + 1);
+			updateImagePrefetchProgress();
 			pc_exportpages++;
 			if (usingGUI)
 			{
@@ -675,16 +789,26 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 		ret = true;//Even when aborting we return true. Don't want that "couldnt write msg"
 		if (!abortExport)
 		{
-			if (PDF_IsPDFX(doc.pdfOptions().Version))
+			writeEncodedStreams();
+			if (incrementalUpdate)
+				ret = PDF_End_Update();
+			else if (PDF_IsPDFX(doc.pdfOptions().Version))
 				ret = PDF_End_Doc(ScCore->PrinterProfiles[doc.pdfOptions().PrintProf], nam, Components);
 			else
 				ret = PDF_End_Doc();
+			if (ret && Options.incrementalUpdate)
+				saveExportIndex(fn, indexPages, exportRevision, prologueCount, optionsKey, fontsKey);
 		}
 		else
 			closeAndCleanup();
+		// a failed or aborted update leaves the file as it was, but the index may not describe it
+		if (incrementalUpdate && (abortExport || !ret))
+			PdfExportIndex::remove(fn);
 	}
 	if (usingGUI)
 		progressDialog->close();
+	if (rejectedUpdate)
+		return false;
 	return (ret && !error);
 }
 
@@ -698,6 +822,140 @@ bool PDFLibCore::exportAborted(void) const
 	return abortExport;
 }
 
+bool PDFLibCore::updateRejected(void) const
+{
+	return rejectedUpdate;
+}
+
+QList<PdfExportIndex::Page> PDFLibCore::scanExportPages(const std::vector<int>& pageNs)
+{
+	QList<PdfExportIndex::Page> pages;
+	for (uint a = 0; a < pageNs.size(); ++a)
+	{
+		const ScPage* page = doc.DocPages.at(pageNs[a] - 1);
+		double bLeft, bRight, bBottom, bTop;
+		getBleeds(page, bLeft, bRight, bBottom, bTop);
+		QRectF pageRect(page->xOffset() - bLeft, page->yOffset() - bTop, page->width() + bLeft + bRight, page->height() + bBottom + bTop);
+		PdfExportIndex::Page entry;
+		entry.pageIndex = pageNs[a] - 1;
+		entry.object = 0;
+		entry.pinned = false;
+		entry.revision = doc.pageRevision(page);
+		// linked image files may be replaced without a change of the document
+		QCryptographicHash images(QCryptographicHash::Md5);
+		bool hasImages = false;
+		const QList<int> candidates(doc.itemIndicesIn(doc.DocItems, pageRect));
+		for (int i : candidates)
+		{
+			PageItem* item = doc.DocItems.at(i);
+			if (!item->getVisualBoundingRect().intersects(pageRect))
+				continue;
+			entry.items.append(item->uniqueNr);
+			entry.revision = qMax(entry.revision, item->revision());
+			QList<PageItem*> parts = item->isGroup() ? item->getAllChildren() : QList<PageItem*>();
+			parts.prepend(item);
+			for (PageItem* part : qAsConst(parts))
+			{
+				// annotations, bookmarks and article beads refer to objects written with the whole file
+				if (part->isAnnotation() || part->isPDFBookmark())
+					entry.pinned = true;
+				if (part->isImageFrame() && !part->Pfile.isEmpty())
+				{
+					images.addData(part->Pfile.toUtf8());
+					images.addData(imageStreamCache.fileKey(part->Pfile));
+					hasImages = true;
+				}
+				if (!part->isTextFrame() || !part->isInChain())
+					continue;
+				if (Options.Articles)
+					entry.pinned = true;
+				// the text of a frame depends on the frames before it in its chain
+				for (PageItem* frame = part->firstInChain(); frame && (frame != part); frame = frame->nextInChain())
+					entry.revision = qMax(entry.revision, frame->revision());
+			}
+		}
+		if (hasImages)
+			entry.imagesKey = images.result();
+		pages.append(entry);
+	}
+	return pages;
+}
+
+QByteArray PDFLibCore::exportOptionsKey() const
+{
+	PDFOptions opts(Options);
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	if (!PDFOptionsIO(opts).writeTo(buffer))
+		return QByteArray();
+	QDataStream ks(&buffer);
+	ks.setVersion(QDataStream::Qt_5_0);
+	// options PDFOptionsIO does not save
+	ks << qint32(Options.Version) << Options.doClip << Options.cropMarks << Options.bleedMarks << Options.registrationMarks;
+	ks << Options.colorMarks << Options.docInfoMarks << Options.markLength << Options.markOffset << Options.useDocBleeds;
+	ks << qint32(Options.PageLayout) << Options.displayBookmarks << Options.displayFullscreen << Options.displayThumbs;
+	ks << Options.displayLayers << Options.hideToolBar << Options.hideMenuBar << Options.fitWindow << Options.openAction;
+	ks << Options.UseProfiles2 << Options.Intent2 << Options.UseLPI << Options.embedPDF;
+	return QCryptographicHash::hash(buffer.data(), QCryptographicHash::Md5);
+}
+
+QByteArray PDFLibCore::exportFontsKey(const QMap<QString, QMap<uint, FPointArray> >& usedFonts) const
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	for (QMap<QString, QMap<uint, FPointArray> >::const_iterator it = usedFonts.constBegin(); it != usedFonts.constEnd(); ++it)
+	{
+		hash.addData(it.key().toUtf8());
+		QList<uint> glyphs = it.value().keys();
+		for (uint glyph : qAsConst(glyphs))
+			hash.addData(QByteArray::number(glyph) + ' ');
+	}
+	return hash.result();
+}
+
+bool PDFLibCore::prepareIncrementalUpdate(const QString& fn, const QList<PdfExportIndex::Page>& pages, const QByteArray& optionsKey, const QByteArray& fontsKey, std::vector<int>& changedPages)
+{
+	// encrypted objects depend on the file identifier and PDF/X forbids incremental updates
+	if (Options.Encrypt || PDF_IsPDFX() || optionsKey.isEmpty())
+		return false;
+	if (!exportIndex.load(fn))
+		return false;
+	if ((exportIndex.revisionSession != doc.revisionSession()) || (exportIndex.optionsKey != optionsKey) || (exportIndex.fontsKey != fontsKey))
+		return false;
+	// changes of the settings, layers and master pages may affect every page
+	if ((doc.settingsRevision() > exportIndex.revision) || (doc.layersRevision() > exportIndex.revision))
+		return false;
+	for (int i = 0; i < doc.MasterPages.count(); ++i)
+	{
+		if (doc.MasterPages.at(i)->revision() > exportIndex.revision)
+			return false;
+	}
+	if (pages.count() != exportIndex.pages.count())
+		return false;
+	std::vector<int> changed;
+	for (int i = 0; i < pages.count(); ++i)
+	{
+		const PdfExportIndex::Page& current = pages.at(i);
+		const PdfExportIndex::Page& exported = exportIndex.pages.at(i);
+		if (current.pageIndex != exported.pageIndex)
+			return false;
+		if ((current.revision == exported.revision) && (current.items == exported.items) && (current.imagesKey == exported.imagesKey))
+			continue;
+		if (current.pinned || exported.pinned)
+			return false;
+		changed.push_back(current.pageIndex + 1);
+	}
+	// rewriting the whole file is as fast when most pages changed and keeps it from growing
+	if (changed.size() * 2 > static_cast<size_t>(pages.count()))
+		return false;
+	if (QFileInfo(fn).size() > 2 * exportIndex.fullExportSize)
+		return false;
+	updatePageObjects.clear();
+	for (const PdfExportIndex::Page& exported : qAsConst(exportIndex.pages))
+		updatePageObjects.insert(exported.pageIndex, exported.object);
+	changedPages = changed;
+	return true;
+}
+
 //#define StartObj(n) writer.startObj((n))
 #define PutDoc(s) writer.write(s)
 //#define newObject() writer.newObject()
@@ -995,11 +1253,225 @@ int PDFLibCore::WriteFlateImageToStream(ScImage& image, PdfId ObjNum, ColorSpace
 	return (succeed ? bytesWritten : 0);
 }
 
+QByteArray PDFLibCore::EncodeImageToArray(ScImage& image, const QString& fn, PDFOptions::PDFCompression cm, int quality, ColorSpaceEnum format, bool sameFile, bool precal)
+{
+	QByteArray data;
+	if (cm == PDFOptions::Compression_JPEG)
+	{
+		QString ext = QFileInfo(fn).suffix().toLower();
+		if (extensionIndicatesJPEG(ext) && sameFile)
+		{
+			loadRawBytes(fn, data);
+			return data;
+		}
+		QString tmpFile = QDir::toNativeSeparators(ScPaths::tempFileDir() + "sc.jpg");
+		if (format == ColorSpaceGray && (!precal))
+			image.convertToGray();
+		if (image.convert2JPG(tmpFile, quality, format == ColorSpaceCMYK, format == ColorSpaceGray))
+			loadRawBytes(tmpFile, data);
+		if (QFile::exists(tmpFile))
+			QFile::remove(tmpFile);
+		return data;
+	}
+
+	bool fromCmyk, succeed = false;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	ScNullEncodeFilter nullEncode(&stream);
+	ScFlateEncodeFilter flateEncode(&nullEncode);
+	ScStreamFilter* filter = &nullEncode;
+	if (cm == PDFOptions::Compression_ZIP)
+		filter = &flateEncode;
+	if (filter->openFilter())
+	{
+		switch (format)
+		{
+			case ColorSpaceMonochrome :
+				fromCmyk = !Options.UseRGB && !Options.isGrayscale && !(doc.HasCMS && Options.UseProfiles2);
+				succeed = image.writeMonochromeDataToFilter(filter, fromCmyk); break;
+			case ColorSpaceGray :
+				succeed = image.writeGrayDataToFilter(filter, precal); break;
+			case ColorSpaceCMYK :
+				succeed = image.writeCMYKDataToFilter(filter); break;
+			default :
+				succeed = image.writeRGBDataToFilter(filter); break;
+		}
+		succeed &= filter->closeFilter();
+	}
+	if (!succeed)
+		data.clear();
+	return data;
+}
+
+QByteArray PDFLibCore::imageStreamKey(PageItem* c, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const
+{
+	QByteArray fileKey = imageStreamCache.fileKey(fn);
+	if (fileKey.isEmpty())
+		return QByteArray();
+	QByteArray key;
+	QDataStream ks(&key, QIODevice::WriteOnly);
+	ks.setVersion(QDataStream::Qt_5_0);
+	// increase when the streams written by PDF_Image change
+	ks << quint32(1) << fileKey;
+	ks << c->pixm.imgInfo.actualPageNumber << c->pixm.imgInfo.isRequest << qint32(c->pixm.imgInfo.type);
+	for (QMap<int, ImageLoadRequest>::const_iterator it = c->pixm.imgInfo.RequestProps.constBegin(); it != c->pixm.imgInfo.RequestProps.constEnd(); ++it)
+		ks << it.key() << it.value().visible << it.value().useMask << it.value().opacity << it.value().blend;
+	ks << sx << sy << c->imageXScale() << c->imageYScale();
+	ks << Options.UseRGB << Options.isGrayscale << Options.UseProfiles2 << doc.HasCMS;
+	ks << Options.RecalcPic << Options.PicRes << Options.Resolution;
+	ks << qint32(Options.CompressMethod) << Options.Quality << qint32(Options.Version);
+	ks << Options.EmbeddedI << Options.Intent2 << Options.ImageProf << Options.PrintProf;
+	ks << Profil << Embedded << qint32(Intent);
+	ks << c->OverrideCompressionMethod << c->CompressionMethodIndex << c->OverrideCompressionQuality << c->CompressionQualityIndex;
+	const CMSData& cms = c->doc()->cmsSettings();
+	ks << cms.DefaultImageRGBProfile << cms.DefaultImageCMYKProfile << cms.DefaultPrinterProfile;
+	ks << qint32(cms.DefaultIntentImages) << cms.CMSinUse << cms.BlackPoint;
+	return key;
+}
 
+void PDFLibCore::prepareImage(PageItem* c, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent, PreparedImage& prepared) const
+{
+	if ((c->effectsInUse.count() == 0) && imageStreamCache.enabled())
+	{
+		prepared.cacheKey = imageStreamKey(c, fn, sx, sy, Profil, Embedded, Intent);
+		prepared.cacheHit = !prepared.cacheKey.isEmpty() && imageStreamCache.load(prepared.cacheKey, prepared.cached);
+		if (prepared.cacheHit)
+		{
+			prepared.sxa = prepared.cached.sxa;
+			prepared.sya = prepared.cached.sya;
+			return;
+		}
+	}
+	ScImage& img = prepared.img;
+	bool imageLoaded = false;
+	img.imgInfo.valid = false;
+	img.imgInfo.clipPath = "";
+	img.imgInfo.PDSpathData.clear();
+	img.imgInfo.layerInfo.clear();
+	img.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
+	img.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
+	CMSettings cms(c->doc(), Profil, Intent);
+	cms.setUseEmbeddedProfile(Embedded);
+	if (Options.UseRGB)
+		imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &prepared.realCMYK);
+	else
+	{
+		if ((doc.HasCMS) && (Options.UseProfiles2))
+			imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RawData, 72, &prepared.realCMYK);
+		else
+		{
+			if (Options.isGrayscale)
+				imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &prepared.realCMYK);
+			else
+				imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, 72, &prepared.realCMYK);
+		}
+	}
+	if (!imageLoaded)
+	{
+		prepared.loadFailed = true;
+		return;
+	}
+	if ((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))
+	{
+		double afl = Options.PicRes;
+		double a2 = (72.0 / sx) / afl;
+		double a1 = (72.0 / sy) / afl;
+		double ax = img.width() / a2;
+		double ay = img.height() / a1;
+		// #10510 : do not use scaled() here, may cause display problem 
+		// with acrobat reader if image contains some transparency
+		img.scaleImage(qRound(ax), qRound(ay));
+		prepared.sxa = sx * a2;
+		prepared.sya = sy * a1;
+	}
+	prepared.maskFailed = !loadImageMask(c, fn, Options.Resolution, img.width(), img.height(), prepared.mask, prepared.maskCompressed);
+}
+
+bool PDFLibCore::loadImageMask(PageItem* c, const QString& fn, int resolution, int width, int height, QByteArray& mask, bool& compressed) const
+{
+	mask.clear();
+	compressed = false;
+	if (c->pixm.imgInfo.type == ImageType7)
+		return true;
+	ScImage img2;
+	img2.imgInfo.clipPath = "";
+	img2.imgInfo.PDSpathData.clear();
+	img2.imgInfo.layerInfo.clear();
+	img2.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
+	img2.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
+	bool pdfVer14 = (Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4);
+	if (!img2.getAlpha(fn, c->pixm.imgInfo.actualPageNumber, mask, true, pdfVer14, resolution, width, height))
+		return false;
+	if (!mask.isEmpty() && (Options.CompressMethod != PDFOptions::Compression_None))
+	{
+		QByteArray compMask = CompressArray(mask);
+		if (compMask.size() > 0)
+		{
+			mask = compMask;
+			compressed = true;
+		}
+	}
+	return true;
+}
+
+void PDFLibCore::updateImagePrefetchProgress()
+{
+	if (!usingGUI || (imagePrefetcher.jobCount() == 0))
+		return;
+	progressDialog->setProgress("EIP", imagePrefetcher.finishedCount(), imagePrefetcher.jobCount());
+	progressDialog->setLabel("EIP", tr("Preparing Images (%1% overlapped):").arg(imagePrefetcher.overlapPercent()));
+}
+
+void PDFLibCore::prefetchImages(const std::vector<int>& pageNs, const QMap<int, int>& usedMasters)
+{
+	// frames showing the same file at the same size share their XObject, see SharedImages
+	QSet<QString> shared;
+	auto prefetchImage = [&](PageItem* item, int step)
+	{
+		if ((item->itemType() != PageItem::ImageFrame) || !item->imageIsAvailable || item->Pfile.isEmpty())
+			return;
+		if (!item->printEnabled() || !doc.layerPrintable(item->LayerID))
+			return;
+		if (!ScImagePrefetcher::canPrepare(item->Pfile))
+			return;
+		if (item->effectsInUse.count() == 0)
+		{
+			QString key = QString("%1 %2 %3 %4").arg(item->Pfile).arg(item->imageXScale()).arg(item->imageYScale()).arg(item->pixm.imgInfo.actualPageNumber);
+			if (shared.contains(key))
+				return;
+			shared.insert(key);
+		}
+		imagePrefetcher.addJob(new PdfImagePrefetchJob(this, item, step));
+	};
+	// the images are needed in the order doExport() writes the master pages and then the pages
+	for (int ap = 0; ap < doc.MasterPages.count(); ++ap)
+	{
+		if (!usedMasters.contains(ap))
+			continue;
+		QString masterName = doc.MasterPages.at(ap)->pageName();
+		QList<PageItem*> items = doc.getAllItems(doc.MasterItems);
+		for (PageItem* item : items)
+		{
+			if (item->OnMasterPage == masterName)
+				prefetchImage(item, 0);
+		}
+	}
+	QList<PageItem*> items = doc.getAllItems(doc.DocItems);
+	for (uint a = 0; a < pageNs.size(); ++a)
+	{
+		int pageIndex = pageNs[a] - 1;
+		for (PageItem* item : items)
+		{
+			if (item->OwnPage == pageIndex)
+				prefetchImage(item, a + 1);
+		}
+	}
+}
 
 bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, const QMap<QString, QMap<uint, FPointArray> >& DocFonts, BookMView* vi)
 {
-	if (!writer.open(fn))
+	// an update numbers the objects of the prologue as the export it appends to, but does not write them again
+	bool opened = incrementalUpdate ? writer.openDiscarding() : writer.open(fn);
+	if (!opened)
 		return false;
 	
 	inPattern = 0;
@@ -1194,6 +1666,11 @@ void PDFLibCore::PDF_Begin_MetadataAndEncrypt()
 	{
 		writer.setEncryption((Options.Version == PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_15), Pdf::toPdfDocEncoding(Options.PassOwner), Pdf::toPdfDocEncoding(Options.PassUser), Options.Permissions);
 	}
+	PDF_Info(Datum);
+}
+
+void PDFLibCore::PDF_Info(const QByteArray& creationDate)
+{
 	writer.startObj(writer.InfoObj);
 	PutDoc("<<\n/Creator " + EncString(QByteArray("Scribus ") + VERSION, writer.InfoObj) + "\n");
 	PutDoc("/Producer " + EncString(QByteArray("Scribus PDF Library ") + VERSION, writer.InfoObj) + "\n");
@@ -1205,7 +1682,7 @@ void PDFLibCore::PDF_Begin_MetadataAndEncrypt()
 	PutDoc("/Author " + EncStringUTF16(doc.documentInfo().author(), writer.InfoObj) + "\n");
 	PutDoc("/Subject " + EncStringUTF16(doc.documentInfo().subject(), writer.InfoObj) + "\n");
 	PutDoc("/Keywords " + EncStringUTF16(doc.documentInfo().keywords(), writer.InfoObj) + "\n");
-	PutDoc("/CreationDate " + EncString(Datum, writer.InfoObj) + "\n");
+	PutDoc("/CreationDate " + EncString(creationDate, writer.InfoObj) + "\n");
 	PutDoc("/ModDate " + EncString(Datum, writer.InfoObj) + "\n");
 	if (Options.Version == PDFOptions::PDFVersion_X1a)
 	{
@@ -3558,7 +4035,9 @@ void PDFLibCore::PDF_End_Page()
 			PutPage("Q\n");
 		}
 	}
-	pageData.ObjNum = WritePDFStream(Content);
+	// the content stream is compressed while the next pages are generated
+	pageData.ObjNum = writer.newObject();
+	WritePDFStreamLater(Content, pageData.ObjNum);
 	int Gobj = 0;
 	if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
 	{
@@ -3582,7 +4061,10 @@ void PDFLibCore::PDF_End_Page()
 		PutDoc(">>");
 		writer.endObj(Gobj);
 	}
-	PdfId pageObject = writer.newObject();
+	// an update replaces the page object of the earlier export, which the page tree refers to
+	PdfId pageObject = updatePageObjects.value(PgNr, 0);
+	if (pageObject == 0)
+		pageObject = writer.newObject();
 	writer.startObj(pageObject);
 	PutDoc("<<\n/Type /Page\n/Parent " + Pdf::toObjRef(writer.PagesObj) + "\n");
 	PutDoc("/MediaBox [0 0 "+FToStr(maxBoxX)+" "+FToStr(maxBoxY)+"]\n");
@@ -4332,6 +4814,7 @@ QByteArray PDFLibCore::PDF_PutSoftShadow(PageItem* ite, const ScPage *pag)
 bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage* pag, uint PNr, bool embedded, bool pattern)
 {
 	QByteArray tmp(""), tmpOut;
+	ScOperatorWriter out(tmp);
 	if (ite->isGroup())
 		ite->asGroupFrame()->adjustXYPosition();
 	ite->setRedrawBounding();
@@ -4397,7 +4880,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 		tmp += putColor(ite->fillColor(), ite->fillShade(), true);
 	if (ite->lineColor() != CommonStrings::None)
 		tmp += putColor(ite->lineColor(), ite->lineShade(), false);
-	tmp += FToStr(fabs(ite->lineWidth()))+" w\n";
+	out.lineWidth(fabs(ite->lineWidth()));
 	if (ite->DashValues.count() != 0)
 	{
 		tmp += "[ ";
@@ -4446,7 +4929,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 	}
 	if (!embedded)
 	{
-		tmp += "1 0 0 1 "+FToStr(ite->xPos() - pag->xOffset())+" "+FToStr(pag->height() - (ite->yPos()  - pag->yOffset()))+" cm\n";
+		out.translate(ite->xPos() - pag->xOffset(), pag->height() - (ite->yPos()  - pag->yOffset()));
 	}
 	if (ite->rotation() != 0)
 	{
@@ -4456,7 +4939,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			cr = 0;
 		if ((sr * sr) < 0.000001)
 			sr = 0;
-		tmp += FToStr(cr)+" "+FToStr(sr)+" "+FToStr(-sr)+" "+FToStr(cr)+" 0 0 cm\n";
+		out.transform(cr, sr, -sr, cr, 0, 0);
 	}
 	tmp += PDF_PutSoftShadow(ite,pag);
 	switch (ite->itemType())
@@ -4508,7 +4991,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						else
 						{
 							tmp += tmpOut;
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 						}
 						tmp += "Q\n";
@@ -4518,7 +5001,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 				{
 					if (ite->fillColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 					}
 				}
@@ -4526,9 +5009,9 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			tmp += "q\n";
 			tmp += SetPathAndClip(ite, true);
 			if (ite->imageFlippedH())
-				tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+				out.transform(-1, 0, 0, 1, ite->width(), 0);
 			if (ite->imageFlippedV())
-				tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+				out.transform(1, 0, 0, -1, 0, -ite->height());
 			if (ite->imageClip.size() != 0)
 				tmp += SetImagePathAndClip(ite);
 			if ((ite->imageIsAvailable) && (!ite->Pfile.isEmpty()))
@@ -4555,7 +5038,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
 							tmp += tmpOut;
@@ -4568,13 +5051,13 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 							return false;
 						tmp += "q\n";
 						tmp += tmpOut;
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 						tmp += "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 					}
 				}
@@ -4586,7 +5069,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
 							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += "h\nS\n";
 						}
 					}
@@ -4637,7 +5120,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						else
 						{
 							tmp += tmpOut;
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 						}
 						tmp += "Q\n";
@@ -4647,16 +5130,16 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 				{
 					if (ite->fillColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 					}
 				}
 			}
 			tmp += "q\n";
 			if (ite->imageFlippedH())
-				tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+				out.transform(-1, 0, 0, 1, ite->width(), 0);
 			if (ite->imageFlippedV())
-				tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+				out.transform(1, 0, 0, -1, 0, -ite->height());
 			if (ite->itemText.length() != 0)
 				tmp += setTextSt(ite, PNr, pag);
 			tmp += "Q\n";
@@ -4677,7 +5160,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
 							tmp += tmpOut;
@@ -4690,13 +5173,13 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 							return false;
 						tmp += "q\n";
 						tmp += tmpOut;
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 						tmp += "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 					}
 				}
@@ -4708,7 +5191,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
 							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += "h\nS\n";
 						}
 					}
@@ -4735,8 +5218,8 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 							return false;
 						tmp += tmpOut;
-						tmp += "0 0 m\n";
-						tmp += FToStr(ite->width())+" 0 l\n";
+						out.moveTo(0, 0);
+						out.lineTo(ite->width(), 0);
 						tmp += "S\n";
 					}
 				}
@@ -4746,15 +5229,15 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						return false;
 					tmp += "q\n";
 					tmp += tmpOut;
-					tmp += "0 0 m\n";
-					tmp += FToStr(ite->width())+" 0 l\n";
+					out.moveTo(0, 0);
+					out.lineTo(ite->width(), 0);
 					tmp += "S\n";
 					tmp += "Q\n";
 				}
 				else if (ite->lineColor() != CommonStrings::None)
 				{
-					tmp += "0 0 m\n";
-					tmp += FToStr(ite->width())+" 0 l\n";
+					out.moveTo(0, 0);
+					out.lineTo(ite->width(), 0);
 					tmp += "S\n";
 				}
 			}
@@ -4766,8 +5249,8 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 					if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 					{
 						tmp += setStrokeMulti(&ml[it]);
-						tmp += "0 0 m\n";
-						tmp += FToStr(ite->width())+" 0 l\n";
+						out.moveTo(0, 0);
+						out.lineTo(ite->width(), 0);
 						tmp += "S\n";
 					}
 				}
@@ -4821,7 +5304,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 					else
 					{
 						tmp += tmpOut;
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 					}
 				}
@@ -4830,7 +5313,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			{
 				if (ite->fillColor() != CommonStrings::None)
 				{
-					tmp += SetClipPath(ite);
+					writePath(out, ite->PoLine);
 					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 			}
@@ -4851,7 +5334,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
 							tmp += tmpOut;
@@ -4864,13 +5347,13 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 							return false;
 						tmp += "q\n";
 						tmp += tmpOut;
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 						tmp += "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 					}
 				}
@@ -4882,7 +5365,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
 							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += "h\nS\n";
 						}
 					}
@@ -4922,7 +5405,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						else
 						{
 							tmp += tmpOut;
-							tmp += SetClipPath(ite);
+							writePath(out, ite->PoLine);
 							tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 						}
 					}
@@ -4931,7 +5414,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 				{
 					if (ite->fillColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 					}
 				}
@@ -4953,7 +5436,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						}
 						else
 						{
-							tmp += SetClipPath(ite, false);
+							writePath(out, ite->PoLine, false);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
 							tmp += tmpOut;
@@ -4966,13 +5449,13 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 							return false;
 						tmp += "q\n";
 						tmp += tmpOut;
-						tmp += SetClipPath(ite);
+						writePath(out, ite->PoLine);
 						tmp += "h\nS\n";
 						tmp += "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite, false);
+						writePath(out, ite->PoLine, false);
 						tmp += "S\n";
 					}
 				}
@@ -4984,7 +5467,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
 							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite, false);
+							writePath(out, ite->PoLine, false);
 							tmp += "S\n";
 						}
 					}
@@ -5049,7 +5532,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 								}
 								else
 								{
-									tmp += SetClipPath(ite, false);
+									writePath(out, ite->PoLine, false);
 									if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 										return false;
 									tmp += tmpOut;
@@ -5062,13 +5545,13 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 									return false;
 								tmp += "q\n";
 								tmp += tmpOut;
-								tmp += SetClipPath(ite, false);
+								writePath(out, ite->PoLine, false);
 								tmp += "S\n";
 								tmp += "Q\n";
 							}
 							else if (ite->lineColor() != CommonStrings::None)
 							{
-								tmp += SetClipPath(ite, false);
+								writePath(out, ite->PoLine, false);
 								tmp += "S\n";
 							}
 						}
@@ -5080,7 +5563,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 								if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 								{
 									tmp += setStrokeMulti(&ml[it]);
-									tmp += SetClipPath(ite, false);
+									writePath(out, ite->PoLine, false);
 									tmp += "S\n";
 								}
 							}
@@ -5104,24 +5587,25 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			if (doc.docPatterns.contains(ite->pattern()))
 			{
 				QByteArray tmpD;
+				ScOperatorWriter outD(tmpD);
 				ScPattern pat = doc.docPatterns[ite->pattern()];
 				tmp += "q\n";
 				tmp += SetPathAndClip(ite);
 				if (ite->imageFlippedH())
-					tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+					out.transform(-1, 0, 0, 1, ite->width(), 0);
 				if (ite->imageFlippedV())
-					tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+					out.transform(1, 0, 0, -1, 0, -ite->height());
 				QTransform trans;
 				trans.scale(ite->width() / pat.width, ite->height() / pat.height);
 				trans.translate(0.0, -ite->height());
 	//			trans.translate(pat.items.at(0)->gXpos, -pat.items.at(0)->gYpos);
-				tmp += FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n";
+				out.transform(trans.m11(), trans.m12(), trans.m21(), trans.m22(), trans.dx(), trans.dy());
 				groupStackPos.push(QPointF(0, ite->height()));
 				for (int em = 0; em < pat.items.count(); ++em)
 				{
 					PageItem* embedded = pat.items.at(em);
 					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
+					outD.translate(embedded->gXpos, ite->height() - embedded->gYpos);
 					QByteArray output;
 					if (!PDF_ProcessItem(output, embedded, pag, PNr, true))
 						return false;
@@ -5140,23 +5624,24 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			if (ite->groupItemList.count() > 0)
 			{
 				QByteArray tmpD;
+				ScOperatorWriter outD(tmpD);
 				tmp += "q\n";
 				if (ite->groupClipping())
 					tmp += SetPathAndClip(ite);
 				if (ite->imageFlippedH())
-					tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+					out.transform(-1, 0, 0, 1, ite->width(), 0);
 				if (ite->imageFlippedV())
-					tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+					out.transform(1, 0, 0, -1, 0, -ite->height());
 				QTransform trans;
 				trans.scale(ite->width() / ite->groupWidth, ite->height() / ite->groupHeight);
 				trans.translate(0.0, -ite->height());
-				tmp += FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n";
+				out.transform(trans.m11(), trans.m12(), trans.m21(), trans.m22(), trans.dx(), trans.dy());
 				groupStackPos.push(QPointF(ite->xPos(), ite->height()));
 				for (int em = 0; em < ite->groupItemList.count(); ++em)
 				{
 					PageItem* embedded = ite->groupItemList.at(em);
 					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
+					outD.translate(embedded->gXpos, ite->height() - embedded->gYpos);
 					QByteArray output;
 					if (inPattern > 0)
 						patternStackPos.push(QPointF(embedded->gXpos, ite->height() - embedded->gYpos));
@@ -5177,7 +5662,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 			break;
 		case PageItem::Table:
 			tmp += "q\n";
-			tmp +=  "1 0 0 1 "+FToStr(ite->asTable()->gridOffset().x())+" "+FToStr(-ite->asTable()->gridOffset().y())+" cm\n";
+			out.translate(ite->asTable()->gridOffset().x(), -ite->asTable()->gridOffset().y());
 			// Paint table fill.
 			if (ite->asTable()->fillColor() != CommonStrings::None)
 			{
@@ -5188,7 +5673,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 				double width = ite->asTable()->columnPosition(lastCol) + ite->asTable()->columnWidth(lastCol) - x;
 				double height = ite->asTable()->rowPosition(lastRow) + ite->asTable()->rowHeight(lastRow) - y;
 				tmp += putColor(ite->asTable()->fillColor(), ite->asTable()->fillShade(), true);
-				tmp += "0 0 "+FToStr(width)+" "+FToStr(-height)+" re\n";
+				out.rect(0, 0, width, -height);
 				tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 			}
 			// Pass 1: Paint cell fills.
@@ -5213,7 +5698,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 							double y = ite->asTable()->rowPosition(row);
 							double width = ite->asTable()->columnPosition(lastCol) + ite->asTable()->columnWidth(lastCol) - x;
 							double height = ite->asTable()->rowPosition(lastRow) + ite->asTable()->rowHeight(lastRow) - y;
-							tmp += FToStr(x)+" "+FToStr(-y)+" "+FToStr(width)+" "+FToStr(-height)+" re\n";
+							out.rect(x, -y, width, -height);
 							tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 							tmp += "Q\n";
 						}
@@ -5367,7 +5852,7 @@ bool PDFLibCore::PDF_ProcessItem(QByteArray& output, PageItem* ite, const ScPage
 					{
 						PageItem* textFrame = cell.textFrame();
 						tmp += "q\n";
-						tmp +=  "1 0 0 1 "+FToStr(cell.contentRect().x())+" "+FToStr(-cell.contentRect().y())+" cm\n";
+						out.translate(cell.contentRect().x(), -cell.contentRect().y());
 						QByteArray output;
 						PDF_ProcessItem(output, textFrame, pag, PNr, true);
 						tmp += output;
@@ -5985,89 +6470,55 @@ QByteArray PDFLibCore::SetGradientColor(const QString& farbe, double Shade)
 QByteArray PDFLibCore::SetClipPath(PageItem *ite, bool poly)
 {
 	QByteArray tmp;
-	FPoint np, np1, np2, np3, np4, firstP;
-	bool nPath = true;
-	bool first = true;
-	if (ite->PoLine.size() <= 3)
-		return tmp;
-
-	for (int poi=0; poi<ite->PoLine.size()-3; poi += 4)
-	{
-		if (ite->PoLine.isMarker(poi))
-		{
-			nPath = true;
-			continue;
-		}
-		if (nPath)
-		{
-			np = ite->PoLine.point(poi);
-			if ((!first) && (poly) && (np4 == firstP))
-				tmp += "h\n";
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
-			nPath = false;
-			first = false;
-			firstP = np;
-			np4 = np;
-		}
-		np = ite->PoLine.point(poi);
-		np1 = ite->PoLine.point(poi+1);
-		np2 = ite->PoLine.point(poi+3);
-		np3 = ite->PoLine.point(poi+2);
-		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
-		else
-		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
-		}
-		np4 = np3;
-	}
+	ScOperatorWriter out(tmp);
+	writePath(out, ite->PoLine, poly);
 	return tmp;
 }
 
 QByteArray PDFLibCore::SetClipPathArray(FPointArray *ite, bool poly)
 {
 	QByteArray tmp;
+	ScOperatorWriter out(tmp);
+	writePath(out, *ite, poly);
+	return tmp;
+}
+
+void PDFLibCore::writePath(ScOperatorWriter& out, const FPointArray& path, bool poly)
+{
 	FPoint np, np1, np2, np3, np4, firstP;
 	bool nPath = true;
 	bool first = true;
-	if (ite->size() <= 3)
-		return tmp;
+	if (path.size() <= 3)
+		return;
 
-	for (int poi=0; poi<ite->size()-3; poi += 4)
+	for (int poi=0; poi<path.size()-3; poi += 4)
 	{
-		if (ite->isMarker(poi))
+		if (path.isMarker(poi))
 		{
 			nPath = true;
 			continue;
 		}
 		if (nPath)
 		{
-			np = ite->point(poi);
+			np = path.point(poi);
 			if ((!first) && (poly) && (np4 == firstP))
-				tmp += "h\n";
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+				out.closePath();
+			out.moveTo(np.x(), -np.y());
 			nPath = false;
 			first = false;
 			firstP = np;
 			np4 = np;
 		}
-		np = ite->point(poi);
-		np1 = ite->point(poi+1);
-		np2 = ite->point(poi+3);
-		np3 = ite->point(poi+2);
+		np = path.point(poi);
+		np1 = path.point(poi+1);
+		np2 = path.point(poi+3);
+		np3 = path.point(poi+2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
+			out.lineTo(np3.x(), -np3.y());
 		else
-		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
-		}
+			out.curveTo(np1.x(), -np1.y(), np2.x(), -np2.y(), np3.x(), -np3.y());
 		np4 = np3;
 	}
-	return tmp;
 }
 
 QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
@@ -6076,12 +6527,13 @@ QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 	if (ite->imageClip.size() <= 3)
 		return tmp;
 
+	ScOperatorWriter out(tmp);
 	bool nPath = true;
 	for (int poi=0; poi<ite->imageClip.size()-3; poi += 4)
 	{
 		if (ite->imageClip.isMarker(poi))
 		{
-			tmp += "h\n";
+			out.closePath();
 			nPath = true;
 			continue;
 		}
@@ -6089,7 +6541,7 @@ QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 		if (nPath)
 		{
 			np = ite->imageClip.point(poi);
-			tmp += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+			out.moveTo(np.x(), -np.y());
 			nPath = false;
 		}
 		np = ite->imageClip.point(poi);
@@ -6097,13 +6549,9 @@ QByteArray PDFLibCore::SetClipPathImage(PageItem *ite)
 		np2 = ite->imageClip.point(poi+3);
 		np3 = ite->imageClip.point(poi+2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" l\n";
+			out.lineTo(np3.x(), -np3.y());
 		else
-		{
-			tmp += FToStr(np1.x())+" "+FToStr(-np1.y())+" ";
-			tmp += FToStr(np2.x())+" "+FToStr(-np2.y())+" ";
-			tmp += FToStr(np3.x())+" "+FToStr(-np3.y())+" c\n";
-		}
+			out.curveTo(np1.x(), -np1.y(), np2.x(), -np2.y(), np3.x(), -np3.y());
 	}
 	return tmp;
 }
@@ -9711,16 +10159,57 @@ PdfId PDFLibCore::WritePDFStream(const QByteArray& cc)
 
 PdfId PDFLibCore::WritePDFStream(const QByteArray& cc, PdfId objId)
 {
-	QByteArray tmp(cc);
+	writeStreamObject(encodeStream(cc, objId), objId);
+	return objId;
+}
+
+void PDFLibCore::WritePDFStreamLater(const QByteArray& cc, PdfId objId)
+{
+	EncodedStream* stream = new EncodedStream;
+	stream->objId = objId;
+	stream->data = cc;
+	m_encodedStreams.append(stream);
+	if (Options.Compress || Options.Encrypt)
+		m_streamPool.start(new PdfStreamEncodeTask(this, stream));
+	else
+		stream->finished.release();
+}
+
+void PDFLibCore::writeEncodedStreams(int keep)
+{
+	while (m_encodedStreams.count() > keep)
+	{
+		EncodedStream* stream = m_encodedStreams.takeFirst();
+		stream->finished.acquire();
+		writeStreamObject(stream->data, stream->objId);
+		delete stream;
+	}
+}
+
+void PDFLibCore::discardEncodedStreams()
+{
+	m_streamPool.waitForDone();
+	qDeleteAll(m_encodedStreams);
+	m_encodedStreams.clear();
+}
+
+// Called on the threads of m_streamPool too, so it must only read members which do not change during the export.
+QByteArray PDFLibCore::encodeStream(const QByteArray& cc, PdfId objId)
+{
 	if (Options.Compress)
-		tmp = CompressArray(tmp);
+		return EncStream(CompressArray(cc), objId);
+	return EncStream(cc, objId);
+}
+
+void PDFLibCore::writeStreamObject(const QByteArray& encoded, PdfId objId)
+{
+	// encryption does not change the length
 	writer.startObj(objId);
-	PutDoc("<< /Length " + Pdf::toPdf(tmp.length()));  // moeglicherweise +1
+	PutDoc("<< /Length " + Pdf::toPdf(encoded.length()));  // moeglicherweise +1
 	if (Options.Compress)
 		PutDoc("\n/Filter /FlateDecode");
-	PutDoc(" >>\nstream\n" + EncStream(tmp, objId) + "\nendstream");
+	PutDoc(" >>\nstream\n" + encoded + "\nendstream");
 	writer.endObj(objId);
-	return objId;
 }
 
 PdfId PDFLibCore::WritePDFString(const QString& cc)
@@ -10253,9 +10742,12 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 	bool   avoidPDFXOutputIntentProf = false;
 	QString profInUse = Profil;
 	int    afl = Options.Resolution;
-	double ax, ay, a2, a1;
 	int    origWidth = 1;
 	int    origHeight = 1;
+	// raster images without effects are encoded into memory, deduplicated and kept in imageStreamCache
+	bool   encodeToArray = false;
+	bool   cacheHit = false;
+	PreparedImage prepared;
 	ShIm   ImInfo;
 	ImInfo.ResNum = 0;
 	ImInfo.sxa = 0;
@@ -10421,50 +10913,31 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 			// not PS/PDF
 			else
 			{
-				img.imgInfo.valid = false;
-				img.imgInfo.clipPath = "";
-				img.imgInfo.PDSpathData.clear();
-				img.imgInfo.layerInfo.clear();
-				img.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
-				img.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
-				CMSettings cms(c->doc(), Profil, Intent);
-				cms.setUseEmbeddedProfile(Embedded);
-				if (Options.UseRGB)
-					imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
+				encodeToArray = (c->effectsInUse.count() == 0);
+				QScopedPointer<ScImagePrefetcher::Job> job(imagePrefetcher.take(c, fn));
+				PdfImagePrefetchJob* prefetched = static_cast<PdfImagePrefetchJob*>(job.data());
+				if (prefetched && (prefetched->sx == sx) && (prefetched->sy == sy) && (prefetched->profile == Profil) && (prefetched->embedded == Embedded) && (prefetched->intent == Intent))
+					prepared = prefetched->prepared;
 				else
-				{
-					if ((doc.HasCMS) && (Options.UseProfiles2))
-						imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RawData, 72, &realCMYK);
-					else
-					{
-						if (Options.isGrayscale)
-							imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
-						else
-							imageLoaded = img.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, 72, &realCMYK);
-					}
-				}
-				if (!imageLoaded)
+					prepareImage(c, fn, sx, sy, Profil, Embedded, Intent, prepared);
+				if (prepared.loadFailed)
 				{
 					PDF_Error_ImageLoadFailure(fn);
 					return false;
 				}
-				if ((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))
+				if (prepared.maskFailed)
 				{
-					double afl = Options.PicRes;
-					a2 = (72.0 / sx) / afl;
-					a1 = (72.0 / sy) / afl;
-					origWidth = img.width();
-					origHeight = img.height();
-					ax = img.width() / a2;
-					ay = img.height() / a1;
-					// #10510 : do not use scaled() here, may cause display problem 
-					// with acrobat reader if image contains some transparency
-					img.scaleImage(qRound(ax), qRound(ay));
-					ImInfo.sxa = sx * a2;
-					ImInfo.sya = sy * a1;
+					PDF_Error_MaskLoadFailure(fn);
+					return false;
 				}
+				cacheHit = prepared.cacheHit;
+				img = prepared.img;
+				realCMYK = prepared.realCMYK;
+				ImInfo.sxa = prepared.sxa;
+				ImInfo.sya = prepared.sya;
 				ImInfo.reso = 1;
 			}
+			ColorSpaceEnum imageColorSpace = cacheHit ? static_cast<ColorSpaceEnum>(prepared.cached.colorSpace) : img.imgInfo.colorspace;
 			bool hasColorEffect = false;
 			if (c->effectsInUse.count() != 0)
 			{
@@ -10489,9 +10962,9 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 					QByteArray dataP;
 					if ((Embedded) && (!Options.EmbeddedI))
 						img3.getEmbeddedProfile(fn, &dataP, &components);
-					if ((dataP.isEmpty()) || ((img.imgInfo.colorspace == ColorSpaceGray) && (hasColorEffect) && (components == 1)))
+					if ((dataP.isEmpty()) || ((imageColorSpace == ColorSpaceGray) && (hasColorEffect) && (components == 1)))
 					{
-						if (img.imgInfo.colorspace == ColorSpaceCMYK)
+						if (imageColorSpace == ColorSpaceCMYK)
 						{
 							QString profilePath;
 							if (Embedded && ScCore->InputProfilesCMYK.contains(Options.ImageProf))
@@ -10572,7 +11045,7 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 				{
 					if (ICCProfiles[Profil].components == 1)
 					{
-						if ((img.imgInfo.colorspace == ColorSpaceGray) && (hasColorEffect))
+						if ((imageColorSpace == ColorSpaceGray) && (hasColorEffect))
 						{
 							profInUse = c->doc()->cmsSettings().DefaultImageRGBProfile;
 							if (!ICCProfiles.contains(profInUse))
@@ -10618,128 +11091,117 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 				}
 			}
 			QByteArray im2;
-			ScImage img2;
-			img2.imgInfo.clipPath = "";
-			img2.imgInfo.PDSpathData.clear();
-			img2.imgInfo.layerInfo.clear();
-			img2.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
-			img2.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
-			if (c->pixm.imgInfo.type == ImageType7)
-				alphaM = false;
-			else
+			bool compAlphaAvail = false;
+			if (cacheHit)
 			{
-				bool gotAlpha = false;
-				bool pdfVer14 = (Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4);
-				gotAlpha = img2.getAlpha(fn, c->pixm.imgInfo.actualPageNumber, im2, true, pdfVer14, afl, img.width(), img.height());
-				if (!gotAlpha)
-				{
-					PDF_Error_MaskLoadFailure(fn);
-					return false;
-				}
+				im2 = prepared.cached.mask;
 				alphaM = !im2.isEmpty();
+				origWidth = prepared.cached.maskWidth;
+				origHeight = prepared.cached.maskHeight;
+				compAlphaAvail = prepared.cached.maskCompressed;
 			}
-			bool imgE = false;
-			if ((Options.UseRGB) || (Options.isGrayscale))
-				imgE = false;
 			else
 			{
-				if ((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK))
-					imgE = false;
-				else
-					imgE = true;
-			}
-			origWidth = img.width();
-			origHeight = img.height();
-			img.applyEffect(c->effectsInUse, c->doc()->PageColors, imgE);
-			if (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale())))))
-			{
-				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
-				ImInfo.sya = sy * (1.0 / ImInfo.reso);
-			}
-			PdfId maskObj = 0;
-			if (alphaM)
-			{
-				bool compAlphaAvail = false;
-				maskObj = writer.newObject();
-				writer.startObj(maskObj);
-				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-				if (Options.CompressMethod != PDFOptions::Compression_None)
+				if (bitmapFromGS)
 				{
-					QByteArray compAlpha = CompressArray(im2);
-					if (compAlpha.size() > 0)
+					if (!loadImageMask(c, fn, afl, img.width(), img.height(), im2, compAlphaAvail))
 					{
-						im2 = compAlpha;
-						compAlphaAvail = true;
+						PDF_Error_MaskLoadFailure(fn);
+						return false;
 					}
 				}
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+				else
 				{
-					PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
-					PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
-					PutDoc("/ColorSpace /DeviceGray\n");
-					PutDoc("/BitsPerComponent 8\n");
-					PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					im2 = prepared.mask;
+					compAlphaAvail = prepared.maskCompressed;
 				}
+				alphaM = !im2.isEmpty();
+				bool imgE = false;
+				if ((Options.UseRGB) || (Options.isGrayscale))
+					imgE = false;
 				else
 				{
-					PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
-					PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
-					PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
-					PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					if ((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK))
+						imgE = false;
+					else
+						imgE = true;
 				}
-				if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
-					PutDoc("/Filter /FlateDecode\n");
-				PutDoc(">>\nstream\n");
-				EncodeArrayToStream(im2, maskObj);
-				PutDoc("\nendstream");
-				writer.endObj(maskObj);
-				pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = maskObj;
-				ResCount++;
-			}
-			PdfId imageObj = writer.newObject();
-			writer.startObj(imageObj);
-			PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-			PutDoc("/Width "+Pdf::toPdf(img.width())+"\n");
-			PutDoc("/Height "+Pdf::toPdf(img.height())+"\n");
-			enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
- 			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
-			bool exportToCMYK = false, exportToGrayscale = false, jpegUseOriginal = false;
-			if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
+				origWidth = img.width();
+				origHeight = img.height();
+				img.applyEffect(c->effectsInUse, c->doc()->PageColors, imgE);
+			}
+			if (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale())))))
 			{
-				exportToGrayscale = Options.isGrayscale;
-				if (exportToGrayscale)
-					exportToCMYK      = !Options.isGrayscale;
-				else
-					exportToCMYK      = !Options.UseRGB;
+				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
+				ImInfo.sya = sy * (1.0 / ImInfo.reso);
 			}
-			if (c->OverrideCompressionMethod)
-				compress_method = cm = (enum PDFOptions::PDFCompression) c->CompressionMethodIndex;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && (c->effectsInUse.count() == 0))
+ 			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
+			bool jpegUseOriginal = false;
+			// Fixme: outType variable should be set directly in the if/else maze below.
+			ColorSpaceEnum outType;
+			if (cacheHit)
 			{
-				compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
-				cm = compress_method;
+				cm = static_cast<PDFOptions::PDFCompression>(prepared.cached.compression);
+				outType = static_cast<ColorSpaceEnum>(prepared.cached.outType);
 			}
-			if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
+			else
 			{
-				if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))))
+				enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
+				bool exportToCMYK = false, exportToGrayscale = false;
+				if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
 				{
-					// #12961 : we must not rely on PDF viewers taking exif infos into account
-					// So if JPEG orientation is non default, do not use the original file
-					jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
-					cm = PDFOptions::Compression_JPEG;
+					exportToGrayscale = Options.isGrayscale;
+					if (exportToGrayscale)
+						exportToCMYK      = !Options.isGrayscale;
+					else
+						exportToCMYK      = !Options.UseRGB;
 				}
-				// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
-				// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
-				// amongst which photoshop and illustrator
-				/*else if (((!Options.UseRGB) && (!Options.isGrayscale) && (!Options.UseProfiles2)) && (cm== 0) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceCMYK) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))) && (!img.imgInfo.progressive))
+				if (c->OverrideCompressionMethod)
+					compress_method = cm = (enum PDFOptions::PDFCompression) c->CompressionMethodIndex;
+				if (img.imgInfo.colorspace == ColorSpaceMonochrome && (c->effectsInUse.count() == 0))
 				{
-					jpegUseOriginal = false;
-					exportToCMYK = true;
-					cm = PDFOptions::Compression_JPEG;
-				}*/
+					compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
+					cm = compress_method;
+				}
+				if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
+				{
+					if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))))
+					{
+						// #12961 : we must not rely on PDF viewers taking exif infos into account
+						// So if JPEG orientation is non default, do not use the original file
+						jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
+						cm = PDFOptions::Compression_JPEG;
+					}
+					// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
+					// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
+					// amongst which photoshop and illustrator
+					/*else if (((!Options.UseRGB) && (!Options.isGrayscale) && (!Options.UseProfiles2)) && (cm== 0) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceCMYK) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))) && (!img.imgInfo.progressive))
+					{
+						jpegUseOriginal = false;
+						exportToCMYK = true;
+						cm = PDFOptions::Compression_JPEG;
+					}*/
+					else
+					{
+						if (compress_method == PDFOptions::Compression_JPEG)
+						{
+							if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+							{
+								exportToGrayscale = Options.isGrayscale;
+								if (exportToGrayscale)
+									exportToCMYK      = !Options.isGrayscale;
+								else
+									exportToCMYK      = !Options.UseRGB;
+							}
+							cm = PDFOptions::Compression_JPEG;
+						}
+						else
+							cm = PDFOptions::Compression_ZIP;
+					}
+				}
 				else
 				{
-					if (compress_method == PDFOptions::Compression_JPEG)
+					if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
 					{
 						if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
 						{
@@ -10750,116 +11212,193 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 								exportToCMYK      = !Options.UseRGB;
 						}
 						cm = PDFOptions::Compression_JPEG;
+						/*if (compress_method == PDFOptions::Compression_Auto)
+						{
+							QFileInfo fi(tmpFile);
+							if (fi.size() < im.size())
+							{
+								im.resize(0);
+								if (!loadRawBytes(tmpFile, im))
+									return false;
+								cm = PDFOptions::Compression_JPEG;
+							}
+							else
+								cm = PDFOptions::Compression_ZIP;
+						}*/
 					}
-					else
-						cm = PDFOptions::Compression_ZIP;
 				}
+				if ((hasGrayProfile) && (doc.HasCMS) && (Options.UseProfiles2) && (!hasColorEffect))
+					exportToGrayscale = true;
+				if (img.imgInfo.colorspace == ColorSpaceMonochrome && c->effectsInUse.count() == 0)
+					outType = ColorSpaceMonochrome;
+				else
+					outType = getOutputType(exportToGrayscale, exportToCMYK);
+			}
+			int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
+			if (c->OverrideCompressionQuality)
+				jpegUseOriginal = false;
+			int inte2 = Intent;
+			if (Options.EmbeddedI)
+				inte2 = Options.Intent2;
+			int imageWidth = cacheHit ? prepared.cached.width : img.width();
+			int imageHeight = cacheHit ? prepared.cached.height : img.height();
+			QByteArray imageData;
+			QByteArray contentHash;
+			if (cacheHit)
+			{
+				imageData = prepared.cached.data;
+				contentHash = prepared.cached.contentHash;
+			}
+			else if (encodeToArray)
+			{
+				imageData = EncodeImageToArray(img, fn, cm, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
+				if (imageData.isEmpty())
+				{
+					PDF_Error_ImageWriteFailure(fn);
+					return false;
+				}
+				// everything written to the image and mask objects
+				QByteArray dictionary;
+				QDataStream ds(&dictionary, QIODevice::WriteOnly);
+				ds << imageWidth << imageHeight << qint32(outType) << qint32(cm) << profInUse << inte2 << avoidPDFXOutputIntentProf;
+				ds << origWidth << origHeight << compAlphaAvail;
+				QCryptographicHash hash(QCryptographicHash::Md5);
+				hash.addData(dictionary);
+				hash.addData(imageData);
+				hash.addData(im2);
+				contentHash = hash.result();
+			}
+			// annotations refer to the image by ResCount, so they always get their own
+			if (!fromAN && !contentHash.isEmpty() && ImageContents.contains(contentHash))
+			{
+				const ShIm& written = ImageContents[contentHash];
+				ImInfo.ResNum = written.ResNum;
+				ImInfo.Width = written.Width;
+				ImInfo.Height = written.Height;
 			}
 			else
 			{
-				if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
+				PdfId maskObj = 0;
+				if (alphaM)
 				{
-					if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+					maskObj = writer.newObject();
+					writer.startObj(maskObj);
+					PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
 					{
-						exportToGrayscale = Options.isGrayscale;
-						if (exportToGrayscale)
-							exportToCMYK      = !Options.isGrayscale;
-						else
-							exportToCMYK      = !Options.UseRGB;
+						PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
+						PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
+						PutDoc("/ColorSpace /DeviceGray\n");
+						PutDoc("/BitsPerComponent 8\n");
+						PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
 					}
-					cm = PDFOptions::Compression_JPEG;
-					/*if (compress_method == PDFOptions::Compression_Auto)
+					else
 					{
-						QFileInfo fi(tmpFile);
-						if (fi.size() < im.size())
-						{
-							im.resize(0);
-							if (!loadRawBytes(tmpFile, im))
-								return false;
-							cm = PDFOptions::Compression_JPEG;
-						}
-						else
-							cm = PDFOptions::Compression_ZIP;
-					}*/
+						PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
+						PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
+						PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
+						PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					}
+					if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
+						PutDoc("/Filter /FlateDecode\n");
+					PutDoc(">>\nstream\n");
+					EncodeArrayToStream(im2, maskObj);
+					PutDoc("\nendstream");
+					writer.endObj(maskObj);
+					pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = maskObj;
+					ResCount++;
 				}
-			}
-			if ((hasGrayProfile) && (doc.HasCMS) && (Options.UseProfiles2) && (!hasColorEffect))
-				exportToGrayscale = true;
-			int bytesWritten = 0;
-			// Fixme: outType variable should be set directly in the if/else maze above.
-			ColorSpaceEnum outType;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && c->effectsInUse.count() == 0)
-				outType = ColorSpaceMonochrome;
-			else
-				outType = getOutputType(exportToGrayscale, exportToCMYK);
-			if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2) && (!avoidPDFXOutputIntentProf))
-			{
-				PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
-				PutDoc("/Intent /");
-				int inte2 = Intent;
-				if (Options.EmbeddedI)
-					inte2 = Options.Intent2;
-				static const QByteArray cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
-				PutDoc(cmsmode[inte2] + "\n");
-			}
-			else
-			{
-				switch (outType)
+				PdfId imageObj = writer.newObject();
+				writer.startObj(imageObj);
+				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+				PutDoc("/Width "+Pdf::toPdf(imageWidth)+"\n");
+				PutDoc("/Height "+Pdf::toPdf(imageHeight)+"\n");
+				int bytesWritten = 0;
+				if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2) && (!avoidPDFXOutputIntentProf))
 				{
-					case ColorSpaceMonochrome :
-					case ColorSpaceGray : PutDoc("/ColorSpace /DeviceGray\n"); break;
-					case ColorSpaceCMYK : PutDoc("/ColorSpace /DeviceCMYK\n"); break;
-					default : PutDoc("/ColorSpace /DeviceRGB\n"); break;
+					PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
+					PutDoc("/Intent /");
+					static const QByteArray cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
+					PutDoc(cmsmode[inte2] + "\n");
 				}
-			}
-			if (outType == ColorSpaceMonochrome)
-				PutDoc("/BitsPerComponent 1\n");
-			else
-				PutDoc("/BitsPerComponent 8\n");
-			PdfId lengthObj = writer.newObject();
-			PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
-			if (cm == PDFOptions::Compression_JPEG)
-				PutDoc("/Filter /DCTDecode\n");
-			else if (cm != PDFOptions::Compression_None)
-				PutDoc("/Filter /FlateDecode\n");
-//			if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
-//				PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
-			if (alphaM)
-			{
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
-					PutDoc("/SMask "+Pdf::toPdf(maskObj)+" 0 R\n");
 				else
-					PutDoc("/Mask "+Pdf::toPdf(maskObj)+" 0 R\n");
-			}
-			PutDoc(">>\nstream\n");
-			if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
-			{
-				int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
-				if (c->OverrideCompressionQuality)
-					jpegUseOriginal = false;
-				bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
-			}
-			else if (cm == PDFOptions::Compression_ZIP)
-				bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
-			else
-				bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
-			PutDoc("\nendstream");
-			writer.endObj(imageObj);
-			if (bytesWritten <= 0)
-			{
-				PDF_Error_ImageWriteFailure(fn);
-				return false;
+				{
+					switch (outType)
+					{
+						case ColorSpaceMonochrome :
+						case ColorSpaceGray : PutDoc("/ColorSpace /DeviceGray\n"); break;
+						case ColorSpaceCMYK : PutDoc("/ColorSpace /DeviceCMYK\n"); break;
+						default : PutDoc("/ColorSpace /DeviceRGB\n"); break;
+					}
+				}
+				if (outType == ColorSpaceMonochrome)
+					PutDoc("/BitsPerComponent 1\n");
+				else
+					PutDoc("/BitsPerComponent 8\n");
+				PdfId lengthObj = writer.newObject();
+				PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
+				if (cm == PDFOptions::Compression_JPEG)
+					PutDoc("/Filter /DCTDecode\n");
+				else if (cm != PDFOptions::Compression_None)
+					PutDoc("/Filter /FlateDecode\n");
+//				if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
+//					PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
+				if (alphaM)
+				{
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+						PutDoc("/SMask "+Pdf::toPdf(maskObj)+" 0 R\n");
+					else
+						PutDoc("/Mask "+Pdf::toPdf(maskObj)+" 0 R\n");
+				}
+				PutDoc(">>\nstream\n");
+				if (!imageData.isEmpty())
+				{
+					if (EncodeArrayToStream(imageData, imageObj))
+						bytesWritten = imageData.size();
+				}
+				else if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
+					bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
+				else if (cm == PDFOptions::Compression_ZIP)
+					bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
+				else
+					bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
+				PutDoc("\nendstream");
+				writer.endObj(imageObj);
+				if (bytesWritten <= 0)
+				{
+					PDF_Error_ImageWriteFailure(fn);
+					return false;
+				}
+				writer.startObj(lengthObj);
+				PutDoc("    " + Pdf::toPdf(bytesWritten));
+				writer.endObj(lengthObj);
+				pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = imageObj;
+				ImInfo.ResNum = ResCount;
+				ImInfo.Width = imageWidth;
+				ImInfo.Height = imageHeight;
+				if (!contentHash.isEmpty() && !ImageContents.contains(contentHash))
+					ImageContents.insert(contentHash, ImInfo);
 			}
-			writer.startObj(lengthObj);
-			PutDoc("    " + Pdf::toPdf(bytesWritten));
-			writer.endObj(lengthObj);
-			pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = imageObj;
-			ImInfo.ResNum = ResCount;
-			ImInfo.Width = img.width();
-			ImInfo.Height = img.height();
 			ImInfo.xa = sx;
 			ImInfo.ya = sy;
 			ImInfo.RequestProps = c->pixm.imgInfo.RequestProps;
+			if (!cacheHit && !prepared.cacheKey.isEmpty())
+			{
+				prepared.cached.contentHash = contentHash;
+				prepared.cached.colorSpace = imageColorSpace;
+				prepared.cached.sxa = ImInfo.sxa;
+				prepared.cached.sya = ImInfo.sya;
+				prepared.cached.width = imageWidth;
+				prepared.cached.height = imageHeight;
+				prepared.cached.outType = outType;
+				prepared.cached.compression = cm;
+				prepared.cached.data = imageData;
+				prepared.cached.mask = alphaM ? im2 : QByteArray();
+				prepared.cached.maskWidth = origWidth;
+				prepared.cached.maskHeight = origHeight;
+				prepared.cached.maskCompressed = compAlphaAvail;
+				imageStreamCache.store(prepared.cacheKey, prepared.cached);
+			}
 		} // not embedded PDF
 		if ((c->effectsInUse.count() == 0) && (!SharedImages.contains(fn)))
 			SharedImages.insert(fn, ImInfo);
@@ -11007,8 +11546,9 @@ void PDFLibCore::PDF_End_Bookmarks()
 
 void PDFLibCore::PDF_End_Resources()
 {
-	writer.ResourcesObj = writer.newObject();
-	writer.startObj(writer.ResourcesObj);
+	// an update replaces the resources of the earlier export, which the page tree refers to
+	if (!incrementalUpdate)
+		writer.ResourcesObj = writer.newObject();
 	
 	Pdf::ResourceDictionary dict;
 	dict.XObject.unite(pageData.ImgObjects);
@@ -11036,7 +11576,12 @@ void PDFLibCore::PDF_End_Resources()
 			Lnr++;
 		}
 	}
+	// the pages which are not updated still use the resources they were written with
+	if (incrementalUpdate)
+		PdfExportIndex::mergeResources(dict, exportIndex.resources);
+	exportIndex.resources = dict;
 
+	writer.startObj(writer.ResourcesObj);
 	writer.write(dict);
 	writer.endObj(writer.ResourcesObj);
 }
@@ -11404,6 +11949,59 @@ bool PDFLibCore::PDF_End_XRefAndTrailer()
 	return closeAndCleanup();
 }
 
+bool PDFLibCore::PDF_Begin_Update(const QString& fn)
+{
+	writeEncodedStreams();
+	// the replay must number the objects as the export it appends to did
+	if (writer.objectCounter() != exportIndex.prologueCount)
+	{
+		rejectedUpdate = true;
+		return false;
+	}
+	if (!writer.openForUpdate(fn, exportIndex.objectCount, exportIndex.xrefOffset, exportIndex.fileId))
+	{
+		PDF_Error_WriteFailure();
+		return false;
+	}
+	ResCount = qMax(ResCount, exportIndex.resourceCount);
+	writer.ResourcesObj = exportIndex.resourcesObj;
+	PDF_Info(exportIndex.creationDate);
+	return true;
+}
+
+bool PDFLibCore::PDF_End_Update()
+{
+	PDF_End_Resources();
+	return PDF_End_XRefAndTrailer();
+}
+
+void PDFLibCore::saveExportIndex(const QString& fn, QList<PdfExportIndex::Page>& pages, quint64 exportRevision, PdfId prologueCount, const QByteArray& optionsKey, const QByteArray& fontsKey)
+{
+	// see prepareIncrementalUpdate()
+	if (Options.Encrypt || PDF_IsPDFX() || optionsKey.isEmpty())
+		return;
+	if (!incrementalUpdate)
+	{
+		exportIndex.fileId = writer.fileId();
+		exportIndex.creationDate = Datum;
+		exportIndex.prologueCount = prologueCount;
+		exportIndex.fullExportSize = QFileInfo(fn).size();
+	}
+	exportIndex.revisionSession = doc.revisionSession();
+	exportIndex.revision = exportRevision;
+	exportIndex.optionsKey = optionsKey;
+	exportIndex.fontsKey = fontsKey;
+	exportIndex.objectCount = writer.objectCounter();
+	exportIndex.resourcesObj = writer.ResourcesObj;
+	exportIndex.resourceCount = ResCount;
+	exportIndex.xrefOffset = writer.xrefOffset();
+	for (int i = 0; i < pages.count(); ++i)
+		pages[i].object = PageTree.KidsMap.value(pages[i].pageIndex, updatePageObjects.value(pages[i].pageIndex, 0));
+	exportIndex.pages = pages;
+	if (!exportIndex.save(fn))
+		PdfExportIndex::remove(fn);
+}
+
 void PDFLibCore::generateXMP(const QString& timeStamp)
 {
 	/*
@@ -11543,6 +12141,7 @@ void PDFLibCore::PDF_Error_InsufficientMemory()
 
 bool PDFLibCore::closeAndCleanup()
 {
+	discardEncodedStreams();
 	bool writeSucceed = writer.close(abortExport);
 	if (!writeSucceed)
 		PDF_Error_WriteFailure();
@@ -11556,6 +12155,9 @@ bool PDFLibCore::closeAndCleanup()
 	Shadings.clear();
 	Transpar.clear();
 	ICCProfiles.clear();
+	imagePrefetcher.clear();
+	ImageContents.clear();
+	imageStreamCache.prune();
 	return writeSucceed;
 }
 
@@ -12,7 +12,9 @@ for which a new license (GPL+exception) is in place.
 #include <QDataStream>
 #include <QPixmap>
 #include <QList>
+#include <QSemaphore>
 #include <QStack>
+#include <QThreadPool>
 #include <string>
 #include <vector>
 
@@ -29,11 +31,15 @@ class PDFOptions;
 class PrefsContext;
 class MultiProgressDialog;
 class ScLayer;
+class ScOperatorWriter;
 class ScText;
 
+#include "pdfexportindex.h"
+#include "pdfimagestreamcache.h"
 #include "pdfoptions.h"
 #include "pdfstructs.h"
 #include "scribusstructs.h"
+#include "scimageprefetcher.h"
 #include "scimagestructs.h"
 #include "tableborder.h"
 
@@ -62,6 +68,8 @@ class PDFLibCore : public QObject
 	Q_OBJECT
 
 friend class PdfPainter;
+friend class PdfStreamEncodeTask;
+friend class PdfImagePrefetchJob;
 
 public:
 	explicit PDFLibCore(ScribusDoc & docu);
@@ -70,6 +78,8 @@ public:
 
 	const QString& errorMessage(void) const;
 	bool  exportAborted(void) const;
+	/// true if an incremental update was given up before the file was touched, a new export writes the whole file
+	bool  updateRejected(void) const;
 
 private:
 	struct ShIm
@@ -88,12 +98,25 @@ private:
 		QMap<int, ImageLoadRequest> RequestProps;
 	};
 
+	/// a stream object whose contents are compressed and encrypted on the thread pool
+	struct EncodedStream
+	{
+		PdfId objId;
+		QByteArray data;
+		// released when data holds the encoded contents
+		QSemaphore finished;
+	};
+
+	/// a raster image loaded for PDF_Image(), on the thread pool of imagePrefetcher if it was prefetched
+	struct PreparedImage;
+
 	bool PDF_IsPDFX();
 	bool PDF_IsPDFX(PDFOptions::PDFVersion ver);
 
 	bool PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, const QMap<QString, QMap<uint, FPointArray> >& DocFonts, BookMView* vi);
 	void PDF_Begin_Catalog();
 	void PDF_Begin_MetadataAndEncrypt();
+	void PDF_Info(const QByteArray& creationDate);
 	QMap<QString, QMap<uint, FPointArray> >
 	     PDF_Begin_FindUsedFonts(SCFonts &AllFonts, const QMap<QString, QMap<uint, FPointArray> >& DocFonts);
 	void PDF_Begin_WriteUsedFonts(SCFonts &AllFonts, const QMap<QString, QMap<uint, FPointArray> >& ReallyUsed);
@@ -138,6 +161,17 @@ private:
 	bool PDF_End_XRefAndTrailer();
 	bool closeAndCleanup();
 
+	/// the pages of pageNs with the items shown on them, see PdfExportIndex::Page
+	QList<PdfExportIndex::Page> scanExportPages(const std::vector<int>& pageNs);
+	QByteArray exportOptionsKey() const;
+	QByteArray exportFontsKey(const QMap<QString, QMap<uint, FPointArray> >& usedFonts) const;
+	/// loads exportIndex and returns true if the pages changed since the export it describes can be appended to fn
+	bool prepareIncrementalUpdate(const QString& fn, const QList<PdfExportIndex::Page>& pages, const QByteArray& optionsKey, const QByteArray& fontsKey, std::vector<int>& changedPages);
+	/// switches the writer from replaying the prologue and master pages to appending to fn
+	bool PDF_Begin_Update(const QString& fn);
+	bool PDF_End_Update();
+	void saveExportIndex(const QString& fn, QList<PdfExportIndex::Page>& pages, quint64 exportRevision, PdfId prologueCount, const QByteArray& optionsKey, const QByteArray& fontsKey);
+
 	void PDF_Error(const QString& errorMsg);
 	void PDF_Error_WriteFailure();
 	void PDF_Error_ImageLoadFailure(const QString& fileName);
@@ -155,6 +189,17 @@ private:
 	int     WriteImageToStream(ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal);
 	int     WriteJPEGImageToStream(ScImage& image, const QString& fn, PdfId ObjNum, int quality, ColorSpaceEnum format, bool sameFile, bool precal);
 	int     WriteFlateImageToStream(ScImage& image, PdfId ObjNum, ColorSpaceEnum format, bool precal);
+	/// encodes the stream of image like the Write*ImageToStream() functions, but into a byte array
+	QByteArray EncodeImageToArray(ScImage& image, const QString& fn, PDFOptions::PDFCompression cm, int quality, ColorSpaceEnum format, bool sameFile, bool precal);
+	/// the key of the stream of an image in imageStreamCache, empty if the image file can't be read
+	QByteArray imageStreamKey(PageItem* c, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const;
+	/// loads a raster image or its stream from imageStreamCache, may be called from the threads of imagePrefetcher
+	void prepareImage(PageItem* c, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent, PreparedImage& prepared) const;
+	/// the soft mask or mask of an image, compressed if the options ask for it
+	bool loadImageMask(PageItem* c, const QString& fn, int resolution, int width, int height, QByteArray& mask, bool& compressed) const;
+	/// adds the images of the pages in pageNs and of their master pages to imagePrefetcher
+	void prefetchImages(const std::vector<int>& pageNs, const QMap<int, int>& usedMasters);
+	void updateImagePrefetchProgress();
 
 //	void    CalcOwnerKey(const QString & Owner, const QString & User);
 //	void    CalcUserKey(const QString & User, int Permission);
@@ -163,6 +208,8 @@ private:
 	QByteArray SetClipPath(PageItem *ite, bool poly = true);
 	QByteArray SetClipPathArray(FPointArray *ite, bool poly = true);
 	QByteArray SetClipPathImage(PageItem *ite);
+	/// appends the operators drawing path to out, poly closes subpaths ending at their start
+	void       writePath(ScOperatorWriter& out, const FPointArray& path, bool poly = true);
 
 	QByteArray SetImagePathAndClip(PageItem *item);
 	QByteArray SetPathAndClip(PageItem *item);
@@ -192,6 +239,13 @@ private:
 //	uint       newObject() { return ObjCounter++; }
 	uint       WritePDFStream(const QByteArray& cc);
 	uint       WritePDFStream(const QByteArray& cc, PdfId objId);
+	/// same as WritePDFStream(), but the stream is encoded on the thread pool and written by writeEncodedStreams()
+	void       WritePDFStreamLater(const QByteArray& cc, PdfId objId);
+	/// writes the streams of WritePDFStreamLater() in the order they were queued, except the last keep ones
+	void       writeEncodedStreams(int keep = 0);
+	void       discardEncodedStreams();
+	QByteArray encodeStream(const QByteArray& cc, PdfId objId);
+	void       writeStreamObject(const QByteArray& encoded, PdfId objId);
 	uint       WritePDFString(const QString& cc);
 	uint       WritePDFString(const QString& cc, PdfId objId);
 	void       writeXObject(uint objNr, QByteArray dictionary, QByteArray stream);
@@ -256,6 +310,9 @@ private:
 	BookMView* Bvie;
 	//int Dokument;
 	QMap<QString,ShIm> SharedImages;
+	/// images written by this export by the hash of their stream and dictionary, see PdfImageStreamCache::Entry::contentHash
+	QHash<QByteArray,ShIm> ImageContents;
+	PdfImageStreamCache imageStreamCache;
 	QList<PdfDest> NamedDest;
 	QList<PdfId> CalcFields;
 	Pdf::ResourceMap Patterns;
@@ -295,6 +352,15 @@ private:
 	QByteArray xmpPacket;
 	QStack<QPointF> groupStackPos;
 	QStack<QPointF> patternStackPos;
+	QThreadPool m_streamPool;
+	QList<EncodedStream*> m_encodedStreams;
+	ScImagePrefetcher imagePrefetcher;
+	PdfExportIndex exportIndex;
+	/// the export appends the changed pages to the file described by exportIndex
+	bool incrementalUpdate;
+	bool rejectedUpdate;
+	/// page objects of the earlier export by page index, reused by the pages of an update
+	QMap<int, PdfId> updatePageObjects;
 
 protected slots:
 	void cancelRequested();
@@ -136,6 +136,8 @@ public:
 	bool UseSpotColors;
 	bool doMultiFile;
 	bool openAfterExport;
+	/// appends the pages changed since the last export to the existing file, see PdfExportIndex
+	bool incrementalUpdate;
 	QMap<QString,LPIData> LPISettings;
 	QString SolidProf;
 	int  SComp;
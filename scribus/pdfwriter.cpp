@@ -9,11 +9,20 @@ for which a new license (GPL+exception) is in place.
 
 #include "pdfwriter.h"
 #include "rc4.h"
+#include "scoperatorwriter.h"
 #include "scstreamfilter_rc4.h"
 #include "util.h"
 
 namespace Pdf
 {
+	/// swallows what is written to it, see Writer::openDiscarding()
+	class DiscardDevice : public QIODevice
+	{
+	protected:
+		qint64 readData(char*, qint64) { return -1; }
+		qint64 writeData(const char*, qint64 len) { return len; }
+	};
+
 
 	
 	bool isWhiteSpace(char c)
@@ -331,7 +340,7 @@ namespace Pdf
 	
 	QByteArray toPdf(double v)
 	{
-		return QByteArray::number(v, 'f');
+		return ScOperatorWriter::toByteArray(v, 6);
 	}
 	
 	QByteArray toObjRef(PdfId id)
@@ -494,6 +503,9 @@ namespace Pdf
 		
 		m_ObjCounter = 0;
 		m_CurrentObj = 0;
+		m_XRefOffset = 0;
+		m_UpdateStart = 0;
+		m_PrevXRef = 0;
 		
 		m_KeyLen = 5;
 		m_KeyGen.resize(32);
@@ -524,6 +536,34 @@ namespace Pdf
 	}
 	
 	
+	bool Writer::openDiscarding()
+	{
+		m_Discard.reset(new DiscardDevice());
+		if (!m_Discard->open(QIODevice::WriteOnly))
+			return false;
+		m_outStream.setDevice(m_Discard.data());
+		m_ObjCounter = 4;
+		return true;
+	}
+	
+	
+	bool Writer::openForUpdate(const QString& fn, PdfId objectCount, qint64 prevXref, const QByteArray& fileId)
+	{
+		m_Spool.setFileName(fn);
+		if (!m_Spool.open(QIODevice::ReadWrite) || !m_Spool.seek(m_Spool.size()))
+			return false;
+		m_outStream.setDevice(&m_Spool);
+		m_Discard.reset();
+		m_UpdateStart = m_Spool.size();
+		m_PrevXRef = prevXref;
+		m_OriginalFileID = fileId;
+		// the xref section of the update lists the objects written from now on
+		m_XRef.clear();
+		m_ObjCounter = qMax(m_ObjCounter, objectCount);
+		return true;
+	}
+	
+	
 	ScStreamFilter* Writer::openStreamFilter(bool encrypted, PdfId objId)
 	{
 		if (encrypted)
@@ -542,6 +582,12 @@ namespace Pdf
 	{
 		bool result = (m_Spool.error() == QFile::NoError);
 
+		if ((m_UpdateStart > 0) && (abortExport || !result))
+		{
+			m_Spool.resize(m_UpdateStart);
+			m_Spool.close();
+			return result;
+		}
 		m_Spool.close();
 		if (abortExport || !result)
 		{
@@ -596,7 +642,7 @@ namespace Pdf
 	}
 	
 	
-	QByteArray Writer::encryptBytes(const QByteArray& in, PdfId ObjNum)
+	QByteArray Writer::encryptBytes(const QByteArray& in, PdfId ObjNum) const
 	{
 		rc4_context_t rc4;
 		QByteArray result(in.length(), ' ');
@@ -609,7 +655,7 @@ namespace Pdf
 		return result;
 	}
 	
-	QByteArray Writer::ComputeRC4Key(PdfId ObjNum)
+	QByteArray Writer::ComputeRC4Key(PdfId ObjNum) const
 	{
 		int dlen = 0;
 		QByteArray data(10, ' ');
@@ -617,7 +663,7 @@ namespace Pdf
 			data.resize(21);
 		for (int cd = 0; cd < m_KeyLen; ++cd)
 		{
-			data[cd] = m_EncryKey[cd];
+			data[cd] = m_EncryKey.at(cd);
 			dlen++;
 		}
 		data[dlen++] = ObjNum;
@@ -769,6 +815,12 @@ namespace Pdf
 	{
 		QByteArray tmp;
 		uint StX = bytesWritten();
+		m_XRefOffset = StX;
+		if (m_UpdateStart > 0)
+		{
+			writeUpdateXrefAndTrailer();
+			return;
+		}
 		write("xref\n");
 		write("0 "+Pdf::toPdf(m_ObjCounter)+"\n");
 		//write("0000000000 65535 f \n");
@@ -802,6 +854,45 @@ namespace Pdf
 		write(Pdf::toPdf(StX)+"\n%%EOF\n");
 	}
 	
+	void Writer::writeUpdateXrefAndTrailer()
+	{
+		QByteArray tmp;
+		write("xref\n");
+		// one subsection for each run of consecutive objects the update wrote
+		int a = 1;
+		while (a < m_XRef.count())
+		{
+			if (m_XRef[a] <= 0)
+			{
+				++a;
+				continue;
+			}
+			int count = 1;
+			while ((a + count < m_XRef.count()) && (m_XRef[a + count] > 0))
+				++count;
+			write(Pdf::toPdf(a) + " " + Pdf::toPdf(count) + "\n");
+			for (int b = a; b < a + count; ++b)
+			{
+				tmp.setNum(m_XRef[b]);
+				while (tmp.length()< 10)
+				{
+					tmp.prepend('0');
+				}
+				write(tmp);
+				write(" 00000 n \n");
+			}
+			a += count;
+		}
+		write("trailer\n<<\n/Size "+Pdf::toPdf(m_ObjCounter)+"\n");
+		write("/Prev "+Pdf::toPdf(m_PrevXRef)+"\n");
+		QByteArray IDs ="";
+		for (uint cl = 0; cl < 16; ++cl)
+			IDs += (m_FileID[cl]);
+		write("/Root 1 0 R\n/Info 2 0 R\n/ID ["+Pdf::toHexString(m_OriginalFileID)+Pdf::toHexString(IDs)+"]\n");
+		write(">>\nstartxref\n");
+		write(Pdf::toPdf(m_XRefOffset)+"\n%%EOF\n");
+	}
+	
 	
 	void Writer::write(const QByteArray& bytes)
 	{
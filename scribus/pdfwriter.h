@@ -15,6 +15,7 @@
 #include <QDateTime>
 #include <QList>
 #include <QRect>
+#include <QScopedPointer>
 #include <QString>
 
 #include "pdfoptions.h"
@@ -80,7 +81,7 @@ namespace Pdf
 	QByteArray toPdf(qulonglong v);
 	
 	/**
-	 Cf. PDF32000-2008, 7.3.3
+	 with six digits after the decimal point at most, cf. PDF32000-2008, 7.3.3
 	 */
 	QByteArray toPdf(double v);
 	
@@ -160,25 +161,39 @@ public:
 	
 	// file handling
 	bool open (const QString& filename);
+	/// numbers the objects as open() does but drops the output, to rebuild the state of an earlier export
+	bool openDiscarding();
+	/**
+	 appends an incremental update to filename, cf. PDF32000-2008, 7.5.6. New objects are numbered
+	 from objectCount on and the trailer links to the xref section at prevXref. Closing an aborted
+	 update restores the file.
+	 */
+	bool openForUpdate(const QString& filename, PdfId objectCount, qint64 prevXref, const QByteArray& fileId);
 	QDataStream& getOutStream() { return m_outStream; }
 	bool close(bool aborted);
-	qint64 bytesWritten() { return m_Spool.pos(); }
+	qint64 bytesWritten() { return m_outStream.device()->pos(); }
 	
 	// encryption
 	void setFileId(const QByteArray& id);
+	/// the first part of the file identifier, which updates keep
+	QByteArray fileId() const { return m_OriginalFileID.isEmpty() ? m_FileID : m_OriginalFileID; }
 	void setEncryption(bool keylen16, const QByteArray& ownerKey, const QByteArray& userKey, int permissions);
-	QByteArray encryptBytes(const QByteArray& in, PdfId objNum);
+	// const and thread-safe once the encryption has been set up
+	QByteArray encryptBytes(const QByteArray& in, PdfId objNum) const;
 	
-	QByteArray ComputeRC4Key(PdfId ObjNum);
+	QByteArray ComputeRC4Key(PdfId ObjNum) const;
 private:
 	void CalcOwnerKey(const QByteArray & Owner, const QByteArray & User);
 	void CalcUserKey(const QByteArray & User, int Permission);
 	QByteArray FitKey(const QByteArray & pass);
+	void writeUpdateXrefAndTrailer();
 public:
 	
 	// writing
 	void writeHeader(PDFOptions::PDFVersion vers);
 	void writeXrefAndTrailer();
+	/// position of the xref section written last
+	qint64 xrefOffset() const { return m_XRefOffset; }
 	void write(const QByteArray& bytes);
 	void write(const Pdf::ResourceDictionary& dict);
 	void write(const PdfFont font);
@@ -221,14 +236,20 @@ private:
 	PdfId m_CurrentObj;
 	
 	QFile m_Spool;
+	QScopedPointer<QIODevice> m_Discard;
 	QDataStream m_outStream;
 	
 	QList<qint64> m_XRef;
+	qint64 m_XRefOffset;
+	// size of the file before an update and its last xref section, 0 when writing a new file
+	qint64 m_UpdateStart;
+	qint64 m_PrevXRef;
 	
 	QByteArray m_KeyGen;
 	QByteArray m_OwnerKey;
 	QByteArray m_UserKey;
 	QByteArray m_FileID;
+	QByteArray m_OriginalFileID;
 	QByteArray m_EncryKey;
 	int m_KeyLen;
 
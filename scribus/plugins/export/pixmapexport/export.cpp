@@ -18,9 +18,15 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "scraction.h"
+#include "ui/multiprogressdialog.h"
 #include "ui/scmwmenumanager.h"
 #include "util.h"
 #include "commonstrings.h"
+#include "prefscontext.h"
+#include "prefsfile.h"
+#include "prefsmanager.h"
+#include "scpageimageexporter.h"
+#include "scpagerenderer.h"
 #include "scpaths.h"
 
 int scribusexportpixmap_getPluginAPIVersion()
@@ -115,6 +121,7 @@ bool PixmapExportPlugin::run(ScribusDoc* doc, QString target)
 		ex->exportDir   = QDir::fromNativeSeparators(dia->outputDirectory->text());
 		ex->bitmapType  = dia->bitmapType->currentText();
 		ex->filenamePrefix = dia->prefixLineEdit->text();
+		ex->pagesInFlight = PrefsManager::instance()->prefsFile->getPluginContext("pixmapexport")->getInt("PagesInFlight", 0);
 
 		// check availability of the destination
 		QFileInfo fi(ex->exportDir);
@@ -162,6 +169,8 @@ ExportBitmap::ExportBitmap()
 	exportDir = QDir::currentPath();
 	bitmapType = QString("png");
 	overwrite = false;
+	pagesInFlight = 0;
+	m_progressDialog = nullptr;
 }
 
 QString ExportBitmap::getFileName(ScribusDoc* doc, uint pageNr)
@@ -173,25 +182,37 @@ ExportBitmap::~ExportBitmap()
 {
 }
 
+bool ExportBitmap::confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single)
+{
+	if (!QFile::exists(fileName) || overwrite)
+		return true;
+	QString fn = QDir::toNativeSeparators(fileName);
+//	QApplication::restoreOverrideCursor();
+	QApplication::changeOverrideCursor(Qt::ArrowCursor);
+	uint over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
+			fn +"\n"+ tr("exists already. Overwrite?"),
+			// hack for multiple overwriting (petr) 
+			(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
+			QMessageBox::NoButton,	// GUI default
+			QMessageBox::YesToAll);	// batch default
+	QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
+	if (over == QMessageBox::YesToAll)
+		overwrite = true;
+	return (over == QMessageBox::Yes || over == QMessageBox::YesToAll);
+}
+
 bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single = true)
 {
-	uint over   = 0;
-	bool saved = false, doFileSave = true;
+	bool saved = false;
 	QString fileName(getFileName(doc, pageNr));
 
 	if (!doc->Pages->at(pageNr))
 		return false;
 	ScPage* page = doc->Pages->at(pageNr);
 
-	/* a little magic here - I need to compute the "maxGr" value...
-	* We need to know the right size of the page for landscape,
-	* portrait and user defined sizes.
-	*/
-	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
-	PageToPixmapFlags flags;
-	if (background)
-		flags |= Pixmap_DrawBackground;
-	QImage im(doc->view()->PageToPixmap(pageNr, qRound(pixmapSize * enlargement * (pageDPI / 72.0) / 100.0), flags));
+	ScPageRenderer renderer(doc);
+	renderer.prepare(QList<ScPage*>() << page);
+	QImage im(renderer.render(page, pageDPI * enlargement / 100.0, background ? ScPageRenderer::DrawBackground : ScPageRenderer::NoFlags));
 	if (im.isNull())
 	{
 		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
@@ -201,24 +222,7 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, boo
 	int dpm = qRound(100.0 / 2.54 * pageDPI);
 	im.setDotsPerMeterY(dpm);
 	im.setDotsPerMeterX(dpm);
-	if (QFile::exists(fileName) && !overwrite)
-	{
-		doFileSave = false;
-		QString fn = QDir::toNativeSeparators(fileName);
-//		QApplication::restoreOverrideCursor();
-		QApplication::changeOverrideCursor(Qt::ArrowCursor);
-		over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
-				fn +"\n"+ tr("exists already. Overwrite?"),
-				// hack for multiple overwriting (petr) 
-				(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
-				QMessageBox::NoButton,	// GUI default
-				QMessageBox::YesToAll);	// batch default
-		QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
-		if (over == QMessageBox::Yes || over == QMessageBox::YesToAll)
-			doFileSave = true;
-		if (over == QMessageBox::YesToAll)
-			overwrite = true;
-	}
+	bool doFileSave = confirmOverwrite(doc, fileName, single);
 	if (doFileSave)
 		saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
 	if (!saved && doFileSave)
@@ -236,12 +240,60 @@ bool ExportBitmap::exportCurrent(ScribusDoc* doc,  bool background)
 
 bool ExportBitmap::exportInterval(ScribusDoc* doc, std::vector<int> &pageNs, bool background)
 {
-	doc->scMW()->mainWindowProgressBar->setMaximum(pageNs.size());
+	// existing files are confirmed up front, a refused one ends the export there as before
+	QList<int> pageNumbers;
+	QStringList fileNames;
+	bool refused = false;
 	for (uint a = 0; a < pageNs.size(); ++a)
 	{
-		doc->scMW()->mainWindowProgressBar->setValue(a);
-		if (!exportPage(doc, pageNs[a]-1, background, false))
-			return false;
+		QString fileName(getFileName(doc, pageNs[a] - 1));
+		if (!confirmOverwrite(doc, fileName, false))
+		{
+			refused = true;
+			break;
+		}
+		pageNumbers.append(pageNs[a] - 1);
+		fileNames.append(fileName);
 	}
-	return true;
+	if (pageNumbers.isEmpty())
+		return !refused;
+
+	ScPageImageExporter exporter(doc);
+	exporter.setFormat(bitmapType);
+	exporter.setResolution(pageDPI, enlargement / 100.0);
+	exporter.setQuality(quality);
+	exporter.setRenderFlags(background ? ScPageRenderer::DrawBackground : ScPageRenderer::NoFlags);
+	if (pagesInFlight > 0)
+		exporter.setPagesInFlight(pagesInFlight);
+
+	// the dialog is modal, so the document can't be changed while pages are rendered
+	m_progressDialog = new MultiProgressDialog(tr("Save as Image"), CommonStrings::tr_Cancel, doc->scMW());
+	m_progressDialog->setModal(true);
+	m_progressDialog->setOverallTotalSteps(pageNumbers.count());
+	m_progressDialog->setOverallProgress(0);
+	m_progressDialog->show();
+	connect(m_progressDialog, SIGNAL(canceled()), &exporter, SLOT(cancel()));
+	connect(&exporter, SIGNAL(progress(int,int)), this, SLOT(exportProgress(int,int)));
+	// the canvas draws master page items, which are moved while they are rendered
+	doc->view()->updatesOn(false);
+	bool res = exporter.exportPages(pageNumbers, fileNames);
+	doc->view()->updatesOn(true);
+	m_progressDialog->close();
+	delete m_progressDialog;
+	m_progressDialog = nullptr;
+
+	if (!exporter.errorMessage().isEmpty())
+	{
+		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), exporter.errorMessage());
+		doc->scMW()->setStatusBarInfoText(exporter.errorMessage());
+	}
+	return res && !refused;
+}
+
+void ExportBitmap::exportProgress(int done, int total)
+{
+	if (m_progressDialog == nullptr)
+		return;
+	m_progressDialog->setOverallProgress(done, total);
+	qApp->processEvents();
 }
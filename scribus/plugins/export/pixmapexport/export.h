@@ -13,6 +13,7 @@ for which a new license (GPL+exception) is in place.
 #include <loadsaveplugin.h>
 #include <vector>
 
+class MultiProgressDialog;
 class ScrAction;
 
 class PLUGIN_API PixmapExportPlugin : public ScActionPlugin
@@ -63,6 +64,8 @@ public:
 	bool overwrite;
 	/*! \brief Prefix for filenames */
 	QString filenamePrefix;
+	/*! \brief Maximum number of pages rendered but not written yet, 0 for the default */
+	int pagesInFlight;
 
 	/*! \brief Exports only the actual page
 	\retval bool true on success */
@@ -71,9 +74,20 @@ public:
 	\param pageNs interval of the page numbers
 	\retval true on success */
 	bool exportInterval(ScribusDoc* doc, std::vector<int> &pageNs, bool background);
+private slots:
+	/*! \brief updates the progress dialog while pages are exported */
+	void exportProgress(int done, int total);
+
 private:
+	MultiProgressDialog* m_progressDialog;
+
 	/*! \brief create specified filename "docfilename-005.ext" */
 	QString getFileName(ScribusDoc* doc, uint pageNr);
+	/*! \brief asks whether an existing file may be overwritten
+	\param single bool TRUE if only the one page is exported
+	\retval bool true if the file may be written
+	*/
+	bool confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single);
 	/*! \brief export one specified page
 	\param pageNr number of the page
 	\param single bool TRUE if only the one page is exported
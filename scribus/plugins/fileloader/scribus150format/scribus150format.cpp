@@ -3213,6 +3213,7 @@ bool Scribus150Format::readPDFOptions(ScribusDoc* doc, ScXmlStreamReader& reader
 	doc->pdfOptions().hideToolBar   = attrs.valueAsBool("hideToolBar", false);
 	doc->pdfOptions().fitWindow     = attrs.valueAsBool("fitWindow", false);
 	doc->pdfOptions().openAfterExport     = attrs.valueAsBool("openAfterExport", false);
+	doc->pdfOptions().incrementalUpdate   = attrs.valueAsBool("incrementalUpdate", false);
 	doc->pdfOptions().PageLayout    = attrs.valueAsInt("PageLayout", 0);
 	doc->pdfOptions().openAction    = attrs.valueAsString("openAction", "");
 
@@ -151,6 +151,16 @@ If the document was not saved before the name is empty.\n\
 /** Saves active document with given name */
 PyObject *scribus_getdocname(PyObject * /*self*/);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_getdocrevision__doc__,
+QT_TR_NOOP("getDocRevision() -> integer\n\
+\n\
+Returns the revision of the document. It grows with every change of the\n\
+document, so scripts can compare it to tell if the document has been changed.\n\
+"));
+/** Returns the revision of the active document */
+PyObject *scribus_getdocrevision(PyObject * /*self*/);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_savedocas__doc__,
 QT_TR_NOOP("saveDocAs(\"name\")\n\
@@ -9,6 +9,20 @@ for which a new license (GPL+exception) is in place.
 #include "scribuscore.h"
 #include "scribusdoc.h"
 
+/* getObjectRevision(name) */
+PyObject *scribus_getobjectrevision(PyObject* /* self */, PyObject* args)
+{
+	char *Name = const_cast<char*>("");
+	if (!PyArg_ParseTuple(args, "|es", "utf-8", &Name))
+		return nullptr;
+	if(!checkHaveDocument())
+		return nullptr;
+	PageItem *item = GetUniqueItem(QString::fromUtf8(Name));
+	if (item == nullptr)
+		return nullptr;
+	return PyLong_FromUnsignedLongLong(item->revision());
+}
+
 /* getObjectType(name) */
 PyObject *scribus_getobjecttype(PyObject* /* self */, PyObject* args)
 {
@@ -399,7 +413,8 @@ PV */
 void cmdgetpropdocwarnings()
 {
 	QStringList s;
-	s << scribus_getobjecttype__doc__ << scribus_getfillcolor__doc__
+	s << scribus_getobjecttype__doc__ << scribus_getobjectrevision__doc__
+	  << scribus_getfillcolor__doc__
 	  << scribus_getcustomlinestyle__doc__
 	  << scribus_getfilltrans__doc__ << scribus_getfillblend__doc__ 
 	  << scribus_getlinecolor__doc__ << scribus_getlinetrans__doc__ 
@@ -21,6 +21,16 @@ Get type of object \"name\" as a string.\n\
 /** Get Object Type of name. */
 PyObject *scribus_getobjecttype(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_getobjectrevision__doc__,
+QT_TR_NOOP("getObjectRevision([\"name\"]) -> integer\n\
+\n\
+Returns the revision of the document object \"name\" has last been changed in.\n\
+If \"name\" is not given the currently selected item is used.\n\
+"));
+/** Get the revision of object name. */
+PyObject *scribus_getobjectrevision(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_getfillcolor__doc__,
 QT_TR_NOOP("getFillColor([\"name\"]) -> string\n\
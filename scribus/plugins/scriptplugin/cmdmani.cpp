@@ -387,6 +387,12 @@ PyObject *scribus_groupobj(PyObject* /* self */, PyObject* args)
 				delete tempSelection;
 				return nullptr;
 			}
+			if (ic->isGroupChild())
+			{
+				PyErr_SetString(PyExc_ValueError, QObject::tr("Cannot group an item which is part of a group", "python error").toLocal8Bit().constData());
+				delete tempSelection;
+				return nullptr;
+			}
 			tempSelection->addItem (ic, true);
 		}
 		finalSelection=tempSelection;
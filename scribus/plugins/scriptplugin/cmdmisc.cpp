@@ -18,7 +18,9 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "selection.h"
 #include "fonts/scfontmetrics.h"
+#include "fonts/scglyphcache.h"
 #include "pdfoptionsio.h"
+#include "text/textshaper.h"
 
 PyObject *scribus_setredraw(PyObject* /* self */, PyObject* args)
 {
@@ -33,6 +35,20 @@ PyObject *scribus_setredraw(PyObject* /* self */, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyObject *scribus_setshapingthreads(PyObject* /* self */, PyObject* args)
+{
+	int count;
+	if (!PyArg_ParseTuple(args, "i", &count))
+		return nullptr;
+	if (count < 0)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Thread count must not be negative.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	TextShaper::setThreadCount(count);
+	Py_RETURN_NONE;
+}
+
 PyObject *scribus_fontnames(PyObject* /* self */)
 {
 	int cc2 = 0;
@@ -56,6 +72,32 @@ PyObject *scribus_fontnames(PyObject* /* self */)
 	return l;
 }
 
+PyObject *scribus_getglyphcachestats(PyObject* /* self */)
+{
+	const ScGlyphCache& cache(ScGlyphCache::instance());
+	return Py_BuildValue("{sLsLsLsisLsL}",
+			"hits", static_cast<long long>(cache.hits()),
+			"misses", static_cast<long long>(cache.misses()),
+			"evictions", static_cast<long long>(cache.evictions()),
+			"glyphs", cache.count(),
+			"bytes", static_cast<long long>(cache.bytes()),
+			"maxBytes", static_cast<long long>(cache.maxBytes()));
+}
+
+PyObject *scribus_setglyphcachesize(PyObject* /* self */, PyObject* args)
+{
+	long long bytes;
+	if (!PyArg_ParseTuple(args, "L", &bytes))
+		return nullptr;
+	if (bytes < 0)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Cache size must not be negative.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	ScGlyphCache::instance().setMaxBytes(bytes);
+	Py_RETURN_NONE;
+}
+
 PyObject *scribus_xfontnames(PyObject* /* self */)
 {
 	PyObject *l = PyList_New(PrefsManager::instance()->appPrefs.fontPrefs.AvailFonts.count());
@@ -256,6 +298,7 @@ PyObject *scribus_layervisible(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].isViewable = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -289,6 +332,7 @@ PyObject *scribus_layerprint(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].isPrintable = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -355,6 +399,7 @@ PyObject *scribus_layeroutline(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].outlineMode = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -388,6 +433,7 @@ PyObject *scribus_layerflow(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].flowControl = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -421,6 +467,7 @@ PyObject *scribus_layerblend(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].blendMode = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -454,6 +501,7 @@ PyObject *scribus_layertrans(PyObject* /* self */, PyObject* args)
 		if (ScCore->primaryMainWindow()->doc->Layers[lam].Name == QString::fromUtf8(Name))
 		{
 			ScCore->primaryMainWindow()->doc->Layers[lam].transparency = vis;
+			ScCore->primaryMainWindow()->doc->bumpLayerRevision(ScCore->primaryMainWindow()->doc->Layers[lam].ID);
 			found = true;
 			break;
 		}
@@ -685,6 +733,27 @@ PyObject *scribus_glayertrans(PyObject* /* self */, PyObject* args)
 	return PyFloat_FromDouble(i);
 }
 
+PyObject *scribus_glayerrevision(PyObject* /* self */, PyObject* args)
+{
+	char *Name = const_cast<char*>("");
+	if (!PyArg_ParseTuple(args, "es", "utf-8", &Name))
+		return nullptr;
+	if(!checkHaveDocument())
+		return nullptr;
+	if (strlen(Name) == 0)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Cannot have an empty layer name.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	const ScLayer* layer = ScCore->primaryMainWindow()->doc->Layers.layerByName(QString::fromUtf8(Name));
+	if (!layer)
+	{
+		PyErr_SetString(NotFoundError, QObject::tr("Layer not found.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	return PyLong_FromUnsignedLongLong(layer->revision);
+}
+
 PyObject *scribus_removelayer(PyObject* /* self */, PyObject* args)
 {
 //FIXME: Use the docs remove layer code
@@ -818,7 +887,9 @@ PV */
 void cmdmiscdocwarnings()
 {
 	QStringList s;
-	s << scribus_setredraw__doc__ << scribus_fontnames__doc__ 
+	s << scribus_setredraw__doc__ << scribus_setshapingthreads__doc__
+	  << scribus_fontnames__doc__ << scribus_getglyphcachestats__doc__
+	  << scribus_setglyphcachesize__doc__
 	  << scribus_xfontnames__doc__ << scribus_renderfont__doc__ 
 	  << scribus_getlayers__doc__ << scribus_setactlayer__doc__ 
 	  << scribus_getactlayer__doc__ << scribus_senttolayer__doc__ 
@@ -829,6 +900,7 @@ void cmdmiscdocwarnings()
 	  << scribus_glayerprint__doc__ << scribus_glayerlock__doc__ 
 	  << scribus_glayeroutline__doc__ << scribus_glayerflow__doc__ 
 	  << scribus_glayerblend__doc__ << scribus_glayertrans__doc__ 
+	  << scribus_glayerrevision__doc__
 	  << scribus_removelayer__doc__ << scribus_createlayer__doc__ 
 	  << scribus_getlanguage__doc__ << scribus_moveselectiontofront__doc__
 	  << scribus_moveselectiontoback__doc__ << scribus_filequit__doc__
@@ -25,6 +25,17 @@ setRedraw(True) in a finally: clause at the top level of your script.\n\
 /*! Enable/disable page redrawing. */
 PyObject *scribus_setredraw(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_setshapingthreads__doc__,
+QT_TR_NOOP("setShapingThreads(count)\n\
+\n\
+Sets the number of threads used to shape long runs of text, e.g. after\n\
+changing the font of a long story. 1 shapes all text on the main thread,\n\
+0 uses one thread per processor core, which is the default.\n\
+"));
+/*! Set the number of text shaping threads. */
+PyObject *scribus_setshapingthreads(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_fontnames__doc__,
 QT_TR_NOOP("getFontNames() -> list\n\
@@ -34,6 +45,30 @@ Returns a list with the names of all available fonts.\n\
 /*! simple list of font names. */
 PyObject *scribus_fontnames(PyObject * /*self*/);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_getglyphcachestats__doc__,
+QT_TR_NOOP("getGlyphCacheStats() -> dict\n\
+\n\
+Returns the statistics of the glyph cache shared by all fonts as a dictionary\n\
+with the keys \"hits\", \"misses\", \"evictions\", \"glyphs\", \"bytes\"\n\
+and \"maxBytes\". \"bytes\" is the estimated memory used by the cached glyph\n\
+outlines and metrics.\n\
+"));
+/*! glyph cache counters and memory use. */
+PyObject *scribus_getglyphcachestats(PyObject * /*self*/);
+
+/*! docstring */
+PyDoc_STRVAR(scribus_setglyphcachesize__doc__,
+QT_TR_NOOP("setGlyphCacheSize(bytes)\n\
+\n\
+Sets the memory limit of the glyph cache in bytes. When the cache grows beyond\n\
+it, the least recently used glyphs are dropped and loaded again when needed.\n\
+\n\
+May raise ValueError if bytes is negative.\n\
+"));
+/*! set the glyph cache memory limit. */
+PyObject *scribus_setglyphcachesize(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_xfontnames__doc__,
 QT_TR_NOOP("getXFontNames() -> list of tuples\n\
@@ -288,6 +323,18 @@ May raise ValueError if the layer name isn't acceptable.\n\
 /*! Set layer visible */
 PyObject *scribus_glayertrans(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_glayerrevision__doc__,
+QT_TR_NOOP("getLayerRevision(\"layer\") -> integer\n\
+\n\
+Returns the revision of the document the \"layer\" layer has last been changed in.\n\
+\n\
+May raise NotFoundError if the layer can't be found.\n\
+May raise ValueError if the layer name isn't acceptable.\n\
+"));
+/*! Revision of a layer */
+PyObject *scribus_glayerrevision(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_removelayer__doc__,
 QT_TR_NOOP("deleteLayer(\"layer\")\n\
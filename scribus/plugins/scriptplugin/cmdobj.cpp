@@ -495,6 +495,12 @@ PyObject *scribus_pathtext(PyObject* /* self */, PyObject* args)
 		PyErr_SetString(NotFoundError, QObject::tr("Object not found.","python error").toLocal8Bit().constData());
 		return nullptr;
 	}
+	// GetItem() also finds members of groups, which can't be joined
+	if (i->isGroupChild() || ii->isGroupChild())
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Cannot join an item which is part of a group", "python error").toLocal8Bit().constData());
+		return nullptr;
+	}
 	ScCore->primaryMainWindow()->doc->m_Selection->clear();
 	ScCore->primaryMainWindow()->doc->m_Selection->addItem(i);
 	ScCore->primaryMainWindow()->doc->m_Selection->addItem(ii);
@@ -522,6 +528,12 @@ PyObject *scribus_deleteobj(PyObject* /* self */, PyObject* args)
 	PageItem *i = GetUniqueItem(QString::fromUtf8(Name));
 	if (i == nullptr)
 		return nullptr;
+	// itemSelection_DeleteItem() skips members of groups, which GetUniqueItem() also finds
+	if (i->isGroupChild())
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Cannot delete an item which is part of a group", "python error").toLocal8Bit().constData());
+		return nullptr;
+	}
 	ScCore->primaryMainWindow()->doc->m_Selection->clear();
 	ScCore->primaryMainWindow()->doc->m_Selection->addItem(i);
 	ScCore->primaryMainWindow()->doc->itemSelection_DeleteItem();
@@ -178,6 +178,7 @@ to that object. If \"name\" is not given Scribus will create one for you.\n\
 \n\
 May raise NameExistsError if you explicitly pass a name that's already used.\n\
 May raise NotFoundError if one or both of the named base object don't exist.\n\
+May raise ValueError if one of them is part of a group.\n\
 "));
 /** Joins 2 objects - textframe and line - into text on path.
  Uses x, y (base of the new object), name of the text frame,
@@ -190,6 +191,8 @@ QT_TR_NOOP("deleteObject([\"name\"])\n\
 \n\
 Deletes the item with the name \"name\". If \"name\" is not given the currently\n\
 selected item is deleted.\n\
+\n\
+May raise ValueError if the item is part of a group.\n\
 "));
 /** Deletes an object - if is the name given the named object is
  deleted else the active object erased. */
@@ -48,6 +48,25 @@ PyObject *scribus_pageposition(PyObject* /* self */, PyObject* args)
 	return PyInt_FromLong(static_cast<long>(ScCore->primaryMainWindow()->doc->locationOfPage(e)));
 }
 
+PyObject *scribus_getpagerevision(PyObject* /* self */, PyObject* args)
+{
+	int e = 0;
+	if (!PyArg_ParseTuple(args, "|i", &e))
+		return nullptr;
+	if(!checkHaveDocument())
+		return nullptr;
+	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
+	if (e == 0)
+		e = currentDoc->currentPageNumber() + 1;
+	e--;
+	if ((e < 0) || (e > static_cast<int>(currentDoc->Pages->count())-1))
+	{
+		PyErr_SetString(PyExc_IndexError, QObject::tr("Page number out of range.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	return PyLong_FromUnsignedLongLong(currentDoc->pageRevision(currentDoc->Pages->at(e)));
+}
+
 PyObject *scribus_savepageeps(PyObject* /* self */, PyObject* args)
 {
 	char *Name;
@@ -509,6 +528,7 @@ void cmdpagedocwarnings()
 {
 	QStringList s;
 	s << scribus_newpage__doc__        << scribus_pageposition__doc__
+	  << scribus_getpagerevision__doc__
 	  << scribus_actualpage__doc__     << scribus_redraw__doc__
 	  << scribus_savepageeps__doc__    << scribus_deletepage__doc__
 	  << scribus_gotopage__doc__       << scribus_pagecount__doc__
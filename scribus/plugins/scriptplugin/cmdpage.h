@@ -55,6 +55,19 @@ Returns the type of the Page, 0 means left Page, 1 is a middle Page and 2 is a r
 /*! Go to page */
 PyObject *scribus_pageposition(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_getpagerevision__doc__,
+QT_TR_NOOP("getPageRevision([nr]) -> integer\n\
+\n\
+Returns the revision of the document the content of page \"nr\" has last been\n\
+changed in, including the items of its master page and the layers. Page numbers\n\
+are counted from 1 upwards. If \"nr\" is not given the current page is used.\n\
+\n\
+May raise IndexError if the page number is out of range.\n\
+"));
+/*! Revision of a page */
+PyObject *scribus_getpagerevision(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_savepageeps__doc__,
 QT_TR_NOOP("savePageAsEPS(\"name\")\n\
@@ -15,6 +15,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
+#include "text/shapedtextcache.h"
 #include "util.h"
 
 
@@ -134,6 +135,25 @@ PyObject *scribus_gettextlines(PyObject* /* self */, PyObject* args)
 	return PyInt_FromLong(static_cast<long>(i->textLayout.lines()));
 }
 
+PyObject *scribus_gettextcachestats(PyObject* /* self */, PyObject* args)
+{
+	char *Name = const_cast<char*>("");
+	if (!PyArg_ParseTuple(args, "|es", "utf-8", &Name))
+		return nullptr;
+	if(!checkHaveDocument())
+		return nullptr;
+	PageItem *i = GetUniqueItem(QString::fromUtf8(Name));
+	if (i == nullptr)
+		return nullptr;
+	if (!(i->isTextFrame()) && !(i->isPathText()))
+	{
+		PyErr_SetString(WrongFrameTypeError, QObject::tr("Cannot get text cache statistics of non-text frame.","python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	const ShapedTextCache* cache = i->itemText.shapedTextCache();
+	return Py_BuildValue("(iid)", cache->hitCount(), cache->missCount(), cache->hitRate());
+}
+
 PyObject *scribus_getcolumns(PyObject* /* self */, PyObject* args)
 {
 	char *Name = const_cast<char*>("");
@@ -1280,6 +1300,7 @@ void cmdtextdocwarnings()
 	QStringList s;
 	s << scribus_getfontsize__doc__    << scribus_getfont__doc__
 	  << scribus_gettextlines__doc__   << scribus_gettextsize__doc__
+	  << scribus_gettextcachestats__doc__
 	  << scribus_getframetext__doc__   << scribus_gettext__doc__
 	  << scribus_getlinespace__doc__   << scribus_getcolumngap__doc__
 	  << scribus_getcolumns__doc__     << scribus_setboxtext__doc__
@@ -69,6 +69,18 @@ If \"name\" is not given the currently selected item is used.\n\
 /*! Get text lines */
 PyObject *scribus_gettextlines(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_gettextcachestats__doc__,
+QT_TR_NOOP("getTextCacheStats([\"name\"]) -> (hits, misses, hitrate)\n\
+\n\
+Returns how often the layout of the story of the text frame \"name\" found\n\
+its shaped paragraphs in the cache and how often it had to shape them. The\n\
+counts are totals since the story was created, the hit rate is between 0 and 1.\n\
+If \"name\" is not given the currently selected item is used.\n\
+"));
+/*! Get shaped text cache statistics */
+PyObject *scribus_gettextcachestats(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_getframetext__doc__,
 QT_TR_NOOP("getText([\"name\"]) -> string\n\
@@ -64,11 +64,7 @@ PageItem *GetItem(QString Name)
 {
 	if (!Name.isEmpty())
 	{
-		for (int a = 0; a < ScCore->primaryMainWindow()->doc->Items->count(); a++)
-		{
-			if (ScCore->primaryMainWindow()->doc->Items->at(a)->itemName() == Name)
-				return ScCore->primaryMainWindow()->doc->Items->at(a);
-		}
+		return ScCore->primaryMainWindow()->doc->getItemFromName(Name);
 	}
 	else
 	{
@@ -120,11 +116,9 @@ PageItem* getPageItemByName(QString name)
 		PyErr_SetString(PyExc_ValueError, QString("Cannot accept empty name for pageitem").toLocal8Bit().constData());
 		return nullptr;
 	}
-	for (int j = 0; j<ScCore->primaryMainWindow()->doc->Items->count(); j++)
-	{
-		if (name==ScCore->primaryMainWindow()->doc->Items->at(j)->itemName())
-			return ScCore->primaryMainWindow()->doc->Items->at(j);
-	} // for items
+	PageItem* item = ScCore->primaryMainWindow()->doc->getItemFromName(name);
+	if (item)
+		return item;
 	PyErr_SetString(NoValidObjectError, QString("Object not found").toLocal8Bit().constData());
 	return nullptr;
 }
@@ -139,12 +133,7 @@ bool ItemExists(QString name)
 {
 	if (name.length() == 0)
 		return false;
-	for (int j = 0; j<ScCore->primaryMainWindow()->doc->Items->count(); j++)
-	{
-		if (name==ScCore->primaryMainWindow()->doc->Items->at(j)->itemName())
-			return true;
-	} // for items
-	return false;
+	return ScCore->primaryMainWindow()->doc->getItemFromName(name) != nullptr;
 }
 
 /*!
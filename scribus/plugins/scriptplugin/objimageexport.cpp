@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 #include "objimageexport.h"
 
+#include <QDir>
 #include <QImageWriter>
 #include <structmember.h>
 #include <QFileInfo>
@@ -13,9 +14,11 @@ for which a new license (GPL+exception) is in place.
 
 #include "cmdutil.h"
 #include "scpage.h"
+#include "scpageimageexporter.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
+#include "util.h"
 
 typedef struct
 {
@@ -26,6 +29,7 @@ typedef struct
 	int dpi; // DPI of the bitmap
 	int scale; // how is bitmap scaled 100 = 100%
 	int quality; // quality/compression <1; 100>
+	int pagesInFlight; // pages kept in memory by savePages(), 0 = automatic
 } ImageExport;
 
 static void ImageExport_dealloc(ImageExport* self)
@@ -50,6 +54,7 @@ static PyObject * ImageExport_new(PyTypeObject *type, PyObject * /*args*/, PyObj
 		self->dpi = 72;
 		self->scale = 100;
 		self->quality = 100;
+		self->pagesInFlight = 0;
 	}
 	return (PyObject *) self;
 }
@@ -63,6 +68,7 @@ static PyMemberDef ImageExport_members[] = {
 	{const_cast<char*>("dpi"), T_INT, offsetof(ImageExport, dpi), 0, imgexp_dpi__doc__},
 	{const_cast<char*>("scale"), T_INT, offsetof(ImageExport, scale), 0, imgexp_scale__doc__},
 	{const_cast<char*>("quality"), T_INT, offsetof(ImageExport, quality), 0, imgexp_quality__doc__},
+	{const_cast<char*>("pagesInFlight"), T_INT, offsetof(ImageExport, pagesInFlight), 0, imgexp_pagesinflight__doc__},
 	{nullptr, 0, 0, 0, nullptr} // sentinel
 };
 
@@ -196,9 +202,64 @@ static PyObject *ImageExport_saveAs(ImageExport *self, PyObject *args)
 	return PyBool_FromLong(static_cast<long>(true));
 }
 
+static PyObject *ImageExport_savePages(ImageExport *self, PyObject *args)
+{
+	PyObject *pages = nullptr;
+	char *directory = nullptr;
+	char *prefix = nullptr;
+	if(!checkHaveDocument())
+		return nullptr;
+	if (!PyArg_ParseTuple(args, const_cast<char*>("Oes|es"), &pages, "utf-8", &directory, "utf-8", &prefix))
+		return nullptr;
+	QString dirName(QString::fromUtf8(directory));
+	QString filePrefix(prefix ? QString::fromUtf8(prefix) : QString());
+	PyMem_Free(directory);
+	PyMem_Free(prefix);
+
+	ScribusDoc* doc = ScCore->primaryMainWindow()->doc;
+	if (!PyList_Check(pages))
+	{
+		PyErr_SetString(PyExc_TypeError, QObject::tr("The pages must be a list of page numbers.", "python error").toLocal8Bit().constData());
+		return nullptr;
+	}
+	QList<int> pageNumbers;
+	QStringList fileNames;
+	QString extension(QString(PyString_AsString(self->type)).toLower());
+	for (Py_ssize_t i = 0; i < PyList_Size(pages); ++i)
+	{
+		long page = PyInt_AsLong(PyList_GetItem(pages, i));
+		if (PyErr_Occurred())
+			return nullptr;
+		if ((page < 1) || (page > doc->DocPages.count()))
+		{
+			PyErr_SetString(PyExc_IndexError, QObject::tr("Page number out of range: %1.","python error").arg(page).toLocal8Bit().constData());
+			return nullptr;
+		}
+		pageNumbers.append(page - 1);
+		fileNames.append(QDir::cleanPath(dirName + "/" + getFileNameByPage(doc, page - 1, extension, filePrefix)));
+	}
+
+	ScPageImageExporter exporter(doc);
+	exporter.setFormat(PyString_AsString(self->type));
+	exporter.setResolution(self->dpi, self->scale / 100.0);
+	exporter.setQuality(self->quality);
+	if (self->pagesInFlight > 0)
+		exporter.setPagesInFlight(self->pagesInFlight);
+	if (!exporter.exportPages(pageNumbers, fileNames))
+	{
+		QString error(exporter.errorMessage());
+		if (error.isEmpty())
+			error = QObject::tr("Failed to export image", "python error");
+		PyErr_SetString(ScribusException, error.toLocal8Bit().constData());
+		return nullptr;
+	}
+	return PyBool_FromLong(static_cast<long>(true));
+}
+
 static PyMethodDef ImageExport_methods[] = {
 	{const_cast<char*>("save"), (PyCFunction)ImageExport_save, METH_NOARGS, imgexp_save__doc__},
 	{const_cast<char*>("saveAs"), (PyCFunction)ImageExport_saveAs, METH_VARARGS, imgexp_saveas__doc__},
+	{const_cast<char*>("savePages"), (PyCFunction)ImageExport_savePages, METH_VARARGS, imgexp_savepages__doc__},
 	{nullptr, (PyCFunction)(0), 0, nullptr} // sentinel
 };
 
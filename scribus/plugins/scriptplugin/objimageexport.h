@@ -34,9 +34,16 @@ PyDoc_STRVAR(imgexp_quality__doc__, "Quality/compression: minimum 1 (poor), maxi
 PyDoc_STRVAR(imgexp_filename__doc__, "Filename of the image. With or without path. Read/write string.");
 PyDoc_STRVAR(imgexp_type__doc__, "Bitmap type. See allTypes list for more info. Read/write string.");
 PyDoc_STRVAR(imgexp_alltypes__doc__, "Available types. Read only list of strings.");
+PyDoc_STRVAR(imgexp_pagesinflight__doc__, "Number of pages savePages() keeps in memory at most, 0 for a default depending on the number of processors. Read/write integer.");
 
 PyDoc_STRVAR(imgexp_save__doc__, "save() -> boolean\n\nSaves image under previously set 'name'.");
 PyDoc_STRVAR(imgexp_saveas__doc__, "saveAs('filename') -> boolean\n\nSaves image as 'filename'.");
+PyDoc_STRVAR(imgexp_savepages__doc__, "savePages([pages], 'directory', ['prefix']) -> boolean\n\n\
+Saves the pages with the numbers in the list pages to 'directory', named like\n\
+'prefix-page005.png'. The document name is used if 'prefix' is not given.\n\
+Several pages are rendered and written at once.\n\
+\n\
+May raise ScribusException if a page can't be exported.");
 
 // Nest items are not needed but are here for me to exercise
 // writing complete python objects
@@ -501,6 +501,7 @@ void PrefsManager::initDefaults()
 	appPrefs.pdfPrefs.hideToolBar = false;
 	appPrefs.pdfPrefs.fitWindow = false;
 	appPrefs.pdfPrefs.openAfterExport = false;
+	appPrefs.pdfPrefs.incrementalUpdate = false;
 	appPrefs.pdfPrefs.PageLayout = PDFOptions::SinglePage;
 	appPrefs.pdfPrefs.openAction = "";
 	appPrefs.imageCachePrefs.cacheEnabled = false;
@@ -1864,6 +1865,7 @@ bool PrefsManager::WritePref(QString ho)
 	pdf.setAttribute("hideToolBar", static_cast<int>(appPrefs.pdfPrefs.hideToolBar));
 	pdf.setAttribute("fitWindow", static_cast<int>(appPrefs.pdfPrefs.fitWindow));
 	pdf.setAttribute("openAfterExport", static_cast<int>(appPrefs.pdfPrefs.openAfterExport));
+	pdf.setAttribute("incrementalUpdate", static_cast<int>(appPrefs.pdfPrefs.incrementalUpdate));
 	pdf.setAttribute("PageLayout", appPrefs.pdfPrefs.PageLayout);
 	pdf.setAttribute("OpenAction", appPrefs.pdfPrefs.openAction);
 	QMap<QString,LPIData>::Iterator itlp;
@@ -2607,6 +2609,7 @@ bool PrefsManager::ReadPref(QString ho)
 			appPrefs.pdfPrefs.hideToolBar = static_cast<bool>(dc.attribute("hideToolBar", "0").toInt());
 			appPrefs.pdfPrefs.fitWindow = static_cast<bool>(dc.attribute("fitWindow", "0").toInt());
 			appPrefs.pdfPrefs.openAfterExport = static_cast<bool>(dc.attribute("openAfterExport", "0").toInt());
+			appPrefs.pdfPrefs.incrementalUpdate = static_cast<bool>(dc.attribute("incrementalUpdate", "0").toInt());
 			appPrefs.pdfPrefs.PageLayout = dc.attribute("PageLayout", "0").toInt();
 			appPrefs.pdfPrefs.openAction = dc.attribute("OpenAction", "");
 			QDomNode PFO = DOC.firstChild();
@@ -33,6 +33,7 @@ for which a new license (GPL+exception) is in place.
 #include <QByteArray>
 #include <QRegExp>
 #include <QBuffer>
+#include <QScopedPointer>
 #include <QStack>
 
 #include "cmsettings.h"
@@ -45,6 +46,7 @@ for which a new license (GPL+exception) is in place.
 #include "scclocale.h"
 #include "sccolorengine.h"
 #include "scfonts.h"
+#include "scoperatorwriter.h"
 #include "scribusapp.h"
 #include "scribusdoc.h"
 
@@ -63,6 +65,39 @@ for which a new license (GPL+exception) is in place.
 
 using namespace TableUtils;
 
+class PSImagePrefetchJob : public ScImagePrefetcher::Job
+{
+public:
+	PSImagePrefetchJob(const PSLib* ps, PageItem* item, int step, int resolution) :
+		ScImagePrefetcher::Job(item, item->Pfile, step, qMax<qint64>(1, qint64(item->OrigW) * item->OrigH * 5)),
+		profile(item->IProfile),
+		embedded(item->UseEmbedded),
+		resolution(resolution),
+		imageLoaded(false),
+		maskLoaded(false),
+		m_ps(ps),
+		m_pageItem(item)
+	{ }
+
+	QString profile;
+	bool embedded;
+	int resolution;
+	ScImage image;
+	QByteArray mask;
+	bool imageLoaded;
+	bool maskLoaded;
+
+protected:
+	void prepare()
+	{
+		imageLoaded = m_ps->loadImage(m_pageItem, fileName(), profile, embedded, resolution, image, mask, maskLoaded);
+	}
+
+private:
+	const PSLib* m_ps;
+	PageItem* m_pageItem;
+};
+
 class PSPainter:public TextLayoutPainter
 {
 	ScribusDoc* m_Doc;
@@ -219,6 +254,7 @@ PSLib::PSLib(PrintOptions &options, bool psart, SCFonts &AllFonts, QMap<QString,
 {
 	Options = options;
 	optimization = OptimizeCompat;
+	operatorBuffer.reserve(1024);
 	usingGUI=ScCore->usingGUI();
 	abortExport=false;
 	QStringList wt;
@@ -515,8 +551,9 @@ void PSLib::WriteASCII85Bytes(const unsigned char* array, int length)
 
 QString PSLib::ToStr(double c)
 {
-	QString cc;
-	return cc.setNum(c);
+	char text[ScOperatorWriter::NumberBufferSize];
+	int length = ScOperatorWriter::formatNumber(text, c);
+	return QString::fromLatin1(text, length);
 }
 
 QString PSLib::IToStr(int c)
@@ -927,17 +964,26 @@ void PSLib::PS_end_page()
 
 void PSLib::PS_curve(double x1, double y1, double x2, double y2, double x3, double y3)
 {
-	PutStream(ToStr(x1) + " " + ToStr(y1) + " " + ToStr(x2) + " " + ToStr(y2) + " " + ToStr(x3) + " " + ToStr(y3) + " cu\n");
+	operatorBuffer.resize(0);
+	ScOperatorWriter out(operatorBuffer);
+	out.number(x1).number(y1).number(x2).number(y2).number(x3).number(y3).op("cu");
+	PutStream(operatorBuffer, false);
 }
 
 void PSLib::PS_moveto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " m\n");
+	operatorBuffer.resize(0);
+	ScOperatorWriter out(operatorBuffer);
+	out.number(x).number(y).op("m");
+	PutStream(operatorBuffer, false);
 }
 
 void PSLib::PS_lineto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " li\n");
+	operatorBuffer.resize(0);
+	ScOperatorWriter out(operatorBuffer);
+	out.number(x).number(y).op("li");
+	PutStream(operatorBuffer, false);
 }
 
 void PSLib::PS_closepath()
@@ -1183,9 +1229,82 @@ bool PSLib::PS_ImageData(PageItem *c, QString fn, QString Name, QString Prof, bo
 	return true;
 }
 
-bool PSLib::PS_image(PageItem *c, double x, double y, QString fn, double scalex, double scaley, QString Prof, bool UseEmbedded, QString Name)
+bool PSLib::loadImage(PageItem* c, const QString& fn, const QString& Prof, bool UseEmbedded, int resolution, ScImage& image, QByteArray& mask, bool& maskLoaded) const
 {
 	bool dummy;
+	image.imgInfo.valid = false;
+	image.imgInfo.clipPath = "";
+	image.imgInfo.PDSpathData.clear();
+	image.imgInfo.layerInfo.clear();
+	image.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
+	image.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
+	CMSettings cms(c->doc(), Prof, c->IRender);
+	cms.allowColorManagement(true);
+	cms.setUseEmbeddedProfile(UseEmbedded);
+	maskLoaded = false;
+	if (!image.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, resolution, &dummy))
+		return false;
+	mask.clear();
+	maskLoaded = true;
+	if (c->pixm.imgInfo.type != ImageType7)
+	{
+		ScImage img2;
+		img2.imgInfo.clipPath = "";
+		img2.imgInfo.PDSpathData.clear();
+		img2.imgInfo.layerInfo.clear();
+		img2.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
+		img2.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
+		maskLoaded = img2.getAlpha(fn, c->pixm.imgInfo.actualPageNumber, mask, false, true, resolution);
+	}
+	return true;
+}
+
+void PSLib::prefetchImages(ScribusDoc* Doc, const std::vector<int>& pageNs)
+{
+	auto prefetchImage = [&](PageItem* item, int step)
+	{
+		if ((item->itemType() != PageItem::ImageFrame) || !item->imageIsAvailable || item->Pfile.isEmpty())
+			return;
+		if (!item->printEnabled() || !Doc->layerPrintable(item->LayerID))
+			return;
+		if (!ScImagePrefetcher::canPrepare(item->Pfile))
+			return;
+		int resolution = (item->pixm.imgInfo.type == ImageType7) ? 72 : 300;
+		imagePrefetcher.addJob(new PSImagePrefetchJob(this, item, step, resolution));
+	};
+	// the images are needed in the order CreatePS() writes the master page templates and then
+	// the pages, image frames of master pages are written again on each page using them
+	QList<PageItem*> items = Doc->getAllItems(Doc->MasterItems);
+	for (PageItem* item : items)
+		prefetchImage(item, 0);
+	items = Doc->getAllItems(Doc->DocItems);
+	for (uint aa = 0; aa < pageNs.size(); ++aa)
+	{
+		int pageIndex = pageNs[aa] - 1;
+		ScPage* page = Doc->Pages->at(pageIndex);
+		if (!page->MPageNam.isEmpty())
+		{
+			for (PageItem* item : page->FromMaster)
+				prefetchImage(item, aa + 1);
+		}
+		for (PageItem* item : items)
+		{
+			if (item->OwnPage == pageIndex)
+				prefetchImage(item, aa + 1);
+		}
+	}
+}
+
+void PSLib::updateImagePrefetchProgress()
+{
+	if (!usingGUI || (imagePrefetcher.jobCount() == 0))
+		return;
+	progressDialog->setProgress("EIP", imagePrefetcher.finishedCount(), imagePrefetcher.jobCount());
+	progressDialog->setLabel("EIP", tr("Preparing Images (%1% overlapped):").arg(imagePrefetcher.overlapPercent()));
+}
+
+bool PSLib::PS_image(PageItem *c, double x, double y, QString fn, double scalex, double scaley, QString Prof, bool UseEmbedded, QString Name)
+{
 	QByteArray tmp;
 	QFileInfo fi = QFileInfo(fn);
 	QString ext = fi.suffix().toLower();
@@ -1229,22 +1348,29 @@ bool PSLib::PS_image(PageItem *c, double x, double y, QString fn, double scalex,
 	else
 	{
 		ScImage image;
-		image.imgInfo.valid = false;
-		image.imgInfo.clipPath = "";
-		image.imgInfo.PDSpathData.clear();
-		image.imgInfo.layerInfo.clear();
-		image.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
-		image.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
-		CMSettings cms(c->doc(), Prof, c->IRender);
-		cms.allowColorManagement(true);
-		cms.setUseEmbeddedProfile(UseEmbedded);
+		QByteArray maskArray;
+		bool imageLoaded = false;
+		bool maskLoaded = false;
 		int resolution = 300;
 		if (c->asLatexFrame())
 			resolution = c->asLatexFrame()->realDpi();
 		else if (c->pixm.imgInfo.type == ImageType7)
 			resolution = 72;
 //		int resolution = (c->pixm.imgInfo.type == ImageType7) ? 72 : 300;
-		if ( !image.loadPicture(fn, c->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, resolution, &dummy) )
+		QScopedPointer<ScImagePrefetcher::Job> job(imagePrefetcher.take(c, fn));
+		PSImagePrefetchJob* prefetched = static_cast<PSImagePrefetchJob*>(job.data());
+		if (prefetched && (prefetched->profile == Prof) && (prefetched->embedded == UseEmbedded) && (prefetched->resolution == resolution))
+		{
+			image = prefetched->image;
+			maskArray = prefetched->mask;
+			imageLoaded = prefetched->imageLoaded;
+			maskLoaded = prefetched->maskLoaded;
+		}
+		else
+			imageLoaded = loadImage(c, fn, Prof, UseEmbedded, resolution, image, maskArray, maskLoaded);
+		job.reset();
+		updateImagePrefetchProgress();
+		if (!imageLoaded)
 		{
 			PS_Error_ImageLoadFailure(fn);
 			return false;
@@ -1264,21 +1390,10 @@ bool PSLib::PS_image(PageItem *c, double x, double y, QString fn, double scalex,
 //		PutStream(ToStr(x*scalex) + " " + ToStr(y*scaley) + " tr\n");
 		PutStream(ToStr(qRound(scalex*w)) + " " + ToStr(qRound(scaley*h)) + " sc\n");
 		PutStream(((!DoSep) && (!GraySc)) ? "/DeviceCMYK setcolorspace\n" : "/DeviceGray setcolorspace\n");
-		QByteArray maskArray;
-		ScImage img2;
-		img2.imgInfo.clipPath = "";
-		img2.imgInfo.PDSpathData.clear();
-		img2.imgInfo.layerInfo.clear();
-		img2.imgInfo.RequestProps = c->pixm.imgInfo.RequestProps;
-		img2.imgInfo.isRequest = c->pixm.imgInfo.isRequest;
-		if (c->pixm.imgInfo.type != ImageType7)
+		if (!maskLoaded)
 		{
-			bool alphaLoaded = img2.getAlpha(fn, c->pixm.imgInfo.actualPageNumber, maskArray, false, true, resolution);
-			if (!alphaLoaded)
-			{
-				PS_Error_MaskLoadFailure(fn);
-				return false;
-			}
+			PS_Error_MaskLoadFailure(fn);
+			return false;
 		}
  		if ((maskArray.size() > 0) && (c->pixm.imgInfo.type != ImageType7))
  		{
@@ -1539,10 +1654,10 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 		else
 		{
 			QStringList barNames, barTexts;
-			barNames << "EMP" << "EP";
-			barTexts << tr("Processing Master Page:") << tr("Exporting Page:");
+			barNames << "EMP" << "EP" << "EIP";
+			barTexts << tr("Processing Master Page:") << tr("Exporting Page:") << tr("Preparing Images:");
 			QList<bool> barsNumeric;
-			barsNumeric << true << true;
+			barsNumeric << true << true << true;
 			progressDialog->addExtraProgressBars(barNames, barTexts, barsNumeric);
 			progressDialog->setOverallTotalSteps(pageNs.size()+Doc->MasterPages.count());
 			progressDialog->setTotalSteps("EMP", Doc->MasterPages.count());
@@ -1611,7 +1726,11 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 			maxHeight = qMax(Doc->Pages->at(a)->height(), maxHeight);
 		}
 		errorOccured = !PS_begin_doc(Doc, 0.0, 0.0, maxWidth, maxHeight, pageNs.size()*pagemult, doDev, sep, farb);
+		// when printing a selection most images of the pages are not needed
+		if (!errorOccured)
+			prefetchImages(Doc, pageNs);
 	}
+	updateImagePrefetchProgress();
 	int ap=0;
 	for (; ap < Doc->MasterPages.count() && !abortExport && !errorOccured; ++ap)
 	{
@@ -1670,6 +1789,7 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 		}
 		if (errorOccured) break;
 	}
+	imagePrefetcher.finishStep(0);
 	sepac = 0;
 	uint aa = 0;
 	uint a;	
@@ -1755,7 +1875,11 @@ int PSLib::CreatePS(ScribusDoc* Doc, PrintOptions &options)
 		}
 		else
 			aa++;
+		// drops the images of the finished pages, with all separations the page is written once per plate
+		imagePrefetcher.finishStep(aa);
+		updateImagePrefetchProgress();
 	}
+	imagePrefetcher.clear();
 	PS_close();
 	if (usingGUI)
 		progressDialog->close();
@@ -4488,6 +4612,9 @@ void PSLib::SetClipPath(FPointArray *c, bool poly)
 	if (c->size() <= 3)
 		return;
 
+	// the whole path is written at once
+	operatorBuffer.resize(0);
+	ScOperatorWriter out(operatorBuffer);
 	for (int poi=0; poi < c->size()-3; poi += 4)
 	{
 		if (c->isMarker(poi))
@@ -4499,8 +4626,8 @@ void PSLib::SetClipPath(FPointArray *c, bool poly)
 		{
 			np = c->point(poi);
 			if ((!first) && (poly) && (np4 == firstP))
-				PS_closepath();
-			PS_moveto(np.x(), -np.y());
+				out.op("cl");
+			out.number(np.x()).number(-np.y()).op("m");
 			nPath = false;
 			first = false;
 			firstP = np;
@@ -4511,11 +4638,12 @@ void PSLib::SetClipPath(FPointArray *c, bool poly)
 		np2 = c->point(poi+3);
 		np3 = c->point(poi+2);
 		if ((np == np1) && (np2 == np3))
-			PS_lineto(np3.x(), -np3.y());
+			out.number(np3.x()).number(-np3.y()).op("li");
 		else
-			PS_curve(np1.x(), -np1.y(), np2.x(), -np2.y(), np3.x(), -np3.y());
+			out.number(np1.x()).number(-np1.y()).number(np2.x()).number(-np2.y()).number(np3.x()).number(-np3.y()).op("cu");
 		np4 = np3;
 	}
+	PutStream(operatorBuffer, false);
 }
 
 void PSLib::SetPathAndClip(FPointArray &path, bool clipRule)
@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusapi.h"
 #include "scribusstructs.h"
 #include "colormgmt/sccolormgmtengine.h"
+#include "scimageprefetcher.h"
 #include "tableborder.h"
 
 
@@ -57,6 +58,7 @@ class SCRIBUS_API PSLib : public QObject
 	Q_OBJECT
 
 	friend class PSPainter;
+	friend class PSImagePrefetchJob;
 
 	public:
 
@@ -162,6 +164,12 @@ class SCRIBUS_API PSLib : public QObject
 
 		void paintBorder(const TableBorder& border, const QPointF& start, const QPointF& end, const QPointF& startOffsetFactors, const QPointF& endOffsetFactors);
 
+		/// loads the image and the mask of PS_image(), may be called from the threads of imagePrefetcher
+		bool loadImage(PageItem* c, const QString& fn, const QString& Prof, bool UseEmbedded, int resolution, ScImage& image, QByteArray& mask, bool& maskLoaded) const;
+		/// adds the images of the master pages and of the pages in pageNs to imagePrefetcher
+		void prefetchImages(ScribusDoc* Doc, const std::vector<int>& pageNs);
+		void updateImagePrefetchProgress();
+
 		Optimization optimization;
 
 		QString ToStr(double c);
@@ -192,6 +200,8 @@ class SCRIBUS_API PSLib : public QObject
 		bool isPDF;
 		QFile Spool;
 		QDataStream spoolStream;
+		// reused by the path operators, so writing them does not allocate
+		QByteArray operatorBuffer;
 		int  Plate;
 		bool DoSep;
 		bool useSpotColors;
@@ -207,6 +217,7 @@ class SCRIBUS_API PSLib : public QObject
 		bool abortExport;
 		PrintOptions Options;
 		ScPage* ActPage;
+		ScImagePrefetcher imagePrefetcher;
 
 	protected slots:
 		void cancelRequested();
@@ -0,0 +1,168 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+
+#include "scimageprefetcher.h"
+#include "util_formats.h"
+
+class ScImagePrefetchTask : public QRunnable
+{
+public:
+	ScImagePrefetchTask(ScImagePrefetcher::Job* job, QAtomicInt& finishedCount) : m_job(job), m_finishedCount(finishedCount) { }
+
+	void run()
+	{
+		QElapsedTimer timer;
+		timer.start();
+		m_job->prepare();
+		m_job->m_prepareMSecs = timer.elapsed();
+		m_finishedCount.ref();
+		m_job->m_finished.release();
+	}
+
+private:
+	ScImagePrefetcher::Job* m_job;
+	QAtomicInt& m_finishedCount;
+};
+
+ScImagePrefetcher::Job::Job(const PageItem* item, const QString& fileName, int step, qint64 estimatedBytes) :
+	m_item(item),
+	m_fileName(fileName),
+	m_step(step),
+	m_estimatedBytes(estimatedBytes),
+	m_started(false),
+	m_prepareMSecs(0)
+{
+}
+
+ScImagePrefetcher::ScImagePrefetcher(qint64 budget) :
+	m_startedCount(0),
+	m_budget(budget),
+	m_usedBytes(0),
+	m_jobCount(0),
+	m_finishedCount(0),
+	m_preparedMSecs(0),
+	m_waitedMSecs(0)
+{
+}
+
+ScImagePrefetcher::~ScImagePrefetcher()
+{
+	clear();
+}
+
+bool ScImagePrefetcher::canPrepare(const QString& fileName)
+{
+	QString ext = QFileInfo(fileName).suffix().toLower();
+	QString type = getImageType(fileName);
+	if (ext.isEmpty() || (!type.isEmpty() && (type != ext)))
+		ext = type;
+	// the loaders of vector formats render through Ghostscript or a document and those of
+	// GraphicsMagick are not known to be reentrant
+	if (extensionIndicatesJPEG(ext) || extensionIndicatesTIFF(ext) || extensionIndicatesPSD(ext))
+		return true;
+	if ((ext == "pat") || (ext == "pgf"))
+		return true;
+	return QImageReader::supportedImageFormats().contains(ext.toLatin1());
+}
+
+void ScImagePrefetcher::addJob(Job* job)
+{
+	m_jobs.append(job);
+	++m_jobCount;
+	startJobs();
+}
+
+ScImagePrefetcher::Job* ScImagePrefetcher::take(const PageItem* item, const QString& fileName)
+{
+	for (int i = 0; i < m_jobs.count(); ++i)
+	{
+		Job* job = m_jobs.at(i);
+		if ((job->item() != item) || (job->fileName() != fileName))
+			continue;
+		m_jobs.removeAt(i);
+		QElapsedTimer timer;
+		timer.start();
+		if (job->m_started)
+		{
+			job->m_finished.acquire();
+			--m_startedCount;
+			m_usedBytes -= job->estimatedBytes();
+		}
+		else
+		{
+			// the exporter got ahead of the budget, prepare the image here
+			job->prepare();
+			job->m_prepareMSecs = timer.elapsed();
+			m_finishedCount.ref();
+		}
+		m_waitedMSecs += timer.elapsed();
+		m_preparedMSecs += job->m_prepareMSecs;
+		startJobs();
+		return job;
+	}
+	return nullptr;
+}
+
+void ScImagePrefetcher::finishStep(int step)
+{
+	for (int i = m_jobs.count() - 1; i >= 0; --i)
+	{
+		Job* job = m_jobs.at(i);
+		if (job->step() > step)
+			continue;
+		m_jobs.removeAt(i);
+		drop(job);
+	}
+	startJobs();
+}
+
+void ScImagePrefetcher::clear()
+{
+	while (!m_jobs.isEmpty())
+		drop(m_jobs.takeLast());
+}
+
+int ScImagePrefetcher::overlapPercent() const
+{
+	if (m_preparedMSecs <= 0)
+		return 0;
+	qint64 overlapped = qMax<qint64>(0, m_preparedMSecs - m_waitedMSecs);
+	return static_cast<int>(overlapped * 100 / m_preparedMSecs);
+}
+
+void ScImagePrefetcher::startJobs()
+{
+	while (m_startedCount < m_jobs.count())
+	{
+		Job* job = m_jobs.at(m_startedCount);
+		// a job larger than the budget is started once nothing else is held
+		if ((m_usedBytes > 0) && (m_usedBytes + job->estimatedBytes() > m_budget))
+			break;
+		job->m_started = true;
+		m_usedBytes += job->estimatedBytes();
+		++m_startedCount;
+		m_pool.start(new ScImagePrefetchTask(job, m_finishedCount));
+	}
+}
+
+void ScImagePrefetcher::drop(Job* job)
+{
+	if (job->m_started)
+	{
+		job->m_finished.acquire();
+		--m_startedCount;
+		m_usedBytes -= job->estimatedBytes();
+	}
+	else
+		m_finishedCount.ref();
+	delete job;
+}
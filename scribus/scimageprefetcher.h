@@ -0,0 +1,104 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEPREFETCHER_H
+#define SCIMAGEPREFETCHER_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QSemaphore>
+#include <QString>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ ScImagePrefetcher loads and converts the images of an export on a thread pool while the
+ exporter writes the items before them. The exporter scans the pages it is going to write and
+ adds a job for each image in the order it will need them, take() waits for the job of an image
+ and hands it back when the exporter reaches it.
+
+ Jobs are started in order while the estimated memory of the started jobs which were not taken
+ yet stays within the budget, further jobs are started as jobs are taken. Each job belongs to a
+ step of the export, a master page pass or a page, jobs of finished steps which were not taken,
+ e.g. because their item was skipped, are dropped by finishStep().
+ */
+class SCRIBUS_API ScImagePrefetcher
+{
+public:
+	/// memory the prepared images may take by default
+	static const qint64 DefaultBudget = 512 * 1024 * 1024;
+
+	class SCRIBUS_API Job
+	{
+	public:
+		Job(const PageItem* item, const QString& fileName, int step, qint64 estimatedBytes);
+		virtual ~Job() {}
+
+		const PageItem* item() const { return m_item; }
+		const QString& fileName() const { return m_fileName; }
+		int step() const { return m_step; }
+		qint64 estimatedBytes() const { return m_estimatedBytes; }
+
+	protected:
+		/// called on a worker thread, must only read the document and the exporter
+		virtual void prepare() = 0;
+
+	private:
+		friend class ScImagePrefetcher;
+		friend class ScImagePrefetchTask;
+
+		const PageItem* m_item;
+		QString m_fileName;
+		int m_step;
+		qint64 m_estimatedBytes;
+		bool m_started;
+		qint64 m_prepareMSecs;
+		QSemaphore m_finished;
+	};
+
+	explicit ScImagePrefetcher(qint64 budget = DefaultBudget);
+	~ScImagePrefetcher();
+
+	/// true if the loader of fileName is known to be reentrant, so it may be prepared by a job
+	static bool canPrepare(const QString& fileName);
+
+	/// appends job, the prefetcher owns it until it is taken
+	void addJob(Job* job);
+	/// waits for the job of fileName in item and returns it, the caller owns it; nullptr if there is none
+	Job* take(const PageItem* item, const QString& fileName);
+	/// drops the jobs of step and the steps before it which were not taken
+	void finishStep(int step);
+	/// drops all jobs, waiting for the running ones
+	void clear();
+
+	/// jobs added since the prefetcher was created
+	int jobCount() const { return m_jobCount; }
+	/// jobs added since the prefetcher was created which were prepared or dropped
+	int finishedCount() const { return m_finishedCount.load(); }
+	/// percentage of the time spent preparing taken jobs during which the exporter did not wait for them
+	int overlapPercent() const;
+
+private:
+	void startJobs();
+	void drop(Job* job);
+
+	QThreadPool m_pool;
+	// jobs not taken yet in the order they were added, the started ones first
+	QList<Job*> m_jobs;
+	int m_startedCount;
+	qint64 m_budget;
+	qint64 m_usedBytes;
+	int m_jobCount;
+	QAtomicInt m_finishedCount;
+	qint64 m_preparedMSecs;
+	qint64 m_waitedMSecs;
+};
+
+#endif
@@ -28,6 +28,7 @@ ScLayer::ScLayer()
 	transparency = 1.0;
 	blendMode    = 0;
 	markerColor  = QColor(0, 0, 0);
+	revision     = 0;
 }
 
 ScLayer::ScLayer(const QString& name, int level, int id)
@@ -44,6 +45,7 @@ ScLayer::ScLayer(const QString& name, int level, int id)
 	transparency = 1.0;
 	blendMode    = 0;
 	markerColor  = QColor(0, 0, 0);
+	revision     = 0;
 	switch (ID % 7)
 	{
 		case 0:
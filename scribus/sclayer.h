@@ -31,6 +31,8 @@ public:
 	double  transparency;
 	int     blendMode;
 	QColor  markerColor;
+	//! Revision of the document the layer has last been changed in, see ScribusDoc::revision()
+	quint64 revision;
 	bool operator< (const ScLayer& other) const;
 	bool operator== (const ScLayer& other) const;
 };
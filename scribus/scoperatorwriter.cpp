@@ -0,0 +1,79 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cmath>
+
+#include <QtGlobal>
+
+#include "scoperatorwriter.h"
+
+static const int MaxDecimals = 9;
+static const quint64 Powers[MaxDecimals + 1] =
+{
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+// the rounded magnitude times 10^decimals has to fit into a quint64
+static const double MaxScaled = 9.0e18;
+
+int ScOperatorWriter::formatNumber(char* buffer, double v, int decimals)
+{
+	decimals = qBound(0, decimals, MaxDecimals);
+	if (qIsNaN(v))
+		v = 0.0;
+	const quint64 scale = Powers[decimals];
+	double magnitude = qMin(std::fabs(v), MaxScaled / scale);
+	quint64 scaled = static_cast<quint64>(magnitude * scale + 0.5);
+	quint64 integral = scaled / scale;
+	quint64 fraction = scaled % scale;
+
+	int length = 0;
+	if ((v < 0.0) && (scaled != 0))
+		buffer[length++] = '-';
+	char digits[NumberBufferSize];
+	int count = 0;
+	do
+	{
+		digits[count++] = '0' + static_cast<char>(integral % 10);
+		integral /= 10;
+	}
+	while (integral != 0);
+	while (count > 0)
+		buffer[length++] = digits[--count];
+	if (fraction != 0)
+	{
+		int places = decimals;
+		while (fraction % 10 == 0)
+		{
+			fraction /= 10;
+			--places;
+		}
+		buffer[length++] = '.';
+		for (int i = places - 1; i >= 0; --i)
+		{
+			buffer[length + i] = '0' + static_cast<char>(fraction % 10);
+			fraction /= 10;
+		}
+		length += places;
+	}
+	return length;
+}
+
+QByteArray ScOperatorWriter::toByteArray(double v, int decimals)
+{
+	char text[NumberBufferSize];
+	int length = formatNumber(text, v, decimals);
+	return QByteArray(text, length);
+}
+
+ScOperatorWriter& ScOperatorWriter::number(int v)
+{
+	char text[NumberBufferSize];
+	int length = formatNumber(text, v, 0);
+	text[length++] = ' ';
+	m_buffer.append(text, length);
+	return *this;
+}
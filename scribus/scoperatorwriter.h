@@ -0,0 +1,101 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCOPERATORWRITER_H
+#define SCOPERATORWRITER_H
+
+#include <QByteArray>
+
+#include "scribusapi.h"
+
+/**
+ ScOperatorWriter appends the operands and operators of PDF content streams and PostScript
+ programs to a buffer. Numbers are formatted by formatNumber() into a fixed array on the stack,
+ so writing them needs no allocation besides the growth of the buffer, unlike concatenating
+ the results of QByteArray::number() or QString::setNum().
+
+ Operands are followed by a space and operators by a newline, so
+	w.moveTo(10, 20); w.lineTo(30.5, 20);
+ appends "10 20 m\n30.5 20 l\n". The typed helpers write PDF operators, PostScript
+ procedures are written with number() and op().
+ */
+class SCRIBUS_API ScOperatorWriter
+{
+public:
+	/// digits after the decimal point written by default, the precision of FToStr() in the PDF export
+	static const int DefaultDecimals = 5;
+	/// size of a buffer formatNumber() may write to
+	static const int NumberBufferSize = 32;
+
+	/// appends to buffer, which must live as long as the writer
+	explicit ScOperatorWriter(QByteArray& buffer, int decimals = DefaultDecimals) : m_buffer(buffer), m_decimals(decimals) { }
+
+	/**
+	 Writes v rounded to decimals digits after the decimal point to buffer without trailing zeros,
+	 so it is the shortest text that reads back as the rounded value: 1.5 for 1.50000, 2 for 2.00000,
+	 0 for -0.000001. Values beyond +-9e13 are clamped, NaN is written as 0. Returns the length;
+	 buffer must hold NumberBufferSize characters and is not null terminated.
+	 */
+	static int formatNumber(char* buffer, double v, int decimals = DefaultDecimals);
+	/// formatNumber() into a new QByteArray, for code which still concatenates
+	static QByteArray toByteArray(double v, int decimals = DefaultDecimals);
+
+	QByteArray& buffer() { return m_buffer; }
+	int decimals() const { return m_decimals; }
+
+	/// appends a number followed by a space
+	ScOperatorWriter& number(double v)
+	{
+		char text[NumberBufferSize];
+		int length = formatNumber(text, v, m_decimals);
+		text[length++] = ' ';
+		m_buffer.append(text, length);
+		return *this;
+	}
+	ScOperatorWriter& number(int v);
+	/// appends an operator followed by a newline
+	ScOperatorWriter& op(const char* name)
+	{
+		m_buffer.append(name);
+		m_buffer.append('\n');
+		return *this;
+	}
+	ScOperatorWriter& append(const char* text) { m_buffer.append(text); return *this; }
+	ScOperatorWriter& append(const QByteArray& text) { m_buffer.append(text); return *this; }
+
+	// path construction, cf. PDF32000-2008, 8.5.2
+	void moveTo(double x, double y) { number(x).number(y).op("m"); }
+	void lineTo(double x, double y) { number(x).number(y).op("l"); }
+	void curveTo(double x1, double y1, double x2, double y2, double x3, double y3)
+	{
+		number(x1).number(y1).number(x2).number(y2).number(x3).number(y3).op("c");
+	}
+	void closePath() { op("h"); }
+	void rect(double x, double y, double width, double height) { number(x).number(y).number(width).number(height).op("re"); }
+
+	// graphics state, cf. PDF32000-2008, 8.4.4
+	void transform(double a, double b, double c, double d, double e, double f)
+	{
+		number(a).number(b).number(c).number(d).number(e).number(f).op("cm");
+	}
+	void translate(double x, double y) { transform(1, 0, 0, 1, x, y); }
+	void lineWidth(double width) { number(width).op("w"); }
+
+	// colours, cf. PDF32000-2008, 8.6.8
+	void fillGray(double gray) { number(gray).op("g"); }
+	void strokeGray(double gray) { number(gray).op("G"); }
+	void fillRGB(double r, double g, double b) { number(r).number(g).number(b).op("rg"); }
+	void strokeRGB(double r, double g, double b) { number(r).number(g).number(b).op("RG"); }
+	void fillCMYK(double c, double m, double y, double k) { number(c).number(m).number(y).number(k).op("k"); }
+	void strokeCMYK(double c, double m, double y, double k) { number(c).number(m).number(y).number(k).op("K"); }
+
+private:
+	QByteArray& m_buffer;
+	int m_decimals;
+};
+
+#endif
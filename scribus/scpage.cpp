@@ -52,7 +52,8 @@ ScPage::ScPage(const double x, const double y, const double b, const double h) :
 	m_initialWidth(b),
 	m_initialHeight(h),
 	m_PageName(""),
-	m_Doc(nullptr)
+	m_Doc(nullptr),
+	m_revision(0)
 {
 	guides.setPage(this);
 	marginPreset = 0;
@@ -82,6 +83,15 @@ void ScPage::setDocument(ScribusDoc *doc)
 {
 	m_Doc=doc;
 	setMassObservable(doc? doc->pagesChanged() : nullptr);
+	// a new page may reuse the address of a deleted one caches still know
+	if (doc)
+		m_revision = doc->nextRevision();
+}
+
+void ScPage::bumpRevision()
+{
+	if (m_Doc)
+		m_Doc->bumpRevision(this);
 }
 
 void ScPage::setPageNr(int pageNr)
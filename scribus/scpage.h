@@ -89,6 +89,10 @@ public:
 	const QString& pageName() const {return m_PageName;}
 	void setPageName(const QString& newName);
 	void restore(UndoState* state, bool isUndo);
+	//! Revision of the document the page or its items have last been changed in, see ScribusDoc::revision()
+	quint64 revision() const { return m_revision; }
+	void setRevision(quint64 revision) { m_revision = revision; }
+	void bumpRevision();
 
 	/*! \brief As a bit of a dirty hack, we declare this mutable so it can be altered
 	even while the object is `const'. That's normally only for internal
@@ -120,6 +124,7 @@ protected:
 	QString m_PageName;
 	ScribusDoc* m_Doc;	
 	QString m_pageSectionNumber;
+	quint64 m_revision;
 };
 
 Q_DECLARE_METATYPE(ScPage*);
@@ -0,0 +1,194 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+#include "scpage.h"
+#include "scpageimageexporter.h"
+#include "scribusdoc.h"
+
+// how often progress() is emitted while no page is finished, in ms
+static const int ProgressInterval = 100;
+
+/// Renders one page and hands it over to the write pool.
+class ScPageRenderTask : public QRunnable
+{
+public:
+	ScPageRenderTask(ScPageImageExporter* exporter, int index) : m_exporter(exporter), m_index(index) { }
+	void run() { m_exporter->renderPage(m_index); }
+
+private:
+	ScPageImageExporter* m_exporter;
+	int m_index;
+};
+
+/// Encodes and writes one rendered page.
+class ScPageWriteTask : public QRunnable
+{
+public:
+	ScPageWriteTask(ScPageImageExporter* exporter, int index, const QImage& image) : m_exporter(exporter), m_index(index), m_image(image) { }
+	void run() { m_exporter->writePage(m_index, m_image); }
+
+private:
+	ScPageImageExporter* m_exporter;
+	int m_index;
+	QImage m_image;
+};
+
+ScPageImageExporter::ScPageImageExporter(ScribusDoc* doc, QObject* parent) : QObject(parent),
+	m_doc(doc),
+	m_renderer(doc),
+	m_format("png"),
+	m_dpi(72.0),
+	m_scale(1.0),
+	m_quality(-1),
+	m_renderFlags(ScPageRenderer::DrawBackground),
+	m_pagesInFlight(qMax(2, QThread::idealThreadCount() * 2)),
+	m_threadCount(qMax(1, QThread::idealThreadCount())),
+	m_cancelled(0)
+{
+}
+
+ScPageImageExporter::~ScPageImageExporter()
+{
+	cancel();
+	m_renderPool.waitForDone();
+	m_writePool.waitForDone();
+}
+
+void ScPageImageExporter::setResolution(double dpi, double scale)
+{
+	m_dpi = dpi;
+	m_scale = scale;
+}
+
+void ScPageImageExporter::setPagesInFlight(int pages)
+{
+	m_pagesInFlight = qMax(1, pages);
+}
+
+void ScPageImageExporter::setThreadCount(int threads)
+{
+	m_threadCount = qMax(1, threads);
+}
+
+bool ScPageImageExporter::exportPages(const QList<int>& pageNumbers, const QStringList& fileNames)
+{
+	m_failedPages.clear();
+	m_errorMessage.clear();
+	m_cancelled.store(0);
+	if (pageNumbers.count() != fileNames.count())
+		return false;
+	for (int pageNumber : pageNumbers)
+	{
+		if ((pageNumber < 0) || (pageNumber >= m_doc->DocPages.count()))
+			return false;
+	}
+	if (pageNumbers.isEmpty())
+		return true;
+
+	m_pageNumbers = pageNumbers;
+	m_fileNames = fileNames;
+	m_slots.acquire(m_slots.available());
+	m_slots.release(m_pagesInFlight);
+	// rendering more pages at once than may be in flight would only block threads
+	m_renderPool.setMaxThreadCount(qMin(m_threadCount, m_pagesInFlight));
+	m_writePool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+
+	QList<ScPage*> pages;
+	for (int pageNumber : pageNumbers)
+		pages.append(m_doc->DocPages.at(pageNumber));
+	m_renderer.prepare(pages);
+
+	for (int i = 0; i < pageNumbers.count(); ++i)
+		m_renderPool.start(new ScPageRenderTask(this, i));
+
+	int total = pageNumbers.count();
+	int done = 0;
+	emit progress(done, total);
+	while (done < total)
+	{
+		if (m_finished.tryAcquire(1, ProgressInterval))
+			++done;
+		emit progress(done, total);
+	}
+	m_renderPool.waitForDone();
+	m_writePool.waitForDone();
+	m_pageNumbers.clear();
+	m_fileNames.clear();
+
+	QMutexLocker locker(&m_errorMutex);
+	return m_failedPages.isEmpty() && !isCancelled();
+}
+
+void ScPageImageExporter::cancel()
+{
+	m_cancelled.store(1);
+}
+
+bool ScPageImageExporter::isCancelled() const
+{
+	return m_cancelled.load() != 0;
+}
+
+QList<int> ScPageImageExporter::failedPages() const
+{
+	QMutexLocker locker(&m_errorMutex);
+	return m_failedPages;
+}
+
+QString ScPageImageExporter::errorMessage() const
+{
+	QMutexLocker locker(&m_errorMutex);
+	return m_errorMessage;
+}
+
+void ScPageImageExporter::renderPage(int index)
+{
+	m_slots.acquire();
+	if (isCancelled())
+	{
+		m_slots.release();
+		pageFinished(index, QString());
+		return;
+	}
+	ScPage* page = m_doc->DocPages.at(m_pageNumbers.at(index));
+	QImage image(m_renderer.render(page, m_dpi * m_scale, m_renderFlags));
+	if (image.isNull())
+	{
+		m_slots.release();
+		pageFinished(index, tr("Insufficient memory for this image size."));
+		return;
+	}
+	int dpm = qRound(100.0 / 2.54 * m_dpi);
+	image.setDotsPerMeterX(dpm);
+	image.setDotsPerMeterY(dpm);
+	m_writePool.start(new ScPageWriteTask(this, index, image));
+}
+
+void ScPageImageExporter::writePage(int index, const QImage& image)
+{
+	QString error;
+	if (!isCancelled() && !image.save(m_fileNames.at(index), m_format.toLocal8Bit().constData(), m_quality))
+		error = tr("Error writing the output file(s).");
+	m_slots.release();
+	pageFinished(index, error);
+}
+
+void ScPageImageExporter::pageFinished(int index, const QString& error)
+{
+	if (!error.isEmpty())
+	{
+		QMutexLocker locker(&m_errorMutex);
+		m_failedPages.append(m_pageNumbers.at(index));
+		if (m_errorMessage.isEmpty())
+			m_errorMessage = error;
+	}
+	m_finished.release();
+}
@@ -0,0 +1,115 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCPAGEIMAGEEXPORTER_H
+#define SCPAGEIMAGEEXPORTER_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+#include "scpagerenderer.h"
+
+class ScribusDoc;
+
+/**
+ ScPageImageExporter writes pages of a document to image files. Pages are rendered
+ concurrently by ScPageRenderer on one thread pool, encoded and written on another one.
+ At most pagesInFlight() pages are held in memory at a time, rendering waits for
+ writing if it gets ahead.
+
+ exportPages() blocks the calling thread, which must own the document, until all pages are
+ written, failed or the export is cancelled. Meanwhile progress() is emitted regularly on the
+ calling thread; receivers may process events and call cancel(). The document must not be
+ changed during the export.
+ */
+class SCRIBUS_API ScPageImageExporter : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit ScPageImageExporter(ScribusDoc* doc, QObject* parent = nullptr);
+	~ScPageImageExporter();
+
+	/// image format as understood by QImageWriter, e.g. "png", "jpg" or "tif"
+	const QString& format() const { return m_format; }
+	void setFormat(const QString& format) { m_format = format; }
+	/// resolution written to the image files, pages are rendered at dpi * scale
+	void setResolution(double dpi, double scale = 1.0);
+	double resolution() const { return m_dpi; }
+	double scale() const { return m_scale; }
+	/// quality of lossy formats from 0 to 100, -1 for the default of the format
+	void setQuality(int quality) { m_quality = quality; }
+	int quality() const { return m_quality; }
+	void setRenderFlags(ScPageRenderer::RenderFlags flags) { m_renderFlags = flags; }
+	ScPageRenderer::RenderFlags renderFlags() const { return m_renderFlags; }
+	/// maximum number of pages rendered but not written yet, this bounds the memory used
+	void setPagesInFlight(int pages);
+	int pagesInFlight() const { return m_pagesInFlight; }
+	/// number of threads rendering pages
+	void setThreadCount(int threads);
+	int threadCount() const { return m_threadCount; }
+
+	/**
+	 Exports the pages with the indices in pageNumbers to fileNames, which must be as long.
+	 Returns true if all pages have been written.
+	 */
+	bool exportPages(const QList<int>& pageNumbers, const QStringList& fileNames);
+	bool isCancelled() const;
+
+	/// indices of the pages which could not be exported by the last call of exportPages()
+	QList<int> failedPages() const;
+	/// description of the first error of the last call of exportPages()
+	QString errorMessage() const;
+
+public slots:
+	/// stops the running export, pages already written are kept. Thread-safe.
+	void cancel();
+
+signals:
+	/// done pages have been written or have failed so far
+	void progress(int done, int total);
+
+private:
+	friend class ScPageRenderTask;
+	friend class ScPageWriteTask;
+
+	void renderPage(int index);
+	void writePage(int index, const QImage& image);
+	void pageFinished(int index, const QString& error);
+
+	ScribusDoc* m_doc;
+	ScPageRenderer m_renderer;
+	QString m_format;
+	double m_dpi;
+	double m_scale;
+	int m_quality;
+	ScPageRenderer::RenderFlags m_renderFlags;
+	int m_pagesInFlight;
+	int m_threadCount;
+	QThreadPool m_renderPool;
+	QThreadPool m_writePool;
+
+	// state of the running export
+	QList<int> m_pageNumbers;
+	QStringList m_fileNames;
+	QAtomicInt m_cancelled;
+	QSemaphore m_slots;
+	QSemaphore m_finished;
+	mutable QMutex m_errorMutex;
+	QList<int> m_failedPages;
+	QString m_errorMessage;
+};
+
+#endif
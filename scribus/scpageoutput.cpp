@@ -241,7 +241,7 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 			painter->m_fillGradient = VGradientEx(VGradientEx::linear);
 			if (item->fillColor() != CommonStrings::None)
 			{
-				painter->setBrush(ScColorShade(m_doc->PageColors[item->fillColor()], (int) item->fillShade()));
+				painter->setBrush(ScColorShade(m_doc->PageColors.value(item->fillColor()), (int) item->fillShade()));
 				painter->setFillMode(ScPainterExBase::Solid);
 			}
 			else
@@ -265,10 +265,10 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 		FPoint pG2 = FPoint(item->width(), 0);
 		FPoint pG3 = FPoint(item->width(), item->height());
 		FPoint pG4 = FPoint(0, item->height());
-		ScColorShade col1(m_doc->PageColors[item->GrColorP1], item->GrCol1Shade);
-		ScColorShade col2(m_doc->PageColors[item->GrColorP2], item->GrCol2Shade);
-		ScColorShade col3(m_doc->PageColors[item->GrColorP3], item->GrCol3Shade);
-		ScColorShade col4(m_doc->PageColors[item->GrColorP4], item->GrCol4Shade);
+		ScColorShade col1(m_doc->PageColors.value(item->GrColorP1), item->GrCol1Shade);
+		ScColorShade col2(m_doc->PageColors.value(item->GrColorP2), item->GrCol2Shade);
+		ScColorShade col3(m_doc->PageColors.value(item->GrColorP3), item->GrCol3Shade);
+		ScColorShade col4(m_doc->PageColors.value(item->GrColorP4), item->GrCol4Shade);
 		painter->set4ColorGeometry(pG1, pG2, pG3, pG4, item->GrControl1, item->GrControl2, item->GrControl3, item->GrControl4);
 		painter->set4ColorColors(col1, col2, col3, col4);
 	}
@@ -278,12 +278,12 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 		if ((!gradientVal.isEmpty()) && (!m_doc->docGradients.contains(gradientVal)))
 			gradientVal = "";
 		if (!(gradientVal.isEmpty()) && (m_doc->docGradients.contains(gradientVal)))
-			painter->m_fillGradient = VGradientEx(m_doc->docGradients[gradientVal], *m_doc);
+			painter->m_fillGradient = VGradientEx(m_doc->docGradients.value(gradientVal), *m_doc);
 		if ((painter->m_fillGradient.Stops() < 2) && (item->GrType < 9)) // fall back to solid filling if there are not enough colorstops in the gradient.
 		{
 			if (item->fillColor() != CommonStrings::None)
 			{
-				painter->setBrush( ScColorShade(m_doc->PageColors[item->fillColor()], (int) item->fillShade()) );
+				painter->setBrush( ScColorShade(m_doc->PageColors.value(item->fillColor()), (int) item->fillShade()) );
 				painter->setFillMode(ScPainterExBase::Solid);
 			}
 			else
@@ -330,7 +330,7 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 		painter->m_fillGradient = VGradientEx(VGradientEx::linear);
 		if (item->fillColor() != CommonStrings::None)
 		{
-			painter->setBrush( ScColorShade(m_doc->PageColors[item->fillColor()], (int) item->fillShade()) );
+			painter->setBrush( ScColorShade(m_doc->PageColors.value(item->fillColor()), (int) item->fillShade()) );
 			painter->setFillMode(ScPainterExBase::Solid);
 		}
 		else
@@ -342,7 +342,7 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 			painter->setLineWidth(0);
 		else
 		{
-			ScColorShade tmp(m_doc->PageColors[item->lineColor()], (int) item->lineShade());
+			ScColorShade tmp(m_doc->PageColors.value(item->lineColor()), (int) item->lineShade());
 			painter->setPen( tmp , item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 			if (item->DashValues.count() != 0)
 				painter->setDash(item->DashValues, item->DashOffset);
@@ -367,7 +367,7 @@ void ScPageOutput::drawItem_Pre( PageItem* item, ScPainterExBase* painter)
 		if ((!gradientMaskVal.isEmpty()) && (!m_doc->docGradients.contains(gradientMaskVal)))
 			gradientMaskVal = "";
 		if (!(gradientMaskVal.isEmpty()) && (m_doc->docGradients.contains(gradientMaskVal)))
-			painter->m_maskGradient = VGradientEx(m_doc->docGradients[gradientMaskVal], *m_doc);
+			painter->m_maskGradient = VGradientEx(m_doc->docGradients.value(gradientMaskVal), *m_doc);
 		if ((item->GrMask == 1) || (item->GrMask == 4))
 			painter->setGradientMask(VGradientEx::linear, fpMaskStart, fpMaskEnd, fpMaskStart, item->GrMaskScale, item->GrMaskSkew);
 		else
@@ -413,7 +413,7 @@ void ScPageOutput::drawItem_Post( PageItem* item, ScPainterExBase* painter )
 			painter->setPenOpacity(1.0 - item->lineTransparency());
 			if ((item->lineColor() != CommonStrings::None)|| (!item->strokePattern().isEmpty()) || (item->strokeGradientType() > 0))
 			{
-				ScColorShade tmp(m_doc->PageColors[item->lineColor()], (int) item->lineShade());
+				ScColorShade tmp(m_doc->PageColors.value(item->lineColor()), (int) item->lineShade());
 				painter->setPen(tmp, item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 				if (item->DashValues.count() != 0)
 					painter->setDash(item->DashValues, item->DashOffset);
@@ -446,12 +446,12 @@ void ScPageOutput::drawItem_Post( PageItem* item, ScPainterExBase* painter )
 					if ((!gradientStrokeVal.isEmpty()) && (!m_doc->docGradients.contains(gradientStrokeVal)))
 						gradientStrokeVal = "";
 					if (!(gradientStrokeVal.isEmpty()) && (m_doc->docGradients.contains(gradientStrokeVal)))
-						painter->m_strokeGradient = VGradientEx(m_doc->docGradients[gradientStrokeVal], *m_doc);
+						painter->m_strokeGradient = VGradientEx(m_doc->docGradients.value(gradientStrokeVal), *m_doc);
 					if (painter->m_strokeGradient.Stops() < 2) // fall back to solid stroking if there are not enough colorstops in the gradient.
 					{
 						if (item->lineColor() != CommonStrings::None)
 						{
-							ScColorShade strokeColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+							ScColorShade strokeColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 							painter->setBrush(strokeColor);
 							painter->setStrokeMode(ScPainterExBase::Solid);
 						}
@@ -474,7 +474,7 @@ void ScPageOutput::drawItem_Post( PageItem* item, ScPainterExBase* painter )
 				}
 				else if (item->lineColor() != CommonStrings::None)
 				{
-					ScColorShade scColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+					ScColorShade scColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 					painter->setStrokeMode(ScPainterExBase::Solid);
 					painter->setPen(scColor, item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 					if (item->DashValues.count() != 0)
@@ -484,13 +484,13 @@ void ScPageOutput::drawItem_Post( PageItem* item, ScPainterExBase* painter )
 			}
 			else
 			{
-				multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+				multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 				for (int it = ml.size()-1; it > -1; it--)
 				{
 					const SingleLine& sl = ml[it];
 					if ((sl.Color != CommonStrings::None) && (sl.Width != 0))
 					{
-						ScColorShade tmp(m_doc->PageColors[sl.Color], sl.Shade);
+						ScColorShade tmp(m_doc->PageColors.value(sl.Color), sl.Shade);
 						painter->setPen(tmp, sl.Width, static_cast<Qt::PenStyle>(sl.Dash),
 										static_cast<Qt::PenCapStyle>(sl.LineEnd),
 										static_cast<Qt::PenJoinStyle>(sl.LineJoin));
@@ -564,7 +564,7 @@ void ScPageOutput::drawItem_Embedded( PageItem* item, ScPainterExBase *p, QRect
 void ScPageOutput::drawPattern( PageItem* item, ScPainterExBase* painter, QRect clip)
 {
 	double x1, x2, y1, y2;
-	ScPattern& pattern = m_doc->docPatterns[item->pattern()];
+	const ScPattern pattern = m_doc->docPatterns.value(item->pattern());
 	double patternScaleX, patternScaleY, patternOffsetX, patternOffsetY, patternRotation, patternSkewX, patternSkewY;
 	item->patternTransform(patternScaleX, patternScaleY, patternOffsetX, patternOffsetY, patternRotation, patternSkewX, patternSkewY);
 
@@ -854,12 +854,12 @@ void ScPageOutput::drawItem_Line( PageItem_Line* item, ScPainterExBase* painter,
 			if ((!gradientStrokeVal.isEmpty()) && (!m_doc->docGradients.contains(gradientStrokeVal)))
 				gradientStrokeVal = "";
 			if (!(gradientStrokeVal.isEmpty()) && (m_doc->docGradients.contains(gradientStrokeVal)))
-				painter->m_strokeGradient = VGradientEx(m_doc->docGradients[gradientStrokeVal], *m_doc);
+				painter->m_strokeGradient = VGradientEx(m_doc->docGradients.value(gradientStrokeVal), *m_doc);
 			if (painter->m_strokeGradient.Stops() < 2) // fall back to solid stroking if there are not enough colorstops in the gradient.
 			{
 				if (item->lineColor() != CommonStrings::None)
 				{
-					ScColorShade strokeColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+					ScColorShade strokeColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 					painter->setBrush(strokeColor);
 					painter->setStrokeMode(ScPainterExBase::Solid);
 				}
@@ -882,7 +882,7 @@ void ScPageOutput::drawItem_Line( PageItem_Line* item, ScPainterExBase* painter,
 		}
 		else if (item->lineColor() != CommonStrings::None)
 		{
-			ScColorShade scColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+			ScColorShade scColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 			painter->setStrokeMode(ScPainterExBase::Solid);
 			painter->setPen(scColor, item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 			if (item->DashValues.count() != 0)
@@ -893,13 +893,13 @@ void ScPageOutput::drawItem_Line( PageItem_Line* item, ScPainterExBase* painter,
 	else
 	{
 		painter->setStrokeMode(ScPainterExBase::Solid);
-		multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+		multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 		for (int it = ml.size()-1; it > -1; it--)
 		{
 			const SingleLine& sl = ml[it];
 			if ((sl.Color != CommonStrings::None) && (sl.Width != 0))
 			{
-				ScColorShade tmp(m_doc->PageColors[sl.Color], sl.Shade);
+				ScColorShade tmp(m_doc->PageColors.value(sl.Color), sl.Shade);
 				painter->setPen(tmp, sl.Width, static_cast<Qt::PenStyle>(sl.Dash),
 						static_cast<Qt::PenCapStyle>(sl.LineEnd),
 						static_cast<Qt::PenJoinStyle>(sl.LineJoin));
@@ -932,9 +932,9 @@ private:
 	void setupState()
 	{
 		m_painter->setLineWidth(strokeWidth());
-		ScColorShade fill(m_item->doc()->PageColors[fillColor().color], fillColor().shade);
+		ScColorShade fill(m_item->doc()->PageColors.value(fillColor().color), fillColor().shade);
 		m_painter->setBrush(fill);
-		ScColorShade stroke(m_item->doc()->PageColors[strokeColor().color], strokeColor().shade);
+		ScColorShade stroke(m_item->doc()->PageColors.value(strokeColor().color), strokeColor().shade);
 		m_painter->setPen(stroke, strokeWidth(), Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
 
 		if (matrix() != QTransform())
@@ -1191,12 +1191,12 @@ void ScPageOutput::drawItem_PolyLine( PageItem_PolyLine* item, ScPainterExBase*
 			if ((!gradientStrokeVal.isEmpty()) && (!m_doc->docGradients.contains(gradientStrokeVal)))
 				gradientStrokeVal = "";
 			if (!(gradientStrokeVal.isEmpty()) && (m_doc->docGradients.contains(gradientStrokeVal)))
-				painter->m_strokeGradient = VGradientEx(m_doc->docGradients[gradientStrokeVal], *m_doc);
+				painter->m_strokeGradient = VGradientEx(m_doc->docGradients.value(gradientStrokeVal), *m_doc);
 			if (painter->m_strokeGradient.Stops() < 2) // fall back to solid stroking if there are not enough colorstops in the gradient.
 			{
 				if (item->lineColor() != CommonStrings::None)
 				{
-					ScColorShade strokeColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+					ScColorShade strokeColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 					painter->setBrush(strokeColor);
 					painter->setStrokeMode(ScPainterExBase::Solid);
 				}
@@ -1219,7 +1219,7 @@ void ScPageOutput::drawItem_PolyLine( PageItem_PolyLine* item, ScPainterExBase*
 		}
 		else if (item->lineColor() != CommonStrings::None)
 		{
-			ScColorShade scColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+			ScColorShade scColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 			painter->setStrokeMode(ScPainterExBase::Solid);
 			painter->setPen(scColor, item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 			if (item->DashValues.count() != 0)
@@ -1229,13 +1229,13 @@ void ScPageOutput::drawItem_PolyLine( PageItem_PolyLine* item, ScPainterExBase*
 	}
 	else
 	{
-		multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+		multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 		for (int it = ml.size()-1; it > -1; it--)
 		{
 			const SingleLine& sl = ml[it];
 			if (sl.Color != CommonStrings::None)
 			{
-				ScColorShade tmp(m_doc->PageColors[sl.Color], sl.Shade);
+				ScColorShade tmp(m_doc->PageColors.value(sl.Color), sl.Shade);
 				painter->setPen(tmp, sl.Width, static_cast<Qt::PenStyle>(sl.Dash),
 						static_cast<Qt::PenCapStyle>(sl.LineEnd),
 						static_cast<Qt::PenJoinStyle>(sl.LineJoin));
@@ -1358,12 +1358,12 @@ void ScPageOutput::drawItem_Spiral( PageItem_Spiral* item, ScPainterExBase* pain
 			if ((!gradientStrokeVal.isEmpty()) && (!m_doc->docGradients.contains(gradientStrokeVal)))
 				gradientStrokeVal = "";
 			if (!(gradientStrokeVal.isEmpty()) && (m_doc->docGradients.contains(gradientStrokeVal)))
-				painter->m_strokeGradient = VGradientEx(m_doc->docGradients[gradientStrokeVal], *m_doc);
+				painter->m_strokeGradient = VGradientEx(m_doc->docGradients.value(gradientStrokeVal), *m_doc);
 			if (painter->m_strokeGradient.Stops() < 2) // fall back to solid stroking if there are not enough colorstops in the gradient.
 			{
 				if (item->lineColor() != CommonStrings::None)
 				{
-					ScColorShade strokeColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+					ScColorShade strokeColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 					painter->setBrush(strokeColor);
 					painter->setStrokeMode(ScPainterExBase::Solid);
 				}
@@ -1386,7 +1386,7 @@ void ScPageOutput::drawItem_Spiral( PageItem_Spiral* item, ScPainterExBase* pain
 		}
 		else if (item->lineColor() != CommonStrings::None)
 		{
-			ScColorShade scColor(m_doc->PageColors[item->lineColor()], item->lineShade());
+			ScColorShade scColor(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 			painter->setStrokeMode(ScPainterExBase::Solid);
 			painter->setPen(scColor, item->lineWidth(), item->PLineArt, item->PLineEnd, item->PLineJoin);
 			if (item->DashValues.count() != 0)
@@ -1396,13 +1396,13 @@ void ScPageOutput::drawItem_Spiral( PageItem_Spiral* item, ScPainterExBase* pain
 	}
 	else
 	{
-		multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+		multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 		for (int it = ml.size()-1; it > -1; it--)
 		{
 			const SingleLine& sl = ml[it];
 			if (sl.Color != CommonStrings::None)
 			{
-				ScColorShade tmp(m_doc->PageColors[sl.Color], sl.Shade);
+				ScColorShade tmp(m_doc->PageColors.value(sl.Color), sl.Shade);
 				painter->setPen(tmp, sl.Width, static_cast<Qt::PenStyle>(sl.Dash),
 						static_cast<Qt::PenCapStyle>(sl.LineEnd),
 						static_cast<Qt::PenJoinStyle>(sl.LineJoin));
@@ -1473,13 +1473,13 @@ void ScPageOutput::drawItem_Text( PageItem* item, ScPainterExBase* painter, QRec
 		}
 		else
 		{
-			multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+			multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 			for (int it = ml.size() - 1; it > -1; it--)
 			{
 				const SingleLine& sl = ml[it];
 				if ((sl.Color != CommonStrings::None) && (sl.Width != 0))
 				{
-					ScColorShade tmp(m_doc->PageColors[sl.Color], sl.Shade);
+					ScColorShade tmp(m_doc->PageColors.value(sl.Color), sl.Shade);
 					painter->setPen(tmp, sl.Width,  static_cast<Qt::PenStyle>(sl.Dash), 
 							 static_cast<Qt::PenCapStyle>(sl.LineEnd), 
 							 static_cast<Qt::PenJoinStyle>(sl.LineJoin));
@@ -1524,7 +1524,7 @@ void ScPageOutput::drawArrow(ScPainterExBase* painter, PageItem* item, QTransfor
 	}
 	else
 	{
-		multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+		multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 		if (ml[ml.size()-1].Width != 0.0)
 			arrowTrans.scale(ml[ml.size()-1].Width, ml[ml.size()-1].Width);
 	}
@@ -1534,7 +1534,7 @@ void ScPageOutput::drawArrow(ScPainterExBase* painter, PageItem* item, QTransfor
 	{
 		if (item->lineColor() != CommonStrings::None)
 		{
-			ScColorShade tmp(m_doc->PageColors[item->lineColor()], item->lineShade());
+			ScColorShade tmp(m_doc->PageColors.value(item->lineColor()), item->lineShade());
 			painter->setBrush(tmp);
 			painter->setBrushOpacity(1.0 - item->lineTransparency());
 			painter->setLineWidth(0);
@@ -1544,10 +1544,10 @@ void ScPageOutput::drawArrow(ScPainterExBase* painter, PageItem* item, QTransfor
 	}
 	else
 	{
-		multiLine ml = m_doc->MLineStyles[item->NamedLStyle];
+		multiLine ml = m_doc->MLineStyles.value(item->NamedLStyle);
 		if (ml[0].Color != CommonStrings::None)
 		{
-			ScColorShade tmp(m_doc->PageColors[ml[0].Color], ml[0].Shade);
+			ScColorShade tmp(m_doc->PageColors.value(ml[0].Color), ml[0].Shade);
 			painter->setBrush(tmp);
 			painter->setLineWidth(0);
 			painter->setFillMode(ScPainterExBase::Solid);
@@ -1557,7 +1557,7 @@ void ScPageOutput::drawArrow(ScPainterExBase* painter, PageItem* item, QTransfor
 		{
 			if (ml[it].Color != CommonStrings::None)
 			{
-				ScColorShade tmp(m_doc->PageColors[ml[it].Color], ml[it].Shade);
+				ScColorShade tmp(m_doc->PageColors.value(ml[it].Color), ml[it].Shade);
 				painter->setPen(tmp, ml[it].Width, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
 				painter->strokePath();
 			}
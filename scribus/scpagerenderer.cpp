@@ -0,0 +1,219 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cairo.h>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+
+#include "pageitem.h"
+#include "scpage.h"
+#include "scpageoutput.h"
+#include "scpagerenderer.h"
+#include "scpainterex_cairo.h"
+#include "scribusdoc.h"
+
+// serializes the drawing of items which are changed while they are drawn
+static QMutex s_changingItemsMutex;
+
+/**
+ Draws a page like ScPageOutput, but holds s_changingItemsMutex while drawing items
+ which ScPageOutput changes temporarily, see ScPageRenderer.
+ */
+class ScPageRendererOutput : public ScPageOutput
+{
+public:
+	ScPageRendererOutput(ScribusDoc* doc, bool reloadImages, int resolution, bool useProfiles, const QRect& clip)
+		: ScPageOutput(doc, reloadImages, resolution, useProfiles), m_clip(clip), m_locked(false)
+	{ }
+
+	void drawPage(ScPage* page, ScPainterExBase* painter)
+	{
+		// same as ScPageOutput, but items in the bleeds are drawn if requested
+		ScLayer layer;
+		layer.isViewable = false;
+		int layerCount = m_doc->layerCount();
+		for (int la = 0; la < layerCount; ++la)
+		{
+			m_doc->Layers.levelToLayer(layer, la);
+			drawMasterItems(painter, page, layer, m_clip);
+			drawPageItems(painter, page, layer, m_clip);
+		}
+	}
+
+protected:
+	void drawMasterItems(ScPainterExBase* painter, ScPage* page, ScLayer& layer, QRect clip)
+	{
+		if (page->MPageNam.isEmpty() || page->FromMaster.isEmpty())
+			return;
+		// master items are moved to page and laid out again for its page number
+		QMutexLocker locker(&s_changingItemsMutex);
+		m_locked = true;
+		ScPageOutput::drawMasterItems(painter, page, layer, clip);
+		m_locked = false;
+	}
+
+	void drawPageItems(ScPainterExBase* painter, ScPage* page, ScLayer& layer, QRect clip)
+	{
+		if (!layer.isViewable || !layer.isPrintable)
+			return;
+		// the items of page, whether the views of the document edit master pages or not
+		bool masterPage = !page->pageName().isEmpty();
+		const QList<PageItem*>& items = masterPage ? m_doc->MasterItems : m_doc->DocItems;
+		for (PageItem* item : items)
+		{
+			if ((item->LayerID != layer.ID) || !item->printEnabled())
+				continue;
+			if (masterPage && (item->OnMasterPage != page->pageName()))
+				continue;
+			QRectF bounds(item->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0));
+			if (clip.intersects(bounds.toRect()))
+				drawItem(item, painter, clip);
+		}
+	}
+
+	void drawItem(PageItem* item, ScPainterExBase* painter, QRect clip)
+	{
+		if (m_locked || !ScPageRenderer::changesWhenDrawn(m_doc, item, m_reloadImages))
+		{
+			ScPageOutput::drawItem(item, painter, clip);
+			return;
+		}
+		QMutexLocker locker(&s_changingItemsMutex);
+		m_locked = true;
+		ScPageOutput::drawItem(item, painter, clip);
+		m_locked = false;
+	}
+
+private:
+	QRect m_clip;
+	// true while this output holds s_changingItemsMutex
+	bool m_locked;
+};
+
+ScPageRenderer::ScPageRenderer(ScribusDoc* doc) :
+	m_doc(doc)
+{
+}
+
+void ScPageRenderer::prepare(const QList<ScPage*>& pages)
+{
+	QList<PageItem*> items(m_doc->getAllItems(m_doc->DocItems) + m_doc->getAllItems(m_doc->MasterItems));
+	for (PageItem* item : qAsConst(items))
+	{
+		if (!item->invalid || !(item->isTextFrame() || item->isPathText()))
+			continue;
+		bool onPages = pages.isEmpty();
+		QRectF bounds(item->getBoundingRect());
+		for (int i = 0; !onPages && (i < pages.count()); ++i)
+		{
+			const ScPage* page = pages.at(i);
+			onPages = bounds.intersects(QRectF(page->xOffset(), page->yOffset(), page->width(), page->height()));
+		}
+		if (onPages)
+			item->layout();
+	}
+}
+
+void ScPageRenderer::prepare(const QRectF& area)
+{
+	// group members and inline objects are laid out when drawn, which is serialized
+	const QList<int> indices(m_doc->itemIndicesIn(area));
+	for (int index : indices)
+	{
+		PageItem* item = m_doc->Items->at(index);
+		if (item->invalid && (item->isTextFrame() || item->isPathText()))
+			item->layout();
+	}
+}
+
+QImage ScPageRenderer::render(ScPage* page, double dpi, RenderFlags flags) const
+{
+	QImage image;
+	if (dpi <= 0.0)
+		return image;
+
+	QRectF area(page->xOffset(), page->yOffset(), page->width(), page->height());
+	if (flags & IncludeBleeds)
+	{
+		MarginStruct bleeds;
+		m_doc->getBleeds(page, bleeds);
+		area.adjust(-bleeds.left(), -bleeds.top(), bleeds.right(), bleeds.bottom());
+	}
+	double scale = dpi / 72.0;
+	int width = qRound(area.width() * scale);
+	int height = qRound(area.height() * scale);
+	if ((width <= 0) || (height <= 0))
+		return image;
+	image = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+	if (image.isNull())
+		return image;
+	image.setDotsPerMeterX(qRound(dpi / 0.0254));
+	image.setDotsPerMeterY(qRound(dpi / 0.0254));
+	if (flags & DrawBackground)
+	{
+		QColor paper(m_doc->paperColor());
+		if (flags & Grayscale)
+			paper = QColor(qGray(paper.rgb()), qGray(paper.rgb()), qGray(paper.rgb()));
+		image.fill(paper);
+	}
+	else if (flags & DrawWhiteBackground)
+		image.fill(Qt::white);
+	else
+		image.fill(Qt::transparent);
+
+	cairo_surface_t* surface = cairo_image_surface_create_for_data(image.bits(), CAIRO_FORMAT_ARGB32, width, height, image.bytesPerLine());
+	if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_surface_destroy(surface);
+		return QImage();
+	}
+	cairo_t* context = cairo_create(surface);
+
+	// the output reloads images at the output resolution, at least at 72 dpi
+	int imageRes = qMax(72, qCeil(dpi));
+	ScPageRendererOutput output(m_doc, flags.testFlag(ReloadImages), imageRes, flags.testFlag(UseProfiles), area.toAlignedRect());
+	{
+		QRect drawRect(0, 0, width, height);
+		ScPainterEx_Cairo painter(context, drawRect, m_doc, flags.testFlag(Grayscale));
+		painter.setWorldMatrix(QTransform(scale, 0.0, 0.0, scale, -area.x() * scale, -area.y() * scale));
+		output.drawPage(page, &painter);
+	}
+
+	cairo_destroy(context);
+	cairo_surface_flush(surface);
+	cairo_surface_destroy(surface);
+	return image;
+}
+
+bool ScPageRenderer::changesWhenDrawn(const ScribusDoc* doc, const PageItem* item, bool reloadImages)
+{
+	// members of groups and tables are flagged as embedded and invalidated
+	if (item->isGroup() || item->isTable())
+		return true;
+	// inline objects are moved and flagged as embedded
+	if ((item->isTextFrame() || item->isPathText()) && !doc->FrameItems.isEmpty())
+		return true;
+	// loaders and colour management of images are not known to be reentrant
+	if (reloadImages && item->isImageFrame())
+		return true;
+	return false;
+}
+
+QMutex* ScPageRenderer::changingItemsMutex()
+{
+	return &s_changingItemsMutex;
+}
+
+double ScPageRenderer::dpiForSize(const ScPage* page, int maxSize)
+{
+	double longSide = qMax(page->width(), page->height());
+	if (longSide <= 0.0)
+		return 72.0;
+	return maxSize * 72.0 / longSide;
+}
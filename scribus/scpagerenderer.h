@@ -0,0 +1,81 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCPAGERENDERER_H
+#define SCPAGERENDERER_H
+
+#include <QFlags>
+#include <QImage>
+#include <QList>
+#include <QRectF>
+
+#include "scribusapi.h"
+
+class PageItem;
+class QMutex;
+class ScPage;
+class ScribusDoc;
+
+/**
+ ScPageRenderer rasterizes pages of a document into images without a view. Pages are drawn
+ through ScPageOutput and ScPainterEx_Cairo, neither the canvas nor any view or document
+ setting is changed, so it can be used while the document is displayed and without a GUI.
+
+ render() may be called from several threads at once to render different pages in parallel.
+ Text must be laid out before, which is what prepare() does on the thread owning the document.
+ Drawing some items temporarily changes them: master page items are moved to the page they
+ are drawn on, group members and inline objects are flagged as embedded and images may be
+ reloaded. These items are drawn by one thread at a time, all others concurrently.
+ The document must not be changed while pages are rendered.
+ */
+class SCRIBUS_API ScPageRenderer
+{
+public:
+	enum RenderFlag
+	{
+		NoFlags = 0,
+		DrawBackground = 1 << 0,      ///< fill the page with the paper colour, it is transparent otherwise
+		DrawWhiteBackground = 1 << 1, ///< fill the page with white
+		ReloadImages = 1 << 2,        ///< load images at the output resolution instead of drawing their previews
+		UseProfiles = 1 << 3,         ///< colour manage reloaded images
+		Grayscale = 1 << 4,           ///< convert all colours to gray
+		IncludeBleeds = 1 << 5        ///< extend the image by the bleeds of the page
+	};
+	Q_DECLARE_FLAGS(RenderFlags, RenderFlag)
+
+	explicit ScPageRenderer(ScribusDoc* doc);
+
+	/**
+	 Lays out the text frames of pages and of their master pages, must be called from the thread
+	 owning the document before pages are rendered from other threads. All pages if pages is empty.
+	 */
+	void prepare(const QList<ScPage*>& pages = QList<ScPage*>());
+	/// Lays out the text frames of the current item list near area, in canvas coordinates
+	void prepare(const QRectF& area);
+	/**
+	 Renders page at dpi. Returns a null image if the image can't be allocated.
+	 The image is in QImage::Format_ARGB32_Premultiplied and has its dots per meter set to dpi.
+	 */
+	QImage render(ScPage* page, double dpi, RenderFlags flags = DrawBackground) const;
+
+	/// the resolution at which the longer side of page is maxSize pixels
+	static double dpiForSize(const ScPage* page, int maxSize);
+
+	/**
+	 True if drawing item changes it or other items temporarily. Such items, and master page items,
+	 must only be drawn from other threads while changingItemsMutex() is held.
+	 */
+	static bool changesWhenDrawn(const ScribusDoc* doc, const PageItem* item, bool reloadImages);
+	static QMutex* changingItemsMutex();
+
+private:
+	ScribusDoc* m_doc;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ScPageRenderer::RenderFlags)
+
+#endif
@@ -562,6 +562,11 @@ QString ScPaths::imageCacheDir(void)
 	return applicationDataDir() + "cache/img/";
 }
 
+QString ScPaths::pdfImageCacheDir(void)
+{
+	return applicationDataDir() + "cache/pdf/";
+}
+
 QString ScPaths::pluginDataDir(bool createIfNotExists)
 {
 	QDir useFilesDirectory(applicationDataDir() + "plugins/");
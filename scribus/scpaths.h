@@ -87,6 +87,8 @@ public:
 	static QString userTemplateDir(bool createIfNotExists);
 	/** @brief Return path to image cache dir*/
 	static QString imageCacheDir();
+	/** @brief Return path to the cache of image streams encoded by the PDF export*/
+	static QString pdfImageCacheDir();
 	/** @brief Return path to plugin data dir*/
 	static QString pluginDataDir(bool createIfNotExists);
 	/** @brief Return path to user documents*/
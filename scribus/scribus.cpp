@@ -111,6 +111,7 @@ for which a new license (GPL+exception) is in place.
 #include "fpoint.h"
 #include "fpointarray.h"
 #include "gtgettext.h"
+#include "hyphenationservice.h"
 #include "hyphenator.h"
 #include "iconmanager.h"
 #include "langmgr.h"
@@ -141,6 +142,7 @@ for which a new license (GPL+exception) is in place.
 #include "scimagecachemanager.h"
 #include "scmimedata.h"
 #include "scpage.h"
+#include "scpagerenderer.h"
 #include "scpaths.h"
 #include "scprintengine_ps.h"
 #include "scraction.h"
@@ -2015,6 +2017,7 @@ void ScribusMainWindow::closeEvent(QCloseEvent *ce)
 	UndoManager::deleteInstance();
 	FormatsManager::deleteInstance();
 	UrlLauncher::deleteInstance();
+	HyphenationService::deleteInstance();
 //	qApp->changeOverrideCursor(QCursor(Qt::ArrowCursor));
 	ce->accept();
 }
@@ -3953,7 +3956,7 @@ void ScribusMainWindow::slotGetContent()
 			}
 			delete gt;
 			if (doc->docHyphenator->AutoCheck)
-				doc->docHyphenator->slotHyphenate(currItem);
+				doc->docHyphenator->slotHyphenateLater(currItem);
 			for (int a = 0; a < doc->Items->count(); ++a)
 			{
 				if (doc->Items->at(a)->isBookmark)
@@ -4005,7 +4008,7 @@ void ScribusMainWindow::slotGetContent2() // kk2006
 
 	ScGTPluginManager::instance()->run();
 	if (doc->docHyphenator->AutoCheck)
-		doc->docHyphenator->slotHyphenate(currItem);
+		doc->docHyphenator->slotHyphenateLater(currItem);
 	for (int a = 0; a < doc->Items->count(); ++a)
 	{
 		if (doc->Items->at(a)->isBookmark)
@@ -7236,6 +7239,9 @@ void ScribusMainWindow::doSaveAsPDF()
 		doc->cmsSettings().GamutCheck = false;
 		doc->enableCMS(true);
 	}
+	ScPageRenderer thumbRenderer(doc);
+	if (doc->pdfOptions().Thumbnails)
+		thumbRenderer.prepare();
 	pageNumbersSize = pageNs.size();
 	for (uint i = 0; i < pageNumbersSize; ++i)
 	{
@@ -7243,8 +7249,8 @@ void ScribusMainWindow::doSaveAsPDF()
 		if (doc->pdfOptions().Thumbnails)
 		{
 			// No need to load full res images for drawing small thumbnail
-			PageToPixmapFlags flags = Pixmap_DontReloadImages | Pixmap_DrawWhiteBackground;
-			thumb = view->PageToPixmap(pageNs[i] - 1, 100, flags);
+			ScPage* thumbPage = doc->DocPages.at(pageNs[i] - 1);
+			thumb = thumbRenderer.render(thumbPage, ScPageRenderer::dpiForSize(thumbPage, 100), ScPageRenderer::DrawWhiteBackground);
 		}
 		allThumbs.insert(pageNs[i], thumb);
 	}
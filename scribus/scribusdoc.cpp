@@ -38,6 +38,7 @@ for which a new license (GPL+exception) is in place.
 #include <QProgressBar>
 #include <QtAlgorithms>
 #include <QTime>
+#include <QUuid>
 //#include <qtconcurrentmap.h>
 
 #include "actionmanager.h"
@@ -74,6 +75,7 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_spiral.h"
 #include "pageitem_symbol.h"
 #include "pagesize.h"
+#include "pagethumbnailcache.h"
 #include "pagestructs.h"
 #include "pdfwriter.h"
 #include "prefsfile.h"
@@ -126,7 +128,7 @@ for which a new license (GPL+exception) is in place.
  This class forwards change events for pages and pageitems to 
  the region occupied by this page or pageitem.
  */
-class DocUpdater : public Observer<ScPage*>, public Observer<PageItem*>
+class DocUpdater : public Observer<ScPage*>, public Observer<PageItem*>, public Observer<QRectF>
 {
 	ScribusDoc* doc;
 	int  m_updateEnabled;
@@ -161,6 +163,7 @@ public:
 	
 	void changed(ScPage* pg, bool /*doLayout*/)
 	{
+		doc->bumpRevision(pg);
 		QRectF pagebox(pg->xOffset(), pg->yOffset(), pg->width(), pg->height());
 		doc->invalidateRegion(pagebox);
 		doc->regionsChanged()->update(pagebox);
@@ -174,6 +177,7 @@ public:
 	
 	void changed(PageItem* it, bool doLayout)
 	{
+		doc->bumpRevision(it);
 		it->invalidateLayout();
 		if (doLayout)
 			it->layout();
@@ -193,6 +197,11 @@ public:
 		m_docChangeNeeded = true;
 	}
 
+	void changed(QRectF re, bool /*doLayout*/)
+	{
+		doc->bumpRevision(re);
+	}
+
 	void setDocChangeNeeded(bool changeNeeded = true)
 	{
 		m_docChangeNeeded = changeNeeded;
@@ -282,6 +291,13 @@ ScribusDoc::ScribusDoc() : UndoObject( tr("Document")), Observable<ScribusDoc>(n
 	m_currentPage(nullptr),
 	m_updateManager(),
 	m_docUpdater(nullptr),
+	m_thumbnailCache(nullptr),
+	m_revisionSession(QUuid::createUuid().toRfc4122()),
+	m_revision(0),
+	m_settingsRevision(0),
+	m_layersRevision(0),
+	m_styleChangeLevel(0),
+	m_allStylesChanged(false),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -399,6 +415,13 @@ ScribusDoc::ScribusDoc(const QString& docName, int unitindex, const PageSize& pa
 	m_currentPage(nullptr),
 	m_updateManager(),
 	m_docUpdater(nullptr),
+	m_thumbnailCache(nullptr),
+	m_revisionSession(QUuid::createUuid().toRfc4122()),
+	m_revision(0),
+	m_settingsRevision(0),
+	m_layersRevision(0),
+	m_styleChangeLevel(0),
+	m_allStylesChanged(false),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -451,6 +474,7 @@ void ScribusDoc::init()
 	m_docUpdater = new DocUpdater(this);
 	m_itemsChanged.connectObserver(m_docUpdater);
 	m_pagesChanged.connectObserver(m_docUpdater);
+	m_regionsChanged.connectObserver(m_docUpdater);
 
 	PrefsManager *prefsManager = PrefsManager::instance();
 	m_docPrefsData.colorPrefs.DCMSset = prefsManager->appPrefs.colorPrefs.DCMSset;
@@ -619,6 +643,11 @@ void ScribusDoc::init()
 ScribusDoc::~ScribusDoc()
 {
 	m_guardedObject.nullify();
+	delete m_thumbnailCache;
+	m_thumbnailCache = nullptr;
+	// items are deleted below, nothing needs to be looked up any more
+	m_docItemLookup.clear();
+	m_masterItemLookup.clear();
 	CloseCMSProfiles();
 	ScCore->fileWatcher->stop();
 	ScCore->fileWatcher->removeFile(DocName);
@@ -950,6 +979,89 @@ const ScGuardedPtr<ScribusDoc>& ScribusDoc::guardedPtr() const
 	return m_guardedObject;
 }
 
+PageThumbnailCache* ScribusDoc::thumbnailCache()
+{
+	if (!m_thumbnailCache)
+		m_thumbnailCache = new PageThumbnailCache(this);
+	return m_thumbnailCache;
+}
+
+quint64 ScribusDoc::pageRevision(const ScPage* page) const
+{
+	quint64 revision = qMax(m_settingsRevision, m_layersRevision);
+	revision = qMax(revision, page->revision());
+	int masterIndex = MasterNames.value(page->MPageNam, -1);
+	if ((masterIndex >= 0) && (masterIndex < MasterPages.count()))
+		revision = qMax(revision, MasterPages.at(masterIndex)->revision());
+	return revision;
+}
+
+void ScribusDoc::bumpRevision()
+{
+	m_settingsRevision = nextRevision();
+}
+
+void ScribusDoc::bumpRevision(PageItem* item)
+{
+	quint64 revision = nextRevision();
+	PageItem* topItem = item;
+	for (PageItem* parent = item; parent != nullptr; parent = parent->Parent)
+	{
+		parent->setRevision(revision);
+		topItem = parent;
+	}
+	if (!topItem->OnMasterPage.isEmpty())
+	{
+		int masterIndex = MasterNames.value(topItem->OnMasterPage, -1);
+		if ((masterIndex >= 0) && (masterIndex < MasterPages.count()))
+			MasterPages.at(masterIndex)->setRevision(revision);
+		return;
+	}
+	QRectF bounds(topItem->getVisualBoundingRect());
+	for (ScPage* page : qAsConst(DocPages))
+	{
+		QRectF pageRect(page->xOffset() - bleeds()->left(), page->yOffset() - bleeds()->top(),
+						page->width() + bleeds()->left() + bleeds()->right(), page->height() + bleeds()->top() + bleeds()->bottom());
+		if (pageRect.intersects(bounds))
+			page->setRevision(revision);
+	}
+}
+
+void ScribusDoc::bumpRevision(ScPage* page)
+{
+	page->setRevision(nextRevision());
+}
+
+void ScribusDoc::bumpRevision(const QRectF& region)
+{
+	if (!region.isValid())
+	{
+		bumpRevision();
+		return;
+	}
+	// regions are in the coordinates of the pages being edited
+	quint64 revision = nextRevision();
+	const QList<ScPage*>& pages = m_masterPageMode ? MasterPages : DocPages;
+	for (ScPage* page : pages)
+	{
+		QRectF pageRect(page->xOffset() - bleeds()->left(), page->yOffset() - bleeds()->top(),
+						page->width() + bleeds()->left() + bleeds()->right(), page->height() + bleeds()->top() + bleeds()->bottom());
+		if (pageRect.intersects(region))
+			page->setRevision(revision);
+	}
+}
+
+void ScribusDoc::bumpLayerRevision(int layerID)
+{
+	quint64 revision = nextRevision();
+	for (auto it = Layers.begin(); it != Layers.end(); ++it)
+	{
+		if (it->ID == layerID)
+			it->revision = revision;
+	}
+	m_layersRevision = revision;
+}
+
 
 void ScribusDoc::CloseCMSProfiles()
 {
@@ -1362,6 +1474,13 @@ void ScribusDoc::replaceStyles(const QMap<QString,QString>& newNameForOld)
 
 void ScribusDoc::replaceNamedResources(ResourceCollection& newNames)
 {
+	beginStyleChanges();
+	if (!newNames.colors().isEmpty() || !newNames.fonts().isEmpty() || !newNames.fontfeatures().isEmpty())
+		allStylesChanged();
+	for (auto it = newNames.styles().constBegin(); it != newNames.styles().constEnd(); ++it)
+		paragraphStyleChanged(it.key());
+	for (auto it = newNames.charStyles().constBegin(); it != newNames.charStyles().constEnd(); ++it)
+		charStyleChanged(it.key());
 	// replace names in items
 	QList<PageItem*> * itemlist = & MasterItems;
 	while (itemlist != nullptr)
@@ -1484,6 +1603,7 @@ void ScribusDoc::replaceNamedResources(ResourceCollection& newNames)
 			&& newNames.styles().isEmpty() && newNames.charStyles().isEmpty() && newNames.lineStyles().isEmpty()
 			&& newNames.tableStyles().isEmpty() && newNames.cellStyles().isEmpty()))
 		changed();
+	endStyleChanges();
 }
 
 
@@ -1510,6 +1630,17 @@ void ScribusDoc::replaceCellStyles(const QMap<QString, QString>& newNameForOld)
 
 void ScribusDoc::redefineStyles(const StyleSet<ParagraphStyle>& newStyles, bool removeUnused)
 {
+	beginStyleChanges();
+	for (int i = 0; i < newStyles.count(); ++i)
+	{
+		int j = m_docParagraphStyles.find(newStyles[i].name());
+		if ((j < 0) || !m_docParagraphStyles[j].equiv(newStyles[i]))
+			paragraphStyleChanged(newStyles[i].name());
+	}
+	const ParagraphStyle* oldDefault = m_docParagraphStyles.getDefault();
+	const ParagraphStyle* newDefault = newStyles.getDefault();
+	if (newDefault && (!oldDefault || (oldDefault->name() != newDefault->name())))
+		allStylesChanged();
 	m_docParagraphStyles.redefine(newStyles, false);
 	if (removeUnused)
 	{
@@ -1543,10 +1674,22 @@ void ScribusDoc::redefineStyles(const StyleSet<ParagraphStyle>& newStyles, bool
 		flag_Renumber = true;
 		flag_NumUpdateRequest = true;
 	}
+	endStyleChanges();
 }
 
 void ScribusDoc::redefineCharStyles(const StyleSet<CharStyle>& newStyles, bool removeUnused)
 {
+	beginStyleChanges();
+	for (int i = 0; i < newStyles.count(); ++i)
+	{
+		int j = m_docCharStyles.find(newStyles[i].name());
+		if ((j < 0) || !m_docCharStyles[j].equiv(newStyles[i]))
+			charStyleChanged(newStyles[i].name());
+	}
+	const CharStyle* oldDefault = m_docCharStyles.getDefault();
+	const CharStyle* newDefault = newStyles.getDefault();
+	if (newDefault && (!oldDefault || (oldDefault->name() != newDefault->name())))
+		allStylesChanged();
 	m_docCharStyles.redefine(newStyles, false);
 	if (removeUnused)
 	{
@@ -1564,6 +1707,7 @@ void ScribusDoc::redefineCharStyles(const StyleSet<CharStyle>& newStyles, bool r
 			replaceCharStyles(deletion);
 	}
 	m_docCharStyles.invalidate();
+	endStyleChanges();
 }
 
 void ScribusDoc::redefineTableStyles(const StyleSet<TableStyle>& newStyles, bool removeUnused)
@@ -1882,25 +2026,25 @@ void ScribusDoc::restore(UndoState* state, bool isUndo)
 		restoreChangePageProperties(ss,isUndo);
 	else if (ss->contains("DELETE_FRAMETEXT"))
 	{
-		PageItem * nF = getItemFromName(ss->get("noteframeName"));
+		PageItem * nF = getTopLevelItemFromName(ss->get("noteframeName"));
 		Q_ASSERT(nF != nullptr);
 		nF->asNoteFrame()->restoreDeleteNoteText(ss, isUndo);
 	}
 	else if (ss->contains("DELETE_FRAMEPARA"))
 	{
-		PageItem * nF = getItemFromName(ss->get("noteframeName"));
+		PageItem * nF = getTopLevelItemFromName(ss->get("noteframeName"));
 		Q_ASSERT(nF != nullptr);
 		nF->asNoteFrame()->restoreDeleteNoteParagraph(ss, isUndo);
 	}
 	else if (ss->contains("INSERT_FRAMETEXT"))
 	{
-		PageItem * nF = getItemFromName(ss->get("noteframeName"));
+		PageItem * nF = getTopLevelItemFromName(ss->get("noteframeName"));
 		Q_ASSERT(nF != nullptr);
 		nF->asNoteFrame()->restoreInsertNoteText(ss,isUndo);
 	}
 	else if (ss->contains("INSERT_FRAMEPARA"))
 	{
-		PageItem * nF = getItemFromName(ss->get("noteframeName"));
+		PageItem * nF = getTopLevelItemFromName(ss->get("noteframeName"));
 		Q_ASSERT(nF != nullptr);
 		nF->asNoteFrame()->restoreInsertNoteParagraph(ss,isUndo);
 	}
@@ -2015,7 +2159,7 @@ void ScribusDoc::restore(UndoState* state, bool isUndo)
 			NotesStyle* nStyle = getNotesStyle(is->get("nStyle"));
 			PageItem* master = nullptr;
 			if (is->contains("noteframeName"))
-				master = getItemFromName(is->get("noteframeName"));
+				master = getTopLevelItemFromName(is->get("noteframeName"));
 			else
 				master = (PageItem*) is->getItem("inItem");
 			if (isUndo)
@@ -2062,7 +2206,7 @@ void ScribusDoc::restore(UndoState* state, bool isUndo)
 			PageItem* currItem = nullptr;
 			if (is->contains("noteframeName"))
 			{
-				currItem = getItemFromName(is->get("noteframeName"));
+				currItem = getTopLevelItemFromName(is->get("noteframeName"));
 				if (currItem != nullptr)
 					isAutoNoteFrame = currItem->asNoteFrame()->isAutoFrame();
 			}
@@ -3007,6 +3151,7 @@ bool ScribusDoc::deleteLayer(const int layerID, const bool deleteItems)
 		removeLayer(layerID, deleteItems);
 
 	//Now delete the layer
+	bumpLayerRevision(layerID);
 	Layers.removeLayerByID(layerID);
 
 	if (activeTransaction)
@@ -3083,7 +3228,10 @@ bool ScribusDoc::setLayerPrintable(const int layerID, const bool isPrintable)
 		}
 	}
 	if (found)
+	{
+		bumpLayerRevision(layerID);
 		changed();
+	}
 	return found;
 }
 
@@ -3114,7 +3262,10 @@ bool ScribusDoc::setLayerVisible(const int layerID, const bool isViewable)
 		}
 	}
 	if (found)
+	{
+		bumpLayerRevision(layerID);
 		changed();
+	}
 	return found;
 }
 
@@ -3231,6 +3382,7 @@ bool ScribusDoc::setLayerFlow(const int layerID, const bool flow)
 				break;
 			invalidateLayer(it->ID);
 		}
+		bumpLayerRevision(layerID);
 		changed();
 	}
 	return found;
@@ -3272,7 +3424,10 @@ bool ScribusDoc::setLayerTransparency(const int layerID, double trans)
 		}
 	}
 	if (found)
+	{
+		bumpLayerRevision(layerID);
 		changed();
+	}
 	return found;
 }
 
@@ -3312,7 +3467,10 @@ bool ScribusDoc::setLayerBlendMode(const int layerID, int blend)
 		}
 	}
 	if (found)
+	{
+		bumpLayerRevision(layerID);
 		changed();
+	}
 	return found;
 }
 
@@ -3343,7 +3501,10 @@ bool ScribusDoc::setLayerOutline(const int layerID, const bool outline)
 		}
 	}
 	if (found)
+	{
+		bumpLayerRevision(layerID);
 		changed();
+	}
 	return found;
 }
 
@@ -3467,6 +3628,8 @@ bool ScribusDoc::lowerLayerByLevel(const int layerLevel)
 	}
 	it2->Level -= 1;
 	it->Level  += 1;
+	bumpLayerRevision(it->ID);
+	bumpLayerRevision(it2->ID);
 	// #9188 : invalidate layout of items in below layers
 	int maxLevel = qMax(it->Level, it2->Level);
 	for (it = Layers.begin(); it != itend; ++it)
@@ -3514,6 +3677,8 @@ bool ScribusDoc::raiseLayerByLevel(const int layerLevel)
 	}
 	it2->Level += 1;
 	it->Level  -= 1;
+	bumpLayerRevision(it->ID);
+	bumpLayerRevision(it2->ID);
 	// #9188 : invalidate layout of items in below layers
 	int maxLevel = qMax(it->Level, it2->Level);
 	for (it = Layers.begin(); it != itend; ++it)
@@ -5779,29 +5944,95 @@ bool ScribusDoc::itemAddCommit(PageItem* item)
 
 int ScribusDoc::getItemNrfromUniqueID(uint unique)
 {
-	int ret = 0;
-	for (int i = 0; i < Items->count(); ++i)
+	PageItem* item = nullptr;
+	if (Items == &DocItems)
+		item = m_docItemLookup.itemByUniqueID(DocItems, unique);
+	else if (Items == &MasterItems)
+		item = m_masterItemLookup.itemByUniqueID(MasterItems, unique);
+	else
 	{
-		if (Items->at(i)->uniqueNr == unique)
+		for (int i = 0; i < Items->count(); ++i)
 		{
-			ret = Items->indexOf(Items->at(i));
-			break;
+			if (Items->at(i)->uniqueNr == unique)
+				return i;
 		}
 	}
-	return ret;
+	if ((item == nullptr) || item->isGroupChild())
+		return 0;
+	return Items->indexOf(item);
 }
 
-PageItem* ScribusDoc::getItemFromName(QString name)
+PageItem* ScribusDoc::getItemFromName(const QString& name)
 {
+	if (Items == &DocItems)
+		return m_docItemLookup.itemByName(DocItems, name);
+	if (Items == &MasterItems)
+		return m_masterItemLookup.itemByName(MasterItems, name);
 	PageItem* ret = nullptr;
 	for (int i = 0; i < Items->count(); ++i)
 	{
 		if (Items->at(i)->itemName() == name)
 			return Items->at(i);
 	}
+	for (int i = 0; i < Items->count(); ++i)
+	{
+		if (!Items->at(i)->isGroup())
+			continue;
+		QList<PageItem*> allItems = Items->at(i)->getAllChildren();
+		for (int j = 0; j < allItems.count(); ++j)
+		{
+			if (allItems.at(j)->itemName() == name)
+				return allItems.at(j);
+		}
+	}
 	return ret;
 }
 
+QList<int> ScribusDoc::itemIndicesIn(const QRectF& area)
+{
+	return itemIndicesIn(*Items, area);
+}
+
+QList<int> ScribusDoc::itemIndicesIn(const QList<PageItem*>& items, const QRectF& area)
+{
+	if (&items == &DocItems)
+		return m_docItemIndex.indicesIn(DocItems, area);
+	if (&items == &MasterItems)
+		return m_masterItemIndex.indicesIn(MasterItems, area);
+	QList<int> indices;
+	indices.reserve(items.count());
+	for (int i = 0; i < items.count(); ++i)
+		indices.append(i);
+	return indices;
+}
+
+void ScribusDoc::itemGeometryChanged(PageItem* item)
+{
+	m_docItemIndex.itemChanged(item);
+	m_masterItemIndex.itemChanged(item);
+}
+
+PageItem* ScribusDoc::getTopLevelItemFromName(const QString& name)
+{
+	// top level items are found first
+	PageItem* item = getItemFromName(name);
+	if ((item == nullptr) || item->isGroupChild())
+		return nullptr;
+	return item;
+}
+
+void ScribusDoc::itemRenamed(PageItem* item)
+{
+	m_docItemLookup.itemRenamed(item);
+	m_masterItemLookup.itemRenamed(item);
+}
+
+void ScribusDoc::itemDeleted(PageItem* item)
+{
+	m_docItemLookup.itemDeleted(item);
+	m_masterItemLookup.itemDeleted(item);
+}
+
 void ScribusDoc::rebuildItemLists()
 {
 	// #5826 Rebuild items list in case layer order as been changed
@@ -6614,6 +6845,10 @@ int ScribusDoc::currentPageNumber()
 
 bool ScribusDoc::itemNameExists(const QString checkItemName)
 {
+	if (Items == &DocItems)
+		return m_docItemLookup.itemByName(DocItems, checkItemName) != nullptr;
+	if (Items == &MasterItems)
+		return m_masterItemLookup.itemByName(MasterItems, checkItemName) != nullptr;
 	bool found = false;
 	QList<PageItem*> allItems;
 	int docItemCount = Items->count();
@@ -13101,6 +13336,182 @@ void ScribusDoc::endUpdate()
 	m_docUpdater->endUpdate();
 }
 
+void ScribusDoc::beginStyleChanges()
+{
+	++m_styleChangeLevel;
+}
+
+// adds the styles inheriting from one of names to names, children maps parents to their children
+static void addInheritingStyles(QSet<QString>& names, const QMultiHash<QString, QString>& children)
+{
+	QStringList pending(names.toList());
+	while (!pending.isEmpty())
+	{
+		QString name(pending.takeLast());
+		for (auto it = children.constFind(name); (it != children.constEnd()) && (it.key() == name); ++it)
+		{
+			if (names.contains(it.value()))
+				continue;
+			names.insert(it.value());
+			pending.append(it.value());
+		}
+	}
+}
+
+void ScribusDoc::endStyleChanges()
+{
+	if ((m_styleChangeLevel <= 0) || (--m_styleChangeLevel > 0))
+		return;
+	QList<QPointer<StoryText> > stories(m_styleChangedStoryList);
+	QSet<QString> paragraphStyles(m_changedParagraphStyles);
+	QSet<QString> charStyles(m_changedCharStyles);
+	bool all = m_allStylesChanged;
+	m_styleChangedStoryList.clear();
+	m_styleChangedStories.clear();
+	m_changedParagraphStyles.clear();
+	m_changedCharStyles.clear();
+	m_allStylesChanged = false;
+	// only stories connected to a style set which changed need to be looked at
+	if (stories.isEmpty())
+		return;
+
+	QMultiHash<QString, QString> children;
+	for (int i = 0; i < m_docCharStyles.count(); ++i)
+		children.insert(m_docCharStyles[i].parent(), m_docCharStyles[i].name());
+	addInheritingStyles(charStyles, children);
+	children.clear();
+	for (int i = 0; i < m_docParagraphStyles.count(); ++i)
+	{
+		const ParagraphStyle& style(m_docParagraphStyles[i]);
+		children.insert(style.parent(), style.name());
+		if (charStyles.contains(style.charStyle().parent()) || charStyles.contains(style.peCharStyleName()))
+			paragraphStyles.insert(style.name());
+	}
+	addInheritingStyles(paragraphStyles, children);
+	// all other styles fall back to the default styles
+	const CharStyle* defaultCharStyle = m_docCharStyles.getDefault();
+	const ParagraphStyle* defaultParagraphStyle = m_docParagraphStyles.getDefault();
+	if ((defaultCharStyle && charStyles.contains(defaultCharStyle->name()))
+		|| (defaultParagraphStyle && paragraphStyles.contains(defaultParagraphStyle->name())))
+		all = true;
+
+	// reverse index from the styles to the stories using them
+	QHash<QString, QList<StoryText*> > paragraphStyleUsers;
+	QHash<QString, QList<StoryText*> > charStyleUsers;
+	QSet<StoryText*> affected;
+	for (const QPointer<StoryText>& story : stories)
+	{
+		if (story.isNull())
+			continue;
+		if (all)
+		{
+			affected.insert(story.data());
+			continue;
+		}
+		QSet<QString> usedParagraphStyles, usedCharStyles;
+		story->getStyleNames(usedParagraphStyles, usedCharStyles);
+		for (const QString& name : usedParagraphStyles)
+			paragraphStyleUsers[name].append(story.data());
+		for (const QString& name : usedCharStyles)
+			charStyleUsers[name].append(story.data());
+	}
+	for (const QString& name : paragraphStyles)
+	{
+		for (StoryText* story : paragraphStyleUsers.value(name))
+			affected.insert(story);
+	}
+	for (const QString& name : charStyles)
+	{
+		for (StoryText* story : charStyleUsers.value(name))
+			affected.insert(story);
+	}
+	if (affected.isEmpty())
+		return;
+	for (StoryText* story : affected)
+		story->invalidateAll();
+	if (isLoading())
+		return;
+
+	// one update for all frames showing the stories, an invalid rect stands for all pages
+	QRectF region;
+	bool everywhere = false;
+	auto showsAffectedStory = [&affected](PageItem* item)
+	{
+		if (affected.contains(&item->itemText))
+			return true;
+		if (!item->isTable())
+			return false;
+		PageItem_Table* table = item->asTable();
+		for (int row = 0; row < table->rows(); ++row)
+		{
+			for (int col = 0; col < table->columns(); ++col)
+			{
+				PageItem_TextFrame* cellFrame = table->cellAt(row, col).textFrame();
+				if (cellFrame && affected.contains(&cellFrame->itemText))
+					return true;
+			}
+		}
+		return false;
+	};
+	for (PageItem* item : DocItems)
+	{
+		QList<PageItem*> allItems;
+		if (item->isGroup())
+			allItems = item->getAllChildren();
+		allItems.prepend(item);
+		// members of groups are reported with the bounds of their group
+		for (PageItem* currItem : allItems)
+		{
+			if (showsAffectedStory(currItem))
+			{
+				region = region.united(item->getVisualBoundingRect());
+				break;
+			}
+		}
+	}
+	for (PageItem* item : MasterItems)
+	{
+		QList<PageItem*> allItems;
+		if (item->isGroup())
+			allItems = item->getAllChildren();
+		allItems.prepend(item);
+		for (PageItem* currItem : allItems)
+			everywhere = everywhere || showsAffectedStory(currItem);
+	}
+	for (auto it = FrameItems.constBegin(); !everywhere && (it != FrameItems.constEnd()); ++it)
+		everywhere = showsAffectedStory(it.value());
+	if (everywhere)
+		regionsChanged()->update(QRectF());
+	else if (!region.isNull())
+		regionsChanged()->update(region);
+}
+
+void ScribusDoc::paragraphStyleChanged(const QString& name)
+{
+	if (m_styleChangeLevel > 0)
+		m_changedParagraphStyles.insert(name);
+}
+
+void ScribusDoc::charStyleChanged(const QString& name)
+{
+	if (m_styleChangeLevel > 0)
+		m_changedCharStyles.insert(name);
+}
+
+void ScribusDoc::allStylesChanged()
+{
+	if (m_styleChangeLevel > 0)
+		m_allStylesChanged = true;
+}
+
+void ScribusDoc::storyStylesChanged(StoryText* story)
+{
+	if (m_styleChangedStories.contains(story))
+		return;
+	m_styleChangedStories.insert(story);
+	m_styleChangedStoryList.append(story);
+}
+
 void ScribusDoc::itemSelection_SwapLeft()
 {
 	if (!startAlign(2))
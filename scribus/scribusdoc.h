@@ -33,7 +33,9 @@ for which a new license (GPL+exception) is in place.
 #include <QHash>
 #include <QObject>
 #include <QPixmap>
+#include <QPointer>
 #include <QRectF>
+#include <QSet>
 #include <QStringList>
 #include <QTimer>
 #include <QFile>
@@ -51,6 +53,8 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_group.h"
 #include "pageitem_latexframe.h"
 #include "pageitem_textframe.h"
+#include "pageitemindex.h"
+#include "pageitemlookup.h"
 #include "pagestructs.h"
 #include "prefsstructs.h"
 #include "scguardedptr.h"
@@ -66,6 +70,7 @@ for which a new license (GPL+exception) is in place.
 #include "usertaskstructs.h"
 
 class DocUpdater;
+class PageThumbnailCache;
 class FPoint;
 class UndoManager;
 // class UndoState;
@@ -126,6 +131,33 @@ public:
 	MassObservable<PageItem*> * itemsChanged() { return &m_itemsChanged; }
 	MassObservable<ScPage*>     * pagesChanged() { return &m_pagesChanged; }
 	MassObservable<QRectF>    * regionsChanged() { return &m_regionsChanged; }
+	/// thumbnails of the pages and master pages, created on first use
+	PageThumbnailCache* thumbnailCache();
+
+	/**
+	 * @brief Revisions are generations of the document. Every change of the document, a page,
+	 * a layer or an item makes the document one revision newer, the changed objects remember
+	 * the revision of their last change. Caches compare them to tell if they are up to date.
+	 */
+	quint64 revision() const { return m_revision; }
+	/// identifies the document while it is open, revisions of different sessions can not be compared
+	const QByteArray& revisionSession() const { return m_revisionSession; }
+	/// makes the document one revision newer and returns the new revision
+	quint64 nextRevision() { return ++m_revision; }
+	/// revision of the last change which may affect all pages, e.g. of styles or colours
+	quint64 settingsRevision() const { return m_settingsRevision; }
+	/// revision of the last change of the layers
+	quint64 layersRevision() const { return m_layersRevision; }
+	/// newest revision of the things shown on page: its items, its master page and the layers
+	quint64 pageRevision(const ScPage* page) const;
+	/// marks a change which may affect all pages
+	void bumpRevision();
+	/// marks a change of item, which also changes its groups and the pages showing it
+	void bumpRevision(PageItem* item);
+	void bumpRevision(ScPage* page);
+	/// marks a change of the pages intersecting region, of all pages if region is not valid
+	void bumpRevision(const QRectF& region);
+	void bumpLayerRevision(int layerID);
 	
 	void invalidateAll();
 	void invalidateLayer(int layerID);
@@ -821,9 +853,40 @@ public:
 	 */
 	void itemAddDetails(const PageItem::ItemType itemType, const PageItem::ItemFrameType frameType, PageItem* newItem);
 
+	/**
+	 * @brief Position in Items of the top level item with the uniqueNr unique, 0 if there is none.
+	 */
 	int getItemNrfromUniqueID(uint unique);
-	//return pointer to item
-	PageItem* getItemFromName(QString name);
+	/**
+	 * @brief The item named name in Items or in one of its groups, top level items first.
+	 * DocItems and MasterItems are looked up in hashes, other lists are scanned.
+	 */
+	PageItem* getItemFromName(const QString& name);
+	/**
+	 * @brief The top level item named name in Items, nullptr if only a member of a group has that name.
+	 */
+	PageItem* getTopLevelItemFromName(const QString& name);
+	/**
+	 * @brief Positions in Items of the items whose bounds intersect area, in ascending order.
+	 * Uses the spatial index of DocItems or MasterItems, other lists are not indexed
+	 * and all their positions are returned. Callers still test the returned items exactly.
+	 */
+	QList<int> itemIndicesIn(const QRectF& area);
+	/// the same for items, which need not be Items
+	QList<int> itemIndicesIn(const QList<PageItem*>& items, const QRectF& area);
+	/**
+	 * @brief Called by PageItem when its position, size, rotation or clip changed,
+	 * so the item is moved in the spatial index before the next query.
+	 */
+	void itemGeometryChanged(PageItem* item);
+	/**
+	 * @brief Called by PageItem when its name changed, so it is found by its new name.
+	 */
+	void itemRenamed(PageItem* item);
+	/**
+	 * @brief Called by PageItem when it is destroyed, so it is not found by name or uniqueNr any more.
+	 */
+	void itemDeleted(PageItem* item);
 	//itemDelete
 	//itemBlah...
 
@@ -1193,6 +1256,23 @@ public:
 	// unncessary signals when doing updates on multiple items
 	void beginUpdate();
 	void endUpdate();
+	/**
+	 * @brief Starts a batch of style changes, batches may be nested.
+	 * Until the matching endStyleChanges() stories are not invalidated whenever a style set changes.
+	 * Instead endStyleChanges() invalidates the stories using a changed style, or a style inheriting
+	 * from one, once and reports the frames showing them in one region update.
+	 */
+	void beginStyleChanges();
+	void endStyleChanges();
+	bool inStyleChanges() const { return m_styleChangeLevel > 0; }
+	//! \brief Marks a paragraph style as changed in the running batch
+	void paragraphStyleChanged(const QString& name);
+	//! \brief Marks a character style as changed in the running batch
+	void charStyleChanged(const QString& name);
+	//! \brief Marks all styles as changed in the running batch, e.g. when colors or fonts are replaced
+	void allStylesChanged();
+	//! \brief Called by StoryText when a style set changed during a batch
+	void storyStylesChanged(StoryText* story);
 	int addToInlineFrames(PageItem *item);
 	void removeInlineFrame(int fIndex);
 	void checkItemForFrames(PageItem *it, int fIndex);
@@ -1399,6 +1479,22 @@ private:
 	MassObservable<ScPage*> m_pagesChanged;
 	MassObservable<QRectF> m_regionsChanged;
 	DocUpdater* m_docUpdater;
+	PageThumbnailCache* m_thumbnailCache;
+	QByteArray m_revisionSession;
+	quint64 m_revision;
+	quint64 m_settingsRevision;
+	quint64 m_layersRevision;
+	PageItemIndex m_docItemIndex;
+	PageItemIndex m_masterItemIndex;
+	PageItemLookup m_docItemLookup;
+	PageItemLookup m_masterItemLookup;
+	// the running batch of style changes, see beginStyleChanges()
+	int m_styleChangeLevel;
+	bool m_allStylesChanged;
+	QSet<QString> m_changedParagraphStyles;
+	QSet<QString> m_changedCharStyles;
+	QSet<StoryText*> m_styleChangedStories;
+	QList<QPointer<StoryText> > m_styleChangedStoryList;
 	
 signals:
 	//Lets make our doc talk to our GUI rather than confusing all our normal stuff
@@ -79,6 +79,7 @@ for which a new license (GPL+exception) is in place.
 #include "filewatcher.h"
 #include "hyphenator.h"
 #include "iconmanager.h"
+#include "itemrendercache.h"
 #include "loadsaveplugin.h"
 #include "text/textlayoutpainter.h"
 #include "pageitem.h"
@@ -364,6 +365,9 @@ void ScribusView::changed(QRectF re, bool)
 		m_oldCanvasWidth = newCanvasWidth;
 		m_oldCanvasHeight = newCanvasHeight;
 	}
+	// also when the canvas is not updated right away, the cached tiles and item bitmaps are out of date
+	m_canvas->invalidateTiles(re);
+	ItemRenderCache::instance().invalidate(Doc, re);
 	if (!Doc->isLoading() && !m_ScMW->scriptIsRunning())
 	{
 // 		qDebug() << "ScribusView-changed(): changed region:" << re;
@@ -1073,7 +1077,7 @@ void ScribusView::contentsDropEvent(QDropEvent *e)
 					}
 				}
 				if (Doc->docHyphenator->AutoCheck)
-					Doc->docHyphenator->slotHyphenate(b);
+					Doc->docHyphenator->slotHyphenateLater(b);
 				b->invalidateLayout();
 				b->update();
 				delete gt;
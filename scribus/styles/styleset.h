@@ -3,6 +3,7 @@
 #ifndef STYLESET_H
 #define STYLESET_H
 
+#include <QHash>
 #include <QList>
 
 #include <assert.h>
@@ -14,6 +15,8 @@ class StyleSet : public StyleContext {
 public:
 	STYLE& operator[] (int index) { 
 		assert(index < styles.count()); 
+		// the caller may rename the style, rebuild the name index on the next lookup
+		m_indexVersion = -1;
 		return * styles[index]; 
 	}
 	
@@ -41,6 +44,8 @@ public:
 	STYLE* append(STYLE* style) { 
 		styles.append(style); 
 		style->setContext(this); 
+		if (m_indexVersion == m_version && !m_index.contains(style->name()))
+			m_index.insert(style->name(), styles.count() - 1);
 		return style; 
 	}
 	
@@ -66,7 +71,7 @@ public:
 	}
 	
 	
-	StyleSet() : styles(), m_context(NULL), m_default(NULL) {}
+	StyleSet() : styles(), m_context(NULL), m_default(NULL), m_indexVersion(-1) {}
 	
 	~StyleSet() { 
 		clear(false);
@@ -83,6 +88,8 @@ public:
 			delete styles.front(); 
 			styles.pop_front(); 
 		}
+		m_index.clear();
+		m_indexVersion = -1;
 		if (invalid)
 			invalidate();
 	}
@@ -103,9 +110,15 @@ private:
 	StyleSet(const StyleSet&)             { assert(false); }
 	StyleSet& operator= (const StyleSet&) { assert(false); return *this; }
 
+	inline int indexOf(const QString& name) const;
+	inline void reindex() const;
+
 	QList<STYLE*> styles;
 	const StyleContext* m_context;
 	STYLE* m_default;
+	// position of the first style with a name, rebuilt when the version changed
+	mutable QHash<QString, int> m_index;
+	mutable int m_indexVersion;
 };
 
 template<class STYLE>
@@ -118,24 +131,45 @@ inline void StyleSet<STYLE>::remove(int index)
 //	delete (*it);
 //	styles.erase(it);
 	styles.removeAt(index);
+	// the following positions changed, rebuilt once by the next lookup
+	m_indexVersion = -1;
+}
+
+template<class STYLE>
+inline void StyleSet<STYLE>::reindex() const
+{
+	m_index.clear();
+	m_index.reserve(styles.count());
+	for (int i = styles.count() - 1; i >= 0; --i)
+		m_index.insert(styles[i]->name(), i);
+	m_indexVersion = m_version;
+}
+
+template<class STYLE>
+inline int StyleSet<STYLE>::indexOf(const QString& name) const
+{
+	if (m_indexVersion != m_version)
+		reindex();
+	int index = m_index.value(name, -1);
+	if (index >= 0 && (index >= styles.count() || styles[index]->name() != name))
+	{
+		// renamed through a pointer kept from before the last lookup
+		reindex();
+		index = m_index.value(name, -1);
+	}
+	return index;
 }
 
 template<class STYLE>
 inline bool StyleSet<STYLE>::contains(const QString& name) const
 {
-	for (int i=0; i < styles.count(); ++i)
-		if (styles[i]->name() == name)
-			return true;
-	return false;
+	return indexOf(name) >= 0;
 }
 
 template<class STYLE>
 inline int StyleSet<STYLE>::find(const QString& name) const
 {
-	for (int i=0; i < styles.count(); ++i)
-		if (styles[i]->name() == name)
-			return i;
-	return -1;
+	return indexOf(name);
 }
 
 template<class STYLE>
@@ -143,11 +177,9 @@ inline const BaseStyle* StyleSet<STYLE>::resolve(const QString& name) const
 {
 	if (name.isEmpty())
 		return m_default;
-	for (int i=0; i < styles.count(); ++i)
-	{
-		if (styles[i]->name() == name)
-			return styles[i];
-	}
+	int index = indexOf(name);
+	if (index >= 0)
+		return styles[index];
 	return m_context ? m_context->resolve(name) : NULL;
 }
 
@@ -156,20 +188,15 @@ inline void StyleSet<STYLE>::redefine(const StyleSet<STYLE>& defs, bool removeUn
 {
 	for (int i=signed(styles.count())-1; i >= 0; --i) 
 	{
-		bool found = false;
-		for (int j=0; j < defs.count(); ++j)
+		int j = defs.find(styles[i]->name());
+		if (j >= 0)
 		{
-			if (styles[i]->name() == defs[j].name()) 
-			{
-				found = true;
-				(*styles[i]) = defs[j];
-				(*styles[i]).setContext(this);
-				if (defs.m_default == defs.styles[j])
-					makeDefault(styles[i]);
-				break;
-			}
+			(*styles[i]) = defs[j];
+			(*styles[i]).setContext(this);
+			if (defs.m_default == defs.styles[j])
+				makeDefault(styles[i]);
 		}
-		if (!found && removeUnused) 
+		else if (removeUnused) 
 		{
 			if (styles[i] == m_default)
 				makeDefault(NULL);
@@ -204,6 +231,7 @@ inline void StyleSet<STYLE>::rename(const QMap<QString,QString>& newNames)
 			styles[i]->setParent(it.value());
 	}
 	invalidate();
+	reindex();
 }
 	
 #endif
@@ -2,14 +2,22 @@
 #include <QTest>
 //#include "testGlyphStore.h"
 //#include "testIndex.h"
+#include "testImagePrefetcher.h"
+#include "testOperatorWriter.h"
+#include "testPdfExportIndex.h"
 #include "testStoryText.h"
+#include "testStyleSet.h"
 #include "runtests.h"
 
 int RunTests::runTests(int argc, char ** argv)
 { 
 	QList<QObject *> testObjects;
 //	testObjects << new TestGlyphStore();
+	testObjects << new TestImagePrefetcher();
+	testObjects << new TestOperatorWriter();
+	testObjects << new TestPdfExportIndex();
 	testObjects << new TestStoryText();
+	testObjects << new TestStyleSet();
 //	testObjects << new TestIndex();
 	int failed = 0;
 	for (int i = 0; i < testObjects.count(); ++i)
@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for text shaping throughput versus thread count.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script fills a long chain of linked text frames and changes the font of
+the whole story, which drops all shaped text. The chain is then laid out
+again with 1, 2, 4, ... shaping threads. The throughput is printed in glyphs
+per second, counting one glyph per character, and includes line breaking,
+which is not parallelized.
+"""
+
+from scribus import *
+from scripttest import *
+from multiprocessing import cpu_count
+from time import time
+
+PAGES = 100
+ROUNDS = 3
+
+
+def thread_counts():
+    counts = [1]
+    while counts[-1] * 2 <= cpu_count():
+        counts.append(counts[-1] * 2)
+    if counts[-1] != cpu_count():
+        counts.append(cpu_count())
+    return counts
+
+
+def measure(frames, fonts, threads):
+    setShapingThreads(threads)
+    glyphs = len(getAllText(frames[0]))
+    best = None
+    for i in range(ROUNDS):
+        # a different font invalidates all shaped text
+        selectText(0, glyphs, frames[0])
+        setFont(fonts[i % len(fonts)], frames[0])
+        start = time()
+        textOverflows(frames[-1])
+        elapsed = time() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    return glyphs / best
+
+
+def main():
+    setRedraw(False)
+    frames = create_chain(PAGES)
+    fonts = getFontNames()[:2]
+    print("threads  glyphs/s")
+    for threads in thread_counts():
+        print("%7d  %.0f" % (threads, measure(frames, fonts, threads)))
+    setShapingThreads(0)
+    setRedraw(True)
+    closeDoc()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for shaping text with many short style runs.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script fills a text frame with one long paragraph, like a price list, and
+changes the font size and the font features every few characters. Every edit
+at the start of the paragraph drops its shaped text, so each layout shapes
+the whole paragraph again, run by run. The time per layout is printed at the
+end.
+"""
+
+from scribus import *
+from scripttest import *
+from time import time
+
+WORDS = 4000
+RUN_LENGTH = 6
+EDITS = 50
+
+SIZES = [8, 9, 10, 12]
+FEATURES = ["", "-liga", "+smcp", "+onum,+tnum"]
+
+
+def create_frame():
+    new_document()
+    width, height = getPageSize()
+    frame = createText(20, 20, width - 40, height - 40, "styles")
+    setText(" ".join("item%d" % i for i in range(WORDS)), frame)
+    length = len(getAllText(frame))
+    for i, start in enumerate(range(0, length, RUN_LENGTH)):
+        selectText(start, min(RUN_LENGTH, length - start), frame)
+        setFontSize(SIZES[i % len(SIZES)], frame)
+        setFontFeatures(FEATURES[(i // len(SIZES)) % len(FEATURES)], frame)
+    textOverflows(frame)
+    return frame
+
+
+def edit_frame(frame):
+    timings = []
+    for i in range(EDITS):
+        start = time()
+        insertText("x", 0, frame)
+        textOverflows(frame)
+        timings.append(time() - start)
+    return timings
+
+
+def main():
+    run_benchmark("layouts", create_frame, edit_frame)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+
+"""
+Benchmark script for typing into a long chain of linked text frames.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script creates a document with one linked text frame per page, fills the
+chain with text and then types single characters into an early frame. After
+each keystroke the frame following the edited one and the last frame of the
+chain are laid out, like when they are painted. The per-keystroke latency and
+the hit rate of the shaped text cache while typing are printed at the end.
+"""
+
+from scribus import *
+from scripttest import *
+from time import time
+
+PAGES = 400
+EDIT_FRAME = 5
+KEYSTROKES = 200
+
+
+def type_into_chain(frames):
+    edited = frames[EDIT_FRAME - 1]
+    following = frames[EDIT_FRAME]
+    last = frames[-1]
+    # somewhere in the middle of the edited frame
+    pos = len(getAllText(frames[0])) // PAGES * (EDIT_FRAME - 1) + 100
+    hits, misses, rate = getTextCacheStats(edited)
+    timings = []
+    for i in range(KEYSTROKES):
+        start = time()
+        insertText("x", pos + i, edited)
+        textOverflows(following)
+        textOverflows(last)
+        timings.append(time() - start)
+    newHits, newMisses, rate = getTextCacheStats(edited)
+    hits, misses = newHits - hits, newMisses - misses
+    print("shaped text cache: %d hits, %d misses, %.1f%% hit rate"
+          % (hits, misses, 100.0 * hits / max(1, hits + misses)))
+    return timings
+
+
+def main():
+    run_benchmark("keystrokes", lambda: create_chain(PAGES), type_into_chain)
+
+
+if __name__ == "__main__":
+    main()
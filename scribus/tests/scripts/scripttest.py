@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+
+"""
+Helpers shared by the test and benchmark scripts in this directory.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The Scripter puts the directory of a script first on the module path, so the
+scripts import this module with "from scripttest import *".
+"""
+
+from scribus import *
+from traceback import print_exc
+from sys import stdout
+
+PARAGRAPH = ("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+             "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+             "ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+             "aliquip ex ea commodo consequat.\n")
+
+
+class TestFailure(Exception):
+    """ Raised by check() """
+    def __init__(self, msg):
+        self.msg = msg
+    def __str__(self):
+        return repr(self.msg)
+
+
+def check(condition, msg='Check failed'):
+    """ Fails test if condition is false """
+    if not condition:
+        raise TestFailure(msg)
+
+
+def run_test(name, test):
+    """ Runs test and prints whether it passed, with the traceback if it failed """
+    try:
+        test()
+    except:
+        print('%s tests failed' % name)
+        print_exc(file=stdout)
+    else:
+        print('%s tests passed' % name)
+
+
+def new_document(pages=1):
+    """ Creates an A4 document with the given number of pages """
+    newDocument(PAPER_A4, (20, 20, 20, 20), PORTRAIT, 1, UNIT_MILLIMETERS, PAGE_1, 0, pages)
+
+
+def create_chain(pages):
+    """ Creates a document with one linked text frame per page and roughly fills the chain """
+    new_document(pages)
+    width, height = getPageSize()
+    frames = []
+    for page in range(1, pages + 1):
+        gotoPage(page)
+        frames.append(createText(20, 20, width - 40, height - 40, "chain%d" % page))
+    for i in range(len(frames) - 1):
+        linkTextFrames(frames[i], frames[i + 1])
+    setText(PARAGRAPH * (pages * 8), frames[0])
+    textOverflows(frames[-1])
+    return frames
+
+
+def report(label, timings):
+    """ Prints the count and the distribution of timings, which are in seconds """
+    timings = sorted(timings)
+    count = len(timings)
+    print("%s: %d" % (label, count))
+    print("mean:   %.2f ms" % (1000.0 * sum(timings) / count))
+    print("median: %.2f ms" % (1000.0 * timings[count // 2]))
+    print("p95:    %.2f ms" % (1000.0 * timings[int(count * 0.95)]))
+    print("max:    %.2f ms" % (1000.0 * timings[-1]))
+
+
+def run_benchmark(label, setup, run):
+    """ Times run(setup()) without redrawing, prints the timings it returns and closes the document """
+    setRedraw(False)
+    data = setup()
+    timings = run(data)
+    setRedraw(True)
+    report(label, timings)
+    closeDoc()
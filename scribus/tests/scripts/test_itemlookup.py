@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+
+"""
+Test script for looking up objects by name.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script creates a document and checks that objects are found by name while
+they are created, grouped, ungrouped and deleted.
+"""
+
+from scribus import *
+from scripttest import *
+
+def test_lookup():
+    new_document()
+    try:
+        for i in range(100):
+            createRect(10 + i, 10, 5, 5, 'box%d' % i)
+        check(objectExists('box0') and objectExists('box99'), 'new objects not found')
+        check(not objectExists('box100'), 'missing object found')
+
+        # members of groups are found as well
+        group = groupObjects(['box10', 'box11'])
+        check(objectExists(group), 'group not found')
+        check(objectExists('box10') and objectExists('box11'), 'grouped objects not found')
+        check(getPosition('box11')[0] > getPosition('box10')[0], 'grouped objects mixed up')
+        try:
+            groupObjects(['box10', 'box12'])
+        except ValueError:
+            pass
+        else:
+            check(False, 'grouped an object of another group')
+
+        # members of groups are not deleted on their own
+        try:
+            deleteObject('box11')
+        except ValueError:
+            pass
+        else:
+            check(False, 'deleted an object of a group')
+        check(objectExists('box11'), 'object of a group deleted')
+        check(objectExists(group), 'group of a deleted object lost')
+
+        unGroupObject(group)
+        check(not objectExists(group), 'ungrouped group found')
+        check(objectExists('box10') and objectExists('box11'), 'ungrouped objects not found')
+
+        # names of deleted objects can be used again
+        deleteObject('box50')
+        check(not objectExists('box50'), 'deleted object found')
+        check(createRect(50, 50, 5, 5, 'box50') == 'box50', 'name of deleted object not free')
+        check(objectExists('box50'), 'recreated object not found')
+
+        # deleting a group deletes its members
+        group = groupObjects(['box20', 'box21'])
+        deleteObject(group)
+        check(not objectExists(group), 'deleted group found')
+        check(not objectExists('box20') and not objectExists('box21'), 'objects of a deleted group found')
+    finally:
+        closeDoc()
+
+if __name__ == '__main__':
+    run_test('Lookup', test_lookup)
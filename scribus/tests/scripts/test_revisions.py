@@ -0,0 +1,48 @@
+#!/usr/bin/env python
+
+"""
+Test script for document revisions.
+
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+
+The script creates a document and checks that the revisions of the document,
+its pages, layers and objects grow when they are changed.
+"""
+
+from scribus import *
+from scripttest import *
+
+def test_revisions():
+    new_document(2)
+    try:
+        start = getDocRevision()
+
+        # new objects are newer than the document was
+        rect = createRect(30, 30, 50, 50)
+        check(getDocRevision() > start, 'document revision did not grow')
+        check(getObjectRevision(rect) > start, 'object revision is not new')
+        check(getObjectRevision(rect) <= getDocRevision(), 'object is newer than the document')
+
+        # layer changes make the layer and all pages newer
+        layer = getLayers()[0]
+        layerRevision = getLayerRevision(layer)
+        pageRevision = getPageRevision(2)
+        setLayerTransparency(layer, 0.5)
+        check(getLayerRevision(layer) > layerRevision, 'layer revision did not grow')
+        check(getPageRevision(2) > pageRevision, 'page revision did not grow')
+        check(getPageRevision(2) <= getDocRevision(), 'page is newer than the document')
+
+        try:
+            getPageRevision(3)
+        except IndexError:
+            pass
+        else:
+            check(False, 'no IndexError for a page out of range')
+    finally:
+        closeDoc()
+
+if __name__ == '__main__':
+    run_test('Revision', test_revisions)
@@ -0,0 +1,125 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QSemaphore>
+
+#include "scimageprefetcher.h"
+#include "testImagePrefetcher.h"
+
+// the prefetcher only compares the item pointers
+static const PageItem* fakeItem(quintptr id)
+{
+	return reinterpret_cast<const PageItem*>(id);
+}
+
+class FakeJob : public ScImagePrefetcher::Job
+{
+public:
+	FakeJob(quintptr id, int step, qint64 estimatedBytes, QAtomicInt& started, QSemaphore* gate = nullptr) :
+		ScImagePrefetcher::Job(fakeItem(id), QString("image%1.png").arg(id), step, estimatedBytes),
+		prepared(false),
+		m_started(started),
+		m_gate(gate)
+	{ }
+
+	bool prepared;
+
+protected:
+	void prepare()
+	{
+		m_started.ref();
+		if (m_gate)
+			m_gate->acquire();
+		prepared = true;
+	}
+
+private:
+	QAtomicInt& m_started;
+	QSemaphore* m_gate;
+};
+
+void TestImagePrefetcher::takeReturnsPreparedJobs()
+{
+	QAtomicInt started;
+	ScImagePrefetcher prefetcher;
+	for (quintptr id = 1; id <= 3; ++id)
+		prefetcher.addJob(new FakeJob(id, 0, 10, started));
+	QCOMPARE(prefetcher.jobCount(), 3);
+
+	for (quintptr id = 1; id <= 3; ++id)
+	{
+		QScopedPointer<ScImagePrefetcher::Job> job(prefetcher.take(fakeItem(id), QString("image%1.png").arg(id)));
+		QVERIFY(!job.isNull());
+		QVERIFY(static_cast<FakeJob*>(job.data())->prepared);
+	}
+	QCOMPARE(prefetcher.finishedCount(), 3);
+	// a job is handed out once, other files of an item have no job
+	QVERIFY(prefetcher.take(fakeItem(1), "image1.png") == nullptr);
+	QVERIFY(prefetcher.take(fakeItem(2), "other.png") == nullptr);
+}
+
+void TestImagePrefetcher::budgetLimitsStartedJobs()
+{
+	QAtomicInt started;
+	QSemaphore gate;
+	ScImagePrefetcher prefetcher(100);
+	prefetcher.addJob(new FakeJob(1, 0, 60, started, &gate));
+	prefetcher.addJob(new FakeJob(2, 0, 30, started, &gate));
+	prefetcher.addJob(new FakeJob(3, 0, 60, started, &gate));
+	QTRY_COMPARE(started.load(), 2);
+	QTest::qWait(50);
+	QCOMPARE(started.load(), 2);
+
+	// taking the first job frees its memory for the third one
+	gate.release(3);
+	QScopedPointer<ScImagePrefetcher::Job> job(prefetcher.take(fakeItem(1), "image1.png"));
+	QVERIFY(!job.isNull());
+	QTRY_COMPARE(started.load(), 3);
+	job.reset(prefetcher.take(fakeItem(3), "image3.png"));
+	QVERIFY(static_cast<FakeJob*>(job.data())->prepared);
+	job.reset(prefetcher.take(fakeItem(2), "image2.png"));
+	QVERIFY(static_cast<FakeJob*>(job.data())->prepared);
+	QCOMPARE(prefetcher.finishedCount(), 3);
+}
+
+void TestImagePrefetcher::largeJobStartsAlone()
+{
+	QAtomicInt started;
+	QSemaphore gate;
+	ScImagePrefetcher prefetcher(100);
+	prefetcher.addJob(new FakeJob(1, 0, 500, started, &gate));
+	prefetcher.addJob(new FakeJob(2, 0, 10, started, &gate));
+	QTRY_COMPARE(started.load(), 1);
+	QTest::qWait(50);
+	QCOMPARE(started.load(), 1);
+	gate.release(2);
+	QScopedPointer<ScImagePrefetcher::Job> job(prefetcher.take(fakeItem(1), "image1.png"));
+	QVERIFY(static_cast<FakeJob*>(job.data())->prepared);
+	QTRY_COMPARE(started.load(), 2);
+}
+
+void TestImagePrefetcher::finishStepDropsUntakenJobs()
+{
+	QAtomicInt started;
+	ScImagePrefetcher prefetcher;
+	prefetcher.addJob(new FakeJob(1, 0, 10, started));
+	prefetcher.addJob(new FakeJob(2, 1, 10, started));
+	prefetcher.addJob(new FakeJob(3, 1, 10, started));
+	prefetcher.addJob(new FakeJob(4, 2, 10, started));
+
+	QScopedPointer<ScImagePrefetcher::Job> job(prefetcher.take(fakeItem(2), "image2.png"));
+	QVERIFY(!job.isNull());
+	prefetcher.finishStep(1);
+	QVERIFY(prefetcher.take(fakeItem(1), "image1.png") == nullptr);
+	QVERIFY(prefetcher.take(fakeItem(3), "image3.png") == nullptr);
+	job.reset(prefetcher.take(fakeItem(4), "image4.png"));
+	QVERIFY(!job.isNull());
+	QCOMPARE(prefetcher.jobCount(), 4);
+	QCOMPARE(prefetcher.finishedCount(), 4);
+}
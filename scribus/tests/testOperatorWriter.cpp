@@ -0,0 +1,212 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cmath>
+
+#include "testOperatorWriter.h"
+
+// about the number of points of an imported city map
+static const int MapShapes = 2000;
+static const int ShapeSegments = 100;
+
+// how paths were written before ScOperatorWriter
+static QByteArray concatenatedNumber(double c)
+{
+	double v = c;
+	if (fabs(c) < 0.0000001)
+		v = 0.0;
+	return QByteArray::number(v, 'f', 5);
+}
+
+static QByteArray concatenatedPath(const FPointArray& path)
+{
+	QByteArray tmp;
+	bool nPath = true;
+	for (int poi = 0; poi < path.size() - 3; poi += 4)
+	{
+		if (path.isMarker(poi))
+		{
+			nPath = true;
+			continue;
+		}
+		FPoint np = path.point(poi);
+		if (nPath)
+		{
+			tmp += concatenatedNumber(np.x())+" "+concatenatedNumber(-np.y())+" m\n";
+			nPath = false;
+		}
+		FPoint np1 = path.point(poi+1);
+		FPoint np2 = path.point(poi+3);
+		FPoint np3 = path.point(poi+2);
+		if ((np == np1) && (np2 == np3))
+			tmp += concatenatedNumber(np3.x())+" "+concatenatedNumber(-np3.y())+" l\n";
+		else
+		{
+			tmp += concatenatedNumber(np1.x())+" "+concatenatedNumber(-np1.y())+" ";
+			tmp += concatenatedNumber(np2.x())+" "+concatenatedNumber(-np2.y())+" ";
+			tmp += concatenatedNumber(np3.x())+" "+concatenatedNumber(-np3.y())+" c\n";
+		}
+	}
+	return tmp;
+}
+
+static QByteArray writtenPath(const FPointArray& path)
+{
+	QByteArray tmp;
+	ScOperatorWriter out(tmp);
+	bool nPath = true;
+	for (int poi = 0; poi < path.size() - 3; poi += 4)
+	{
+		if (path.isMarker(poi))
+		{
+			nPath = true;
+			continue;
+		}
+		const FPoint& np = path.point(poi);
+		if (nPath)
+		{
+			out.moveTo(np.x(), -np.y());
+			nPath = false;
+		}
+		const FPoint& np1 = path.point(poi+1);
+		const FPoint& np2 = path.point(poi+3);
+		const FPoint& np3 = path.point(poi+2);
+		if ((np == np1) && (np2 == np3))
+			out.lineTo(np3.x(), -np3.y());
+		else
+			out.curveTo(np1.x(), -np1.y(), np2.x(), -np2.y(), np3.x(), -np3.y());
+	}
+	return tmp;
+}
+
+static QString formatted(double v, int decimals = ScOperatorWriter::DefaultDecimals)
+{
+	return QString::fromLatin1(ScOperatorWriter::toByteArray(v, decimals));
+}
+
+void TestOperatorWriter::initTestCase()
+{
+	// outlines of blocks and roads with fractional coordinates, half of the segments curved
+	quint32 seed = 42;
+	m_map.svgInit();
+	for (int shape = 0; shape < MapShapes; ++shape)
+	{
+		seed = seed * 1103515245 + 12345;
+		double x = (seed % 60000) / 100.0;
+		seed = seed * 1103515245 + 12345;
+		double y = (seed % 80000) / 100.0;
+		m_map.svgMoveTo(x, y);
+		for (int segment = 0; segment < ShapeSegments; ++segment)
+		{
+			seed = seed * 1103515245 + 12345;
+			double dx = ((seed >> 8) % 2001 - 1000) / 137.0;
+			seed = seed * 1103515245 + 12345;
+			double dy = ((seed >> 8) % 2001 - 1000) / 137.0;
+			if (segment % 2)
+				m_map.svgCurveToCubic(x + dx / 3.0, y, x + dx, y + dy / 3.0, x + dx, y + dy);
+			else
+				m_map.svgLineTo(x + dx, y + dy);
+			x += dx;
+			y += dy;
+		}
+		m_map.svgClosePath();
+	}
+}
+
+void TestOperatorWriter::formatNumbers()
+{
+	QCOMPARE(formatted(0.0), QString("0"));
+	QCOMPARE(formatted(2.0), QString("2"));
+	QCOMPARE(formatted(-17.0), QString("-17"));
+	QCOMPARE(formatted(1.5), QString("1.5"));
+	QCOMPARE(formatted(-0.25), QString("-0.25"));
+	QCOMPARE(formatted(0.1), QString("0.1"));
+	QCOMPARE(formatted(123.456789), QString("123.45679"));
+	QCOMPARE(formatted(0.000005), QString("0.00001"));
+	QCOMPARE(formatted(1234567.8), QString("1234567.8"));
+	// no negative zero
+	QCOMPARE(formatted(-0.000001), QString("0"));
+	QCOMPARE(formatted(-0.0), QString("0"));
+	QCOMPARE(formatted(qQNaN()), QString("0"));
+	QCOMPARE(formatted(1e20), QString("90000000000000"));
+	QCOMPARE(formatted(123.456789, 2), QString("123.46"));
+	QCOMPARE(formatted(0.1234567, 6), QString("0.123457"));
+	QCOMPARE(formatted(99.5, 0), QString("100"));
+}
+
+void TestOperatorWriter::writeOperators()
+{
+	QByteArray buffer("q\n");
+	ScOperatorWriter out(buffer);
+	out.translate(10, -20.5);
+	out.moveTo(0, 0);
+	out.lineTo(30.25, 0);
+	out.curveTo(1, 2, 3, 4, 5, 6);
+	out.closePath();
+	out.rect(0, 0, 100, -50);
+	out.lineWidth(0.5);
+	out.fillGray(0.5);
+	out.strokeRGB(1, 0, 0);
+	out.fillCMYK(0, 0.2, 1, 0);
+	out.number(3).number(1.0 / 3.0).op("d0");
+	out.append("Q\n");
+	QCOMPARE(buffer, QByteArray("q\n"
+								"1 0 0 1 10 -20.5 cm\n"
+								"0 0 m\n"
+								"30.25 0 l\n"
+								"1 2 3 4 5 6 c\n"
+								"h\n"
+								"0 0 100 -50 re\n"
+								"0.5 w\n"
+								"0.5 g\n"
+								"1 0 0 RG\n"
+								"0 0.2 1 0 k\n"
+								"3 0.33333 d0\n"
+								"Q\n"));
+}
+
+void TestOperatorWriter::sameValuesAsConcatenation()
+{
+	QList<QByteArray> concatenated = concatenatedPath(m_map).split(' ');
+	QList<QByteArray> written = writtenPath(m_map).split(' ');
+	QCOMPARE(written.count(), concatenated.count());
+	for (int i = 0; i < written.count(); ++i)
+	{
+		QList<QByteArray> concatenatedTokens = concatenated[i].split('\n');
+		QList<QByteArray> writtenTokens = written[i].split('\n');
+		QCOMPARE(writtenTokens.count(), concatenatedTokens.count());
+		for (int j = 0; j < writtenTokens.count(); ++j)
+		{
+			bool isNumber = false;
+			double value = concatenatedTokens[j].toDouble(&isNumber);
+			if (isNumber)
+				QCOMPARE(writtenTokens[j].toDouble(), value);
+			else
+				QCOMPARE(writtenTokens[j], concatenatedTokens[j]);
+		}
+	}
+}
+
+void TestOperatorWriter::benchmarkConcatenation()
+{
+	QByteArray result;
+	QBENCHMARK
+	{
+		result = concatenatedPath(m_map);
+	}
+	QVERIFY(!result.isEmpty());
+}
+
+void TestOperatorWriter::benchmarkOperatorWriter()
+{
+	QByteArray result;
+	QBENCHMARK
+	{
+		result = writtenPath(m_map);
+	}
+	QVERIFY(!result.isEmpty());
+}
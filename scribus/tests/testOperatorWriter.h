@@ -0,0 +1,29 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+#include "fpointarray.h"
+#include "scoperatorwriter.h"
+
+class TestOperatorWriter: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void initTestCase();
+	void formatNumbers();
+	void writeOperators();
+	void sameValuesAsConcatenation();
+	// micro-benchmarks writing the paths of a vector map, as PDF_ProcessItem does
+	void benchmarkConcatenation();
+	void benchmarkOperatorWriter();
+
+private:
+	FPointArray m_map;
+};
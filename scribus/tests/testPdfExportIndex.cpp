@@ -0,0 +1,108 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "pdfexportindex.h"
+#include "testPdfExportIndex.h"
+
+static bool writePdf(const QString& fn, const QByteArray& data)
+{
+	QFile file(fn);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	return file.write(data) == data.size();
+}
+
+static Pdf::Resource colorSpace(const QByteArray& name, PdfId num)
+{
+	Pdf::Resource res;
+	res.ResName = name;
+	res.ResNum = num;
+	return res;
+}
+
+void TestPdfExportIndex::saveAndLoad()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	QString fn = dir.path() + "/out.pdf";
+	QVERIFY(writePdf(fn, "%PDF-1.4\n%%EOF\n"));
+
+	PdfExportIndex index;
+	index.revisionSession = "session";
+	index.revision = 42;
+	index.prologueCount = 17;
+	index.objectCount = 30;
+	index.resourcesObj = 29;
+	index.resourceCount = 5;
+	index.xrefOffset = 1234;
+	index.resources.XObject["RE1"] = 20;
+	index.resources.ColorSpace.append(colorSpace("ICCProfile1", 8));
+	PdfExportIndex::Page page;
+	page.pageIndex = 0;
+	page.object = 25;
+	page.pinned = true;
+	page.revision = 40;
+	page.items << 3 << 7;
+	page.imagesKey = "images";
+	index.pages.append(page);
+	QVERIFY(index.save(fn));
+
+	PdfExportIndex loaded;
+	QVERIFY(loaded.load(fn));
+	QCOMPARE(loaded.revisionSession, QByteArray("session"));
+	QCOMPARE(loaded.revision, quint64(42));
+	QCOMPARE(loaded.prologueCount, PdfId(17));
+	QCOMPARE(loaded.objectCount, PdfId(30));
+	QCOMPARE(loaded.xrefOffset, qint64(1234));
+	QCOMPARE(loaded.resources.XObject.value("RE1"), PdfId(20));
+	QCOMPARE(loaded.resources.ColorSpace.count(), 1);
+	QCOMPARE(loaded.resources.ColorSpace.at(0).ResNum, PdfId(8));
+	QCOMPARE(loaded.pages.count(), 1);
+	QCOMPARE(loaded.pages.at(0).object, PdfId(25));
+	QVERIFY(loaded.pages.at(0).pinned);
+	QCOMPARE(loaded.pages.at(0).items, QList<uint>() << 3 << 7);
+	QCOMPARE(loaded.pages.at(0).imagesKey, QByteArray("images"));
+
+	PdfExportIndex::remove(fn);
+	QVERIFY(!loaded.load(fn));
+}
+
+void TestPdfExportIndex::changedPdfIsNotLoaded()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	QString fn = dir.path() + "/out.pdf";
+	QVERIFY(writePdf(fn, "%PDF-1.4\n%%EOF\n"));
+	PdfExportIndex index;
+	QVERIFY(index.save(fn));
+	QVERIFY(writePdf(fn, "%PDF-1.4\nwritten by another program\n%%EOF\n"));
+	QVERIFY(!index.load(fn));
+}
+
+void TestPdfExportIndex::mergeKeepsNewerResources()
+{
+	Pdf::ResourceDictionary older;
+	older.XObject["RE1"] = 10;
+	older.XObject["RE2"] = 11;
+	older.ColorSpace.append(colorSpace("Spot1", 5));
+	older.ColorSpace.append(colorSpace("Spot2", 6));
+	Pdf::ResourceDictionary dict;
+	dict.XObject["RE2"] = 21;
+	dict.XObject["RE3"] = 22;
+	dict.ColorSpace.append(colorSpace("Spot2", 16));
+
+	PdfExportIndex::mergeResources(dict, older);
+	QCOMPARE(dict.XObject.count(), 3);
+	QCOMPARE(dict.XObject.value("RE1"), PdfId(10));
+	QCOMPARE(dict.XObject.value("RE2"), PdfId(21));
+	QCOMPARE(dict.ColorSpace.count(), 2);
+	QCOMPARE(dict.ColorSpace.at(0).ResNum, PdfId(16));
+	QCOMPARE(dict.ColorSpace.at(1).ResName, QByteArray("Spot1"));
+}
@@ -9,6 +9,9 @@
 
 #include <QDebug>
 #include "testStoryText.h"
+#include "prefsstructs.h"
+#include "text/shapedtext.h"
+#include "text/shapedtextcache.h"
 
 void TestStoryText::initST()
 {
@@ -82,6 +85,216 @@ void TestStoryText::removePars()
 			 QString("0123456789") + SpecialChars::PARSEP + QString("abcdefghijklmnopqrstuVWXYZ"));
 }
 
+void TestStoryText::paragraphIndex()
+{
+	StoryText story;
+	story.insertChars(0,
+					  QString("Hallo") + SpecialChars::PARSEP +
+					  QString("schöne") + SpecialChars::PARSEP +
+					  SpecialChars::PARSEP +
+					  QString("Welt"));
+	QCOMPARE(story.length(), 18);
+	QCOMPARE(story.nrOfParagraphs(), 4u);
+	QCOMPARE(story.startOfParagraph(0), 0);
+	QCOMPARE(story.endOfParagraph(0), 5);
+	QCOMPARE(story.startOfParagraph(1), 6);
+	QCOMPARE(story.endOfParagraph(1), 12);
+	QCOMPARE(story.startOfParagraph(2), 13);
+	QCOMPARE(story.endOfParagraph(2), 13);
+	QCOMPARE(story.startOfParagraph(3), 14);
+	QCOMPARE(story.endOfParagraph(3), 18);
+	QCOMPARE(story.nrOfParagraph(0), 0u);
+	QCOMPARE(story.nrOfParagraph(5), 0u);
+	QCOMPARE(story.nrOfParagraph(6), 1u);
+	QCOMPARE(story.nrOfParagraph(17), 3u);
+	QCOMPARE(story.nrOfParagraph(18), 3u);
+	QCOMPARE(story.nextParagraph(0), 5);
+	QCOMPARE(story.nextParagraph(5), 12);
+	QCOMPARE(story.nextParagraph(13), 18);
+	QCOMPARE(story.prevParagraph(10), 5);
+	QCOMPARE(story.prevParagraph(14), 13);
+	QCOMPARE(story.prevParagraph(3), 0);
+	QCOMPARE(story.nextBlockStart(0), 6);
+
+	StoryText story2;
+	story2.insert(0, story);
+	QCOMPARE(story2.nrOfParagraphs(), 4u);
+	QCOMPARE(story2.endOfParagraph(1), 12);
+	story2.insertChars(story2.length(), QString(SpecialChars::PARSEP));
+	QCOMPARE(story2.nrOfParagraphs(), 4u);
+	QCOMPARE(story2.endOfParagraph(3), 18);
+}
+
+void TestStoryText::paragraphIndexEdit()
+{
+	StoryText story;
+	story.insertChars(0,
+					  QString("0123456789") + SpecialChars::PARSEP +
+					  QString("abcdefghij") + SpecialChars::PARSEP +
+					  QString("ABCDEFGHIJ"));
+	// insert a paragraph in the middle of the second one
+	story.insertChars(15, QString("xy") + SpecialChars::PARSEP + QString("z"));
+	QCOMPARE(story.nrOfParagraphs(), 4u);
+	QCOMPARE(story.endOfParagraph(0), 10);
+	QCOMPARE(story.endOfParagraph(1), 17);
+	QCOMPARE(story.endOfParagraph(2), 25);
+	QCOMPARE(story.startOfParagraph(3), 26);
+	// remove across two paragraph separators
+	story.removeChars(8, 12);
+	QCOMPARE(story.text(0, story.length()), QString("01234567fghij") + SpecialChars::PARSEP + QString("ABCDEFGHIJ"));
+	QCOMPARE(story.nrOfParagraphs(), 2u);
+	QCOMPARE(story.endOfParagraph(0), 13);
+	QCOMPARE(story.startOfParagraph(1), 14);
+	// turn a letter into a separator and back
+	story.replaceChar(3, SpecialChars::PARSEP);
+	QCOMPARE(story.nrOfParagraphs(), 3u);
+	QCOMPARE(story.endOfParagraph(0), 3);
+	QCOMPARE(story.endOfParagraph(1), 13);
+	story.replaceChar(3, QChar('3'));
+	QCOMPARE(story.nrOfParagraphs(), 2u);
+	QCOMPARE(story.endOfParagraph(0), 13);
+	story.removeChars(0, story.length());
+	QCOMPARE(story.nrOfParagraphs(), 0u);
+	QCOMPARE(story.nrOfParagraph(0), 0u);
+}
+
+void TestStoryText::trackPosition()
+{
+	StoryText story;
+	story.insertChars(0, QString("0123456789"));
+	uint revision = story.revision();
+	story.insertChars(2, QString("ab"));
+	story.removeChars(0, 3);
+	int pos = 5;
+	QVERIFY(story.trackPosition(revision, pos));
+	QCOMPARE(pos, 4);
+	QCOMPARE(story.text(pos), QChar('5'));
+
+	revision = story.revision();
+	story.replaceChar(4, QChar('x'));
+	pos = 4;
+	QVERIFY(!story.trackPosition(revision, pos));
+	pos = 6;
+	QVERIFY(story.trackPosition(revision, pos));
+	QCOMPARE(pos, 6);
+
+	revision = story.revision();
+	story.removeChars(3, 2);
+	pos = 4;
+	QVERIFY(!story.trackPosition(revision, pos));
+
+	revision = story.revision();
+	story.invalidateLayout();
+	pos = 6;
+	QVERIFY(!story.trackPosition(revision, pos));
+}
+
+void TestStoryText::shapedTextPrefs()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	TypoPrefs prefs;
+	memset(&prefs, 0, sizeof(TypoPrefs));
+	prefs.valueSuperScript = 33;
+
+	// what PageItem_TextFrame::layout() does before it shapes the story
+	ShapedTextCache* cache = story.shapedTextCache();
+	cache->setTypographicPrefs(prefs);
+	ShapedText shaped(&story, 0, 4);
+	shaped.glyphs().append(GlyphCluster(&story.charStyle(0), ScLayout_None, 0, 4, InlineFrame(-1), 0, story.text(0, 5)));
+	cache->put(shaped);
+	QVERIFY(cache->contains(0, 5));
+
+	// laying out again with the same preferences keeps the shaped text
+	cache->setTypographicPrefs(prefs);
+	QVERIFY(cache->contains(0, 5));
+
+	// the next layout after the superscript offset changed has to shape again
+	prefs.valueSuperScript = 40;
+	cache->setTypographicPrefs(prefs);
+	QVERIFY(!cache->contains(0, 5));
+}
+
+// puts one cluster for [first, last] into the cache of story, like ShapedTextFeed does after shaping
+static void putShaped(StoryText& story, int first, int last)
+{
+	ShapedText shaped(&story, first, last);
+	shaped.glyphs().append(GlyphCluster(&story.charStyle(first), ScLayout_None, first, last, InlineFrame(-1), 0, story.text(first, last + 1 - first)));
+	story.shapedTextCache()->put(shaped);
+}
+
+void TestStoryText::shapedTextChainStarts()
+{
+	StoryText story;
+	story.insertChars(0, QString("0123456789") + SpecialChars::PARSEP + QString("abcdefghij"));
+	ShapedTextCache* cache = story.shapedTextCache();
+
+	// the first frame shapes the whole first paragraph, the second frame starts within it
+	putShaped(story, 0, 10);
+	putShaped(story, 5, 10);
+	putShaped(story, 11, 20);
+	QVERIFY(cache->contains(0, 11));
+	QVERIFY(cache->contains(5, 6));
+	QVERIFY(cache->contains(11, 10));
+
+	// laying out the first frame again keeps the start of the second one
+	putShaped(story, 0, 10);
+	QVERIFY(cache->contains(5, 6));
+
+	QVERIFY(cache->get(5, 6).isValid());
+	QVERIFY(!cache->get(3, 8).isValid());
+	QCOMPARE(cache->hitCount(), 1);
+	QCOMPARE(cache->missCount(), 1);
+	QCOMPARE(cache->hitRate(), 0.5);
+
+	// a change before the second frame only drops the entry of the first
+	cache->clear(2, 1);
+	QVERIFY(!cache->contains(0, 11));
+	QVERIFY(cache->contains(5, 6));
+
+	// a change within the second frame drops both
+	putShaped(story, 0, 10);
+	cache->clear(7, 1);
+	QVERIFY(!cache->contains(0, 11));
+	QVERIFY(!cache->contains(5, 6));
+	QVERIFY(cache->contains(11, 10));
+}
+
+void TestStoryText::shapedTextAdjust()
+{
+	StoryText story;
+	story.insertChars(0, QString("0123456789") + SpecialChars::PARSEP + QString("abcdefghij"));
+	ShapedTextCache* cache = story.shapedTextCache();
+	putShaped(story, 0, 10);
+	putShaped(story, 5, 10);
+	putShaped(story, 11, 20);
+
+	// inserting before a cached paragraph shifts it
+	story.insertChars(2, QString("xy"));
+	QVERIFY(!cache->contains(0, 13));
+	QVERIFY(cache->contains(7, 6));
+	QVERIFY(cache->contains(13, 10));
+	QVERIFY(!cache->contains(11, 10));
+	ShapedText moved = cache->get(13, 10);
+	QVERIFY(moved.isValid());
+	QCOMPARE(moved.firstChar(), 13);
+	QCOMPARE(moved.lastChar(), 22);
+	QCOMPARE(moved.glyphs().first().firstChar(), 13);
+
+	// removing text before it shifts it back
+	story.removeChars(0, 2);
+	QVERIFY(cache->contains(11, 10));
+	QVERIFY(!cache->contains(13, 10));
+	moved = cache->get(11, 10);
+	QCOMPARE(moved.firstChar(), 11);
+	QCOMPARE(moved.glyphs().first().lastChar(), 20);
+
+	// removing the paragraph separator joins it with the previous paragraph
+	story.removeChars(10, 1);
+	QVERIFY(!cache->contains(10, 10));
+	QVERIFY(!cache->contains(11, 10));
+}
+
 void TestStoryText::applyCharStyle()
 {
 	StoryText story;
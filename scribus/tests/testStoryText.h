@@ -25,6 +25,12 @@ private slots:
 	void insertPar();
 	void removePar();
 	void removePars();
+	void paragraphIndex();
+	void paragraphIndexEdit();
+	void trackPosition();
+	void shapedTextPrefs();
+	void shapedTextChainStarts();
+	void shapedTextAdjust();
 	void applyCharStyle();
 	void removeCharStyle();
 };
@@ -0,0 +1,116 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "testStyleSet.h"
+
+static CharStyle namedStyle(const QString& name, double fontSize = 120.0)
+{
+	CharStyle style;
+	style.setName(name);
+	style.setFontSize(fontSize);
+	return style;
+}
+
+void TestStyleSet::findStyles()
+{
+	StyleSet<CharStyle> set;
+	for (int i = 0; i < 100; ++i)
+		set.create(namedStyle(QString("style%1").arg(i)));
+	QCOMPARE(set.count(), 100);
+	QCOMPARE(set.find("style0"), 0);
+	QCOMPARE(set.find("style42"), 42);
+	QCOMPARE(set.find("style100"), -1);
+	QVERIFY(set.contains("style99"));
+	QVERIFY(!set.contains("style100"));
+	set.create(namedStyle("style100"));
+	QCOMPARE(set.find("style100"), 100);
+	// the first one of equally named styles is found
+	set.create(namedStyle("style42", 200.0));
+	QCOMPARE(set.find("style42"), 42);
+	QCOMPARE(set.get("style42").fontSize(), 120.0);
+}
+
+void TestStyleSet::removeStyles()
+{
+	StyleSet<CharStyle> set;
+	for (int i = 0; i < 10; ++i)
+		set.create(namedStyle(QString("style%1").arg(i)));
+	set.remove(3);
+	QCOMPARE(set.count(), 9);
+	QCOMPARE(set.find("style3"), -1);
+	QCOMPARE(set.find("style2"), 2);
+	QCOMPARE(set.find("style4"), 3);
+	QCOMPARE(set.find("style9"), 8);
+}
+
+void TestStyleSet::renameStyles()
+{
+	StyleSet<CharStyle> set;
+	set.create(namedStyle("a"));
+	set.create(namedStyle("b"));
+	QMap<QString, QString> newNames;
+	newNames["a"] = "c";
+	set.rename(newNames);
+	QCOMPARE(set.find("a"), -1);
+	QCOMPARE(set.find("c"), 0);
+	QCOMPARE(set.find("b"), 1);
+	// renamed without telling the set
+	set[1].setName("d");
+	set.invalidate();
+	QCOMPARE(set.find("b"), -1);
+	QCOMPARE(set.find("d"), 1);
+	set[1].setName("e");
+	QCOMPARE(set.find("d"), -1);
+	QCOMPARE(set.find("e"), 1);
+	// the new name looked up first
+	set[1].setName("f");
+	QCOMPARE(set.find("f"), 1);
+	QCOMPARE(set.find("e"), -1);
+}
+
+void TestStyleSet::redefineStyles()
+{
+	StyleSet<CharStyle> set;
+	set.create(namedStyle("a", 100.0));
+	set.create(namedStyle("b", 100.0));
+	set.create(namedStyle("c", 100.0));
+	StyleSet<CharStyle> defs;
+	defs.create(namedStyle("c", 200.0));
+	defs.create(namedStyle("d", 200.0));
+	defs.create(namedStyle("a", 200.0));
+
+	set.redefine(defs, false);
+	QCOMPARE(set.count(), 4);
+	QCOMPARE(set.find("b"), 1);
+	QCOMPARE(set.find("d"), 3);
+	QCOMPARE(set.get("a").fontSize(), 200.0);
+	QCOMPARE(set.get("b").fontSize(), 100.0);
+
+	set.redefine(defs, true);
+	QCOMPARE(set.count(), 3);
+	QCOMPARE(set.find("b"), -1);
+	QCOMPARE(set.find("a"), 0);
+	QCOMPARE(set.find("c"), 1);
+	QCOMPARE(set.find("d"), 2);
+	QCOMPARE(set.get("d").fontSize(), 200.0);
+}
+
+void TestStyleSet::resolveInContext()
+{
+	StyleSet<CharStyle> base;
+	base.create(namedStyle("base", 100.0));
+	StyleSet<CharStyle> set;
+	set.setContext(&base);
+	CharStyle child(namedStyle("child", 200.0));
+	child.setParent("base");
+	child.resetFontSize();
+	set.create(child);
+	QVERIFY(set.resolve("base") != nullptr);
+	QVERIFY(set.resolve("missing") == nullptr);
+	QCOMPARE(set.find("base"), -1);
+	QCOMPARE(set.get("child").fontSize(), 100.0);
+}
@@ -0,0 +1,24 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+#include "styles/charstyle.h"
+#include "styles/styleset.h"
+
+class TestStyleSet: public QObject
+{
+		Q_OBJECT
+		
+private slots:
+		
+	void findStyles();
+	void removeStyles();
+	void renameStyles();
+	void redefineStyles();
+	void resolveInContext();
+};
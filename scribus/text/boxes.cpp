@@ -21,6 +21,16 @@
 #include "itextcontext.h"
 #include "itextsource.h"
 
+void Box::moveChars(int delta)
+{
+	if (m_firstChar != INT_MAX)
+		m_firstChar += delta;
+	if (m_lastChar != INT_MIN)
+		m_lastChar += delta;
+	for (int i = 0; i < m_boxes.count(); ++i)
+		m_boxes[i]->moveChars(delta);
+}
+
 int GroupBox::pointToPosition(QPointF coord, const StoryText &story) const
 {
 	QPointF rel = coord - QPointF(m_x, m_y);
@@ -749,6 +759,12 @@ void GlyphBox::render(TextLayoutPainter *p) const
 	p->restore();
 }
 
+void GlyphBox::moveChars(int delta)
+{
+	Box::moveChars(delta);
+	m_glyphRun.shiftChars(delta);
+}
+
 int GlyphBox::pointToPosition(QPointF coord, const StoryText& story) const
 {
 	if (firstChar() != lastChar())
@@ -867,3 +883,37 @@ void ObjectBox::render(ScreenPainter *p, ITextContext *ctx) const
 {
 	render(p);
 }
+
+BoxArena::~BoxArena()
+{
+	clear();
+	for (int i = 0; i < m_blocks.count(); ++i)
+		delete[] m_blocks[i];
+}
+
+void BoxArena::clear()
+{
+	for (int i = m_boxes.count() - 1; i >= 0; --i)
+		m_boxes[i]->~Box();
+	m_boxes.resize(0);
+
+	// blocks grow in size, the last one is the largest and is kept
+	while (m_blocks.count() > 1)
+		delete[] m_blocks.takeFirst();
+	m_used = 0;
+}
+
+void* BoxArena::allocate(size_t size, size_t align)
+{
+	size_t offset = (m_used + align - 1) & ~(align - 1);
+	if (m_blocks.isEmpty() || offset + size > m_blockSize)
+	{
+		size_t blockSize = m_blocks.isEmpty() ? 4096 : qMin<size_t>(2 * m_blockSize, 256 * 1024);
+		blockSize = qMax(blockSize, size + align);
+		m_blocks.append(new char[blockSize]);
+		m_blockSize = blockSize;
+		offset = 0;
+	}
+	m_used = offset + size;
+	return m_blocks.last() + offset;
+}
@@ -8,7 +8,15 @@
 #ifndef BOXES_H
 #define BOXES_H
 
-#include <QObject>
+#include <climits>
+#include <new>
+#include <utility>
+
+#include <QList>
+#include <QLineF>
+#include <QRectF>
+#include <QTransform>
+#include <QVector>
 
 #include "glyphcluster.h"
 #include "sctextstruct.h"
@@ -24,10 +32,9 @@ class ScreenPainter;
  Scribus packs glyph runs into GlyphBoxes, GlyphBoxes and ObjectBoxes into LineBoxes
  and LineBoxes into GroupBox(T_Block).
  (and in the future: math atoms, tables & table cells, ...)
+ Boxes are created in and owned by a BoxArena, a parent box does not delete its children.
  */
-class Box: public QObject {
-	Q_OBJECT
-
+class Box {
 public:
 	enum BoxType {
 		T_Invalid,
@@ -54,11 +61,7 @@ public:
 		m_naturalDescent = 0;
 	}
 
-	virtual ~Box()
-	{
-		while (!m_boxes.isEmpty())
-			delete m_boxes.takeFirst();
-	}
+	virtual ~Box() {}
 
 	/// The x position of the box relative to its parent.
 	double x() const { return m_x; }
@@ -108,6 +111,9 @@ public:
 	/// The last character within the box.
 	int lastChar() const { return m_lastChar == INT_MIN ? 0 : m_lastChar; }
 
+	/// Shifts the character indices of the box and its children by delta.
+	virtual void moveChars(int delta);
+
 	/// Sets the transformation matrix to applied to the box.
 	void setMatrix(QTransform x) { m_matrix = x; }
 
@@ -144,11 +150,6 @@ public:
 	/// return box type
 	BoxType type() const { return m_type; }
 
-//public slots:
-//	virtual void childChanged() { }
-//signals:
-//	void boxChanged();
-
 protected:
 	BoxType m_type;
 	BoxDirection m_direction;
@@ -168,7 +169,6 @@ protected:
 
 class GroupBox: public Box
 {
-	Q_OBJECT
 public:
 	GroupBox(BoxDirection direction)
 	{
@@ -208,7 +208,6 @@ private:
 
 class LineBox: public GroupBox
 {
-	Q_OBJECT
 public:
 	LineBox()
 		: GroupBox(D_Horizontal)
@@ -240,7 +239,6 @@ protected:
 
 class PathLineBox: public LineBox
 {
-	Q_OBJECT
 public:
 	PathLineBox()
 	{
@@ -254,7 +252,6 @@ protected:
 
 class GlyphBox: public Box
 {
-	Q_OBJECT
 public:
 	GlyphBox(const GlyphCluster& run)
 		: m_glyphRun(run)
@@ -277,6 +274,8 @@ public:
 
 	GlyphCluster glyphRun() const { return m_glyphRun; }
 
+	void moveChars(int delta);
+
 	const CharStyle& style() const { return m_glyphRun.style(); }
 
 protected:
@@ -286,7 +285,6 @@ protected:
 
 class ObjectBox: public GlyphBox
 {
-	Q_OBJECT
 public:
 	ObjectBox(const GlyphCluster& run, ITextContext* ctx)
 		: GlyphBox(run)
@@ -302,4 +300,40 @@ private:
 	/* const */ PageItem* m_object;
 };
 
+
+/**
+ BoxArena holds all boxes of one TextLayout. Boxes are constructed in place in a few
+ large memory blocks and are destroyed all at once by clear(), so that relayouting
+ or closing a document does not cost a heap allocation and a free for every glyph run.
+ */
+class BoxArena
+{
+public:
+	BoxArena() : m_used(0), m_blockSize(0) {}
+	~BoxArena();
+
+	/// Constructs a new box of type T, the box stays valid until clear() is called.
+	template<class T, class... Args>
+	T* create(Args&&... args)
+	{
+		T* box = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		m_boxes.append(box);
+		return box;
+	}
+
+	/// Destroys all boxes and keeps the largest block for reuse.
+	void clear();
+
+private:
+	BoxArena(const BoxArena&);
+	BoxArena& operator=(const BoxArena&);
+
+	void* allocate(size_t size, size_t align);
+
+	QVector<Box*> m_boxes;
+	QVector<char*> m_blocks;
+	size_t m_used;
+	size_t m_blockSize;
+};
+
 #endif // BOXES_H
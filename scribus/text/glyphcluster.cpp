@@ -114,6 +114,17 @@ int GlyphCluster::visualIndex() const
 	return m_visualIndex;
 }
 
+void GlyphCluster::shiftChars(int delta)
+{
+	m_firstChar += delta;
+	m_lastChar += delta;
+}
+
+void GlyphCluster::shiftVisualIndex(int delta)
+{
+	m_visualIndex += delta;
+}
+
 double GlyphCluster::scaleH() const
 {
 	return m_scaleH;
@@ -25,6 +25,10 @@ public:
 	int firstChar() const;
 	int lastChar() const;
 	int visualIndex() const;
+	/// moves the character range by delta, used when text before this cluster changes
+	void shiftChars(int delta);
+	/// moves the visual index by delta, used when shaped texts are combined
+	void shiftVisualIndex(int delta);
 
 	double width() const;
 
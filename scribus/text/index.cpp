@@ -5,6 +5,7 @@
  for which a new license (GPL+exception) is in place.
  */
 
+#include <algorithm>
 #include <QDebug>
 
 #include "index.h"
@@ -8,8 +8,6 @@
 #ifndef INDEX_H
 #define INDEX_H
 
-#undef NDEBUG
-
 #include "scribusapi.h"
 #include <cassert>
 #include <vector>
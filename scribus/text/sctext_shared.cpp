@@ -16,14 +16,20 @@ for which a new license (GPL+exception) is in place.
 #include "sctext_shared.h"
 #include "util.h"
 
+// revisions are unique across all texts so that a revision of one text never matches another one
+static uint s_revisionCounter = 0;
+static const int MaxRecordedChanges = 256;
+
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) : QList<ScText*>(), 
 	defaultStyle(), 
 	pstyleContext(nullptr),
-	refs(1), len(0), cursorPosition(0), trailingStyle()
+	refs(1), len(0), cursorPosition(0), trailingStyle(), shapedTextCache(), paragraphs(),
+	revision(0), baseRevision(0), lastLength(0)
 {
 	pstyleContext.setDefaultStyle( & defaultStyle );
 	defaultStyle.setContext( pstyles );
 	trailingStyle.setContext( &pstyleContext );
+	resetChanges();
 //		defaultStyle.charStyle().setContext( cstyles );
 //		qDebug() << QString("ScText_Shared() %1 %2 %3 %4").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&defaultStyle)).arg(reinterpret_cast<uint>(pstyles)).arg(reinterpret_cast<uint>(cstyles));
 }
@@ -33,7 +39,8 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(),
 	defaultStyle(other.defaultStyle), 
 	pstyleContext(other.pstyleContext),
 	refs(1), len(0), cursorPosition(other.cursorPosition),
-	trailingStyle(other.trailingStyle)
+	trailingStyle(other.trailingStyle), shapedTextCache(), paragraphs(),
+	revision(0), baseRevision(0), lastLength(0)
 {
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
@@ -43,6 +50,8 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(),
 		elem = it.next();
 		ScText* elem2 = new ScText(*elem);
 		append(elem2);
+		if (elem2->ch == SpecialChars::PARSEP)
+			paragraphs.insert(count());
 		if (elem2->parstyle) {
 			elem2->parstyle->setContext( & pstyleContext);
 //				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext() );
@@ -51,6 +60,7 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(),
 	}
 	len = count();
 	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
+	resetChanges();
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
 
@@ -60,6 +70,30 @@ void ScText_Shared::clear()
 		delete this->takeFirst(); 
 	QList<ScText*>::clear();
 	cursorPosition = 0;
+	shapedTextCache.clear();
+	paragraphs.clear();
+	resetChanges();
+}
+
+void ScText_Shared::recordChange(int firstItem, int endItem)
+{
+	Change change;
+	change.delta = static_cast<int>(len) - static_cast<int>(lastLength);
+	change.firstItem = firstItem;
+	change.endItem = qMax(firstItem, endItem - change.delta);
+	change.revision = ++s_revisionCounter;
+	changes.append(change);
+	revision = change.revision;
+	lastLength = len;
+	if (changes.count() > MaxRecordedChanges)
+		baseRevision = changes.takeFirst().revision;
+}
+
+void ScText_Shared::resetChanges()
+{
+	changes.clear();
+	revision = baseRevision = ++s_revisionCounter;
+	lastLength = len;
 }
 
 ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
@@ -79,6 +113,8 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 			elem = it.next();
 			ScText* elem2 = new ScText(*elem);
 			append(elem2);
+			if (elem2->ch == SpecialChars::PARSEP)
+				paragraphs.insert(count());
 			if (elem2->parstyle) {
 				elem2->parstyle->setContext( & pstyleContext );
 //					qDebug() << QString("StoryText::copy: * %1 align=%2").arg(elem2->parstyle->parent())
@@ -94,6 +130,7 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
 //				   .arg(trailingStyle.alignment()).arg((uint)trailingStyle.context());
 		replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext());
+		resetChanges();
 	}
 //			qDebug() << QString("ScText_Shared: %1 = %2").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 	return *this;
@@ -8,10 +8,12 @@
 
 //#include "text/paragraphlayout.h"
 #include "text/frect.h"
+#include "text/index.h"
 #include "style.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
+#include "text/shapedtextcache.h"
 
 
 class SCRIBUS_API ScText_Shared : public QList<ScText*>
@@ -23,6 +25,28 @@ public:
 	uint len;
 	uint cursorPosition;
 	ParagraphStyle trailingStyle;
+	/// shaped blocks of this text, shared by all StoryTexts using this data
+	ShapedTextCache shapedTextCache;
+	/// paragraph runs, each run ends after a PARSEP
+	RunIndex paragraphs;
+
+	/// a recorded change of the text, positions are from before the change
+	struct Change
+	{
+		int firstItem;
+		int endItem;
+		int delta;
+		uint revision;
+	};
+	/// the most recent changes, oldest first
+	QList<Change> changes;
+	/// revision of the last change
+	uint revision;
+	/// changes up to this revision are no longer known
+	uint baseRevision;
+	/// length when the last change was recorded
+	uint lastLength;
+
 	ScText_Shared(const StyleContext* pstyles);	
 
 	ScText_Shared(const ScText_Shared& other);
@@ -32,6 +56,12 @@ public:
 	~ScText_Shared();
 
 	void clear();
+
+	/// records a change of [firstItem, endItem) (new positions) together with the length change since the last record
+	void recordChange(int firstItem, int endItem);
+	/// forgets all recorded changes
+	void resetChanges();
+
 	
 	/**
 	   A char's stylecontext is the containing paragraph's style, 
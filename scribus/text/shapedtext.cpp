@@ -52,12 +52,33 @@ public:
 	/** only possible if they are adjacent pieces of the same text source */
 	bool canCombine(const QSharedPointer<ShapedTextImplementation>  other) const
 	{
-		return false; // TODO: implement
+		return other != nullptr && other->m_source == m_source && other->m_firstChar == m_lastChar + 1;
 	}
 	
 	void combine(QSharedPointer<ShapedTextImplementation>  other)
 	{
-		// TODO: implement
+		if (!canCombine(other))
+			return;
+		int visualOffset = m_glyphs.count();
+		m_glyphs.reserve(m_glyphs.count() + other->m_glyphs.count());
+		for (int i = 0; i < other->m_glyphs.count(); ++i)
+		{
+			m_glyphs.append(other->m_glyphs.at(i));
+			m_glyphs.last().shiftVisualIndex(visualOffset);
+		}
+		m_lastChar = other->m_lastChar;
+		m_needsContext = m_needsContext || other->m_needsContext;
+	}
+	
+	ShapedText moved(int newFirstChar) const
+	{
+		ShapedTextImplementation* result = new ShapedTextImplementation(*this);
+		int delta = newFirstChar - m_firstChar;
+		result->m_firstChar += delta;
+		result->m_lastChar += delta;
+		for (int i = 0; i < result->m_glyphs.count(); ++i)
+			result->m_glyphs[i].shiftChars(delta);
+		return ShapedText(result);
 	}
 	
 private:
@@ -102,4 +123,5 @@ bool ShapedText::canSplit(int pos) const { return p_impl->canSplit(pos); }
 ShapedText ShapedText::split(int pos) { return p_impl->split(pos); }
 bool ShapedText::canCombine(const ShapedText& other) const { return p_impl->canCombine(other.p_impl); }
 void ShapedText::combine(ShapedText& other) { p_impl->combine(other.p_impl); }
+ShapedText ShapedText::moved(int newFirstChar) const { return p_impl->moved(newFirstChar); }
 
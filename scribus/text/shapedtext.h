@@ -64,6 +64,8 @@ public:
 	/** only possible if they are adjacent pieces of the same text source */
 	bool canCombine(const ShapedText& other) const;
 	void combine(ShapedText& other);
+	/** returns a copy whose character positions start at newFirstChar, used by the cache after edits before this text */
+	ShapedText moved(int newFirstChar) const;
 };
 
 
@@ -7,73 +7,170 @@
 
 #include "shapedtextcache.h"
 
-#include "index.h"
+#include <climits>
+#include <QList>
+
+#include "prefsstructs.h"
 #include "shapedtext.h"
 
 
 class ShapedTextCacheImplementation {
 	
-	IndexedList<ShapedText> m_cache;
+	struct Entry {
+		Entry(int f, int l, const ShapedText& t) : first(f), last(l), text(t) {}
+		
+		// current position of the entry in the story. This may differ from
+		// text.firstChar() after edits before the entry, see adjust()
+		int first;
+		int last;
+		ShapedText text;
+	};
+	
+	// Sorted by last, then by first. Entries of different blocks don't overlap, a block may have
+	// several entries ending at its end: one from its start and one from each frame starting in it.
+	QList<Entry> m_cache;
+	int m_hits;
+	int m_misses;
+	// superscript, subscript and small caps metrics go into the glyphs
+	TypoPrefs m_prefs;
+	bool m_havePrefs;
+	
+	// returns the index of the first entry with last >= charPos
+	int search(int charPos) const
+	{
+		int lo = 0;
+		int hi = m_cache.count();
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (m_cache[mid].last < charPos)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
 	
+	// returns the index of the entry for [first, last], or where it would be inserted
+	int search(int first, int last) const
+	{
+		int lo = 0;
+		int hi = m_cache.count();
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			const Entry& entry = m_cache[mid];
+			if (entry.last < last || (entry.last == last && entry.first < first))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	
+	// removes all entries which overlap [first, last]
+	void remove(int first, int last)
+	{
+		// entries of a block ending at or after first are sorted by first, the next blocks
+		// start after the end of that block
+		int idx = search(first);
+		while (idx < m_cache.count() && m_cache[idx].first <= last)
+			m_cache.removeAt(idx);
+	}
 	
 public:
 	
-	// check if all ShapedText in the cache for this range are valid, i.e. source() != nullptr
+	ShapedTextCacheImplementation() : m_hits(0), m_misses(0), m_havePrefs(false) {}
+	
 	bool contains(int charPos, uint len) const
 	{
-		int last = charPos + len - 1;
-		if (!m_cache.containsPosition(charPos) || !m_cache.containsPosition(last))
-			return false;
-		
-		ShapedText st = m_cache(charPos);
-		while (st.isValid() && st.lastChar() < last)
+		int last = charPos + static_cast<int>(len) - 1;
+		int idx = search(charPos, last);
+		return idx < m_cache.count() 
+			&& m_cache[idx].first == charPos 
+			&& m_cache[idx].last == last;
+	}
+	
+	
+	ShapedText get(int charPos, uint minLen)
+	{
+		if (!contains(charPos, minLen))
 		{
-			st = m_cache(st.lastChar() + 1);
+			++m_misses;
+			return ShapedText::Invalid;
 		}
-		
-		return st.isValid();
+		++m_hits;
+		Entry& entry = m_cache[search(charPos, charPos + static_cast<int>(minLen) - 1)];
+		if (entry.text.firstChar() != entry.first)
+			entry.text = entry.text.moved(entry.first);
+		return entry.text;
 	}
 	
 	
-	ShapedText get(int charPos, uint minLen) const
+	void put(const ShapedText& txt)
 	{
-		int last = charPos + minLen - 1;
-		if (!m_cache.containsPosition(charPos) || !m_cache.containsPosition(last))
-			return ShapedText::Invalid;
-
-		ShapedText result = m_cache(charPos);
-		if (!result.isValid())
-			return ShapedText::Invalid;
+		if (!txt.isValid() || txt.lastChar() < txt.firstChar())
+			return;
+		int first = txt.firstChar();
+		int last = txt.lastChar();
 		
-		if (!m_cache.isExactPosition(charPos))
+		// Frames starting within a block shape it from there. Their entries are kept next to
+		// the one for the whole block, so the frames of a chain don't evict each other's.
+		// Overlapping entries ending elsewhere belong to blocks which have changed.
+		int idx = search(first);
+		while (idx < m_cache.count() && m_cache[idx].first <= last)
 		{
-			result = result.split(charPos);
+			if (m_cache[idx].last == last && m_cache[idx].first != first)
+				++idx;
+			else
+				m_cache.removeAt(idx);
 		}
-		while (result.lastChar() < last)
+		// context dependent text has to be reshaped for every frame
+		if (txt.needsContext() || txt.glyphs().isEmpty())
+			return;
+		m_cache.insert(search(first, last), Entry(first, last, txt));
+	}
+	
+	
+	void clear(int charPos, uint len)
+	{
+		if (len == 0)
+			return;
+		if (charPos <= 0 && len == static_cast<uint>(-1))
 		{
-			ShapedText st = m_cache(result.lastChar() + 1);
-			if (st.source() == nullptr || !result.canCombine(st))
-				return ShapedText::Invalid;
-			result.combine(st);
+			m_cache.clear();
+			return;
 		}
-		return result;
+		int last = len > static_cast<uint>(INT_MAX - charPos) ? INT_MAX : charPos + static_cast<int>(len) - 1;
+		remove(charPos, last);
 	}
 	
 	
-	void put(const ShapedText& txt)
+	void adjust(int charPos, int len)
 	{
-		int first = txt.firstChar();
-		int len = txt.lastChar() + 1 - first;
-		
-		m_cache.replace(first, len , txt);
+		if (len == 0)
+			return;
+		// entries adjacent to the edit are dropped as well, since shaping looks at neighbouring chars
+		int end = len > 0 ? charPos : charPos - len;
+		remove(charPos - 1, end);
+		for (int i = search(end); i < m_cache.count(); ++i)
+		{
+			m_cache[i].first += len;
+			m_cache[i].last += len;
+		}
 	}
 	
-	void clear(int charPos, uint len)
+	void setTypographicPrefs(const TypoPrefs& prefs)
 	{
-		put(ShapedText(nullptr, charPos, charPos + len - 1));
+		if (m_havePrefs && m_prefs == prefs)
+			return;
+		m_cache.clear();
+		m_prefs = prefs;
+		m_havePrefs = true;
 	}
-
 	
+	int hits() const { return m_hits; }
+	int misses() const { return m_misses; }
 };
 
 
@@ -90,3 +187,21 @@ void ShapedTextCache::put(const ShapedText& txt)
 
 void ShapedTextCache::clear(int charPos, uint len)
 { p_impl->clear(charPos, len); }
+
+void ShapedTextCache::adjust(int charPos, int len)
+{ p_impl->adjust(charPos, len); }
+
+void ShapedTextCache::setTypographicPrefs(const TypoPrefs& prefs)
+{ p_impl->setTypographicPrefs(prefs); }
+
+int ShapedTextCache::hitCount() const
+{ return p_impl->hits(); }
+
+int ShapedTextCache::missCount() const
+{ return p_impl->misses(); }
+
+double ShapedTextCache::hitRate() const
+{
+	int total = p_impl->hits() + p_impl->misses();
+	return total > 0 ? static_cast<double>(p_impl->hits()) / total : 0.0;
+}
@@ -38,6 +38,11 @@ public:
 class ShapedTextCacheImplementation;
 
 
+/**
+ * Caches the ShapedText of the blocks of a story. Entries are only returned for the exact
+ * range they were shaped for. Context dependent text (page numbers, marks, inline objects)
+ * is never stored and thus always reshaped.
+ */
 class SCRIBUS_API ShapedTextCache : public IShapedTextCache
 {
 	QSharedPointer<ShapedTextCacheImplementation> p_impl;
@@ -48,6 +53,15 @@ public:
 	ShapedText get(int charPos, uint minLen=1) const;
 	void put(const ShapedText& txt);
 	void clear(int charPos = 0, uint len = -1);
+	/** update for len chars inserted (len > 0) or removed (len < 0) at charPos. Drops the touched entries and moves the following ones */
+	void adjust(int charPos, int len);
+	/** drops all entries if prefs differ from the typographic preferences they were shaped with */
+	void setTypographicPrefs(const TypoPrefs& prefs);
+
+	int hitCount() const;
+	int missCount() const;
+	/** fraction of get() calls answered from the cache, 0 if there were none */
+	double hitRate() const;
 };
 
 
@@ -39,7 +39,7 @@ bool ShapedTextFeed::haveMoreText(int glyphPos, QList<GlyphCluster>& glyphs)
 		if (more.glyphs().count() == 0)
 			break;
 //		qDebug() << "feed" << m_endChar << "-->" << more.lastChar() + 1;
-		m_endChar = more.lastChar();
+		m_endChar = more.lastChar() + 1;
 		int nOldGlyphs = glyphs.count();
 		glyphs.append(more.glyphs());
 		std::sort(glyphs.begin() + nOldGlyphs, glyphs.end(), logicalGlyphRunComp);
@@ -51,19 +51,43 @@ bool ShapedTextFeed::haveMoreText(int glyphPos, QList<GlyphCluster>& glyphs)
 
 ShapedText ShapedTextFeed::getMore(int fromChar, int toChar)
 {
-	if (m_cache != nullptr)
+	if (m_cache == nullptr)
+		return m_shaper.shape(fromChar, toChar);
+
+	toChar = qMin(toChar, m_textSource->length());
+	ShapedText cached = m_cache->get(fromChar, toChar - fromChar);
+	if (cached.isValid())
+		return cached;
+
+	if (TextShaper::threadCount() > 1)
 	{
-		int len = toChar - fromChar;
-		if (!m_cache->contains(fromChar, len))
+		// a long run of unshaped blocks ahead, e.g. after an import or a font change:
+		// shape them on all cores and keep them in the cache for the following calls
+		QVector<int> boundaries;
+		boundaries.append(fromChar);
+		boundaries.append(toChar);
+		int pos = toChar;
+		while (pos < m_textSource->length() && pos - fromChar < ParallelShapingChars)
 		{
-			m_cache->put(m_shaper.shape(fromChar, toChar));
+			int next = m_textSource->nextBlockStart(pos);
+			if (m_cache->contains(pos, next - pos))
+				break;
+			boundaries.append(next);
+			pos = next;
+		}
+		// n + 1 boundaries enclose n blocks
+		if (boundaries.count() - 1 > ParallelShapingMinBlocks)
+		{
+			QList<ShapedText> shaped = m_shaper.shapeParallel(boundaries);
+			for (int i = 0; i < shaped.count(); ++i)
+				m_cache->put(shaped[i]);
+			return shaped.first();
 		}
-		return m_cache->get(fromChar, len);
-	}
-	else
-	{
-		return m_shaper.shape(fromChar, toChar);
 	}
+
+	ShapedText result = m_shaper.shape(fromChar, toChar);
+	m_cache->put(result);
+	return result;
 }
 
 
@@ -31,6 +31,11 @@ class ShapedTextFeed
 	TextShaper m_shaper;
 	int m_endChar;
 	
+	/// getMore() shapes up to this many characters ahead in parallel when they are not cached
+	static const int ParallelShapingChars = 65536;
+	/// and only does so if there are more blocks than this
+	static const int ParallelShapingMinBlocks = 8;
+	
 public:
 	ShapedTextFeed(ITextSource* source, int startChar, ITextContext* context, IShapedTextCache* cache = nullptr);
 	
@@ -46,8 +46,8 @@ StoryText::StoryText(ScribusDoc * doc_) : m_doc(doc_)
 	if (doc_)
 	{
 		d = new ScText_Shared(&doc_->paragraphStyles());
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().connect(this, SLOT(styleContextChanged()));
 	}
 	else
 		d = new ScText_Shared(nullptr);
@@ -55,8 +55,6 @@ StoryText::StoryText(ScribusDoc * doc_) : m_doc(doc_)
 	m_selFirst = 0;
 	m_selLast = -1;
 	
-	m_shapedTextCache = new ShapedTextCache();
-	
 	d->len = 0;
 	invalidateAll();
 }
@@ -67,7 +65,6 @@ StoryText::StoryText() : m_doc(nullptr)
 
 	m_selFirst = 0;
 	m_selLast = -1;
-	m_shapedTextCache = nullptr;
 }
 
 StoryText::StoryText(const StoryText & other) : QObject(), SaxIO(), m_doc(other.m_doc)
@@ -77,13 +74,12 @@ StoryText::StoryText(const StoryText & other) : QObject(), SaxIO(), m_doc(other.
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().connect(this, SLOT(styleContextChanged()));
 	}
 	
 	m_selFirst = 0;
 	m_selLast = -1;
-	m_shapedTextCache = nullptr;
 
 	invalidateLayout();
 }
@@ -95,8 +91,8 @@ StoryText::~StoryText()
 	documents */
 /*	if (doc)
 	{
-		doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		doc->paragraphStyles().disconnect(this, SLOT(styleContextChanged()));
+		doc->charStyles().disconnect(this, SLOT(styleContextChanged()));
 	} */
 	d->refs--;
 	if (d->refs == 0) {
@@ -110,16 +106,16 @@ void StoryText::setDoc(ScribusDoc *docin)
 {
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().disconnect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().disconnect(this, SLOT(styleContextChanged()));
 	}
 
 	m_doc = docin;
 
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().connect(this, SLOT(styleContextChanged()));
 	}
 }
 
@@ -143,8 +139,8 @@ StoryText& StoryText::operator= (const StoryText & other)
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().disconnect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().disconnect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().disconnect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().disconnect(this, SLOT(styleContextChanged()));
 	}
 	
 	m_doc = other.m_doc; 
@@ -152,8 +148,8 @@ StoryText& StoryText::operator= (const StoryText & other)
 	
 	if (m_doc)
 	{
-		m_doc->paragraphStyles().connect(this, SLOT(invalidateAll()));
-		m_doc->charStyles().connect(this, SLOT(invalidateAll()));
+		m_doc->paragraphStyles().connect(this, SLOT(styleContextChanged()));
+		m_doc->charStyles().connect(this, SLOT(styleContextChanged()));
 	}
 	
 	m_selFirst = 0;
@@ -495,7 +491,7 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 			applyStyle(pos, other.paragraphStyle(otherEnd-1));
 		}
 	}
-	invalidate(pos, length());
+	invalidate(pos, qMin(findParSep(pos) + 1, length()), pos);
 }
 
 
@@ -505,6 +501,7 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 void StoryText::insertParSep(int pos)
 {
 	ScText* it = item(pos);
+	d->paragraphs.insert(pos + 1);
 	if (!it->parstyle)
 	{
 		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
@@ -539,6 +536,7 @@ void StoryText::removeParSep(int pos)
 	// doesn't choke:
 	it->ch = 0;
 	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());
+	d->paragraphs.remove(d->paragraphs(pos));
 }
 
 void StoryText::removeChars(int pos, uint len)
@@ -555,12 +553,21 @@ void StoryText::removeChars(int pos, uint len)
 	if (pos + static_cast<int>(len) > length())
 		len = length() - pos;
 
+	d->shapedTextCache.adjust(pos, -static_cast<int>(len));
+
+	// removed chars are accounted in the paragraph index before each PARSEP and at the end
+	int removed = 0;
 	for (int i = pos + static_cast<int>(len) - 1; i >= pos; --i)
 	{
 		ScText *it = d->at(i);
 		if ((it->ch == SpecialChars::PARSEP))
+		{
+			d->paragraphs.adjust(i + 1, -removed);
+			removed = 0;
 			removeParSep(i);
+		}
 		d->takeAt(i);
+		++removed;
 		d->len--;
 		delete it;
 		// #9592 : adjust m_selFirst and m_selLast, those values have to be
@@ -573,6 +580,8 @@ void StoryText::removeChars(int pos, uint len)
 			d->cursorPosition -= 1;
 	}
 
+	d->paragraphs.adjust(pos, -removed);
+
 	d->len = d->count();
 	d->cursorPosition = qMin(d->cursorPosition, d->len);
 	if (m_selFirst > m_selLast)
@@ -580,7 +589,8 @@ void StoryText::removeChars(int pos, uint len)
 		m_selFirst =  0;
 		m_selLast  = -1;
 	}
-	invalidate(pos, length());
+	// text after the paragraph containing pos is unchanged and keeps its shaped text
+	invalidate(pos, qMin(findParSep(pos) + 1, length()), pos);
 }
 
 void StoryText::trim()
@@ -635,6 +645,10 @@ void StoryText::insertChars(int pos, const QString& txt, bool applyNeighbourStyl
 		clone.setEffects(ScStyle_Default);
 	}
 
+	d->shapedTextCache.adjust(pos, txt.length());
+
+	// inserted chars are accounted in the paragraph index at each PARSEP and at the end
+	int pending = 0;
 	for (int i = 0; i < txt.length(); ++i)
 	{
 		ScText * item = new ScText(clone);
@@ -642,14 +656,18 @@ void StoryText::insertChars(int pos, const QString& txt, bool applyNeighbourStyl
 		item->setContext(cStyleContext);
 		d->insert(pos + i, item);
 		d->len++;
+		++pending;
 		if (item->ch == SpecialChars::PARSEP)
 		{
 //			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
+			d->paragraphs.adjust(pos + i + 1 - pending, pending);
+			pending = 0;
 			insertParSep(pos + i);
 		}
 		if (d->cursorPosition >= static_cast<uint>(pos + i))
 			d->cursorPosition += 1;
 	}
+	d->paragraphs.adjust(pos + txt.length() - pending, pending);
 
 	d->len = d->count();
 	invalidate(pos, pos + txt.length());
@@ -677,6 +695,7 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 	}
 
 	int inserted = 0;
+	int pending = 0;
 	for (int i = 0; i < txt.length(); ++i) 
 	{
 		QChar ch = txt.at(i);
@@ -701,15 +720,23 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 			item->setContext(cStyleContext);
 			d->insert(index, item);
 			d->len++;
+			++pending;
 			if (item->ch == SpecialChars::PARSEP)
+			{
+				d->paragraphs.adjust(index + 1 - pending, pending);
+				pending = 0;
 				insertParSep(index);
+			}
 			if (d->cursorPosition >= static_cast<uint>(index))
 				d->cursorPosition += 1;
 			++inserted;
 		}
 	}
 
+	d->paragraphs.adjust(pos + inserted - pending, pending);
+
 	d->len = d->count();
+	d->shapedTextCache.adjust(pos, inserted);
 	invalidate(pos, pos + inserted);
 }
 
@@ -900,9 +927,7 @@ bool StoryText::isBlockStart(int pos) const
 
 int StoryText::nextBlockStart(int pos) const
 {
-	int result = pos + 1;
-	while (result < length() && !isBlockStart(result))
-		++result;
+	int result = qMax(pos + 1, qMin(findParSep(pos) + 1, length()));
 	
 	// lump empty (or small) paragraphs together
 	while (result+1 < length() && isBlockStart(result+1))
@@ -1195,8 +1220,7 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 //	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
 //	return doc->docParagraphStyles[that->at(pos)->cab];
 	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP)
-		++pos;
+	pos = findParSep(pos);
 
 	if (pos >= length())
 		return that->d->trailingStyle;
@@ -1323,9 +1347,7 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
-		++i;
+	int i = findParSep(pos);
 
 	if (i < length())
 	{
@@ -1365,9 +1387,7 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos >= 0);
 	assert(pos <= length());
 		
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
-		++i;
+	int i = findParSep(pos);
 
 	if (i < length())
 	{
@@ -1451,6 +1471,20 @@ void StoryText::replaceStyles(QMap<QString,QString> newNameForOld)
 
 void StoryText::replaceNamedResources(ResourceCollection& newNames)
 {
+	// texts which don't use renamed styles need no new layout
+	if (newNames.colors().isEmpty() && newNames.fonts().isEmpty() && newNames.fontfeatures().isEmpty())
+	{
+		QSet<QString> paragraphStyles, charStyles;
+		getStyleNames(paragraphStyles, charStyles);
+		bool used = false;
+		for (auto it = newNames.styles().constBegin(); !used && it != newNames.styles().constEnd(); ++it)
+			used = paragraphStyles.contains(it.key());
+		for (auto it = newNames.charStyles().constBegin(); !used && it != newNames.charStyles().constEnd(); ++it)
+			used = charStyles.contains(it.key());
+		if (!used)
+			return;
+	}
+
 	int len = length();
 
 	d->defaultStyle.replaceNamedResources(newNames);
@@ -1472,6 +1506,32 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 	invalidate(0, len);	
 }
 
+void StoryText::getStyleNames(QSet<QString>& paragraphStyles, QSet<QString>& charStyles) const
+{
+	auto addParagraphStyle = [&](const ParagraphStyle& style)
+	{
+		paragraphStyles.insert(style.parent());
+		charStyles.insert(style.charStyle().parent());
+		charStyles.insert(style.peCharStyleName());
+	};
+	addParagraphStyle(d->defaultStyle);
+	addParagraphStyle(d->trailingStyle);
+
+	// runs of equally styled chars are frequent, don't hash each of them
+	QString lastCharStyle;
+	for (int i = 0; i < d->count(); ++i)
+	{
+		const ScText* itText = d->at(i);
+		if (itText->parstyle)
+			addParagraphStyle(*itText->parstyle);
+		QString charStyle(itText->parent());
+		if ((i > 0) && (charStyle == lastCharStyle))
+			continue;
+		charStyles.insert(charStyle);
+		lastCharStyle = charStyle;
+	}
+}
+
 
 void StoryText::replaceCharStyles(QMap<QString,QString> newNameForOld)
 {
@@ -1531,30 +1591,15 @@ uint StoryText::nrOfParagraph() const
 
 uint StoryText::nrOfParagraph(int pos) const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	pos = qMin(pos, that->length());
-	for (int i=0; i < pos; ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
-	return result;
+	// number of PARSEPs before pos
+	pos = qMin(pos, length());
+	return d->paragraphs(pos);
 }
 
 uint StoryText::nrOfParagraphs() const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	for (int i=0; i < length(); ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
+	uint result = d->paragraphs.runCount();
+	bool lastWasPARSEP = length() == 0 || d->at(length() - 1)->ch == SpecialChars::PARSEP;
 	return lastWasPARSEP ? result : result + 1;
 }
 
@@ -1567,13 +1612,8 @@ int StoryText::startOfParagraph(uint index) const
 {
 	if (index == 0)
 		return 0;
-
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i + 1;
-	}
+	if (index <= d->paragraphs.runCount())
+		return d->paragraphs.runStart(index);
 	return length();
 }
 
@@ -1584,13 +1624,8 @@ int StoryText::endOfParagraph() const
 
 int StoryText::endOfParagraph(uint index) const
 {
-	++index;
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i;
-	}
+	if (index < d->paragraphs.runCount())
+		return d->paragraphs.runEnd(index) - 1;
 	return length();
 }
 
@@ -1713,18 +1748,25 @@ int StoryText::prevSentence(int pos)
 }
 int StoryText::nextParagraph(int pos)
 {
-	int len = length();
-	pos = qMin(len, pos+1);
-	while (pos < len && text(pos) != SpecialChars::PARSEP)
-		++pos;
-	return pos;
+	pos = qMin(length(), pos+1);
+	return findParSep(pos);
 }
 int StoryText::prevParagraph(int pos)
 {
 	pos = qMax(0, pos-1);
-	while (pos > 0 && text(pos) != SpecialChars::PARSEP)
-		--pos;
-	return pos;
+	// index of the first PARSEP after pos
+	uint idx = d->paragraphs(pos + 1);
+	if (idx == 0)
+		return 0;
+	return d->paragraphs.runEnd(idx - 1) - 1;
+}
+
+int StoryText::findParSep(int pos) const
+{
+	uint idx = d->paragraphs(pos);
+	if (idx >= d->paragraphs.runCount())
+		return qMax(pos, length());
+	return d->paragraphs.runEnd(idx) - 1;
 }
 
 
@@ -1976,12 +2018,50 @@ void StoryText::removeSelection()
 
 
 
+ShapedTextCache* StoryText::shapedTextCache()
+{
+	return &d->shapedTextCache;
+}
+
+uint StoryText::revision() const
+{
+	return d->revision;
+}
+
+bool StoryText::trackPosition(uint revision, int& pos) const
+{
+	if (revision < d->baseRevision)
+		return false;
+	for (int i = 0; i < d->changes.count(); ++i)
+	{
+		const ScText_Shared::Change& change = d->changes.at(i);
+		if (change.revision <= revision)
+			continue;
+		if (change.firstItem >= pos || change.endItem >= pos)
+			return false;
+		pos += change.delta;
+	}
+	return true;
+}
+
 void StoryText::invalidateObject(const PageItem * embedded)
 {
 }
 
 void StoryText::invalidateLayout()
 {
+	// frames can't rely on earlier positions any more
+	d->resetChanges();
+}
+
+void StoryText::styleContextChanged()
+{
+	if (m_doc && m_doc->inStyleChanges())
+	{
+		m_doc->storyStylesChanged(this);
+		return;
+	}
+	invalidateAll();
 }
 
 void StoryText::invalidateAll()
@@ -1992,12 +2072,25 @@ void StoryText::invalidateAll()
 
 void StoryText::invalidate(int firstItem, int endItem)
 {
+	invalidate(firstItem, endItem, endItem);
+}
+
+void StoryText::invalidate(int firstItem, int endItem, int changedEnd)
+{
+	d->recordChange(firstItem, changedEnd);
 	for (int i=firstItem; i < endItem; ++i)
 	{
 		ParagraphStyle* par = item(i)->parstyle;
 		if (par)
 			par->charStyleContext()->invalidate();
 	}
+	// shaping looks at neighbouring chars, so drop those blocks too, but not the paragraph
+	// after a range ending with a PARSEP: it is shaped on its own
+	int firstCached = qMax(0, firstItem - 1);
+	int endCached = endItem + 1;
+	if (endItem > firstItem && endItem <= length() && d->at(endItem - 1)->ch == SpecialChars::PARSEP)
+		endCached = endItem;
+	d->shapedTextCache.clear(firstCached, endCached - firstCached);
 	if (!signalsBlocked())
 		emit changed(firstItem, endItem);
 }
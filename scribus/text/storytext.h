@@ -27,6 +27,7 @@ pageitem.cpp  -  description
 
 #include <cassert>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QList>
 
@@ -198,6 +199,8 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO, public ITextSource
 	
 	void getNamedResources(ResourceCollection& lists) const;
 	void replaceNamedResources(ResourceCollection& newNames);
+	/// adds the names of the paragraph and character styles used by the text, without their parents
+	void getStyleNames(QSet<QString>& paragraphStyles, QSet<QString>& charStyles) const;
 	
  	uint nrOfParagraphs() const;
 	int startOfParagraph() const;
@@ -254,7 +257,16 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO, public ITextSource
 
 // layout helpers
 
-	ShapedTextCache* shapedTextCache() { return m_shapedTextCache; }
+	ShapedTextCache* shapedTextCache();
+
+	/// returns a number which changes with every change of the text
+	uint revision() const;
+	/**
+	   Maps pos from the text as of revision to the current text.
+	   Returns false if anything at or after pos was changed since then
+	   or if these changes are no longer known.
+	 */
+	bool trackPosition(uint revision, int& pos) const;
 
 	LayoutFlags flags(int pos) const;
 	bool hasFlag(int pos, LayoutFlags flag) const;
@@ -275,15 +287,20 @@ public slots:
 signals:
 	void changed(int firstItem, int endItem);
 
+private slots:
+	/// invalidates the text, or leaves that to the document during a batch of style changes
+	void styleContextChanged();
+
 private:
  	ScText * item(uint index);
  	const ScText * item(uint index) const;
 	void fixSurrogateSelection();
+	/// returns the position of the first PARSEP at or after pos, or length() if there is none
+	int findParSep(int pos) const;
 	
 private:
 	ScribusDoc * m_doc; 
 	int m_selFirst, m_selLast;
-	ShapedTextCache* m_shapedTextCache;
 	static BreakIterator* m_graphemeIterator;
 	static BreakIterator* m_wordIterator;
 	static BreakIterator* m_sentenceIterator;
@@ -294,6 +311,8 @@ private:
 	
  	/// mark these runs as invalid, ie. need itemize and shaping
  	void invalidate(int firstRun, int lastRun);
+ 	/// same as above, but only [firstRun, changedEnd) was actually edited
+ 	void invalidate(int firstRun, int lastRun, int changedEnd);
  	void removeParSep(int pos);
  	void insertParSep(int pos);
 
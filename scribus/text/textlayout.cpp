@@ -38,12 +38,11 @@ TextLayout::TextLayout(StoryText* text, ITextContext* frame)
 	m_magicX = 0.0;
 	m_lastMagicPos = -1;
 
-	m_box = new GroupBox(Box::D_Horizontal);
+	m_box = m_arena.create<GroupBox>(Box::D_Horizontal);
 }
 
 TextLayout::~TextLayout()
 {
-	delete m_box;
 }
 
 uint TextLayout::lines() const
@@ -111,6 +110,12 @@ void TextLayout::removeLastLine ()
 		column->removeBox(lineCount - 1);
 }
 
+void TextLayout::moveChars(int delta)
+{
+	m_box->moveChars(delta);
+	m_lastMagicPos = -1;
+}
+
 void TextLayout::render(ScreenPainter *p, ITextContext *ctx) const
 {
 	p->save();
@@ -191,7 +196,7 @@ void TextLayout::render(TextLayoutPainter *p) const
 
 void TextLayout::addColumn(double colLeft, double colWidth)
 {
-	GroupBox *newBox = new GroupBox(Box::D_Vertical);
+	GroupBox *newBox = m_arena.create<GroupBox>(Box::D_Vertical);
 	newBox->moveTo(colLeft, 0.0);
 	newBox->setWidth(colWidth);
 	newBox->setAscent(m_frame->height());
@@ -204,8 +209,8 @@ void TextLayout::addColumn(double colLeft, double colWidth)
 
 void TextLayout::clear() 
 {
-	delete m_box;
-	m_box = new GroupBox(Box::D_Horizontal);
+	m_arena.clear();
+	m_box = m_arena.create<GroupBox>(Box::D_Horizontal);
 }
 
 void TextLayout::setStory(StoryText *story)
@@ -24,11 +24,9 @@
 #include "frect.h"
 #include "scpainter.h"
 #include "sctextstruct.h"
+#include "boxes.h"
 
 class StoryText;
-class Box;
-class GroupBox;
-class LineBox;
 class TextLayoutPainter;
 class ScreenPainter;
 class ITextContext;
@@ -68,8 +66,14 @@ public:
 	const Box* box() const;
 	Box* box();
 
+	/// creates a box owned by this layout, it is destroyed by the next clear()
+	template<class T, class... Args>
+	T* createBox(Args&&... args) { return m_arena.create<T>(std::forward<Args>(args)...); }
+
 	void appendLine(LineBox* ls);
 	void removeLastLine ();
+	/// shifts all character indices by delta, used when text was inserted or removed in front of this layout
+	void moveChars(int delta);
 	void addColumn(double colLeft, double colWidth);
 
 	void clear();
@@ -79,6 +83,7 @@ protected:
 	
 	StoryText* m_story;
     ITextContext* m_frame;
+	BoxArena m_arena;
 	GroupBox* m_box;
 	
 	bool m_validLayout;
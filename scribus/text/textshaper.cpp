@@ -3,8 +3,18 @@
 #include <harfbuzz/hb.h>
 #include <harfbuzz/hb-ft.h>
 #include <harfbuzz/hb-icu.h>
+#include <harfbuzz/hb-ot.h>
 #include <unicode/ubidi.h>
 
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QThreadStorage>
+
 #include "scrptrun.h"
 
 #include "glyphcluster.h"
@@ -16,6 +26,261 @@
 
 using namespace icu;
 
+int TextShaper::s_threadCount = 0;
+
+/**
+ A HarfBuzz face for shapeParallel(). Unlike the face behind ScFace::hbFont(), which reads
+ its tables through the FreeType face of the font, it is backed by a copy of the font data
+ and can be used from several threads at once.
+ */
+struct ShaperFace
+{
+	ShaperFace() : face(nullptr), spaceGlyph(0), hyphenGlyph(0) {}
+
+	// a reference of its own, released by shapeParallel()
+	hb_face_t* face;
+	// ScFace::emulateGlyph() asks FreeType for these, so they are looked up in advance
+	ScFace::gid_type spaceGlyph;
+	ScFace::gid_type hyphenGlyph;
+};
+
+static void releaseFontData(void* data)
+{
+	delete reinterpret_cast<QByteArray*>(data);
+}
+
+struct CachedShaperFace
+{
+	hb_face_t* face;
+	qint64 bytes;
+};
+
+// faces are kept between runs, so HarfBuzz can keep its shape plans. Each one holds a copy
+// of the font data, the least recently used ones are dropped beyond MaxShaperFaceBytes.
+static const qint64 MaxShaperFaceBytes = 64 * 1024 * 1024;
+static QMutex s_shaperFacesMutex;
+static QHash<QString, CachedShaperFace> s_shaperFaces;
+// least recently used first
+static QList<QString> s_shaperFaceOrder;
+static qint64 s_shaperFaceBytes = 0;
+
+/// returns a new reference to the face, to be released with hb_face_destroy()
+static hb_face_t* threadSafeFace(const ScFace& scFace)
+{
+	hb_font_t* hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
+	// fonts using the FreeType font functions can't be shared between threads
+	if (hbFont == nullptr || hb_ft_font_get_face(hbFont) != nullptr)
+		return nullptr;
+	if (scFace.format() != ScFace::SFNT && scFace.format() != ScFace::TTCF)
+		return nullptr;
+
+	QMutexLocker locker(&s_shaperFacesMutex);
+	// the faces of a collection share their file
+	const QString key = scFace.fontPath() + QLatin1Char(':') + QString::number(scFace.faceIndex());
+	QHash<QString, CachedShaperFace>::const_iterator it = s_shaperFaces.constFind(key);
+	if (it != s_shaperFaces.constEnd())
+	{
+		s_shaperFaceOrder.removeOne(key);
+		s_shaperFaceOrder.append(key);
+		return it->face ? hb_face_reference(it->face) : nullptr;
+	}
+
+	CachedShaperFace cached;
+	cached.face = nullptr;
+	cached.bytes = 0;
+	QByteArray* data = new QByteArray();
+	// for a collection this is a font file of its own holding just the face
+	ScFace(scFace).rawData(*data);
+	if (data->isEmpty())
+		delete data;
+	else
+	{
+		cached.bytes = data->size();
+		hb_blob_t* blob = hb_blob_create(data->constData(), data->size(), HB_MEMORY_MODE_READONLY, data, releaseFontData);
+		cached.face = hb_face_create(blob, 0);
+		hb_blob_destroy(blob);
+	}
+
+	// the fonts of running or cached shapers keep their own references to dropped faces
+	while (!s_shaperFaceOrder.isEmpty() && (s_shaperFaceBytes + cached.bytes > MaxShaperFaceBytes))
+	{
+		CachedShaperFace dropped = s_shaperFaces.take(s_shaperFaceOrder.takeFirst());
+		s_shaperFaceBytes -= dropped.bytes;
+		if (dropped.face)
+			hb_face_destroy(dropped.face);
+	}
+	s_shaperFaces.insert(key, cached);
+	s_shaperFaceOrder.append(key);
+	s_shaperFaceBytes += cached.bytes;
+	return cached.face ? hb_face_reference(cached.face) : nullptr;
+}
+
+/**
+ The HarfBuzz and ICU objects used by TextShaper::shapeText(). Each thread has its own
+ instance, see local(), which keeps the scaled fonts, the parsed font features and the
+ buffer from one run to the next.
+ */
+class ShaperResources
+{
+public:
+	ShaperResources()
+		: m_faces(nullptr),
+		m_buffer(nullptr),
+		m_lineIterator(nullptr),
+		m_graphemeIterator(nullptr)
+	{
+		UErrorCode status = U_ZERO_ERROR;
+		m_lineIterator = BreakIterator::createLineInstance(Locale(), status);
+		if (U_FAILURE(status))
+		{
+			delete m_lineIterator;
+			m_lineIterator = nullptr;
+		}
+		status = U_ZERO_ERROR;
+		m_graphemeIterator = BreakIterator::createCharacterInstance(Locale(), status);
+		if (U_FAILURE(status))
+		{
+			delete m_graphemeIterator;
+			m_graphemeIterator = nullptr;
+		}
+	}
+
+	~ShaperResources()
+	{
+		clearFonts();
+		if (m_buffer)
+			hb_buffer_destroy(m_buffer);
+		delete m_lineIterator;
+		delete m_graphemeIterator;
+	}
+
+	/// the instance of the calling thread
+	static ShaperResources& local()
+	{
+		static QThreadStorage<ShaperResources*> resources;
+		if (!resources.hasLocalData())
+			resources.setLocalData(new ShaperResources());
+		return *resources.localData();
+	}
+
+	/// the faces prepared by TextShaper::shapeParallel(), nullptr to use the fonts of ScFace
+	void setFaces(const QHash<void*, ShaperFace>* faces) { m_faces = faces; }
+
+	/// a font for scFace scaled to size, nullptr if there is no HarfBuzz font for the face
+	hb_font_t* font(const ScFace& scFace, int size)
+	{
+		hb_font_t* parent = reinterpret_cast<hb_font_t*>(scFace.hbFont());
+		if (parent == nullptr)
+			return nullptr;
+
+		if (m_faces == nullptr)
+		{
+			FT_Face ftFace = hb_ft_font_get_face(parent);
+			if (ftFace)
+			{
+				// fonts using the FreeType font functions share the FreeType face,
+				// these are scaled again for every run
+				hb_font_set_scale(parent, size, size);
+				FT_Set_Char_Size(ftFace, size, 0, 72, 0);
+				return parent;
+			}
+		}
+
+		const FontKey key(parent, size);
+		hb_font_t* font = m_fonts.value(key, nullptr);
+		if (font)
+			return font;
+
+		hb_face_t* face = hb_font_get_face(parent);
+		if (m_faces != nullptr)
+		{
+			face = m_faces->value(parent).face;
+			if (face == nullptr)
+				return nullptr;
+		}
+		if (m_fonts.count() >= MaxFonts)
+			clearFonts();
+		font = hb_font_create(face);
+		hb_ot_font_set_funcs(font);
+		hb_font_set_scale(font, size, size);
+		// holding a reference keeps the key from being reused by another face
+		hb_font_reference(parent);
+		m_fonts.insert(key, font);
+		return font;
+	}
+
+	/// parses a feature like "+liga" or "smcp=1", returns false if it is not valid
+	bool feature(const QString& feature, hb_feature_t& hbFeature)
+	{
+		QHash<QString, ParsedFeature>::const_iterator it = m_features.constFind(feature);
+		if (it == m_features.constEnd())
+		{
+			if (m_features.count() >= MaxFeatures)
+				m_features.clear();
+			ParsedFeature parsed;
+			std::string strFeature(feature.toStdString());
+			parsed.valid = hb_feature_from_string(strFeature.c_str(), strFeature.length(), &parsed.feature);
+			it = m_features.insert(feature, parsed);
+		}
+		hbFeature = it->feature;
+		return it->valid;
+	}
+
+	/// an empty buffer, the same one is handed out for all runs of this thread
+	hb_buffer_t* buffer()
+	{
+		if (m_buffer == nullptr)
+			m_buffer = hb_buffer_create();
+		else
+			hb_buffer_reset(m_buffer);
+		return m_buffer;
+	}
+
+	ScFace::gid_type emulateGlyph(const ScFace& scFace, QChar ch) const
+	{
+		if (m_faces != nullptr)
+		{
+			if (ch == SpecialChars::NBSPACE)
+				return m_faces->value(scFace.hbFont()).spaceGlyph;
+			if (ch == SpecialChars::NBHYPHEN)
+				return m_faces->value(scFace.hbFont()).hyphenGlyph;
+		}
+		return scFace.emulateGlyph(ch.unicode());
+	}
+
+	BreakIterator* lineIterator() const { return m_lineIterator; }
+	BreakIterator* graphemeIterator() const { return m_graphemeIterator; }
+
+private:
+	typedef QPair<hb_font_t*, int> FontKey;
+
+	struct ParsedFeature
+	{
+		hb_feature_t feature;
+		bool valid;
+	};
+
+	static const int MaxFonts = 256;
+	static const int MaxFeatures = 1024;
+
+	void clearFonts()
+	{
+		for (QHash<FontKey, hb_font_t*>::const_iterator it = m_fonts.constBegin(); it != m_fonts.constEnd(); ++it)
+		{
+			hb_font_destroy(it.value());
+			hb_font_destroy(it.key().first);
+		}
+		m_fonts.clear();
+	}
+
+	const QHash<void*, ShaperFace>* m_faces;
+	QHash<FontKey, hb_font_t*> m_fonts;
+	QHash<QString, ParsedFeature> m_features;
+	hb_buffer_t* m_buffer;
+	BreakIterator* m_lineIterator;
+	BreakIterator* m_graphemeIterator;
+};
+
 TextShaper::TextShaper(ITextContext* context, ITextSource &story, int firstChar, bool singlePar)
 	: m_context(context),
 	m_contextNeeded(false),
@@ -118,17 +383,16 @@ QList<TextShaper::FeaturesRun> TextShaper::itemizeFeatures(const TextRun &run)
 	while (start < run.start + run.len)
 	{
 		int end = start;
-		QStringList startFeatures = m_story.charStyle(m_textMap.value(start)).fontFeatures().split(",");
+		const QString& startFeatures = m_story.charStyle(m_textMap.value(start)).fontFeatures();
 		while (end < run.start + run.len)
 		{
-			QStringList endFeatures = m_story.charStyle(m_textMap.value(end)).fontFeatures().split(",");
-			if (startFeatures != endFeatures)
+			if (m_story.charStyle(m_textMap.value(end)).fontFeatures() != startFeatures)
 				break;
 			end++;
 		}
-		subfeature.append(FeaturesRun(start, end - start, startFeatures));
+		// the string is only split once per run
+		subfeature.append(FeaturesRun(start, end - start, startFeatures.split(",")));
 		start = end;
-		startFeatures.clear();
 	}
 	newRuns.append(subfeature);
 	return newRuns;
@@ -265,19 +529,32 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 {
 	m_contextNeeded = false;
 	
-	ShapedText result(ShapedText(&m_story, fromPos, toPos, m_context));
+	if (toPos > m_story.length() || toPos < 0)
+		toPos = m_story.length();
+
+	ShapedText result(ShapedText(&m_story, fromPos, toPos - 1, m_context));
 	
 
 	QVector<int> smallCaps;
 
 	buildText(fromPos, toPos, smallCaps);
 
+	shapeText(result, smallCaps, ShaperResources::local());
+
+	m_textMap.clear();
+	m_text = "";
+	result.needsContext(m_contextNeeded);
+	return result;
+}
+
+void TextShaper::shapeText(ShapedText& result, const QVector<int>& smallCaps, ShaperResources& resources)
+{
 	QList<TextRun> bidiRuns = itemizeBiDi();
 	QList<TextRun> scriptRuns = itemizeScripts(bidiRuns);
 	QList<TextRun> textRuns = itemizeStyles(scriptRuns);
 
 	QVector<int32_t> lineBreaks;
-	BreakIterator* lineIt = StoryText::getLineIterator();
+	BreakIterator* lineIt = resources.lineIterator();
 	// FIXME-HOST: add some fallback code if the iterator failed
 	if (lineIt)
 	{
@@ -302,7 +579,7 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 		case USCRIPT_TAI_VIET:
 		case USCRIPT_THAI:
 		{
-			BreakIterator* charIt = StoryText::getGraphemeIterator();
+			BreakIterator* charIt = resources.graphemeIterator();
 			if (charIt)
 			{
 				const QString text = m_text.mid(run.start, run.len);
@@ -331,21 +608,16 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
 
 		const ScFace &scFace = style.font();
-		hb_font_t *hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
+		hb_font_t *hbFont = resources.font(scFace, style.fontSize());
 		if (hbFont == nullptr)
 			continue;
 
-		hb_font_set_scale(hbFont, style.fontSize(), style.fontSize());
-		FT_Face ftFace = hb_ft_font_get_face(hbFont);
-		if (ftFace)
-			FT_Set_Char_Size(ftFace, style.fontSize(), 0, 72, 0);
-
 		hb_direction_t hbDirection = (textRun.dir == UBIDI_LTR) ? HB_DIRECTION_LTR : HB_DIRECTION_RTL;
 		hb_script_t hbScript = hb_icu_script_to_script(textRun.script);
 		std::string language = style.language().toStdString();
 		hb_language_t hbLanguage = hb_language_from_string(language.c_str(), language.length());
 
-		hb_buffer_t *hbBuffer = hb_buffer_create();
+		hb_buffer_t *hbBuffer = resources.buffer();
 		hb_buffer_add_utf16(hbBuffer, m_text.utf16(), m_text.length(), textRun.start, textRun.len);
 		hb_buffer_set_direction(hbBuffer, hbDirection);
 		hb_buffer_set_script(hbBuffer, hbScript);
@@ -357,13 +629,11 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 		for (const FeaturesRun& featuresRun : featuresRuns)
 		{
 			const QStringList& features = featuresRun.features;
-			hbFeatures.reserve(features.length());
+			hbFeatures.reserve(hbFeatures.length() + features.length());
 			for (const QString& feature : features)
 			{
 				hb_feature_t hbFeature;
-				std::string strFeature(feature.toStdString());
-				hb_bool_t ok = hb_feature_from_string(strFeature.c_str(), strFeature.length(), &hbFeature);
-				if (ok)
+				if (resources.feature(feature, hbFeature))
 				{
 					hbFeature.start = featuresRun.start;
 					hbFeature.end = featuresRun.len + featuresRun.start;
@@ -476,7 +746,7 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 				    (ch == SpecialChars::LINEBREAK || ch == SpecialChars::PARSEP ||
 				     ch == SpecialChars::FRAMEBREAK || ch == SpecialChars::COLBREAK))
 				{
-					gl.glyph = scFace.emulateGlyph(ch.unicode());
+					gl.glyph = resources.emulateGlyph(scFace, ch);
 				}
 
 				if (gl.glyph < ScFace::CONTROL_GLYPHS)
@@ -634,12 +904,182 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 
 			result.glyphs().append(run);
 		}
-		hb_buffer_destroy(hbBuffer);
 
 	}
+}
 
-	m_textMap.clear();
-	m_text = "";
-	result.needsContext(m_contextNeeded);
+
+int TextShaper::threadCount()
+{
+	return s_threadCount > 0 ? s_threadCount : qMax(1, QThread::idealThreadCount());
+}
+
+void TextShaper::setThreadCount(int count)
+{
+	s_threadCount = qMax(0, count);
+}
+
+bool TextShaper::prepareFaces(int fromPos, int toPos, QHash<void*, ShaperFace>& faces)
+{
+	// shapeText() reads this, make sure it exists before the workers start
+	m_story.paragraphStyle(qMin(m_firstChar, m_story.length())).direction();
+
+	void* lastKey = nullptr;
+	for (int i = fromPos; i < toPos; ++i)
+	{
+		// page numbers and marks depend on the document, and marks change their style on access
+		if (m_story.hasExpansionPoint(i))
+			return false;
+		const ScFace& scFace = m_story.charStyle(i).font();
+		void* key = scFace.hbFont();
+		// ScFace would try to load a broken font again on every access
+		if (key == nullptr)
+			return false;
+		if (key == lastKey)
+			continue;
+		lastKey = key;
+		if (!faces.contains(key))
+		{
+			ShaperFace shaperFace;
+			shaperFace.face = threadSafeFace(scFace);
+			shaperFace.spaceGlyph = scFace.emulateGlyph(SpecialChars::NBSPACE.unicode());
+			shaperFace.hyphenGlyph = scFace.emulateGlyph(SpecialChars::NBHYPHEN.unicode());
+			// loads the face data, which is used for super- and subscripts
+			scFace.ascent();
+			faces.insert(key, shaperFace);
+		}
+		if (faces.value(key).face == nullptr)
+			return false;
+	}
+	return true;
+}
+
+/// one range for TextShaper::shapeParallel()
+struct ShaperBlock
+{
+	ShaperBlock(ITextContext* context, ITextSource& story, int firstChar, bool singlePar, int fromPos, int toPos)
+		: shaper(context, story, firstChar, singlePar),
+		result(&story, fromPos, toPos - 1, context),
+		parallel(false)
+	{ }
+
+	TextShaper shaper;
+	ShapedText result;
+	QVector<int> smallCaps;
+	bool parallel;
+};
+
+/// shapes the parallel blocks of shapeParallel() until there are none left
+class TextShaperTask : public QRunnable
+{
+public:
+	TextShaperTask(const QList<ShaperBlock*>& blocks, QAtomicInt& next, const QHash<void*, ShaperFace>& faces, QSemaphore* done)
+		: m_blocks(blocks), m_next(next), m_faces(faces), m_done(done)
+	{ }
+
+	void run()
+	{
+		ShaperResources& resources(ShaperResources::local());
+		resources.setFaces(&m_faces);
+		for (int i = m_next.fetchAndAddOrdered(1); i < m_blocks.count(); i = m_next.fetchAndAddOrdered(1))
+		{
+			ShaperBlock* block = m_blocks.at(i);
+			if (block->parallel)
+				block->shaper.shapeText(block->result, block->smallCaps, resources);
+		}
+		resources.setFaces(nullptr);
+		if (m_done)
+			m_done->release();
+	}
+
+private:
+	const QList<ShaperBlock*>& m_blocks;
+	QAtomicInt& m_next;
+	const QHash<void*, ShaperFace>& m_faces;
+	QSemaphore* m_done;
+};
+
+static QThreadPool* shaperThreadPool()
+{
+	static QThreadPool pool;
+	return &pool;
+}
+
+QList<ShapedText> TextShaper::shapeParallel(const QVector<int>& boundaries)
+{
+	QList<ShapedText> results;
+	int count = boundaries.count() - 1;
+	int threads = qMin(threadCount(), count);
+	if (threads <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+			results.append(shape(boundaries[i], boundaries[i + 1]));
+		return results;
+	}
+
+	// Everything which may change the story, the document or the font caches happens
+	// here, on the calling thread: building the text to shape, expanding page numbers,
+	// paragraph effects, validating styles and loading the fonts.
+	QHash<void*, ShaperFace> faces;
+	QList<ShaperBlock*> blocks;
+	for (int i = 0; i < count; ++i)
+	{
+		int fromPos = boundaries[i];
+		int toPos = boundaries[i + 1];
+		if (toPos > m_story.length() || toPos < 0)
+			toPos = m_story.length();
+		ShaperBlock* block = new ShaperBlock(m_context, m_story, m_firstChar, m_singlePar, fromPos, toPos);
+		block->shaper.buildText(fromPos, toPos, block->smallCaps);
+		block->parallel = block->shaper.prepareFaces(fromPos, toPos, faces);
+		blocks.append(block);
+	}
+
+	// the calling thread takes part in the work instead of just waiting
+	QAtomicInt next(0);
+	QSemaphore done;
+	QThreadPool* pool = shaperThreadPool();
+	if (pool->maxThreadCount() < threads - 1)
+		pool->setMaxThreadCount(threads - 1);
+	for (int t = 1; t < threads; ++t)
+		pool->start(new TextShaperTask(blocks, next, faces, &done));
+	TextShaperTask(blocks, next, faces, nullptr).run();
+	done.acquire(threads - 1);
+
+	ShaperResources& resources(ShaperResources::local());
+	for (ShaperBlock* block : blocks)
+	{
+		if (!block->parallel)
+			block->shaper.shapeText(block->result, block->smallCaps, resources);
+		block->result.needsContext(block->shaper.m_contextNeeded);
+		results.append(block->result);
+	}
+	qDeleteAll(blocks);
+	for (const ShaperFace& shaperFace : qAsConst(faces))
+	{
+		if (shaperFace.face)
+			hb_face_destroy(shaperFace.face);
+	}
+	return results;
+}
+
+ShapedText TextShaper::shapeParallel(int fromPos, int toPos)
+{
+	if (toPos > m_story.length() || toPos < 0)
+		toPos = m_story.length();
+	if (fromPos >= toPos)
+		return shape(fromPos, toPos);
+
+	QVector<int> boundaries;
+	boundaries.append(fromPos);
+	for (int pos = fromPos; pos < toPos; )
+	{
+		pos = qMin(m_story.nextBlockStart(pos), toPos);
+		boundaries.append(pos);
+	}
+
+	QList<ShapedText> parts = shapeParallel(boundaries);
+	ShapedText result = parts.takeFirst();
+	for (ShapedText& part : parts)
+		result.combine(part);
 	return result;
 }
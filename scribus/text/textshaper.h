@@ -1,13 +1,16 @@
 #ifndef TEXTSHAPER_H
 #define TEXTSHAPER_H
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include <unicode/uscript.h>
 
+#include "scribusapi.h"
 #include "itextsource.h"
 #include "itextcontext.h"
 #include "shapedtext.h"
@@ -15,10 +18,12 @@
 class GlyphCluster;
 class StoryText;
 class PageItem;
+class ShaperResources;
+struct ShaperFace;
 
 using namespace icu;
 
-class TextShaper
+class SCRIBUS_API TextShaper
 {
 public:
 	TextShaper(ITextContext* context, ITextSource& story, int firstChar, bool singlePar=false);
@@ -26,7 +31,25 @@ public:
 
 	ShapedText shape(int fromPos, int toPos);
 
+	/**
+	 Shapes each of the ranges [boundaries[i], boundaries[i+1]) like shape() would and returns
+	 the results in the same order. Preparing the text happens on the calling thread, the
+	 itemization and HarfBuzz shaping of the ranges is spread over threadCount() threads.
+	 Ranges which use fonts HarfBuzz can't read on its own or contain expansion points are
+	 shaped on the calling thread.
+	 */
+	QList<ShapedText> shapeParallel(const QVector<int>& boundaries);
+	/// Shapes [fromPos, toPos) split at paragraph boundaries on several threads and combines the result.
+	ShapedText shapeParallel(int fromPos, int toPos);
+
+	/// Number of threads used by shapeParallel(), 1 disables parallel shaping.
+	static int threadCount();
+	/// Sets the number of threads used by shapeParallel(), 0 uses one thread per core.
+	static void setThreadCount(int count);
+
 private:
+	friend class TextShaperTask;
+
 	struct TextRun {
 		TextRun(int s, int l, int d)
 			: start(s), len(l), dir(d), script(USCRIPT_INVALID_CODE)
@@ -61,6 +84,11 @@ private:
 
 	QList<FeaturesRun> itemizeFeatures(const TextRun &run);
 
+	/// everything after buildText(), this part does not modify the story and may run on a worker thread
+	void shapeText(ShapedText& result, const QVector<int>& smallCaps, ShaperResources& resources);
+	/// checks the fonts used by [fromPos, toPos) for shapeParallel(), returns false if the range has to be shaped on the calling thread
+	bool prepareFaces(int fromPos, int toPos, QHash<void*, ShaperFace>& faces);
+
 	ITextContext* m_context;
 	bool m_contextNeeded;
 	ITextSource& m_story;
@@ -68,6 +96,8 @@ private:
 	bool m_singlePar;
 	QString m_text;
 	QMap<int, int> m_textMap;
+
+	static int s_threadCount;
 };
 
 #endif // TEXTSHAPER_H
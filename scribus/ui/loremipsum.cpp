@@ -340,7 +340,7 @@ void LoremManager::insertLoremIpsum(QString name, int paraCount, bool random)
 		i2->itemText.insertChars(l, sampleText);
 		delete lp;
 		if (m_Doc->docHyphenator->AutoCheck)
-			m_Doc->docHyphenator->slotHyphenate(i2);
+			m_Doc->docHyphenator->slotHyphenateLater(i2);
 		i2->asTextFrame()->invalidateLayout(true);
 	}
 	m_Doc->regionsChanged()->update(QRectF());
@@ -24,6 +24,7 @@ for which a new license (GPL+exception) is in place.
 #include "pagelayout.h"
 #include "pagepalette_pages.h"
 #include "pagepalette_widgets.h"
+#include "pagethumbnailcache.h"
 #include "sccombobox.h"
 #include "scpage.h"
 #include "scribuscore.h"
@@ -190,8 +191,10 @@ void PagePalette_Pages::rebuildMasters()
 	masterPageList->clear();
 	if (currView == 0)
 		return;
-	QPixmap pm;
 	QListWidgetItem* item;
+	PageThumbnailCache* thumbnails = currView->Doc->thumbnailCache();
+	if (masterPageList->Thumb)
+		connect(thumbnails, SIGNAL(thumbnailReady(ScPage*,int)), this, SLOT(updateMasterThumbnail(ScPage*,int)), Qt::UniqueConnection);
 	QMap<QString,int>::Iterator it;
 	for (it = currView->Doc->MasterNames.begin(); it != currView->Doc->MasterNames.end(); ++it)
 	{
@@ -199,8 +202,12 @@ void PagePalette_Pages::rebuildMasters()
 		QString pageName = it.key();
 		if (masterPageList->Thumb)
 		{
-			pm = QPixmap::fromImage(currView->MPageToPixmap(it.key(),60));
-			item = new QListWidgetItem(QIcon(pm), pageLabel, masterPageList);
+			// thumbnails which are not rendered yet are updated by updateMasterThumbnail()
+			ScPage* masterPage = currView->Doc->MasterPages.at(it.value());
+			QImage thumbnail(thumbnails->thumbnail(masterPage, 60));
+			if (thumbnail.isNull())
+				thumbnail = PageThumbnailCache::placeholder(masterPage, 60);
+			item = new QListWidgetItem(QIcon(QPixmap::fromImage(thumbnail)), pageLabel, masterPageList);
 		}
 		else
 			item = new QListWidgetItem(pageLabel, masterPageList);
@@ -208,6 +215,24 @@ void PagePalette_Pages::rebuildMasters()
 	}
 }
 
+void PagePalette_Pages::updateMasterThumbnail(ScPage* page, int size)
+{
+	if ((currView == 0) || !masterPageList->Thumb || (size != 60))
+		return;
+	if (!currView->Doc->MasterPages.contains(page))
+		return;
+	QImage thumbnail(currView->Doc->thumbnailCache()->cachedThumbnail(page, size));
+	for (int i = 0; i < masterPageList->count(); ++i)
+	{
+		QListWidgetItem* item = masterPageList->item(i);
+		if (item->data(Qt::UserRole).toString() == page->pageName())
+		{
+			item->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+			break;
+		}
+	}
+}
+
 void PagePalette_Pages::rebuildPages()
 {
 	if (m_scMW->scriptIsRunning())
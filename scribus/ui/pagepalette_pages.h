@@ -20,6 +20,7 @@ for which a new license (GPL+exception) is in place.
 #include "scdockpalette.h"
 
 class PageLayouts;
+class ScPage;
 class ScribusView;
 class ScribusMainWindow;
 class SeItem;
@@ -55,6 +56,7 @@ private slots:
 	void pageView_applyMasterPage(QString masterpageName, int pageIndex);
 	void pageView_movePage(int r, int c);
 	void pageView_gotoPage(int r, int c, int b);
+	void updateMasterThumbnail(ScPage* page, int size);
 
 signals:
 	void gotoMasterPage(QString);
@@ -110,6 +110,9 @@ PDFExportDialog::PDFExportDialog( QWidget* parent, const QString & docFileName,
 	openAfterExportCheckBox = new QCheckBox( tr( "Open PDF after Export" ), Name );
 	openAfterExportCheckBox->setChecked(m_opts.openAfterExport);
 	NameLayout->addWidget( openAfterExportCheckBox, 2, 0 );
+	incrementalUpdateCheckBox = new QCheckBox( tr( "Update existing PDF incrementally" ), Name );
+	incrementalUpdateCheckBox->setChecked(m_opts.incrementalUpdate);
+	NameLayout->addWidget( incrementalUpdateCheckBox, 3, 0 );
 	PDFExportLayout->addWidget( Name );
 
 	Options = new TabPDFOptions( this, pdfOptions, AllFonts, PDFXProfiles, DocFonts, currView->Doc );
@@ -133,6 +136,7 @@ PDFExportDialog::PDFExportDialog( QWidget* parent, const QString & docFileName,
 //tooltips
 	multiFile->setToolTip( "<qt>" + tr( "This enables exporting one individually named PDF file for each page in the document. Page numbers are added automatically. This is most useful for imposing PDF for commercial printing.") + "</qt>" );
 	openAfterExportCheckBox->setToolTip( "<qt>" + tr( "Open the exported PDF with the PDF viewer as set in External Tools preferences, when not exporting to a multi-file export destination") + "</qt>" );
+	incrementalUpdateCheckBox->setToolTip( "<qt>" + tr( "Append only the pages changed since the last export to the existing PDF as an incremental update. The whole file is written again when the settings, fonts, colors or master pages changed, when the changed pages contain annotations, bookmarks or article threads, or when the file has been modified outside of Scribus. Not available for encrypted PDF and PDF/X") + "</qt>" );
 	okButton->setToolTip( "<qt>" + tr( "The save button will be disabled if you are trying to export PDF/X and the info string is missing from the PDF/X tab") + "</qt>" );
 	// signals and slots connections
 	connect( changeButton, SIGNAL( clicked() ), this, SLOT( ChangeFile() ) );
@@ -264,6 +268,7 @@ void PDFExportDialog::updateDocOptions()
 	m_opts.fileName = QDir::fromNativeSeparators(fileNameLineEdit->text());
 	m_opts.doMultiFile = multiFile->isChecked();
 	m_opts.openAfterExport = openAfterExportCheckBox->isChecked();
+	m_opts.incrementalUpdate = incrementalUpdateCheckBox->isChecked();
 	m_opts.Thumbnails = Options->CheckBox1->isChecked();
 	m_opts.Compress = Options->Compression->isChecked();
 	m_opts.CompressMethod = (PDFOptions::PDFCompression) Options->CMethod->currentIndex();
@@ -9,6 +9,7 @@ for which a new license (GPL+exception) is in place.
 #include <QAbstractItemView>
 
 #include "iconmanager.h"
+#include "pagethumbnailcache.h"
 #include "prefsstructs.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
@@ -1300,9 +1301,16 @@ void Prefs_PDFExport::PagePr()
 	effectsPageListWidget->clear();
 	if (showPagePreviewsCheckBox->isChecked())
 	{
+		// thumbnails which are not rendered yet are updated by updatePageThumbnail()
+		PageThumbnailCache* thumbnails = m_doc->thumbnailCache();
+		connect(thumbnails, SIGNAL(thumbnailReady(ScPage*,int)), this, SLOT(updatePageThumbnail(ScPage*,int)), Qt::UniqueConnection);
 		for (int pg = 0; pg < m_doc->Pages->count(); ++pg)
 		{
-			pm=QPixmap::fromImage(m_doc->view()->PageToPixmap(pg, 70));
+			ScPage* page = m_doc->DocPages.at(pg);
+			QImage thumbnail(thumbnails->thumbnail(page, 70));
+			if (thumbnail.isNull())
+				thumbnail = PageThumbnailCache::placeholder(page, 70);
+			pm = QPixmap::fromImage(thumbnail);
 			pgMaxX = qMax(pgMaxX, pm.width());
 			pgMaxY = qMax(pgMaxY, pm.height());
 			new QListWidgetItem( pm, tr("Page")+" "+tmp.setNum(pg+1), effectsPageListWidget);
@@ -1323,6 +1331,17 @@ void Prefs_PDFExport::PagePr()
 	connect(effectsPageListWidget, SIGNAL(itemClicked(QListWidgetItem *)), this, SLOT(SetPgEff()));
 }
 
+void Prefs_PDFExport::updatePageThumbnail(ScPage* page, int size)
+{
+	if (!showPagePreviewsCheckBox->isChecked() || (size != 70))
+		return;
+	int pg = m_doc->DocPages.indexOf(page);
+	if ((pg < 0) || (pg >= effectsPageListWidget->count()))
+		return;
+	QImage thumbnail(m_doc->thumbnailCache()->cachedThumbnail(page, size));
+	effectsPageListWidget->item(pg)->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+}
+
 void Prefs_PDFExport::DoDownsample()
 {
 	if (maxResolutionLimitCheckBox->isChecked())
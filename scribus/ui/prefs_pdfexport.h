@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusapi.h"
 
 #include "pdfoptions.h"
+class ScPage;
 class ScribusDoc;
 
 class SCRIBUS_API Prefs_PDFExport : public Prefs_Pane, Ui::Prefs_PDFExport
@@ -69,6 +70,7 @@ class SCRIBUS_API Prefs_PDFExport : public Prefs_Pane, Ui::Prefs_PDFExport
 		void PagePr();
 		void doDocBleeds();
 		void SetEffOpts(int nr);
+		void updatePageThumbnail(ScPage* page, int size);
 
 	protected:
 		QListWidgetItem* addFontItem(QString fontName, QListWidget* fontList);
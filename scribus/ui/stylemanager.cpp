@@ -264,6 +264,9 @@ void StyleManager::slotApply()
 {
 	if (applyButton->isEnabled())
 	{
+		// stories using the changed styles are invalidated once, after all styles have been applied
+		if (m_doc)
+			m_doc->beginStyleChanges();
 		// #13390 : we have to proceed with some order here
 		SMCharacterStyle* charStyleItem = this->item<SMCharacterStyle>();
 		if (charStyleItem)
@@ -288,7 +291,10 @@ void StyleManager::slotApply()
 			m_items.at(i)->apply();
 		}
 		if (m_doc)
+		{
+			m_doc->endStyleChanges();
 			m_doc->view()->DrawNew();
+		}
 	}
 	slotClean();
 }
@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 
 
 #include "ui/createrange.h"
+#include "pagethumbnailcache.h"
 #include "pdfoptions.h"
 #include "prefsmanager.h"
 #include "scribuscore.h"
@@ -1243,9 +1244,16 @@ void TabPDFOptions::PagePr()
 	Pages->clear();
 	if (PagePrev->isChecked())
 	{
+		// thumbnails which are not rendered yet are updated by updatePageThumbnail()
+		PageThumbnailCache* thumbnails = m_Doc->thumbnailCache();
+		connect(thumbnails, SIGNAL(thumbnailReady(ScPage*,int)), this, SLOT(updatePageThumbnail(ScPage*,int)), Qt::UniqueConnection);
 		for (int pg = 0; pg < m_Doc->Pages->count(); ++pg)
 		{
-			pm=QPixmap::fromImage(m_Doc->view()->PageToPixmap(pg, 70));
+			ScPage* page = m_Doc->DocPages.at(pg);
+			QImage thumbnail(thumbnails->thumbnail(page, 70));
+			if (thumbnail.isNull())
+				thumbnail = PageThumbnailCache::placeholder(page, 70);
+			pm = QPixmap::fromImage(thumbnail);
 			pgMaxX = qMax(pgMaxX, pm.width());
 			pgMaxY = qMax(pgMaxY, pm.height());
 			new QListWidgetItem( pm, tr("Page")+" "+tmp.setNum(pg+1), Pages);
@@ -1266,6 +1274,17 @@ void TabPDFOptions::PagePr()
 	connect(Pages, SIGNAL(currentItemChanged(QListWidgetItem*, QListWidgetItem*)), this, SLOT(SetPgEff(QListWidgetItem*, QListWidgetItem*)));
 }
 
+void TabPDFOptions::updatePageThumbnail(ScPage* page, int size)
+{
+	if (!PagePrev->isChecked() || (size != 70))
+		return;
+	int pg = m_Doc->DocPages.indexOf(page);
+	if ((pg < 0) || (pg >= Pages->count()))
+		return;
+	QImage thumbnail(m_Doc->thumbnailCache()->cachedThumbnail(page, size));
+	Pages->item(pg)->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+}
+
 void TabPDFOptions::DoDownsample()
 {
 	if (DSColor->isChecked())
@@ -34,6 +34,7 @@ class QListWidgetItem;
 
 class PDFOptions;
 class PDFExportDialog;
+class ScPage;
 class ScribusDoc;
 class ScrSpinBox;
 
@@ -101,6 +102,7 @@ public slots:
 protected slots:
 	void createPageNumberRange();
 	void handleCompressionMethod(int ind);
+	void updatePageThumbnail(ScPage* page, int size);
 
 protected:
 	// PDFExportDialog should really privately inherit from us, but it can't
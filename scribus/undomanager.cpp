@@ -333,6 +333,7 @@ void UndoManager::action(UndoObject* target, UndoState* state, QPixmap *targetPi
 		oldIcon = target->getUPixmap();
 		target->setUPixmap(targetPixmap);
 	}
+	target->bumpRevision();
 
 	if (!undoEnabled_) // if so flush down the state
 	{
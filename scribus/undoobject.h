@@ -119,6 +119,14 @@ public:
 	 * @param isUndo If true undo is wanted else if false redo.
 	 */
 	virtual void restore(UndoState* state, bool isUndo) = 0;
+
+	/**
+	 * @brief Called by the UndoManager when an action of this object has been
+	 * recorded, undone or redone.
+	 *
+	 * Objects which keep a revision number make it newer here.
+	 */
+	virtual void bumpRevision() {}
 private:
 	/** @brief id number to be used with the next UndoObject */
 	static ulong m_nextId;
@@ -71,12 +71,17 @@ void UndoState::undo()
 {
 	if (undoObject_) // if !undoObject_ there's an error, hmmm
 		undoObject_->restore(this, true);
+	// restoring may delete the object
+	if (undoObject_)
+		undoObject_->bumpRevision();
 }
 
 void UndoState::redo()
 {
 	if (undoObject_)
 		undoObject_->restore(this, false);
+	if (undoObject_)
+		undoObject_->bumpRevision();
 }
 
 void UndoState::setUndoObject(UndoObject *object)